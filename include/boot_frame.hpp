@@ -0,0 +1,145 @@
+#ifndef PIXLED_DRIVER_BOOT_FRAME_H
+#define PIXLED_DRIVER_BOOT_FRAME_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <driver/rmt.h>
+#include <driver/gpio.h>
+
+#include "strip_config.hpp"
+#include "strip.hpp"
+
+namespace pixled {
+	/**
+	 * A run of identical pixels of a BootFrame.
+	 *
+	 * Bytes are pre-encoded in the order expected by the chip (e.g. GRB for
+	 * a WS2812), so that they are transmitted as is.
+	 */
+	struct boot_run {
+		/**
+		 * Count of pixels of the run.
+		 */
+		uint16_t count;
+		/**
+		 * Bytes of each pixel, in chip order. Only the first `pixel_size`
+		 * bytes are used.
+		 */
+		uint8_t bytes[4];
+	};
+
+	/**
+	 * Startup frame shown before the strips are built.
+	 *
+	 * The frame is stored as a constant array of runs, so that it stays in
+	 * flash and only takes a few bytes, whatever the strip length :
+	 * ```
+	 * // 100 dim orange leds, then 200 black leds, on a WS2812 strip (GRB)
+	 * static const boot_run boot_runs[] {{100, {16, 64, 0}}, {200, {0, 0, 0}}};
+	 * static const BootFrame boot_frame {boot_runs, 2, 3};
+	 *
+	 * extern "C" void app_main() {
+	 *     boot_frame.show(GPIO_NUM_12, RMT_CHANNEL_0, WS2812());
+	 *     // ... slow initialization (Wi-Fi, file system...)
+	 *     RgbStrip strip {GPIO_NUM_12, 300, RMT_CHANNEL_0, WS2812()};
+	 *     boot_frame.copyTo(strip);
+	 * }
+	 * ```
+	 *
+	 * show() does not allocate any pixel or RMT item buffer : the runs are
+	 * expanded to RMT items on the fly by the RMT driver, in small chunks.
+	 * Building the strip, allocating and clearing its buffers, is deferred to
+	 * the moment the application actually needs it.
+	 */
+	class BootFrame {
+		private:
+			const boot_run* runs;
+			uint32_t run_count;
+			uint8_t pixel_size;
+
+			/*
+			 * RMT translator used by show().
+			 */
+			static void translate(const void* src, rmt_item32_t* dest, size_t src_size,
+					size_t wanted_num, size_t* translated_size, size_t* item_num);
+
+		protected:
+			/*
+			 * Position of the encoder in the runs, kept between two calls
+			 * of the translator.
+			 */
+			struct EncodeState {
+				rmt_item32_t bit0;
+				rmt_item32_t bit1;
+				uint8_t pixel_size;
+				/*
+				 * Count of pixels of the current run already encoded.
+				 */
+				uint16_t pixel;
+				/*
+				 * Count of bytes of the current pixel already encoded.
+				 */
+				uint8_t byte;
+			};
+
+			/*
+			 * Initializes an encoder state for `config` timings.
+			 */
+			EncodeState encodeState(const StripConfig& config) const;
+
+			/*
+			 * Encodes the runs starting at `data`, of `size` bytes, producing
+			 * at most `wanted_num` items. `translated_size` is set to the
+			 * size of the runs that are fully encoded : the position in a
+			 * partially encoded run is kept in `state`.
+			 */
+			static void encode(EncodeState& state, const void* data, size_t size,
+					rmt_item32_t* dest, size_t wanted_num, size_t* translated_size, size_t* item_num);
+
+		public:
+			/**
+			 * BootFrame constructor.
+			 *
+			 * @param runs runs of the frame, that must outlive the BootFrame
+			 * @param run_count count of runs
+			 * @param pixel_size count of bytes of each pixel, 3 or 4
+			 */
+			constexpr BootFrame(const boot_run* runs, uint32_t run_count, uint8_t pixel_size)
+				: runs(runs), run_count(run_count), pixel_size(pixel_size) {}
+
+			/**
+			 * @return count of pixels of the frame
+			 */
+			uint32_t length() const;
+
+			/**
+			 * Transmits the frame, as early as possible in the boot.
+			 *
+			 * The RMT channel is configured and the driver installed just for
+			 * this transmission, then uninstalled, so that a Strip can be built
+			 * on the same channel later. The leds keep showing the frame until
+			 * the next show() of that strip.
+			 *
+			 * This call waits for the end of the transmission.
+			 *
+			 * @param gpio_num led strip GPIO
+			 * @param channel RMT channel
+			 * @param config led timings
+			 * @return time to first light : time elapsed since boot, in
+			 * microseconds, when the frame was completely transmitted
+			 */
+			int64_t show(gpio_num_t gpio_num, rmt_channel_t channel, const StripConfig& config) const;
+
+			/**
+			 * Copies the frame to the buffer of a strip, so that its first
+			 * show() transmits the same frame instead of a blank one.
+			 *
+			 * The strip must use pixel_size bytes per pixel, in
+			 * BufferOrder::CHIP order. Pixels beyond the strip length are
+			 * ignored.
+			 */
+			void copyTo(Strip& strip) const;
+	};
+}
+#endif
@@ -0,0 +1,115 @@
+#ifndef PIXLED_DRIVER_CLOCKED_FRAME_H
+#define PIXLED_DRIVER_CLOCKED_FRAME_H
+
+#include <cstdint>
+
+namespace pixled {
+	/**
+	 * Layout of the SPI data sent to clocked leds (APA102, SK9822).
+	 *
+	 * A frame is made of :
+	 * - a start frame of 32 bits set to 0
+	 * - a 32 bits led frame for each pixel : `0b111` followed by a 5 bits
+	 *   global brightness, then the three color bytes in the output order of
+	 *   the chip
+	 * - an end frame, providing the extra clock edges required to propagate
+	 *   the data to the last leds : one bit each two leds, rounded up to whole
+	 *   bytes. SK9822 leds additionally require a 32 bits reset frame before
+	 *   it, that latches the data.
+	 *
+	 * The end frame is made of zeros rather than ones, so that leds past the
+	 * end of the strip are never lit.
+	 *
+	 * This class only manipulates an existing byte buffer, and does not
+	 * depend on the SPI driver.
+	 */
+	class ClockedFrame {
+		public:
+			/**
+			 * Size of the start frame, in bytes.
+			 */
+			static const uint8_t START_FRAME_SIZE = 4;
+			/**
+			 * Size of each led frame, in bytes.
+			 */
+			static const uint8_t LED_FRAME_SIZE = 4;
+			/**
+			 * Size of the SK9822 reset frame, in bytes.
+			 */
+			static const uint8_t RESET_FRAME_SIZE = 4;
+			/**
+			 * Maximum value of the 5 bits global brightness.
+			 */
+			static const uint8_t MAX_BRIGHTNESS = 31;
+
+			/**
+			 * Returns the size, in bytes, of the end frame (including the
+			 * reset frame, if any).
+			 */
+			static uint32_t endFrameSize(uint32_t pixel_count, bool reset_frame);
+
+			/**
+			 * Returns the total size, in bytes, of the frame of `pixel_count`
+			 * leds.
+			 */
+			static uint32_t frameSize(uint32_t pixel_count, bool reset_frame);
+
+			/**
+			 * Initializes the frame in `data`, of at least
+			 * frameSize(pixel_count, reset_frame) bytes.
+			 *
+			 * Start and end frames are written, and all the leds are set to
+			 * black at maximum brightness.
+			 *
+			 * @param data frame buffer
+			 * @param pixel_count number of leds
+			 * @param reset_frame true to insert an SK9822 reset frame
+			 */
+			ClockedFrame(uint8_t* data, uint32_t pixel_count, bool reset_frame);
+
+			/**
+			 * Returns the first byte of the frame.
+			 */
+			uint8_t* data() const {return _data;}
+
+			/**
+			 * Returns the size of the frame, in bytes.
+			 */
+			uint32_t size() const {return _size;}
+
+			/**
+			 * Returns the first led frame. The led frame of pixel `i` starts
+			 * at `pixels()[LED_FRAME_SIZE * i]`, and its colors start at the
+			 * following byte.
+			 */
+			uint8_t* pixels() const {return &_data[START_FRAME_SIZE];}
+
+			/**
+			 * Sets the 5 bits brightness of the led at position `index`.
+			 *
+			 * @param index position of the led
+			 * @param brightness brightness, between 0 and MAX_BRIGHTNESS
+			 */
+			void setBrightness(uint32_t index, uint8_t brightness) {
+				pixels()[LED_FRAME_SIZE * index] = 0xE0 | (brightness > MAX_BRIGHTNESS ? MAX_BRIGHTNESS : brightness);
+			}
+
+			/**
+			 * Returns the 5 bits brightness of the led at position `index`.
+			 */
+			uint8_t brightness(uint32_t index) const {
+				return pixels()[LED_FRAME_SIZE * index] & MAX_BRIGHTNESS;
+			}
+
+			/**
+			 * Sets all the leds to black, with the specified brightness.
+			 */
+			void clear(uint8_t brightness = MAX_BRIGHTNESS);
+
+		private:
+			uint8_t* _data;
+			uint32_t pixel_count;
+			uint32_t _size;
+	};
+}
+#endif
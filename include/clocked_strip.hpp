@@ -0,0 +1,113 @@
+#ifndef PIXLED_DRIVER_CLOCKED_STRIP_H
+#define PIXLED_DRIVER_CLOCKED_STRIP_H
+
+#include <driver/spi_master.h>
+
+#include "strip.hpp"
+#include "clocked_frame.hpp"
+
+namespace pixled {
+	/**
+	 * Strip of SPI clocked RGB leds, such as APA102 or SK9822.
+	 *
+	 * The internal buffer is the SPI frame itself (see ClockedFrame) : each
+	 * pixel uses 4 bytes, a brightness byte followed by the three color bytes
+	 * in the output order. show() directly transmits the frame with DMA,
+	 * without any encoding step.
+	 *
+	 * Each led has a 5 bits global brightness, set with setBrightness() and
+	 * independent of its color. Color setters, clear() included, do not
+	 * change the brightness.
+	 *
+	 * The SPI bus is initialized by the first strip using it, and freed with
+	 * the last one. A bus already initialized by the application is shared
+	 * as is, and never freed by the strips. Clocked leds have no chip
+	 * select : strips sharing a host receive the same data and clock lines,
+	 * so each strip usually gets its own SPI host.
+	 *
+	 * Example usage :
+	 * ```
+	 * ClockedStrip strip {GPIO_NUM_13, GPIO_NUM_14, 144, SPI2_HOST, APA102()};
+	 * strip.setBrightness(8);
+	 * strip.fillRgb(0, 144, {255, 0, 0});
+	 * strip.show();
+	 * ```
+	 */
+	class ClockedStrip : public Strip {
+		public:
+			ClockedStrip(gpio_num_t data_gpio, gpio_num_t clock_gpio, uint32_t pixel_count,
+					spi_host_device_t host, ClockedStripConfig config);
+			ClockedStrip(gpio_num_t data_gpio, gpio_num_t clock_gpio, uint32_t pixel_count,
+					ClockedStripConfig config);
+
+			ClockedStrip(const ClockedStrip&) = delete;
+			ClockedStrip(ClockedStrip&&) = delete;
+			ClockedStrip& operator=(const ClockedStrip&) = delete;
+			ClockedStrip& operator=(ClockedStrip&&) = delete;
+
+			/**
+			 * Returns true if the strip is attached to its SPI bus. Otherwise,
+			 * the error is logged by the constructor and show() does nothing.
+			 */
+			bool ready() const {return device != nullptr;}
+
+			void show() override;
+
+			void setRgbPixel(uint32_t index, uint8_t red, uint8_t green, uint8_t blue) override;
+			void setHsbPixel(uint32_t index, float hue, float saturation, float brightness) override;
+			void setRgbPixels(uint32_t index, const rgb_pixel* pixels, uint32_t count) override;
+			void fillRgb(uint32_t index, uint32_t count, const rgb_pixel& color) override;
+
+			/**
+			 * Sets the 5 bits brightness of the led at position `index`.
+			 *
+			 * The LEDs are not actually updated until a call to show().
+			 *
+			 * @param index position of the led
+			 * @param brightness brightness, between 0 and 31
+			 */
+			void setBrightness(uint32_t index, uint8_t brightness) {
+				markWritten();
+				_frame.setBrightness(index, brightness);
+			}
+
+			/**
+			 * Sets the 5 bits brightness of all the leds.
+			 *
+			 * @param brightness brightness, between 0 and 31
+			 */
+			void setBrightness(uint8_t brightness);
+
+			/**
+			 * Returns the 5 bits brightness of the led at position `index`.
+			 */
+			uint8_t brightness(uint32_t index) const {return _frame.brightness(index);}
+
+			/**
+			 * Sets all the colors to black, without changing brightnesses.
+			 */
+			void clear() override;
+
+			/**
+			 * Returns the complete SPI frame sent by show().
+			 */
+			const ClockedFrame& frame() const {return _frame;}
+
+			/**
+			 * Returns the strip config currently in use.
+			 *
+			 * @return strip config (RGB output order, clock speed)
+			 */
+			const ClockedStripConfig& clockedStripConfig() const {return clocked_strip_config;}
+
+			virtual ~ClockedStrip();
+
+		private:
+			ClockedStripConfig clocked_strip_config;
+			spi_host_device_t host;
+			spi_device_handle_t device;
+			ClockedFrame _frame;
+			HsbToRgbConverter hsb_to_rgb;
+	};
+}
+#endif
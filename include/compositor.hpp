@@ -0,0 +1,163 @@
+#ifndef PIXLED_DRIVER_COMPOSITOR_H
+#define PIXLED_DRIVER_COMPOSITOR_H
+
+#include <cstdint>
+#include <cstddef>
+
+#include "pixel.hpp"
+#include "strip.hpp"
+
+namespace pixled {
+	/**
+	 * Defines how a layer is combined with the layers below it.
+	 *
+	 * In any case, the result is then mixed with the layers below according to
+	 * the layer alpha.
+	 */
+	enum class BlendMode {
+		/**
+		 * The layer color replaces the color below.
+		 */
+		NORMAL,
+		/**
+		 * Colors are added, saturating at 255.
+		 */
+		ADD,
+		/**
+		 * Colors are multiplied, as if their components were in [0;1].
+		 */
+		MULTIPLY,
+		/**
+		 * The maximum of each component is kept.
+		 */
+		MAX
+	};
+
+	/**
+	 * Integer blend kernels.
+	 *
+	 * Each kernel processes `count` bytes, with an alpha value for each byte,
+	 * and only uses 16 bits integer arithmetic so that loops are easily
+	 * vectorized by the compiler. Division by 255 is performed with exact
+	 * rounding.
+	 */
+	namespace blend {
+		void normal(uint8_t* dst, const uint8_t* src, const uint8_t* alpha, size_t count);
+		void add(uint8_t* dst, const uint8_t* src, const uint8_t* alpha, size_t count);
+		void multiply(uint8_t* dst, const uint8_t* src, const uint8_t* alpha, size_t count);
+		void max(uint8_t* dst, const uint8_t* src, const uint8_t* alpha, size_t count);
+	}
+
+	/**
+	 * An RGB layer of a Compositor.
+	 *
+	 * Pixels and optional per-pixel alpha values are owned by the Compositor.
+	 */
+	struct Layer {
+		/**
+		 * Layer colors, written by the application.
+		 */
+		rgb_pixel* pixels;
+		/**
+		 * Per-pixel alpha, or nullptr if the layer has been built without
+		 * per-pixel alpha.
+		 *
+		 * Per-pixel alpha is combined with the layer opacity.
+		 */
+		uint8_t* alpha;
+		/**
+		 * Global alpha of the layer, in [0;255].
+		 */
+		uint8_t opacity;
+		/**
+		 * Blend mode of the layer.
+		 */
+		BlendMode mode;
+		/**
+		 * Invisible layers are skipped.
+		 */
+		bool visible;
+	};
+
+	/**
+	 * Composes a stack of RGB layers into a Strip.
+	 *
+	 * Layers are composed from the first one (bottom) to the last one (top),
+	 * over black. The composition is performed in a single pass, on small
+	 * blocks of pixels that are directly written into the strip with bulk
+	 * setRgbPixels() calls, so that no full size intermediate buffer is
+	 * required.
+	 *
+	 * Example usage, with a base effect and a status overlay :
+	 * ```
+	 * Compositor compositor {strip.length(), 2};
+	 * compositor.layer(1).opacity = 128;
+	 * compositor.layer(1).mode = BlendMode::ADD;
+	 *
+	 * render_effect(compositor.layer(0).pixels);
+	 * render_status(compositor.layer(1).pixels);
+	 * compositor.compose(strip);
+	 * strip.show();
+	 * ```
+	 */
+	class Compositor {
+		public:
+			/**
+			 * Count of pixels composed in each block.
+			 */
+			static const uint16_t BLOCK_SIZE = 32;
+
+		private:
+			uint32_t _length;
+			uint8_t layer_count;
+			Layer* layers;
+
+		public:
+			/**
+			 * Compositor constructor.
+			 *
+			 * All the layers are initialized to black, fully opaque, in NORMAL
+			 * mode.
+			 *
+			 * @param length number of pixels of each layer
+			 * @param layer_count number of layers
+			 * @param pixel_alpha if true, a per-pixel alpha buffer is allocated
+			 * for each layer, initialized to 255
+			 */
+			Compositor(uint32_t length, uint8_t layer_count, bool pixel_alpha = false);
+
+			Compositor(const Compositor&) = delete;
+			Compositor(Compositor&&) = delete;
+			Compositor& operator=(const Compositor&) = delete;
+			Compositor& operator=(Compositor&&) = delete;
+
+			uint32_t length() const {return _length;}
+			uint8_t layerCount() const {return layer_count;}
+
+			Layer& layer(uint8_t index) {return layers[index];}
+			const Layer& layer(uint8_t index) const {return layers[index];}
+
+			/**
+			 * Composes all the visible layers into `output`.
+			 *
+			 * @param output destination array of length() pixels
+			 */
+			void compose(rgb_pixel* output) const;
+
+			/**
+			 * Composes all the visible layers into the strip buffer.
+			 *
+			 * The LEDs are not actually updated until a call to strip.show().
+			 *
+			 * @param strip destination strip
+			 * @param offset strip index of the first pixel of the layers
+			 */
+			void compose(Strip& strip, uint32_t offset = 0) const;
+
+			~Compositor();
+
+		private:
+			void composeBlock(uint32_t index, uint16_t count, rgb_pixel* output) const;
+	};
+}
+#endif
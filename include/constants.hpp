@@ -38,10 +38,10 @@
 #define BGRW pixled::RgbwSerializer(2, 1, 0, 3)
 
 // RMT config
-#define RMT_DIVIDER 8
-#define RMT_CLOCK 8 //80Mhz, 80000000Hz
-#define RMT_RATIO (RMT_CLOCK / RMT_DIVIDER) / 100 // Deduced from nS to S convertion : (([nS]) / 1000000000) * 80000000 / 8, simplified to avoid int overflow
-#define NS_TO_RMT_TICKS(NS) NS * RMT_RATIO
+#define RMT_SOURCE_CLOCK_HZ 80000000 // APB clock, 80Mhz
+#define RMT_MAX_DIVIDER 8 // Coarsest allowed tick : 100nS
+#define DEFAULT_TOLERANCE 150 // Default tolerance of each phase, in nS
+#define DEFAULT_RESET_US 300 // Default low level that latches a frame, in uS
 
 // Delays in nS
 
@@ -50,23 +50,62 @@
 #define WS2812_T0L 800
 #define WS2812_T1H 700
 #define WS2812_T1L 600
+#define WS2812_TOLERANCE 150
 
 // RGB WS2815
 #define WS2815_T0H 300
 #define WS2815_T0L 800
 #define WS2815_T1H 800
 #define WS2815_T1L 300
+#define WS2815_TOLERANCE 150
 
 // RGB SK6812
 #define SK6812_T0H 300
 #define SK6812_T0L 900
 #define SK6812_T1H 600
 #define SK6812_T1L 600
+#define SK6812_TOLERANCE 150
 
 // RGBW SK6812
 #define SK6812W_T0H 300
 #define SK6812W_T0L 900
 #define SK6812W_T1H 600
 #define SK6812W_T1L 600
+#define SK6812W_TOLERANCE 150
+
+// RGB 16 bits WS2816
+#define WS2816_T0H 300
+#define WS2816_T0L 900
+#define WS2816_T1H 750
+#define WS2816_T1L 450
+#define WS2816_TOLERANCE 150
+
+// RGB 16 bits UCS8903
+#define UCS8903_T0H 400
+#define UCS8903_T0L 850
+#define UCS8903_T1H 850
+#define UCS8903_T1L 400
+#define UCS8903_TOLERANCE 150
+
+// RGBW 16 bits UCS8904
+#define UCS8904_T0H 400
+#define UCS8904_T0L 850
+#define UCS8904_T1H 850
+#define UCS8904_T1L 400
+#define UCS8904_TOLERANCE 150
+
+// SPI clock speeds in Hz
+
+// RGB APA102
+#define APA102_CLOCK_SPEED 8000000
+
+// RGB SK9822
+#define SK9822_CLOCK_SPEED 8000000
+
+// Network output UDP ports
+
+#define E131_PORT 5568
+#define ARTNET_PORT 6454
+#define DDP_PORT 4048
 
 #endif
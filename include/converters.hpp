@@ -1,3 +1,8 @@
+#ifndef PIXLED_DRIVER_CONVERTERS_H
+#define PIXLED_DRIVER_CONVERTERS_H
+
+#include <cstddef>
+
 #include "pixel.hpp"
 
 namespace pixled {
@@ -13,7 +18,214 @@ namespace pixled {
 	 */
 	class HsbToRgbConverter {
 		public:
-			rgb_pixel operator()(const hsb_pixel&) const;
+			rgb_pixel operator()(const hsb_pixel& pixel) const {return convert(pixel);}
+
+			/**
+			 * constexpr version of the conversion, that can be used to
+			 * build color tables at compile time.
+			 */
+			static constexpr rgb_pixel convert(const hsb_pixel& pixel) {
+				return pixel.saturation <= 0.0 ?
+					rgb_pixel(pixel.brightness * 255, pixel.brightness * 255, pixel.brightness * 255) :
+					sector(pixel.hue >= 360.0 ? 0.0 : pixel.hue / 60.0, pixel.saturation, pixel.brightness);
+			}
+
+		private:
+			static constexpr rgb_pixel sector(double hh, double saturation, double brightness) {
+				return sector((long) hh, brightness,
+						brightness * (1.0 - saturation),
+						brightness * (1.0 - (saturation * (hh - (long) hh))),
+						brightness * (1.0 - (saturation * (1.0 - (hh - (long) hh)))));
+			}
+			static constexpr rgb_pixel sector(long i, double v, double p, double q, double t) {
+				return
+					i == 0 ? rgb_pixel(v * 255, t * 255, p * 255) :
+					i == 1 ? rgb_pixel(q * 255, v * 255, p * 255) :
+					i == 2 ? rgb_pixel(p * 255, v * 255, t * 255) :
+					i == 3 ? rgb_pixel(p * 255, q * 255, v * 255) :
+					i == 4 ? rgb_pixel(t * 255, p * 255, v * 255) :
+					rgb_pixel(v * 255, p * 255, q * 255);
+			}
+	};
+
+	/**
+	 * @brief Integer HSB to RGB conversion.
+	 *
+	 * Faster alternative to HsbToRgbConverter, that only uses integer
+	 * arithmetic.
+	 *
+	 * @param hue between 0 and 65535, for a full turn
+	 * @param saturation between 0 and 255
+	 * @param brightness between 0 and 255
+	 * @return converted rgb pixel
+	 */
+	class FastHsbToRgbConverter {
+		public:
+			rgb_pixel operator()(uint16_t hue, uint8_t saturation, uint8_t brightness) const {
+				return convert(hue, saturation, brightness);
+			}
+
+			/**
+			 * constexpr version of the conversion, that can be used to
+			 * build color tables at compile time.
+			 */
+			static constexpr rgb_pixel convert(uint16_t hue, uint8_t saturation, uint8_t brightness) {
+				return sector(
+						((uint32_t) hue * 6) >> 16, brightness,
+						div255(brightness * (255 - saturation)),
+						div255(brightness * (255 - div255(saturation * (uint8_t) (((uint32_t) hue * 6) >> 8)))),
+						div255(brightness * (255 - div255(saturation * (255 - (uint8_t) (((uint32_t) hue * 6) >> 8))))));
+			}
+
+		private:
+			/*
+			 * Rounded division by 255 of a value in [0;65535].
+			 */
+			static constexpr uint8_t div255(uint32_t value) {
+				return ((value + 128) + ((value + 128) >> 8)) >> 8;
+			}
+			static constexpr rgb_pixel sector(uint8_t i, uint8_t v, uint8_t p, uint8_t q, uint8_t t) {
+				return
+					i == 0 ? rgb_pixel(v, t, p) :
+					i == 1 ? rgb_pixel(q, v, p) :
+					i == 2 ? rgb_pixel(p, v, t) :
+					i == 3 ? rgb_pixel(p, q, v) :
+					i == 4 ? rgb_pixel(t, p, v) :
+					rgb_pixel(v, p, q);
+			}
+	};
+
+	/**
+	 * @brief Fixed-point sRGB to OKLab conversion.
+	 *
+	 * Components are linearized with a 256 entries table, and the cube root
+	 * of the LMS cone responses is interpolated from a table : only integer
+	 * multiplications are performed, so that the conversion can run for each
+	 * pixel of a frame. All the tables are computed at compile time and stored
+	 * in flash.
+	 *
+	 * Over all the 2^24 sRGB colors, the lightness, a and b components are
+	 * within 8/32768 of a double precision reference.
+	 */
+	class RgbToOklabConverter {
+		public:
+			oklab_pixel operator()(const rgb_pixel& pixel) const {return convert(pixel);}
+
+			/**
+			 * Converts `count` pixels from `input` to `output`.
+			 */
+			void operator()(const rgb_pixel* input, oklab_pixel* output, size_t count) const;
+
+			static oklab_pixel convert(const rgb_pixel& pixel);
+	};
+
+	/**
+	 * @brief Fixed-point OKLab to sRGB conversion.
+	 *
+	 * The LMS cone responses are cubed with integer multiplications, and the
+	 * linear components are encoded to sRGB with a 4096 entries table stored
+	 * in flash.
+	 *
+	 * Colors out of the sRGB gamut are clipped, first in the LMS space, then
+	 * in the linear RGB space. Compared to a double precision reference
+	 * applied to the same OKLab values, components are within 2. Converting
+	 * any sRGB color to OKLab and back gives the same color for 98% of the
+	 * colors, and is never off by more than 2.
+	 */
+	class OklabToRgbConverter {
+		public:
+			rgb_pixel operator()(const oklab_pixel& pixel) const {return convert(pixel);}
+
+			/**
+			 * Converts `count` pixels from `input` to `output`.
+			 */
+			void operator()(const oklab_pixel* input, rgb_pixel* output, size_t count) const;
+
+			static rgb_pixel convert(const oklab_pixel& pixel);
+	};
+
+	/**
+	 * @brief Fixed-point OKLab to OKLCH conversion.
+	 *
+	 * The hue is computed with an arctangent table, and the chroma with an
+	 * integer square root.
+	 */
+	class OklabToOklchConverter {
+		public:
+			oklch_pixel operator()(const oklab_pixel& pixel) const {return convert(pixel);}
+
+			/**
+			 * Converts `count` pixels from `input` to `output`.
+			 */
+			void operator()(const oklab_pixel* input, oklch_pixel* output, size_t count) const;
+
+			static oklch_pixel convert(const oklab_pixel& pixel);
+	};
+
+	/**
+	 * @brief Fixed-point OKLCH to OKLab conversion.
+	 *
+	 * Sines and cosines are interpolated from a quarter wave table.
+	 */
+	class OklchToOklabConverter {
+		public:
+			oklab_pixel operator()(const oklch_pixel& pixel) const {return convert(pixel);}
+
+			/**
+			 * Converts `count` pixels from `input` to `output`.
+			 */
+			void operator()(const oklch_pixel* input, oklab_pixel* output, size_t count) const;
+
+			static oklab_pixel convert(const oklch_pixel& pixel);
+	};
+
+	/**
+	 * @brief Fixed-point OKLCH to sRGB conversion.
+	 *
+	 * Equivalent to an OklchToOklabConverter followed by an
+	 * OklabToRgbConverter. Perceptual gradients are rendered by interpolating
+	 * OKLCH (or OKLab) colors, then converting them in blocks :
+	 * ```
+	 * oklch_pixel gradient[32];
+	 * rgb_pixel block[32];
+	 * for(uint16_t i = 0; i < 32; i++)
+	 *     gradient[i] = {24000, 4000, (uint16_t) (i * 2048)};
+	 * OklchToRgbConverter()(gradient, block, 32);
+	 * strip.setRgbPixels(0, block, 32);
+	 * ```
+	 */
+	class OklchToRgbConverter {
+		public:
+			rgb_pixel operator()(const oklch_pixel& pixel) const {return convert(pixel);}
+
+			/**
+			 * Converts `count` pixels from `input` to `output`.
+			 */
+			void operator()(const oklch_pixel* input, rgb_pixel* output, size_t count) const;
+
+			static rgb_pixel convert(const oklch_pixel& pixel) {
+				return OklabToRgbConverter::convert(OklchToOklabConverter::convert(pixel));
+			}
+	};
+
+	/**
+	 * @brief Converts 16 bits per channel colors to 8 bits per channel
+	 * colors, with rounding.
+	 */
+	class Rgb16ToRgbConverter {
+		public:
+			rgb_pixel operator()(const rgb16_pixel& pixel) const {
+				return rgb_pixel(convert(pixel.red), convert(pixel.green), convert(pixel.blue));
+			}
+
+			/**
+			 * Converts `count` pixels from `input` to `output`.
+			 */
+			void operator()(const rgb16_pixel* input, rgb_pixel* output, size_t count) const;
+
+			static constexpr uint8_t convert(uint16_t value) {
+				return (value * 255u + 32768u) >> 16;
+			}
 	};
 
 	class RgbToRgbwConverter {
@@ -40,7 +252,36 @@ namespace pixled {
 
 	class SimpleRgbToRgbwConverter : public RgbToRgbwConverter {
 		public:
-			rgbw_pixel operator()(const rgb_pixel&) const;
+			rgbw_pixel operator()(const rgb_pixel& pixel) const override {return convert(pixel);}
+
+			/**
+			 * constexpr version of the conversion, that can be used to
+			 * build color tables at compile time.
+			 */
+			static constexpr rgbw_pixel convert(const rgb_pixel& pixel) {
+				return convert(pixel, min(pixel.red, min(pixel.green, pixel.blue)));
+			}
+
+			/**
+			 * Same conversion, on 16 bits channels.
+			 */
+			static constexpr rgbw16_pixel convert16(const rgb16_pixel& pixel) {
+				return convert16(pixel, min16(pixel.red, min16(pixel.green, pixel.blue)));
+			}
+
+		private:
+			static constexpr uint8_t min(uint8_t a, uint8_t b) {
+				return a < b ? a : b;
+			}
+			static constexpr uint16_t min16(uint16_t a, uint16_t b) {
+				return a < b ? a : b;
+			}
+			static constexpr rgbw16_pixel convert16(const rgb16_pixel& pixel, uint16_t white) {
+				return rgbw16_pixel(pixel.red - white, pixel.green - white, pixel.blue - white, white);
+			}
+			static constexpr rgbw_pixel convert(const rgb_pixel& pixel, uint8_t white) {
+				return rgbw_pixel(pixel.red - white, pixel.green - white, pixel.blue - white, white);
+			}
 	};
 
 	/**
@@ -58,6 +299,70 @@ namespace pixled {
 	 */
 	class ComplexRgbToRgbwConverter : public RgbToRgbwConverter {
 		public:
-			rgbw_pixel operator()(const rgb_pixel&) const;
+			rgbw_pixel operator()(const rgb_pixel& pixel) const override {return convert(pixel);}
+
+			/**
+			 * constexpr version of the conversion, that can be used to
+			 * build color tables at compile time.
+			 */
+			static constexpr rgbw_pixel convert(const rgb_pixel& pixel) {
+				// If the maximum value is 0, immediately returns pure black.
+				return max(pixel.red, max(pixel.green, pixel.blue)) == 0 ?
+					rgbw_pixel(0, 0, 0, 0) :
+					convert(pixel, 255.0f / max(pixel.red, max(pixel.green, pixel.blue)));
+			}
+
+			/**
+			 * Same conversion, on 16 bits channels. The white value is
+			 * rounded, and removed from the three channels.
+			 */
+			static constexpr rgbw16_pixel convert16(const rgb16_pixel& pixel) {
+				return max(pixel.red, max(pixel.green, pixel.blue)) == 0 ?
+					rgbw16_pixel(0, 0, 0, 0) :
+					convert16(pixel, 65535.0f / max(pixel.red, max(pixel.green, pixel.blue)));
+			}
+
+		private:
+			static constexpr float max(float a, float b) {
+				return a > b ? a : b;
+			}
+			static constexpr float min(float a, float b) {
+				return a < b ? a : b;
+			}
+			/*
+			 * `multiplier` scales the color to its 100% hue version.
+			 */
+			static constexpr rgbw_pixel convert(const rgb_pixel& pixel, float multiplier) {
+				return withLuminance(pixel, luminance(
+							max(pixel.red * multiplier, max(pixel.green * multiplier, pixel.blue * multiplier)),
+							min(pixel.red * multiplier, min(pixel.green * multiplier, pixel.blue * multiplier)),
+							multiplier));
+			}
+			/*
+			 * Whiteness (not strictly speaking luminance) of the color.
+			 */
+			static constexpr float luminance(float max, float min, float multiplier, float full_scale = 255.0f) {
+				return ((max + min) / 2.0f - full_scale / 2.0f) * 2.0f / multiplier;
+			}
+			static constexpr rgbw16_pixel convert16(const rgb16_pixel& pixel, float multiplier) {
+				return withWhite16(pixel, (uint16_t) (luminance(
+								max(pixel.red * multiplier, max(pixel.green * multiplier, pixel.blue * multiplier)),
+								min(pixel.red * multiplier, min(pixel.green * multiplier, pixel.blue * multiplier)),
+								multiplier, 65535.0f) + 0.5f));
+			}
+			static constexpr uint16_t minus(uint16_t value, uint16_t white) {
+				return value > white ? value - white : 0;
+			}
+			static constexpr rgbw16_pixel withWhite16(const rgb16_pixel& pixel, uint16_t white) {
+				return rgbw16_pixel(minus(pixel.red, white), minus(pixel.green, white), minus(pixel.blue, white), white);
+			}
+			static constexpr rgbw_pixel withLuminance(const rgb_pixel& pixel, float luminance) {
+				return rgbw_pixel(
+						(uint8_t) (pixel.red - luminance),
+						(uint8_t) (pixel.green - luminance),
+						(uint8_t) (pixel.blue - luminance),
+						(uint8_t) luminance);
+			}
 	};
 }
+#endif
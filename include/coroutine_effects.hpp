@@ -0,0 +1,271 @@
+#ifndef PIXLED_DRIVER_COROUTINE_EFFECTS_H
+#define PIXLED_DRIVER_COROUTINE_EFFECTS_H
+
+/*
+ * Coroutine based effects require C++20. This header does not depend on
+ * ESP-IDF, so that effects can also be built and tested on a host.
+ */
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <new>
+
+#include "trace.hpp"
+
+namespace pixled {
+	class EffectScheduler;
+
+	/**
+	 * Coroutine run by an EffectScheduler.
+	 *
+	 * Any function returning an EffectTask is a coroutine that can
+	 * `co_await nextFrame()` or `co_await delay(...)` to give the hand back to
+	 * the scheduler. Only the coroutine frame (its local variables that live
+	 * across suspension points) is allocated, instead of a full task stack.
+	 *
+	 * Example :
+	 * ```
+	 * EffectTask blink(Strip& strip, uint32_t index, rgb_pixel color) {
+	 *     while(true) {
+	 *         strip.setRgbPixel(index, color.red, color.green, color.blue);
+	 *         co_await delay(500);
+	 *         strip.setRgbPixel(index, 0, 0, 0);
+	 *         co_await delay(500);
+	 *     }
+	 * }
+	 * ```
+	 *
+	 * The coroutine does not start until it is spawned into a scheduler, that
+	 * takes its ownership.
+	 */
+	class EffectTask {
+		public:
+			struct promise_type {
+				EffectScheduler* scheduler = nullptr;
+				uint32_t wake_frame = 0;
+				std::size_t frame_size;
+				/*
+				 * Next effect of the scheduler list.
+				 */
+				promise_type* next = nullptr;
+
+				/*
+				 * Size of the last allocated coroutine frame, read by the
+				 * promise constructor that immediately follows the allocation.
+				 */
+				static inline std::size_t last_frame_size = 0;
+
+				promise_type() : frame_size(last_frame_size) {}
+
+				static void* operator new(std::size_t size) {
+					last_frame_size = size;
+					return ::operator new(size);
+				}
+				static void operator delete(void* frame) {
+					::operator delete(frame);
+				}
+
+				EffectTask get_return_object() {
+					return EffectTask(std::coroutine_handle<promise_type>::from_promise(*this));
+				}
+				std::suspend_always initial_suspend() noexcept {return {};}
+				std::suspend_always final_suspend() noexcept {return {};}
+				void return_void() {}
+				void unhandled_exception() {std::terminate();}
+			};
+
+			EffectTask(EffectTask&& other) : handle(other.handle) {other.handle = nullptr;}
+			EffectTask(const EffectTask&) = delete;
+			EffectTask& operator=(const EffectTask&) = delete;
+			EffectTask& operator=(EffectTask&&) = delete;
+
+			/**
+			 * @return bytes allocated for the coroutine frame
+			 */
+			std::size_t frameSize() const {return handle ? handle.promise().frame_size : 0;}
+
+			~EffectTask() {
+				if(handle)
+					handle.destroy();
+			}
+
+		private:
+			friend class EffectScheduler;
+			std::coroutine_handle<promise_type> handle;
+
+			explicit EffectTask(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+	};
+
+	/**
+	 * Runs effect coroutines, frame by frame, from a single task.
+	 *
+	 * At each call to tick(), all the effects that are due are resumed, one
+	 * after the other, then the strip is shown once.
+	 *
+	 * Example usage, from a single FreeRTOS task :
+	 * ```
+	 * EffectScheduler scheduler {20};
+	 * scheduler.spawn(blink(strip, 0, {255, 0, 0}));
+	 * scheduler.spawn(blink(strip, 1, {0, 0, 255}));
+	 *
+	 * TickType_t wake = xTaskGetTickCount();
+	 * while(1) {
+	 *     scheduler.tick(strip);
+	 *     vTaskDelayUntil(&wake, 20 / portTICK_PERIOD_MS);
+	 * }
+	 * ```
+	 */
+	class EffectScheduler {
+		private:
+			uint32_t frame_period_ms;
+			uint32_t _frame;
+			EffectTask::promise_type* effects;
+			std::size_t effect_count;
+
+		public:
+			/**
+			 * @param frame_period_ms duration of a frame, used to convert
+			 * delays to frames
+			 */
+			EffectScheduler(uint32_t frame_period_ms)
+				: frame_period_ms(frame_period_ms), _frame(0), effects(nullptr), effect_count(0) {}
+
+			EffectScheduler(const EffectScheduler&) = delete;
+			EffectScheduler& operator=(const EffectScheduler&) = delete;
+
+			/**
+			 * @return index of the current frame
+			 */
+			uint32_t frame() const {return _frame;}
+
+			/**
+			 * @return count of frames corresponding to `ms`, rounded up
+			 */
+			uint32_t framesFor(uint32_t ms) const {
+				return (ms + frame_period_ms - 1) / frame_period_ms;
+			}
+
+			/**
+			 * @return count of effects that are not finished
+			 */
+			std::size_t effectCount() const {return effect_count;}
+
+			/**
+			 * @return bytes allocated for the frames of the effects that are
+			 * not finished
+			 */
+			std::size_t memoryUsage() const {
+				std::size_t usage = 0;
+				for(EffectTask::promise_type* effect = effects; effect != nullptr; effect = effect->next)
+					usage += effect->frame_size;
+				return usage;
+			}
+
+			/**
+			 * Takes the ownership of an effect. The effect starts at the next
+			 * call to resume() or tick().
+			 *
+			 * Effects are resumed in the order they were spawned.
+			 */
+			void spawn(EffectTask&& task) {
+				EffectTask::promise_type& promise = task.handle.promise();
+				task.handle = nullptr;
+				promise.scheduler = this;
+				promise.wake_frame = _frame;
+				EffectTask::promise_type** link = &effects;
+				while(*link != nullptr)
+					link = &(*link)->next;
+				*link = &promise;
+				effect_count++;
+			}
+
+			/**
+			 * Resumes all the effects that are due, and advances to the next
+			 * frame. Finished effects are destroyed.
+			 */
+			void resume() {
+				EffectTask::promise_type** link = &effects;
+				while(*link != nullptr) {
+					EffectTask::promise_type* effect = *link;
+					auto handle = std::coroutine_handle<EffectTask::promise_type>::from_promise(*effect);
+					if(effect->wake_frame <= _frame) {
+						PIXLED_TRACE_SPAN("effect");
+						handle.resume();
+					}
+					if(handle.done()) {
+						*link = effect->next;
+						handle.destroy();
+						effect_count--;
+					} else {
+						link = &effect->next;
+					}
+				}
+				_frame++;
+			}
+
+			/**
+			 * Resumes the effects that are due, then shows the strip once.
+			 *
+			 * @param strip any object with a show() method
+			 */
+			template<typename S>
+				void tick(S& strip) {
+					resume();
+					strip.show();
+				}
+
+			/**
+			 * Destroys all the remaining effects.
+			 */
+			~EffectScheduler() {
+				while(effects != nullptr) {
+					EffectTask::promise_type* effect = effects;
+					effects = effect->next;
+					std::coroutine_handle<EffectTask::promise_type>::from_promise(*effect).destroy();
+				}
+			}
+	};
+
+	/**
+	 * Awaitable that suspends an effect for `frames` frames.
+	 *
+	 * `co_await` returns the index of the frame at which the effect is
+	 * resumed.
+	 */
+	struct FrameDelay {
+		uint32_t frames;
+		uint32_t ms;
+		EffectScheduler* scheduler = nullptr;
+
+		bool await_ready() const noexcept {return false;}
+		void await_suspend(std::coroutine_handle<EffectTask::promise_type> handle) {
+			EffectTask::promise_type& promise = handle.promise();
+			scheduler = promise.scheduler;
+			const uint32_t delay = frames + scheduler->framesFor(ms);
+			promise.wake_frame = scheduler->frame() + (delay > 0 ? delay : 1);
+		}
+		uint32_t await_resume() const {return scheduler->frame();}
+	};
+
+	/**
+	 * Suspends the effect until the next frame.
+	 */
+	inline FrameDelay nextFrame() {return {1, 0};}
+
+	/**
+	 * Suspends the effect for `frames` frames (at least one).
+	 */
+	inline FrameDelay delayFrames(uint32_t frames) {return {frames, 0};}
+
+	/**
+	 * Suspends the effect for at least `ms` milliseconds, rounded up to a
+	 * whole count of frames (at least one).
+	 */
+	inline FrameDelay delay(uint32_t ms) {return {0, ms};}
+}
+
+#endif
+#endif
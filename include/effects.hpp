@@ -0,0 +1,242 @@
+#ifndef PIXLED_DRIVER_EFFECTS_H
+#define PIXLED_DRIVER_EFFECTS_H
+
+#include <cstdint>
+
+#include "pixel.hpp"
+#include "converters.hpp"
+#include "strip.hpp"
+
+namespace pixled {
+	/**
+	 * General and abstract effect class.
+	 *
+	 * An effect renders `length()` pixels. Its state is advanced by one frame
+	 * with update(), and the current frame is written to a strip with draw().
+	 *
+	 * All the effects only use integer or fixed-point arithmetic, and never
+	 * allocate memory after their construction. Pixels are rendered in small
+	 * blocks that are written to the strip with bulk setRgbPixels() calls.
+	 *
+	 * Example usage :
+	 * ```
+	 * Rainbow rainbow {strip.length()};
+	 * while(1) {
+	 *     rainbow.update();
+	 *     rainbow.draw(strip);
+	 *     strip.show();
+	 *     vTaskDelay(20 / portTICK_PERIOD_MS);
+	 * }
+	 * ```
+	 */
+	class Effect {
+		public:
+			/**
+			 * Count of pixels rendered in each block by draw().
+			 */
+			static const uint16_t BLOCK_SIZE = 32;
+
+			Effect(uint32_t length) : _length(length) {}
+
+			uint32_t length() const {return _length;}
+
+			/**
+			 * Advances the effect by one frame.
+			 */
+			virtual void update() = 0;
+
+			/**
+			 * Renders `count` pixels of the current frame, starting at pixel
+			 * `index` of the effect.
+			 *
+			 * @param index position of the first pixel to render
+			 * @param count number of pixels to render
+			 * @param output rendered pixels
+			 */
+			virtual void render(uint32_t index, uint32_t count, rgb_pixel* output) const = 0;
+
+			/**
+			 * Renders the current frame into `output`, of length() pixels.
+			 */
+			void draw(rgb_pixel* output) const {render(0, _length, output);}
+
+			/**
+			 * Renders the current frame into the strip.
+			 *
+			 * The LEDs are not actually updated until a call to strip.show().
+			 *
+			 * @param strip destination strip
+			 * @param offset strip index of the first pixel of the effect
+			 */
+			void draw(Strip& strip, uint32_t offset = 0) const;
+
+			virtual ~Effect() {}
+
+		protected:
+			uint32_t _length;
+	};
+
+	/**
+	 * A rainbow cycling along the strip.
+	 *
+	 * Hues are 16 bits values, where 65536 is a full turn.
+	 */
+	class Rainbow : public Effect {
+		public:
+			/**
+			 * @param length number of pixels
+			 * @param hue_step hue difference between two consecutive pixels.
+			 * 0 means that a full turn is displayed on the strip (or on
+			 * each 65536 pixels of longer strips).
+			 * @param speed hue increment at each frame
+			 * @param saturation between 0 and 255
+			 * @param brightness between 0 and 255
+			 */
+			Rainbow(uint32_t length, uint16_t hue_step = 0, uint16_t speed = 256,
+					uint8_t saturation = 255, uint8_t brightness = 255);
+
+			void update() override;
+			void render(uint32_t index, uint32_t count, rgb_pixel* output) const override;
+
+			uint16_t hue;
+			uint16_t hue_step;
+			uint16_t speed;
+			uint8_t saturation;
+			uint8_t brightness;
+
+		private:
+			FastHsbToRgbConverter hsb_to_rgb;
+	};
+
+	/**
+	 * Segments of a color moving along the strip, with a fading tail.
+	 *
+	 * Positions are 8.8 fixed-point values, in pixels, so that the chase can
+	 * move slower than one pixel per frame.
+	 */
+	class Chase : public Effect {
+		public:
+			/**
+			 * @param length number of pixels
+			 * @param color color of the segments
+			 * @param width length of each segment, tail included, in pixels
+			 * (0 is used as 1)
+			 * @param spacing distance between the heads of two consecutive
+			 * segments, in pixels (0 is used as 1)
+			 * @param speed 8.8 fixed-point position increment at each frame
+			 */
+			Chase(uint32_t length, rgb_pixel color, uint8_t width = 8, uint8_t spacing = 32, uint16_t speed = 256);
+
+			void update() override;
+			void render(uint32_t index, uint32_t count, rgb_pixel* output) const override;
+
+			rgb_pixel color;
+
+		private:
+			uint8_t width;
+			uint8_t spacing;
+			uint16_t speed;
+			uint16_t position;
+			uint32_t fade_step;
+	};
+
+	/**
+	 * Fire simulation, burning from the first pixel of the strip.
+	 *
+	 * The heat of each pixel is stored in a byte buffer, allocated with the
+	 * effect.
+	 */
+	class Fire : public Effect {
+		public:
+			/**
+			 * @param length number of pixels
+			 * @param cooling how much the air cools as it rises, between 20
+			 * and 100 is a good range
+			 * @param sparking chance (out of 255) that a new spark is lit at
+			 * each frame
+			 * @param seed seed of the internal pseudo random generator
+			 */
+			Fire(uint32_t length, uint8_t cooling = 55, uint8_t sparking = 120, uint32_t seed = 1);
+
+			Fire(const Fire&) = delete;
+			Fire(Fire&&) = delete;
+			Fire& operator=(const Fire&) = delete;
+			Fire& operator=(Fire&&) = delete;
+
+			void update() override;
+			void render(uint32_t index, uint32_t count, rgb_pixel* output) const override;
+
+			uint8_t cooling;
+			uint8_t sparking;
+
+			const uint8_t* heat() const {return _heat;}
+
+			~Fire();
+
+		private:
+			uint8_t* _heat;
+			uint32_t random_state;
+
+			uint8_t random8();
+	};
+
+	/**
+	 * Randomly twinkling pixels.
+	 *
+	 * The phase and rate of each pixel are derived from a hash of its index,
+	 * so no per-pixel state is required.
+	 */
+	class Twinkle : public Effect {
+		public:
+			/**
+			 * @param length number of pixels
+			 * @param color color of the twinkles
+			 * @param density proportion (out of 255) of twinkling pixels
+			 * @param speed phase increment at each frame
+			 */
+			Twinkle(uint32_t length, rgb_pixel color, uint8_t density = 64, uint16_t speed = 512);
+
+			void update() override;
+			void render(uint32_t index, uint32_t count, rgb_pixel* output) const override;
+
+			rgb_pixel color;
+			uint8_t density;
+			uint16_t speed;
+
+		private:
+			uint16_t time;
+	};
+
+	/**
+	 * A linear gradient between two colors.
+	 *
+	 * With a non null speed, the gradient moves along the strip, going back
+	 * and forth between the two colors.
+	 */
+	class Gradient : public Effect {
+		public:
+			/**
+			 * @param length number of pixels
+			 * @param from color of the first pixel
+			 * @param to color of the last pixel
+			 * @param speed 16 bits phase increment at each frame
+			 */
+			Gradient(uint32_t length, rgb_pixel from, rgb_pixel to, uint16_t speed = 0);
+
+			void update() override;
+			void render(uint32_t index, uint32_t count, rgb_pixel* output) const override;
+
+			rgb_pixel from;
+			rgb_pixel to;
+			uint16_t speed;
+
+		private:
+			/*
+			 * 16.16 fixed-point phases, so that long gradients still
+			 * progress between consecutive pixels.
+			 */
+			uint32_t phase;
+			uint32_t phase_step;
+	};
+}
+#endif
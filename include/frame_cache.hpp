@@ -0,0 +1,157 @@
+#ifndef PIXLED_DRIVER_FRAME_CACHE_H
+#define PIXLED_DRIVER_FRAME_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <driver/rmt.h>
+
+namespace pixled {
+	/**
+	 * Cache of encoded RMT frames of a Strip.
+	 *
+	 * Once attached to a strip with Strip::setFrameCache(), each frame
+	 * encoded by show() is stored in the cache, and a frame that is shown
+	 * again is transmitted from the cache without being encoded.
+	 *
+	 * Frames are identified either :
+	 * - by the content of the strip buffer. A hash is used to find the
+	 *   frame, and a copy of the buffer is stored with the items to check
+	 *   that the frame is really identical.
+	 * - by a frame ID provided by the application with Strip::setFrameId(),
+	 *   for example the index of the frame in an animation loop. No copy of
+	 *   the buffer is stored, and the application must guarantee that a given
+	 *   ID always identifies the same content.
+	 *
+	 * The cache never uses more than its memory budget : least recently
+	 * used frames are evicted to make room for new ones. Pinned frames are
+	 * never evicted. A frame that does not fit in the budget is not cached.
+	 *
+	 * A cache must only be attached to a single strip.
+	 *
+	 * Example usage :
+	 * ```
+	 * FrameCache cache {64 * 1024};
+	 * strip.setFrameCache(&cache);
+	 * for(uint32_t frame = 0; ; frame = (frame + 1) % 20) {
+	 *     render(strip, frame);
+	 *     strip.setFrameId(frame);
+	 *     strip.show(); // Only the first loop encodes frames
+	 * }
+	 * ```
+	 */
+	class FrameCache {
+		private:
+			struct Entry {
+				Entry* previous;
+				Entry* next;
+				uint32_t key;
+				bool by_id;
+				bool pinned;
+				uint32_t item_count;
+				rmt_item32_t* items;
+				/*
+				 * Copy of the strip buffer, only for frames identified by
+				 * their content.
+				 */
+				uint8_t* buffer;
+				uint32_t buffer_size;
+			};
+
+			size_t _budget;
+			size_t memory_usage;
+			/*
+			 * Entries, from the most recently used to the least recently
+			 * used.
+			 */
+			Entry* first;
+			Entry* last;
+			uint32_t entry_count;
+			uint32_t _hits;
+			uint32_t _misses;
+			uint32_t _evictions;
+
+			static size_t entrySize(uint32_t item_count, uint32_t buffer_size);
+			Entry* find(uint32_t key, bool by_id) const;
+			void unlink(Entry* entry);
+			void pushFront(Entry* entry);
+			void remove(Entry* entry);
+
+		public:
+			/**
+			 * FrameCache constructor.
+			 *
+			 * @param budget maximum count of bytes used by the cached
+			 * frames, including their bookkeeping
+			 */
+			FrameCache(size_t budget);
+
+			FrameCache(const FrameCache&) = delete;
+			FrameCache(FrameCache&&) = delete;
+			FrameCache& operator=(const FrameCache&) = delete;
+			FrameCache& operator=(FrameCache&&) = delete;
+
+			/**
+			 * Looks up a frame, and records a hit or a miss.
+			 *
+			 * @param key buffer hash, or frame ID
+			 * @param by_id true if `key` is a frame ID
+			 * @param buffer strip buffer, compared to the cached copy for
+			 * frames identified by their content
+			 * @param buffer_size size of the strip buffer
+			 * @param item_count count of items of the frame
+			 * @return cached items, or nullptr on a miss
+			 */
+			const rmt_item32_t* lookup(uint32_t key, bool by_id,
+					const uint8_t* buffer, uint32_t buffer_size, uint32_t item_count);
+
+			/**
+			 * Stores an encoded frame, evicting least recently used frames
+			 * if necessary.
+			 *
+			 * @return false if the frame could not fit in the budget
+			 */
+			bool insert(uint32_t key, bool by_id, bool pinned,
+					const uint8_t* buffer, uint32_t buffer_size,
+					const rmt_item32_t* items, uint32_t item_count);
+
+			/**
+			 * Pins or unpins the frame with the ID `frame_id`, if it is
+			 * cached. Pinned frames are never evicted.
+			 *
+			 * @return true if the frame is cached
+			 */
+			bool pin(uint32_t frame_id, bool pinned = true);
+
+			/**
+			 * Removes all the frames, pinned frames included. Statistics are
+			 * kept.
+			 */
+			void clear();
+
+			size_t budget() const {return _budget;}
+			/**
+			 * @return count of bytes used by the cached frames
+			 */
+			size_t memoryUsage() const {return memory_usage;}
+			/**
+			 * @return count of cached frames
+			 */
+			uint32_t entryCount() const {return entry_count;}
+			/**
+			 * @return count of frames transmitted from the cache
+			 */
+			uint32_t hits() const {return _hits;}
+			/**
+			 * @return count of frames that had to be encoded
+			 */
+			uint32_t misses() const {return _misses;}
+			/**
+			 * @return count of frames evicted to make room for new frames
+			 */
+			uint32_t evictions() const {return _evictions;}
+
+			~FrameCache();
+	};
+}
+#endif
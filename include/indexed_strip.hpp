@@ -0,0 +1,219 @@
+#ifndef PIXLED_DRIVER_INDEXED_STRIP_H
+#define PIXLED_DRIVER_INDEXED_STRIP_H
+
+#include "strip.hpp"
+
+namespace pixled {
+	/**
+	 * Available palette sizes for indexed strips.
+	 */
+	enum class PaletteSize : uint16_t {
+		PALETTE_16 = 16,
+		PALETTE_256 = 256
+	};
+
+	/**
+	 * General and abstract indexed color strip class.
+	 *
+	 * The internal buffer stores a single byte for each pixel : the index of
+	 * its color in a palette. Palette colors are serialized (and pre-encoded to
+	 * RMT items for 16 colors palettes) when they are set, so that show()
+	 * directly expands each index to RMT items.
+	 *
+	 * In TransmitMode::BUFFERED, the whole frame is expanded before the
+	 * transmission, to an item buffer of 4 bytes per transmitted bit (96
+	 * bytes per RGB led) : the 1 byte per led of the indexes is then only a
+	 * small part of the memory used by the strip. With
+	 * TransmitMode::STREAMING, indexes are expanded on the fly by the RMT
+	 * translator, and no item buffer is allocated.
+	 *
+	 * Changing a palette color changes the color of all the pixels using it,
+	 * without modifying the pixels.
+	 *
+	 * The generic setRgbPixel() and setHsbPixel() functions select the closest
+	 * color of the palette. setIndex() should be used to efficiently set
+	 * pixels.
+	 */
+	class IndexedStrip : public Strip {
+		public:
+			IndexedStrip(
+					gpio_num_t gpio_num, uint32_t pixel_count, rmt_channel_t channel,
+					PaletteSize palette_size, uint8_t entry_size, StripConfig config);
+
+			IndexedStrip(const IndexedStrip&) = delete;
+			IndexedStrip(IndexedStrip&&) = delete;
+			IndexedStrip& operator=(const IndexedStrip&) = delete;
+			IndexedStrip& operator=(IndexedStrip&&) = delete;
+
+			void show() override;
+
+			void setRgbPixel(uint32_t index, uint8_t red, uint8_t green, uint8_t blue) override;
+			void setHsbPixel(uint32_t index, float hue, float saturation, float brightness) override;
+			void setRgbPixels(uint32_t index, const rgb_pixel* pixels, uint32_t count) override;
+			void fillRgb(uint32_t index, uint32_t count, const rgb_pixel& color) override;
+
+			/**
+			 * Sets the palette entry of the led at position `index`.
+			 *
+			 * The LEDs are not actually updated until a call to show().
+			 *
+			 * @param index position of the led
+			 * @param entry palette entry, lower than paletteSize()
+			 * @return false if `entry` is out of the palette, in which case
+			 * the led is not modified
+			 */
+			bool setIndex(uint32_t index, uint8_t entry) {
+				if(entry >= palette_size)
+					return false;
+				markWritten();
+				_buffer[index] = entry;
+				return true;
+			}
+
+			/**
+			 * Sets `count` consecutive leds, starting at `index`, to the
+			 * palette entry `entry`.
+			 *
+			 * @return false if `entry` is out of the palette, in which case
+			 * the leds are not modified
+			 */
+			bool fillIndex(uint32_t index, uint32_t count, uint8_t entry);
+
+			/**
+			 * Returns the palette entry of the led at position `index`.
+			 */
+			uint8_t getIndex(uint32_t index) const {return _buffer[index];}
+
+			/**
+			 * Sets all the pixels to the palette entry 0.
+			 */
+			void clear() override;
+
+			uint16_t paletteSize() const {return palette_size;}
+
+			/**
+			 * Returns the RGB color of a palette entry.
+			 */
+			const rgb_pixel& paletteColor(uint8_t entry) const {return palette_colors[entry];}
+
+			/**
+			 * Sets the color of a palette entry.
+			 *
+			 * All the pixels using this entry will be displayed with the new
+			 * color at the next call to show().
+			 *
+			 * @param entry palette entry, lower than paletteSize() (other
+			 * entries are ignored)
+			 * @param color RGB color
+			 */
+			virtual void setPaletteColor(uint8_t entry, const rgb_pixel& color) = 0;
+
+			/**
+			 * Returns the palette entry with the closest RGB color.
+			 */
+			uint8_t closestEntry(const rgb_pixel& color) const;
+
+			virtual ~IndexedStrip();
+
+		protected:
+			/*
+			 * Sets the serialized value of an entry, and its RGB color.
+			 */
+			void setPaletteEntry(uint8_t entry, const uint8_t* serialized, const rgb_pixel& color);
+
+			/*
+			 * Expands at most `size` indexes of `data`, producing at most
+			 * `wanted_num` items. Pixels are expanded byte by byte : an index
+			 * is only counted as translated once all its bytes are encoded.
+			 */
+			static void encodeIndexes(IndexedStrip& strip, const uint8_t* data, size_t size,
+					rmt_item32_t* dest, size_t wanted_num, size_t* translated_size, size_t* item_num);
+
+			/*
+			 * Next byte of the palette entry to encode, in
+			 * TransmitMode::STREAMING.
+			 */
+			uint8_t stream_component;
+
+		private:
+			uint16_t palette_size;
+			uint8_t entry_size;
+			/*
+			 * Serialized colors of the palette, entry_size bytes by entry.
+			 */
+			uint8_t* palette;
+			rgb_pixel* palette_colors;
+			/*
+			 * Pre-encoded palette entries, 8 * entry_size items by entry.
+			 * Only used with 16 colors palettes.
+			 */
+			rmt_item32_t* encoded_palette;
+			/*
+			 * RMT items of each half byte value, MSB first.
+			 */
+			rmt_item32_t nibble_items[16][4];
+
+			HsbToRgbConverter hsb_to_rgb;
+
+			/*
+			 * RMT translator used in TransmitMode::STREAMING, which context
+			 * is the strip.
+			 */
+			static void translate(const void* src, rmt_item32_t* dest, size_t src_size,
+					size_t wanted_num, size_t* translated_size, size_t* item_num);
+	};
+
+	/**
+	 * Indexed color RGB strip.
+	 *
+	 * Example usage :
+	 * ```
+	 * RgbStripConfig config = WS2812();
+	 * config.transmit_mode = TransmitMode::STREAMING;
+	 * IndexedRgbStrip strip {GPIO_NUM_12, 5000, RMT_CHANNEL_0, PaletteSize::PALETTE_16, config};
+	 * strip.setPaletteColor(1, {255, 0, 0});
+	 * strip.fillIndex(0, 2500, 1);
+	 * strip.show();
+	 * ```
+	 */
+	class IndexedRgbStrip : public IndexedStrip {
+		public:
+			IndexedRgbStrip(gpio_num_t gpio_num, uint32_t pixel_count, rmt_channel_t channel,
+					PaletteSize palette_size, RgbStripConfig config);
+			IndexedRgbStrip(gpio_num_t gpio_num, uint32_t pixel_count, PaletteSize palette_size, RgbStripConfig config);
+
+			void setPaletteColor(uint8_t entry, const rgb_pixel& color) override;
+
+			const RgbStripConfig& rgbStripConfig() const {return rgb_strip_config;}
+
+		private:
+			RgbStripConfig rgb_strip_config;
+	};
+
+	/**
+	 * Indexed color RGBW strip.
+	 *
+	 * RGB palette colors are converted to RGBW as with RgbwStrip::setRgbPixel().
+	 */
+	class IndexedRgbwStrip : public IndexedStrip {
+		public:
+			IndexedRgbwStrip(gpio_num_t gpio_num, uint32_t pixel_count, rmt_channel_t channel,
+					PaletteSize palette_size, RgbwStripConfig config);
+			IndexedRgbwStrip(gpio_num_t gpio_num, uint32_t pixel_count, PaletteSize palette_size, RgbwStripConfig config);
+
+			void setPaletteColor(uint8_t entry, const rgb_pixel& color) override;
+
+			/**
+			 * Sets the RGBW color of a palette entry, to manually control the
+			 * white LED.
+			 */
+			void setPaletteColor(uint8_t entry, const rgbw_pixel& color);
+
+			const RgbwStripConfig& rgbwStripConfig() const {return rgbw_strip_config;}
+
+		private:
+			RgbwStripConfig rgbw_strip_config;
+			RGB_TO_RGBW_CONVERTER rgb_to_rgbw;
+	};
+}
+#endif
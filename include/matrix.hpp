@@ -0,0 +1,242 @@
+#ifndef PIXLED_DRIVER_MATRIX_H
+#define PIXLED_DRIVER_MATRIX_H
+
+#include <cstdint>
+
+#include "pixel.hpp"
+#include "strip.hpp"
+
+namespace pixled {
+	/**
+	 * Defines how consecutive rows of leds are chained.
+	 */
+	enum class MatrixWiring {
+		/**
+		 * All the rows are wired in the same direction.
+		 */
+		PROGRESSIVE,
+		/**
+		 * Rows are wired alternatively from left to right and from right to
+		 * left.
+		 */
+		SERPENTINE
+	};
+
+	/**
+	 * Clockwise rotation of each physical panel.
+	 *
+	 * An unrotated panel starts on its top left corner, and its first row goes
+	 * from left to right.
+	 */
+	enum class MatrixRotation {
+		ROTATION_0,
+		ROTATION_90,
+		ROTATION_180,
+		ROTATION_270
+	};
+
+	/**
+	 * Describes the physical wiring of a led matrix.
+	 *
+	 * A matrix is made of `tiles_x * tiles_y` identical panels of
+	 * `panel_width * panel_height` leds, chained on the same strip. Each
+	 * panel is itself wired according to `wiring` and `rotation`, and panels
+	 * are chained row by row according to `tile_wiring`.
+	 *
+	 * Width and height are given as seen by the user, *after* rotation.
+	 */
+	struct MatrixLayout {
+		/**
+		 * Single panel matrix constructor.
+		 *
+		 * @param width matrix width
+		 * @param height matrix height
+		 * @param wiring row wiring
+		 * @param rotation clockwise panel rotation
+		 */
+		MatrixLayout(
+				uint16_t width, uint16_t height,
+				MatrixWiring wiring = MatrixWiring::SERPENTINE,
+				MatrixRotation rotation = MatrixRotation::ROTATION_0)
+			: MatrixLayout(width, height, 1, 1, wiring, rotation, MatrixWiring::PROGRESSIVE) {}
+
+		/**
+		 * Tiled matrix constructor.
+		 *
+		 * @param panel_width width of each panel
+		 * @param panel_height height of each panel
+		 * @param tiles_x count of panels on each row of panels
+		 * @param tiles_y count of rows of panels
+		 * @param wiring row wiring within each panel
+		 * @param rotation clockwise rotation of each panel
+		 * @param tile_wiring wiring of the rows of panels
+		 */
+		MatrixLayout(
+				uint16_t panel_width, uint16_t panel_height,
+				uint16_t tiles_x, uint16_t tiles_y,
+				MatrixWiring wiring, MatrixRotation rotation, MatrixWiring tile_wiring)
+			: panel_width(panel_width), panel_height(panel_height),
+			tiles_x(tiles_x), tiles_y(tiles_y),
+			wiring(wiring), rotation(rotation), tile_wiring(tile_wiring) {}
+
+		uint16_t panel_width;
+		uint16_t panel_height;
+		uint16_t tiles_x;
+		uint16_t tiles_y;
+		MatrixWiring wiring;
+		MatrixRotation rotation;
+		MatrixWiring tile_wiring;
+
+		uint16_t width() const {return panel_width * tiles_x;}
+		uint16_t height() const {return panel_height * tiles_y;}
+
+		/**
+		 * Computes the position on the strip of the led at (x, y).
+		 *
+		 * This is the slow path used to build the Matrix lookup tables.
+		 *
+		 * @param x column, in [0, width())
+		 * @param y row, in [0, height())
+		 * @return index of the led, relative to the first led of the matrix
+		 */
+		uint16_t index(uint16_t x, uint16_t y) const;
+	};
+
+	/**
+	 * A 2D view over a Strip.
+	 *
+	 * The XY to strip index mapping is computed once at construction, and the
+	 * matrix is split into *runs*: horizontal segments of each row that are
+	 * wired on consecutive leds. All the rectangle based operations are then
+	 * performed as bulk Strip writes on each run, instead of a setRgbPixel()
+	 * call for each pixel.
+	 *
+	 * The Matrix does not own the Strip, that must outlive it.
+	 *
+	 * Example usage, for two 8x8 serpentine panels side by side :
+	 * ```
+	 * RgbStrip strip {GPIO_NUM_12, 128, RMT_CHANNEL_0, WS2812()};
+	 * Matrix matrix {strip, {8, 8, 2, 1,
+	 *     MatrixWiring::SERPENTINE, MatrixRotation::ROTATION_0,
+	 *     MatrixWiring::PROGRESSIVE}};
+	 *
+	 * matrix.fillRect(2, 2, 10, 4, {255, 0, 0});
+	 * strip.show();
+	 * ```
+	 */
+	class Matrix {
+		public:
+			/**
+			 * A segment of a row wired on consecutive leds.
+			 */
+			struct run {
+				/**
+				 * Column of the first pixel of the run.
+				 */
+				uint16_t x;
+				/**
+				 * Count of pixels in the run.
+				 */
+				uint16_t length;
+				/**
+				 * Strip index of the pixel at column `x`.
+				 */
+				uint16_t index;
+				/**
+				 * True if strip indexes decrease as x increases.
+				 */
+				bool reversed;
+			};
+
+		private:
+			Strip& strip;
+			MatrixLayout _layout;
+			uint16_t _width;
+			uint16_t _height;
+			uint16_t* xy_lookup;
+			run* runs;
+			uint16_t* row_runs;
+
+			void copyRowSegment(uint16_t to_y, uint16_t to_x, uint16_t from_y, uint16_t from_x, uint16_t length);
+			void fillRowSegment(uint16_t y, uint16_t x, uint16_t length, const rgb_pixel& color);
+
+		public:
+			/**
+			 * Matrix constructor.
+			 *
+			 * @param strip strip on which the matrix is wired
+			 * @param layout physical wiring of the matrix
+			 * @param offset index of the first led of the matrix on the strip
+			 */
+			Matrix(Strip& strip, MatrixLayout layout, uint16_t offset = 0);
+
+			Matrix(const Matrix&) = delete;
+			Matrix(Matrix&&) = delete;
+			Matrix& operator=(const Matrix&) = delete;
+			Matrix& operator=(Matrix&&) = delete;
+
+			uint16_t width() const {return _width;}
+			uint16_t height() const {return _height;}
+			const MatrixLayout& layout() const {return _layout;}
+
+			/**
+			 * Returns the strip index of the led at (x, y).
+			 */
+			uint16_t index(uint16_t x, uint16_t y) const {return xy_lookup[y * _width + x];}
+
+			/**
+			 * Returns the runs of the row `y`, sorted by column.
+			 *
+			 * @param y row
+			 * @param count set to the number of runs in the row
+			 * @return first run of the row
+			 */
+			const run* rowRuns(uint16_t y, uint16_t& count) const;
+
+			void setRgbPixel(uint16_t x, uint16_t y, uint8_t red, uint8_t green, uint8_t blue);
+
+			/**
+			 * Sets all the pixels of the specified rectangle to `color`.
+			 *
+			 * The rectangle is clipped to the matrix bounds.
+			 */
+			void fillRect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const rgb_pixel& color);
+
+			/**
+			 * Sets all the pixels of the matrix to `color`.
+			 */
+			void fill(const rgb_pixel& color) {fillRect(0, 0, _width, _height, color);}
+
+			/**
+			 * Copies an RGB image into the matrix, with its top left corner at
+			 * (x, y).
+			 *
+			 * The image is stored row by row, and clipped to the matrix bounds.
+			 *
+			 * @param x destination column
+			 * @param y destination row
+			 * @param image image pixels, of size width * height
+			 * @param width image width
+			 * @param height image height
+			 */
+			void blit(uint16_t x, uint16_t y, const rgb_pixel* image, uint16_t width, uint16_t height);
+
+			/**
+			 * Scrolls the content of the matrix.
+			 *
+			 * The pixel at (x, y) is moved to (x + dx, y + dy), and the area
+			 * uncovered by the scroll is set to `fill`.
+			 *
+			 * Pixels are moved as raw data in the strip buffer, so no color
+			 * conversion happens.
+			 *
+			 * @param dx horizontal offset, positive to scroll to the right
+			 * @param dy vertical offset, positive to scroll down
+			 * @param fill color of the uncovered area
+			 */
+			void scroll(int16_t dx, int16_t dy, const rgb_pixel& fill);
+
+			~Matrix();
+	};
+}
+#endif
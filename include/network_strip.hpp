@@ -0,0 +1,108 @@
+#ifndef PIXLED_DRIVER_NETWORK_STRIP_H
+#define PIXLED_DRIVER_NETWORK_STRIP_H
+
+#include <cstdint>
+
+#include "strip.hpp"
+
+namespace pixled {
+	/**
+	 * RGB strip sent to a remote controller, over UDP.
+	 *
+	 * Pixels are set as with any RgbStrip, and show() splits the buffer into
+	 * E1.31, Art-Net or DDP packets. Each packet is sent with a single
+	 * sendmsg() call, from a small protocol header and a pointer to the data
+	 * in the strip buffer : pixel data is never copied before it reaches the
+	 * network stack.
+	 *
+	 * The network stack must be initialized (esp_netif_init()) before the
+	 * strip is built. Packets that can't be sent (e.g. while the Wi-Fi is
+	 * disconnected) are dropped and counted by droppedPackets().
+	 *
+	 * Example usage :
+	 * ```
+	 * NetworkStrip strip {600, E131("192.168.1.50", 1)};
+	 * Rainbow rainbow {600};
+	 * while(1) {
+	 *     rainbow.update();
+	 *     rainbow.draw(strip);
+	 *     strip.show(); // universes 1 to 4
+	 *     vTaskDelay(25 / portTICK_PERIOD_MS);
+	 * }
+	 * ```
+	 */
+	class NetworkStrip : public RgbStrip {
+		public:
+			static const uint8_t E131_HEADER_SIZE = 126;
+			static const uint8_t ARTNET_HEADER_SIZE = 18;
+			static const uint8_t DDP_HEADER_SIZE = 10;
+
+		private:
+			NetworkStripConfig network_config;
+			int sock;
+			/*
+			 * Controller address, in network byte order.
+			 */
+			uint32_t destination;
+			/*
+			 * Header of the packet being sent, updated in place for each
+			 * packet. Constant fields are written once by the constructor.
+			 */
+			uint8_t header[E131_HEADER_SIZE];
+			uint8_t sequence;
+			uint32_t dropped_packets;
+			int64_t last_packet;
+
+			void initHeader();
+			uint8_t updateHeader(uint32_t packet, uint32_t offset, uint16_t size, bool last);
+			void pace();
+
+		public:
+			/**
+			 * NetworkStrip constructor.
+			 *
+			 * The UDP socket is opened here.
+			 *
+			 * @param pixel_count Number of leds.
+			 * @param config network config, see E131(), ArtNet() and DDP()
+			 */
+			NetworkStrip(uint32_t pixel_count, NetworkStripConfig config);
+
+			NetworkStrip(const NetworkStrip&) = delete;
+			NetworkStrip(NetworkStrip&&) = delete;
+			NetworkStrip& operator=(const NetworkStrip&) = delete;
+			NetworkStrip& operator=(NetworkStrip&&) = delete;
+
+			/**
+			 * Sends the buffer to the controller, in packetCount() packets.
+			 *
+			 * With E1.31 and Art-Net, packet `i` is sent to the universe
+			 * `universe + i`. With DDP, the last packet of the frame has the
+			 * PUSH flag set.
+			 *
+			 * If a packet interval is configured, this waits between packets,
+			 * so the call lasts at least (packetCount() - 1) intervals.
+			 */
+			void show() override;
+
+			const NetworkStripConfig& networkConfig() const {return network_config;}
+
+			/**
+			 * @return count of packets sent by each show()
+			 */
+			uint32_t packetCount() const;
+
+			/**
+			 * @return count of packets that could not be sent
+			 */
+			uint32_t droppedPackets() const {return dropped_packets;}
+
+			/**
+			 * NetworkStrip destructor.
+			 *
+			 * The socket is closed.
+			 */
+			~NetworkStrip();
+	};
+}
+#endif
@@ -6,6 +6,7 @@
 
 namespace pixled {
 	class RgbSerializer {
+		friend class Rgb16Serializer;
 		private:
 			int R;
 			int G;
@@ -20,12 +21,17 @@ namespace pixled {
 				output[B] = pixel.blue;
 			};
 
+			rgb_pixel deserialize(const uint8_t* input) const {
+				return {input[R], input[G], input[B]};
+			}
+
 			bool operator==(const RgbSerializer& other) const {
 				return (R == other.R) && (G == other.G) && (B == other.B);
 			}
 	};
 
 	class RgbwSerializer {
+		friend class Rgbw16Serializer;
 		private:
 			int R;
 			int G;
@@ -42,9 +48,74 @@ namespace pixled {
 				output[W] = pixel.white;
 			}
 
+			rgbw_pixel deserialize(const uint8_t* input) const {
+				return {input[R], input[G], input[B], input[W]};
+			}
+
 			bool operator==(const RgbwSerializer& other) const {
 				return (R == other.R) && (G == other.G) && (B == other.B) && (W == other.W);
 			}
 	};
+
+	/**
+	 * Serializes 16 bits channels, most significant byte first.
+	 *
+	 * Built from an RgbSerializer defining the color order, so that the
+	 * predefined constants (RGB, GRB, etc...) can be used.
+	 */
+	class Rgb16Serializer {
+		private:
+			int R;
+			int G;
+			int B;
+		public:
+			Rgb16Serializer(const RgbSerializer& order)
+				: R(2*order.R), G(2*order.G), B(2*order.B) {}
+
+			void serialize(const rgb16_pixel& pixel, uint8_t* const& output) const {
+				output[R] = pixel.red >> 8;
+				output[R+1] = pixel.red;
+				output[G] = pixel.green >> 8;
+				output[G+1] = pixel.green;
+				output[B] = pixel.blue >> 8;
+				output[B+1] = pixel.blue;
+			}
+
+			bool operator==(const Rgb16Serializer& other) const {
+				return (R == other.R) && (G == other.G) && (B == other.B);
+			}
+	};
+
+	/**
+	 * Serializes 16 bits channels, most significant byte first.
+	 *
+	 * Built from an RgbwSerializer defining the color order, so that the
+	 * predefined constants (RGBW, GRBW, etc...) can be used.
+	 */
+	class Rgbw16Serializer {
+		private:
+			int R;
+			int G;
+			int B;
+			int W;
+		public:
+			Rgbw16Serializer(const RgbwSerializer& order)
+				: R(2*order.R), G(2*order.G), B(2*order.B), W(2*order.W) {}
+
+			void serialize(const rgbw16_pixel& pixel, uint8_t* const& output) const {
+				output[R] = pixel.red >> 8;
+				output[R+1] = pixel.red;
+				output[G] = pixel.green >> 8;
+				output[G+1] = pixel.green;
+				output[B] = pixel.blue >> 8;
+				output[B+1] = pixel.blue;
+				output[W] = pixel.white >> 8;
+				output[W+1] = pixel.white;
+			}
+
+			bool operator==(const Rgbw16Serializer& other) const {
+				return (R == other.R) && (G == other.G) && (B == other.B) && (W == other.W);
+			}
+	};
 }
 #endif
@@ -0,0 +1,187 @@
+#ifndef PIXLED_DRIVER_PARALLEL_OUTPUT_H
+#define PIXLED_DRIVER_PARALLEL_OUTPUT_H
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_lcd_panel_io.h"
+
+#include "strip.hpp"
+#include "transpose.hpp"
+
+namespace pixled {
+	class ParallelOutput;
+
+	/**
+	 * RGB strip driven by a ParallelOutput.
+	 *
+	 * Pixels are set as with any RgbStrip, but show() transmits all the
+	 * strips of the output.
+	 */
+	class ParallelRgbStrip : public RgbStrip {
+		public:
+			ParallelRgbStrip(ParallelOutput& output, uint32_t pixel_count, RgbStripConfig config);
+
+			void show() override;
+
+		private:
+			ParallelOutput& output;
+	};
+
+	/**
+	 * RGBW strip driven by a ParallelOutput.
+	 *
+	 * Pixels are set as with any RgbwStrip, but show() transmits all the
+	 * strips of the output.
+	 */
+	class ParallelRgbwStrip : public RgbwStrip {
+		public:
+			ParallelRgbwStrip(ParallelOutput& output, uint32_t pixel_count, RgbwStripConfig config);
+
+			void show() override;
+
+		private:
+			ParallelOutput& output;
+	};
+
+	/**
+	 * Drives up to 16 strips of the same type and length with a single
+	 * parallel peripheral (I2S in LCD mode on the ESP32, LCD_CAM on the
+	 * ESP32-S3), through the esp_lcd i80 bus driver.
+	 *
+	 * Each bit is sent as 3 slots on the data lines : all the active lines
+	 * high, then the data bits, then all the lines low. The bit period is
+	 * t0h + t0l of the strip config, so t0h and t1h are approximated as 1/3
+	 * and 2/3 of the period.
+	 *
+	 * Outputs of up to 8 strips use an 8 bits bus, and 8 bits slots. Larger
+	 * outputs use a 16 bits bus, which unused data lines are routed to the
+	 * `dc_gpio`, not connected to the strips.
+	 *
+	 * If the peripheral or the DMA buffer can't be allocated, the error is
+	 * logged and show() does nothing : see ready().
+	 *
+	 * show() transposes the buffers of all the strips into the DMA buffer
+	 * (see transpose::bits8() and transpose::bits16()), starts the transmission and returns. The
+	 * next call to show() waits for the end of the previous transmission,
+	 * so strips can be updated while the DMA is running.
+	 *
+	 * Example usage :
+	 * ```
+	 * gpio_num_t pins[4] {GPIO_NUM_12, GPIO_NUM_13, GPIO_NUM_14, GPIO_NUM_15};
+	 * ParallelOutput output {pins, 4, 300, GPIO_NUM_25, GPIO_NUM_26, WS2812()};
+	 * output.strip(0).fillRgb(0, 300, {255, 0, 0});
+	 * output.strip(3).fillRgb(0, 300, {0, 0, 255});
+	 * output.show();
+	 * ```
+	 */
+	class ParallelOutput {
+		public:
+			/**
+			 * Maximum number of strips driven by an output.
+			 */
+			static const uint8_t MAX_STRIPS = 16;
+			/**
+			 * Number of parallel words sent for each bit.
+			 */
+			static const uint8_t SLOTS_PER_BIT = 3;
+			/**
+			 * Duration of the low level sent after the data to latch it, in
+			 * nS.
+			 */
+			static const uint32_t RESET_NS = 300000;
+
+			/**
+			 * @param gpios data GPIO of each strip
+			 * @param strip_count number of strips, at most MAX_STRIPS
+			 * @param pixel_count number of leds of each strip
+			 * @param clock_gpio GPIO used as the peripheral write clock, not
+			 * connected to the strips
+			 * @param dc_gpio GPIO used as the peripheral data/command
+			 * signal, not connected to the strips
+			 * @param config RGB strip config. Strip buffers are transposed as
+			 * is, so config.buffer_order must be BufferOrder::CHIP.
+			 */
+			ParallelOutput(const gpio_num_t* gpios, uint8_t strip_count, uint32_t pixel_count,
+					gpio_num_t clock_gpio, gpio_num_t dc_gpio, RgbStripConfig config);
+			/**
+			 * @param gpios data GPIO of each strip
+			 * @param strip_count number of strips, at most MAX_STRIPS
+			 * @param pixel_count number of leds of each strip
+			 * @param clock_gpio GPIO used as the peripheral write clock, not
+			 * connected to the strips
+			 * @param dc_gpio GPIO used as the peripheral data/command
+			 * signal, not connected to the strips
+			 * @param config RGBW strip config. Strip buffers are transposed as
+			 * is, so config.buffer_order must be BufferOrder::CHIP.
+			 */
+			ParallelOutput(const gpio_num_t* gpios, uint8_t strip_count, uint32_t pixel_count,
+					gpio_num_t clock_gpio, gpio_num_t dc_gpio, RgbwStripConfig config);
+
+			ParallelOutput(const ParallelOutput&) = delete;
+			ParallelOutput(ParallelOutput&&) = delete;
+			ParallelOutput& operator=(const ParallelOutput&) = delete;
+			ParallelOutput& operator=(ParallelOutput&&) = delete;
+
+			uint8_t stripCount() const {return strip_count;}
+
+			/**
+			 * @return width of the bus in bits : 8 for up to 8 strips, 16
+			 * otherwise
+			 */
+			uint8_t busWidth() const {return bus_width;}
+
+			/**
+			 * @return true if the peripheral was successfully initialized
+			 */
+			bool ready() const {return io != nullptr;}
+
+			/**
+			 * Returns the strip driven by the data line `index`.
+			 */
+			Strip& strip(uint8_t index) {return *strips[index];}
+
+			/**
+			 * Transmits all the strips at once.
+			 *
+			 * Does nothing if the output is not ready().
+			 */
+			void show();
+
+			/**
+			 * Returns the DMA buffer sent by show(), for an 8 bits bus.
+			 */
+			const uint8_t* buffer8() const {return bus_width == 8 ? dma_buffer : nullptr;}
+
+			/**
+			 * Returns the DMA buffer sent by show(), for a 16 bits bus.
+			 */
+			const uint16_t* buffer16() const {
+				return bus_width == 16 ? reinterpret_cast<const uint16_t*>(dma_buffer) : nullptr;
+			}
+
+			/**
+			 * Returns the size of the DMA buffer, in words of busWidth()
+			 * bits.
+			 */
+			uint32_t bufferSize() const {return buffer_size;}
+
+			~ParallelOutput();
+
+		private:
+			uint8_t strip_count;
+			uint8_t bus_width;
+			uint32_t strip_size;
+			Strip* strips[MAX_STRIPS];
+			const uint8_t* inputs[MAX_STRIPS];
+
+			uint8_t* dma_buffer;
+			uint32_t buffer_size;
+
+			esp_lcd_i80_bus_handle_t bus;
+			esp_lcd_panel_io_handle_t io;
+			SemaphoreHandle_t transmitted;
+
+			void init(const gpio_num_t* gpios, gpio_num_t clock_gpio, gpio_num_t dc_gpio, const StripConfig& config);
+	};
+}
+#endif
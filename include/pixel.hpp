@@ -2,14 +2,34 @@
 #define PIXLED_DRIVER_PIXEL_H
 
 #include <cstdint>
+#include <type_traits>
 
 namespace pixled {
+	/*
+	 * Pixel types are trivial and standard-layout, so that buffers of pixels
+	 * can be copied and cleared with memcpy() / memset(), and
+	 * constexpr-constructible, so that color tables can be built at compile
+	 * time (see tables.hpp).
+	 *
+	 * As for any trivial type, the default constructor leaves the components
+	 * uninitialized : `rgb_pixel()` or `rgb_pixel {}` must be used to get a
+	 * black pixel.
+	 */
+
 	/**
 	 * @brief A data type representing an RGB pixel.
 	 */
 	struct rgb_pixel {
-		rgb_pixel();
-		rgb_pixel(uint8_t red, uint8_t green, uint8_t blue);
+		rgb_pixel() = default;
+		/**
+		 * @brief rgb_pixel constructor.
+		 *
+		 * @param red	between 0 and 255
+		 * @param green	between 0 and 255
+		 * @param blue	between 0 and 255
+		 */
+		constexpr rgb_pixel(uint8_t red, uint8_t green, uint8_t blue)
+			: red(red), green(green), blue(blue) {}
 		/**
 		 * @brief The red component of the pixel.
 		 */
@@ -27,21 +47,111 @@ namespace pixled {
 	/**
 	 * @brief A data type representing an RGBW pixel.
 	 */
-	struct rgbw_pixel : rgb_pixel {
-		rgbw_pixel();
-		rgbw_pixel(uint8_t red, uint8_t green, uint8_t blue, uint8_t white);
+	struct rgbw_pixel {
+		rgbw_pixel() = default;
+		/**
+		 * @brief rgbw_pixel constructor.
+		 *
+		 * @param red between 0 and 255
+		 * @param green between 0 and 255
+		 * @param blue between 0 and 255
+		 * @param white between 0 and 255
+		 */
+		constexpr rgbw_pixel(uint8_t red, uint8_t green, uint8_t blue, uint8_t white)
+			: red(red), green(green), blue(blue), white(white) {}
+		/**
+		 * @brief The red component of the pixel.
+		 */
+		uint8_t red;
+		/**
+		 * @brief The green component of the pixel.
+		 */
+		uint8_t green;
+		/**
+		 * @brief The blue component of the pixel.
+		 */
+		uint8_t blue;
 		/**
 		 * @brief The white component of the pixel.
 		 */
 		uint8_t white;
 	};
 
+	/**
+	 * @brief A data type representing an RGB pixel, with 16 bits channels.
+	 */
+	struct rgb16_pixel {
+		rgb16_pixel() = default;
+		/**
+		 * @brief rgb16_pixel constructor.
+		 *
+		 * @param red	between 0 and 65535
+		 * @param green	between 0 and 65535
+		 * @param blue	between 0 and 65535
+		 */
+		constexpr rgb16_pixel(uint16_t red, uint16_t green, uint16_t blue)
+			: red(red), green(green), blue(blue) {}
+		/**
+		 * @brief The red component of the pixel.
+		 */
+		uint16_t red;
+		/**
+		 * @brief The green component of the pixel.
+		 */
+		uint16_t green;
+		/**
+		 * @brief The blue component of the pixel.
+		 */
+		uint16_t blue;
+	};
+
+	/**
+	 * @brief A data type representing an RGBW pixel, with 16 bits channels.
+	 */
+	struct rgbw16_pixel {
+		rgbw16_pixel() = default;
+		/**
+		 * @brief rgbw16_pixel constructor.
+		 *
+		 * @param red between 0 and 65535
+		 * @param green between 0 and 65535
+		 * @param blue between 0 and 65535
+		 * @param white between 0 and 65535
+		 */
+		constexpr rgbw16_pixel(uint16_t red, uint16_t green, uint16_t blue, uint16_t white)
+			: red(red), green(green), blue(blue), white(white) {}
+		/**
+		 * @brief The red component of the pixel.
+		 */
+		uint16_t red;
+		/**
+		 * @brief The green component of the pixel.
+		 */
+		uint16_t green;
+		/**
+		 * @brief The blue component of the pixel.
+		 */
+		uint16_t blue;
+		/**
+		 * @brief The white component of the pixel.
+		 */
+		uint16_t white;
+	};
+
 	/**
 	 * @brief A data type representing an HSB pixel.
 	 */
 	struct hsb_pixel {
-		hsb_pixel();
-		hsb_pixel(float hue, float saturation, float brightness);
+		hsb_pixel() = default;
+		/**
+		 * @brief hsb_pixel constructor
+		 *
+		 * @param hue between 0 and 360
+		 * @param saturation between 0 and 1
+		 * @param brightness between 0 and 1
+		 */
+		constexpr hsb_pixel(float hue, float saturation, float brightness)
+			: hue(hue), saturation(saturation), brightness(brightness) {}
 		/**
 		 * @brief Color hue, in [0;360]
 		 */
@@ -57,5 +167,92 @@ namespace pixled {
 		 */
 		float brightness;
 	};
+
+	/**
+	 * @brief A data type representing a color in the OKLab perceptual color
+	 * space, in fixed-point.
+	 *
+	 * Components are scaled by 32768 : a lightness of 32768 is white, and a
+	 * and b are in about [-0.32;0.28] for sRGB colors.
+	 */
+	struct oklab_pixel {
+		oklab_pixel() = default;
+		/**
+		 * @brief oklab_pixel constructor.
+		 *
+		 * @param lightness between 0 and 32768
+		 * @param a green-red axis, scaled by 32768
+		 * @param b blue-yellow axis, scaled by 32768
+		 */
+		constexpr oklab_pixel(uint16_t lightness, int16_t a, int16_t b)
+			: lightness(lightness), a(a), b(b) {}
+		/**
+		 * @brief Perceived lightness, in [0;32768]
+		 */
+		uint16_t lightness;
+		/**
+		 * @brief Green (negative) to red (positive) component
+		 */
+		int16_t a;
+		/**
+		 * @brief Blue (negative) to yellow (positive) component
+		 */
+		int16_t b;
+	};
+
+	/**
+	 * @brief A data type representing a color in the OKLCH perceptual color
+	 * space (the polar form of OKLab), in fixed-point.
+	 *
+	 * Hues are evenly spaced in perception, so that gradients of hue or
+	 * lightness look uniform, unlike with HSB.
+	 */
+	struct oklch_pixel {
+		oklch_pixel() = default;
+		/**
+		 * @brief oklch_pixel constructor.
+		 *
+		 * @param lightness between 0 and 32768
+		 * @param chroma scaled by 32768, at most about 10500 for sRGB
+		 * colors
+		 * @param hue between 0 and 65535, for a full turn
+		 */
+		constexpr oklch_pixel(uint16_t lightness, uint16_t chroma, uint16_t hue)
+			: lightness(lightness), chroma(chroma), hue(hue) {}
+		/**
+		 * @brief Perceived lightness, in [0;32768]
+		 */
+		uint16_t lightness;
+		/**
+		 * @brief Colorfulness, scaled by 32768
+		 */
+		uint16_t chroma;
+		/**
+		 * @brief Hue angle, 65536 for a full turn (0 is pink-red)
+		 */
+		uint16_t hue;
+	};
+
+	static_assert(std::is_trivial<rgb_pixel>::value && std::is_standard_layout<rgb_pixel>::value,
+			"rgb_pixel must be trivial and standard-layout");
+	static_assert(std::is_trivial<rgbw_pixel>::value && std::is_standard_layout<rgbw_pixel>::value,
+			"rgbw_pixel must be trivial and standard-layout");
+	static_assert(std::is_trivial<rgb16_pixel>::value && std::is_standard_layout<rgb16_pixel>::value,
+			"rgb16_pixel must be trivial and standard-layout");
+	static_assert(std::is_trivial<rgbw16_pixel>::value && std::is_standard_layout<rgbw16_pixel>::value,
+			"rgbw16_pixel must be trivial and standard-layout");
+	static_assert(std::is_trivial<hsb_pixel>::value && std::is_standard_layout<hsb_pixel>::value,
+			"hsb_pixel must be trivial and standard-layout");
+	static_assert(std::is_trivial<oklab_pixel>::value && std::is_standard_layout<oklab_pixel>::value,
+			"oklab_pixel must be trivial and standard-layout");
+	static_assert(std::is_trivial<oklch_pixel>::value && std::is_standard_layout<oklch_pixel>::value,
+			"oklch_pixel must be trivial and standard-layout");
+
+	static_assert(sizeof(rgb_pixel) == 3, "rgb_pixel must be 3 bytes long");
+	static_assert(sizeof(rgbw_pixel) == 4, "rgbw_pixel must be 4 bytes long");
+	static_assert(sizeof(rgb16_pixel) == 6, "rgb16_pixel must be 6 bytes long");
+	static_assert(sizeof(rgbw16_pixel) == 8, "rgbw16_pixel must be 8 bytes long");
+	static_assert(sizeof(oklab_pixel) == 6, "oklab_pixel must be 6 bytes long");
+	static_assert(sizeof(oklch_pixel) == 6, "oklch_pixel must be 6 bytes long");
 }
 #endif
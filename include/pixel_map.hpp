@@ -0,0 +1,287 @@
+#ifndef PIXLED_DRIVER_PIXEL_MAP_H
+#define PIXLED_DRIVER_PIXEL_MAP_H
+
+#include <cassert>
+#include <cstdint>
+
+#include "pixel.hpp"
+#include "strip.hpp"
+
+namespace pixled {
+	/**
+	 * A quantized 3D position, in map units.
+	 *
+	 * The unit is chosen by the user (e.g. millimeters), so that all the
+	 * positions of the installation fit in 16 bits signed integers.
+	 */
+	struct map_point {
+		int16_t x;
+		int16_t y;
+		int16_t z;
+	};
+
+	/**
+	 * Spatial map of the leds of a Strip, or of a segment of a Strip.
+	 *
+	 * Positions are stored as quantized 16 bits coordinates, in three separate
+	 * arrays (x, y and z), in strip order. Effects defined in space (planes,
+	 * spheres, waves...) are evaluated with evaluate(), that calls a
+	 * fixed-point field function for each led, in blocks written to the strip
+	 * with bulk setRgbPixels() calls.
+	 *
+	 * Once all the positions are set, buildIndex() sorts the leds into a
+	 * uniform grid of cubic cells, so that range queries (forEachInBox(),
+	 * forEachInSphere()) only visit the leds of the cells that intersect the
+	 * range.
+	 *
+	 * The PixelMap does not own the Strip, that must outlive it.
+	 *
+	 * Example usage :
+	 * ```
+	 * PixelMap map {strip, 600};
+	 * for(uint32_t i = 0; i < 600; i++)
+	 *     map.setPosition(i, PixelMap::quantize(x_mm[i], 1), ...);
+	 * map.buildIndex();
+	 *
+	 * // A horizontal plane moving up
+	 * int16_t height = 0;
+	 * while(1) {
+	 *     map.evaluate([height] (int16_t x, int16_t y, int16_t z) {
+	 *         int32_t d = z - height;
+	 *         uint8_t v = d < 0 ? 0 : d > 255 ? 0 : 255 - d;
+	 *         return rgb_pixel(v, v, v);
+	 *     });
+	 *     strip.show();
+	 *     height++;
+	 * }
+	 * ```
+	 */
+	class PixelMap {
+		public:
+			/**
+			 * Count of pixels evaluated in each block by evaluate().
+			 */
+			static const uint16_t BLOCK_SIZE = 32;
+
+			/**
+			 * Maximum count of cells of the grid index.
+			 */
+			static const uint32_t MAX_CELLS = 65536;
+
+		private:
+			Strip& strip;
+			uint32_t offset;
+			uint32_t count;
+			uint8_t cell_shift;
+
+			int16_t* xs;
+			int16_t* ys;
+			int16_t* zs;
+
+			map_point bounds_min;
+			map_point bounds_max;
+			uint32_t cells_x;
+			uint32_t cells_y;
+			uint32_t cells_z;
+			/*
+			 * Index in cell_pixels of the first pixel of each cell, with a
+			 * last entry equal to count. Null until buildIndex() is called.
+			 */
+			uint32_t* cell_start;
+			/*
+			 * Pixel indexes, sorted by cell.
+			 */
+			uint32_t* cell_pixels;
+
+			uint16_t cellX(int16_t x) const {return (uint16_t) (x - bounds_min.x) >> cell_shift;}
+			uint16_t cellY(int16_t y) const {return (uint16_t) (y - bounds_min.y) >> cell_shift;}
+			uint16_t cellZ(int16_t z) const {return (uint16_t) (z - bounds_min.z) >> cell_shift;}
+			uint32_t cell(uint16_t x, uint16_t y, uint16_t z) const {
+				return (z * cells_y + y) * cells_x + x;
+			}
+
+			bool clip(map_point& min, map_point& max) const;
+
+		public:
+			/**
+			 * PixelMap constructor.
+			 *
+			 * All the positions are initialized to (0, 0, 0).
+			 *
+			 * @param strip strip on which the leds are wired
+			 * @param count count of leds of the map
+			 * @param offset index of the first led of the map on the strip
+			 * @param cell_shift the cells of the grid index are
+			 * `2^cell_shift` map units wide
+			 */
+			PixelMap(Strip& strip, uint32_t count, uint32_t offset = 0, uint8_t cell_shift = 4);
+
+			PixelMap(const PixelMap&) = delete;
+			PixelMap(PixelMap&&) = delete;
+			PixelMap& operator=(const PixelMap&) = delete;
+			PixelMap& operator=(PixelMap&&) = delete;
+
+			/**
+			 * Quantizes a coordinate to map units, saturated to the int16_t
+			 * range.
+			 *
+			 * @param value coordinate, in any unit
+			 * @param unit size of a map unit, in the same unit
+			 */
+			static int16_t quantize(float value, float unit) {
+				const float q = value / unit;
+				return q >= 32767.f ? 32767 : q <= -32768.f ? -32768 :
+					(int16_t) (q < 0 ? q - 0.5f : q + 0.5f);
+			}
+
+			uint32_t length() const {return count;}
+
+			/**
+			 * Sets the position of the led at `index`, relative to the first
+			 * led of the map.
+			 *
+			 * buildIndex() must be called again before any range query.
+			 */
+			void setPosition(uint32_t index, int16_t x, int16_t y, int16_t z);
+
+			map_point position(uint32_t index) const {return {xs[index], ys[index], zs[index]};}
+
+			/**
+			 * Coordinates of all the leds, in strip order.
+			 */
+			const int16_t* x() const {return xs;}
+			const int16_t* y() const {return ys;}
+			const int16_t* z() const {return zs;}
+
+			/**
+			 * Sorts the leds into the grid index.
+			 *
+			 * The grid covers the bounding box of the leds, and is
+			 * reallocated at each call : this should only be done once the
+			 * installation is mapped, not at each frame. If the grid would
+			 * exceed MAX_CELLS cells, the cell size is doubled until it fits.
+			 */
+			void buildIndex();
+
+			/**
+			 * Bounding box of the leds, computed by buildIndex().
+			 */
+			map_point boundsMin() const {return bounds_min;}
+			map_point boundsMax() const {return bounds_max;}
+
+			/**
+			 * @return count of cells of the grid index
+			 */
+			uint32_t cellCount() const {return cells_x * cells_y * cells_z;}
+
+			/**
+			 * @return width of the cells of the grid index, in map units
+			 */
+			uint32_t cellSize() const {return 1u << cell_shift;}
+
+			/**
+			 * Calls `visitor(index)` for each led within the box
+			 * [min;max] (bounds included), where `index` is relative to the
+			 * first led of the map.
+			 *
+			 * Leds are visited in cell order, not in strip order.
+			 */
+			template<typename Visitor>
+				void forEachInBox(map_point min, map_point max, Visitor visitor) const {
+					assert(cell_start != nullptr);
+					if(!clip(min, max))
+						return;
+					const uint16_t first_x = cellX(min.x), last_x = cellX(max.x);
+					const uint16_t first_y = cellY(min.y), last_y = cellY(max.y);
+					const uint16_t first_z = cellZ(min.z), last_z = cellZ(max.z);
+					for(uint16_t cz = first_z; cz <= last_z; cz++) {
+						for(uint16_t cy = first_y; cy <= last_y; cy++) {
+							// Cells of a row are contiguous
+							const uint32_t end = cell_start[cell(last_x, cy, cz) + 1];
+							for(uint32_t i = cell_start[cell(first_x, cy, cz)]; i < end; i++) {
+								const uint32_t index = cell_pixels[i];
+								if(xs[index] >= min.x && xs[index] <= max.x
+										&& ys[index] >= min.y && ys[index] <= max.y
+										&& zs[index] >= min.z && zs[index] <= max.z)
+									visitor(index);
+							}
+						}
+					}
+				}
+
+			/**
+			 * Calls `visitor(index, distance2)` for each led within `radius`
+			 * of `center` (bounds included), where `distance2` is the
+			 * squared distance of the led to the center.
+			 *
+			 * @param center center of the sphere
+			 * @param radius radius of the sphere, at most 32767
+			 */
+			template<typename Visitor>
+				void forEachInSphere(map_point center, uint16_t radius, Visitor visitor) const {
+					assert(radius <= 32767);
+					const uint32_t radius2 = (uint32_t) radius * radius;
+					map_point min {
+						(int16_t) (center.x - radius < -32768 ? -32768 : center.x - radius),
+						(int16_t) (center.y - radius < -32768 ? -32768 : center.y - radius),
+						(int16_t) (center.z - radius < -32768 ? -32768 : center.z - radius)};
+					map_point max {
+						(int16_t) (center.x + radius > 32767 ? 32767 : center.x + radius),
+						(int16_t) (center.y + radius > 32767 ? 32767 : center.y + radius),
+						(int16_t) (center.z + radius > 32767 ? 32767 : center.z + radius)};
+					const int16_t* xs = this->xs;
+					const int16_t* ys = this->ys;
+					const int16_t* zs = this->zs;
+					forEachInBox(min, max, [&] (uint32_t index) {
+							const int32_t dx = xs[index] - center.x;
+							const int32_t dy = ys[index] - center.y;
+							const int32_t dz = zs[index] - center.z;
+							const uint32_t distance2 = (uint32_t) (dx*dx) + (uint32_t) (dy*dy) + (uint32_t) (dz*dz);
+							if(distance2 <= radius2)
+								visitor(index, distance2);
+						});
+				}
+
+			/**
+			 * Sets all the leds within `radius` of `center` to `color`.
+			 */
+			void fillSphere(map_point center, uint16_t radius, const rgb_pixel& color);
+
+			/**
+			 * Sets all the leds within the box [min;max] to `color`.
+			 */
+			void fillBox(map_point min, map_point max, const rgb_pixel& color);
+
+			/**
+			 * Evaluates a field function over all the leds of the map, and
+			 * writes the result to the strip.
+			 *
+			 * `field(x, y, z)` is called for each led, in strip order, with
+			 * its quantized coordinates, and must return an rgb_pixel. Since
+			 * `field` is a template parameter, it is inlined in the loop over
+			 * the coordinate arrays. Results are written to the strip in
+			 * blocks of BLOCK_SIZE pixels with setRgbPixels().
+			 *
+			 * The LEDs are not actually updated until a call to strip.show().
+			 *
+			 * @param field fixed-point field function
+			 */
+			template<typename Field>
+				void evaluate(const Field& field) {
+					PIXLED_TRACE_SPAN("evaluate");
+					rgb_pixel block[BLOCK_SIZE];
+					for(uint32_t index = 0; index < count; index += BLOCK_SIZE) {
+						const uint32_t size = count - index < BLOCK_SIZE ? count - index : BLOCK_SIZE;
+						const int16_t* x = &xs[index];
+						const int16_t* y = &ys[index];
+						const int16_t* z = &zs[index];
+						for(uint32_t i = 0; i < size; i++)
+							block[i] = field(x[i], y[i], z[i]);
+						strip.setRgbPixels(offset + index, block, size);
+					}
+				}
+
+			~PixelMap();
+	};
+}
+#endif
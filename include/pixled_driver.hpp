@@ -7,8 +7,25 @@
 #include "constants.hpp"
 #include "output.hpp"
 #include "pixel.hpp"
+#include "tables.hpp"
+#include "trace.hpp"
 #include "strip_config.hpp"
+#include "frame_cache.hpp"
 #include "strip.hpp"
+#include "boot_frame.hpp"
+#include "indexed_strip.hpp"
+#include "run_strip.hpp"
+#include "strip16.hpp"
+#include "clocked_strip.hpp"
+#include "parallel_output.hpp"
+#include "network_strip.hpp"
+#include "matrix.hpp"
+#include "pixel_map.hpp"
+#include "compositor.hpp"
+#include "effects.hpp"
+#include "transition.hpp"
+#include "shader_strip.hpp"
+#include "coroutine_effects.hpp"
 
 /**
  * @mainpage ESP32 Led Strip Driver (RGB and RGBW)
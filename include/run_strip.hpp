@@ -0,0 +1,298 @@
+#ifndef PIXLED_DRIVER_RUN_STRIP_H
+#define PIXLED_DRIVER_RUN_STRIP_H
+
+#include "strip.hpp"
+
+namespace pixled {
+	/**
+	 * A run of consecutive pixels of the same color.
+	 */
+	struct color_run {
+		/**
+		 * Index of the first pixel of the run. The run ends at the start of
+		 * the next run, or at the end of the strip.
+		 */
+		uint32_t start;
+		/**
+		 * Color of the run, serialized in the chip order.
+		 */
+		uint8_t color[4];
+	};
+
+	/**
+	 * General and abstract run-length encoded strip class.
+	 *
+	 * Instead of a pixel buffer, the strip stores a sorted array of color
+	 * runs, where two consecutive runs always have different colors. Range
+	 * updates (fillRgb()) locate their bounds with a binary search, and
+	 * replace all the runs they cover by at most two runs, so that filling
+	 * whole zones is cheap whatever their length. show() encodes the RMT
+	 * items of a single pixel for each run, and repeats this pattern for all
+	 * the pixels of the run.
+	 *
+	 * With TransmitMode::STREAMING, no item buffer is allocated : the memory
+	 * used by the strip only depends on the maximum count of runs, and not
+	 * on its length. TransmitMode::BUFFERED encodes the whole frame to an
+	 * item buffer of 4 bytes per transmitted bit (96 bytes per RGB led, 128
+	 * per RGBW led), which is far larger than the runs.
+	 *
+	 * The count of runs is limited to the capacity given at construction.
+	 * An update that would exceed it is dropped as a whole : its pixels keep
+	 * their previous colors. Drops are counted by droppedUpdates(), the
+	 * first one is logged, and tryFillRgb() and trySetRgbPixels() return
+	 * false for them.
+	 *
+	 * Since there is no pixel buffer, buffer() is null, copyPixels() and
+	 * reversePixels() must not be used, and the skipping of unchanged
+	 * frames, the changed prefix transmission and the frame cache are not
+	 * available.
+	 */
+	class RunStrip : public Strip {
+		public:
+			RunStrip(
+					gpio_num_t gpio_num, uint32_t pixel_count, rmt_channel_t channel,
+					uint32_t max_runs, uint8_t entry_size, StripConfig config);
+
+			RunStrip(const RunStrip&) = delete;
+			RunStrip(RunStrip&&) = delete;
+			RunStrip& operator=(const RunStrip&) = delete;
+			RunStrip& operator=(RunStrip&&) = delete;
+
+			void show() override;
+
+			void setRgbPixel(uint32_t index, uint8_t red, uint8_t green, uint8_t blue) override;
+			void setHsbPixel(uint32_t index, float hue, float saturation, float brightness) override;
+
+			/**
+			 * Writes `count` consecutive RGB pixels, starting at `index`.
+			 *
+			 * Consecutive pixels of the same color are written as a single
+			 * run, so gradients use one run per pixel. Each run is inserted
+			 * by moving all the runs after it : writing a gradient of n
+			 * pixels before r runs costs O(n·r) moved runs.
+			 *
+			 * If the maximum count of runs is reached, the pixels from the
+			 * first run that does not fit keep their previous colors.
+			 */
+			void setRgbPixels(uint32_t index, const rgb_pixel* pixels, uint32_t count) override;
+			void fillRgb(uint32_t index, uint32_t count, const rgb_pixel& color) override;
+
+			/**
+			 * Same as fillRgb().
+			 *
+			 * @return false if the update was dropped because it would
+			 * exceed maxRuns()
+			 */
+			bool tryFillRgb(uint32_t index, uint32_t count, const rgb_pixel& color);
+
+			/**
+			 * Same as setRgbPixels().
+			 *
+			 * @return false if some pixels were not written because the
+			 * maximum count of runs was reached
+			 */
+			bool trySetRgbPixels(uint32_t index, const rgb_pixel* pixels, uint32_t count);
+
+			/**
+			 * Sets all the pixels to black, as a single run.
+			 */
+			void clear() override;
+
+			/**
+			 * @return current count of runs
+			 */
+			uint32_t runCount() const {return run_count;}
+
+			/**
+			 * @return maximum count of runs
+			 */
+			uint32_t maxRuns() const {return max_runs;}
+
+			/**
+			 * Returns the run at position `index`, in [0;runCount()[.
+			 */
+			const color_run& run(uint32_t index) const {return runs[index];}
+
+			/**
+			 * Returns the position of the run containing the pixel at
+			 * `index`.
+			 */
+			uint32_t findRun(uint32_t index) const;
+
+			/**
+			 * @return count of updates dropped because the maximum count of
+			 * runs was reached
+			 */
+			uint32_t droppedUpdates() const {return dropped_updates;}
+
+			virtual ~RunStrip();
+
+		protected:
+			/*
+			 * Serializes an RGB color in the chip order.
+			 */
+			virtual void serialize(const rgb_pixel& color, uint8_t* output) const = 0;
+
+			/*
+			 * Sets `count` consecutive pixels, starting at `index`, to a
+			 * serialized color.
+			 *
+			 * Returns false if the update was dropped.
+			 */
+			bool fill(uint32_t index, uint32_t count, const uint8_t* color);
+
+			/*
+			 * Data required to encode the runs on the fly.
+			 */
+			struct RunContext {
+				const color_run* runs;
+				uint32_t run_count;
+				uint32_t pixel_count;
+				uint8_t entry_size;
+				rmt_item32_t bit0;
+				rmt_item32_t bit1;
+				/*
+				 * Position of the run being encoded.
+				 */
+				uint32_t run;
+				/*
+				 * Count of pixels of the run that remain to encode, the
+				 * current one included.
+				 */
+				uint32_t remaining;
+				/*
+				 * Next item of the pattern to encode.
+				 */
+				uint8_t position;
+				/*
+				 * Items of a pixel of the current run.
+				 */
+				rmt_item32_t pattern[32];
+			};
+			RunContext run_context;
+
+			/*
+			 * Restarts the encoding from the first run.
+			 */
+			void startStream();
+
+			/*
+			 * Encodes at most `size` bytes of the strip, from the current
+			 * position of the context, producing at most `wanted_num`
+			 * items. Only whole bytes are encoded.
+			 */
+			static void encodeRuns(RunContext& context, size_t size,
+					rmt_item32_t* dest, size_t wanted_num, size_t* translated_size, size_t* item_num);
+
+		private:
+			uint32_t max_runs;
+			uint8_t entry_size;
+			color_run* runs;
+			uint32_t run_count;
+			uint32_t dropped_updates;
+			HsbToRgbConverter hsb_to_rgb;
+
+			/*
+			 * Encodes the serialized `color` as a pixel pattern.
+			 */
+			static void encodePattern(const RunContext& context, const uint8_t* color, rmt_item32_t* pattern);
+
+			/*
+			 * RMT translator used in TransmitMode::STREAMING. The sample
+			 * pointer is never read : the position is kept in the context.
+			 */
+			static void translate(const void* src, rmt_item32_t* dest, size_t src_size,
+					size_t wanted_num, size_t* translated_size, size_t* item_num);
+	};
+
+	/**
+	 * Run-length encoded RGB strip.
+	 *
+	 * Example usage :
+	 * ```
+	 * RgbStripConfig config = WS2812();
+	 * config.transmit_mode = TransmitMode::STREAMING;
+	 * RunRgbStrip strip {GPIO_NUM_12, 5000, RMT_CHANNEL_0, 64, config};
+	 * strip.fillRgb(0, 2000, {255, 80, 0});
+	 * strip.fillRgb(2000, 3000, {0, 0, 80});
+	 * strip.show();
+	 * ```
+	 */
+	class RunRgbStrip : public RunStrip {
+		public:
+			/**
+			 * @param gpio_num Led Strip GPIO.
+			 * @param pixel_count Number of leds.
+			 * @param channel RMT channel to use.
+			 * @param max_runs maximum count of runs
+			 * @param config RGB strip config
+			 */
+			RunRgbStrip(gpio_num_t gpio_num, uint32_t pixel_count, rmt_channel_t channel,
+					uint32_t max_runs, RgbStripConfig config);
+			RunRgbStrip(gpio_num_t gpio_num, uint32_t pixel_count, uint32_t max_runs, RgbStripConfig config);
+
+			/**
+			 * Reads back the color of the led at position `index`.
+			 */
+			rgb_pixel getRgbPixel(uint32_t index) const {
+				return rgb_strip_config.serializer.deserialize(run(findRun(index)).color);
+			}
+
+			const RgbStripConfig& rgbStripConfig() const {return rgb_strip_config;}
+
+		protected:
+			void serialize(const rgb_pixel& color, uint8_t* output) const override {
+				rgb_strip_config.serializer.serialize(color, output);
+			}
+
+		private:
+			RgbStripConfig rgb_strip_config;
+	};
+
+	/**
+	 * Run-length encoded RGBW strip.
+	 *
+	 * RGB colors are converted to RGBW as with RgbwStrip::setRgbPixel().
+	 */
+	class RunRgbwStrip : public RunStrip {
+		public:
+			/**
+			 * @param gpio_num Led Strip GPIO.
+			 * @param pixel_count Number of leds.
+			 * @param channel RMT channel to use.
+			 * @param max_runs maximum count of runs
+			 * @param config RGBW strip config
+			 */
+			RunRgbwStrip(gpio_num_t gpio_num, uint32_t pixel_count, rmt_channel_t channel,
+					uint32_t max_runs, RgbwStripConfig config);
+			RunRgbwStrip(gpio_num_t gpio_num, uint32_t pixel_count, uint32_t max_runs, RgbwStripConfig config);
+
+			/**
+			 * Sets `count` consecutive pixels, starting at `index`, to the
+			 * same RGBW color.
+			 *
+			 * @return false if the update was dropped because it would
+			 * exceed maxRuns()
+			 */
+			bool fillRgbw(uint32_t index, uint32_t count, const rgbw_pixel& color);
+
+			/**
+			 * Reads back the color of the led at position `index`.
+			 */
+			rgbw_pixel getRgbwPixel(uint32_t index) const {
+				return rgbw_strip_config.serializer.deserialize(run(findRun(index)).color);
+			}
+
+			const RgbwStripConfig& rgbwStripConfig() const {return rgbw_strip_config;}
+
+		protected:
+			void serialize(const rgb_pixel& color, uint8_t* output) const override {
+				rgbw_strip_config.serializer.serialize(rgb_to_rgbw(color), output);
+			}
+
+		private:
+			RgbwStripConfig rgbw_strip_config;
+			RGB_TO_RGBW_CONVERTER rgb_to_rgbw;
+	};
+}
+#endif
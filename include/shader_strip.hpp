@@ -0,0 +1,214 @@
+#ifndef PIXLED_DRIVER_SHADER_STRIP_H
+#define PIXLED_DRIVER_SHADER_STRIP_H
+
+#include "strip.hpp"
+#include "effects.hpp"
+
+namespace pixled {
+	/**
+	 * Effect defined by a function of the pixel index and of the frame.
+	 *
+	 * `shader(index, frame)` must return the rgb_pixel of the pixel at
+	 * `index` for the frame `frame`, that is incremented by update(). Since
+	 * `shader` is a template parameter, it is inlined in the render loop.
+	 *
+	 * Example usage, with pixelShader() to deduce the type of a lambda :
+	 * ```
+	 * auto wave = pixelShader(600, [] (uint32_t index, uint32_t frame) {
+	 *     uint8_t v = (index + frame) & 0xFF;
+	 *     return rgb_pixel(v, 0, 255 - v);
+	 * });
+	 * ```
+	 */
+	template<typename Shader>
+		class PixelShader : public Effect {
+			private:
+				Shader shader;
+				uint32_t _frame;
+
+			public:
+				PixelShader(uint32_t length, const Shader& shader)
+					: Effect(length), shader(shader), _frame(0) {}
+
+				/**
+				 * @return count of calls to update()
+				 */
+				uint32_t frame() const {return _frame;}
+
+				void update() override {_frame++;}
+
+				void render(uint32_t index, uint32_t count, rgb_pixel* output) const override {
+					for(uint32_t i = 0; i < count; i++)
+						output[i] = shader(index + i, _frame);
+				}
+		};
+
+	/**
+	 * @return a PixelShader of `length` pixels, running `shader`
+	 */
+	template<typename Shader>
+		PixelShader<Shader> pixelShader(uint32_t length, const Shader& shader) {
+			return PixelShader<Shader>(length, shader);
+		}
+
+	/**
+	 * RGB strip without framebuffer, which content is rendered by an Effect
+	 * while it is encoded.
+	 *
+	 * For strips which content is a function of the pixel index and of the
+	 * time, no pixel buffer is allocated : show() calls
+	 * Effect::render() span by span, and directly encodes the rendered
+	 * pixels to RMT items. In TransmitMode::STREAMING, no item buffer is
+	 * allocated either : spans of SPAN_SIZE pixels are rendered on demand by
+	 * the RMT translator, so that the memory used by the strip does not
+	 * depend on its length.
+	 *
+	 * Since there is no buffer, the set*Pixel() functions, fillRgb(),
+	 * clear(), copyPixels() and reversePixels() must not be used : the
+	 * setters and clear() do nothing, the leds only show the effect, and
+	 * debug builds (without NDEBUG) log a warning the first time one of them
+	 * is called. buffer() is null, and the skipping of unchanged frames,
+	 * the changed prefix transmission and the frame cache are not
+	 * available. Mirrors can be added in TransmitMode::BUFFERED.
+	 *
+	 * In TransmitMode::STREAMING, render() is called from the RMT interrupt :
+	 * it must not block nor use floating point, should be placed in IRAM
+	 * (IRAM_ATTR) like the translator of the strip, and rendering SPAN_SIZE
+	 * pixels must be faster than the transmission of half an RMT memory
+	 * block (about 40uS for WS2812 leds).
+	 *
+	 * Example usage :
+	 * ```
+	 * Rainbow rainbow {10000};
+	 * RgbStripConfig config = WS2812();
+	 * config.transmit_mode = TransmitMode::STREAMING;
+	 * ShaderStrip strip {GPIO_NUM_12, 10000, RMT_CHANNEL_0, rainbow, config};
+	 * while(1) {
+	 *     rainbow.update();
+	 *     strip.show();
+	 * }
+	 * ```
+	 */
+	class ShaderStrip : public Strip {
+		public:
+			/**
+			 * Count of pixels rendered at once by the RMT translator, in
+			 * TransmitMode::STREAMING.
+			 */
+			static const uint8_t SPAN_SIZE = 8;
+
+			/**
+			 * ShaderStrip constructor.
+			 *
+			 * @param gpio_num Led Strip GPIO.
+			 * @param pixel_count Number of leds, at most effect.length()
+			 * @param channel RMT channel to use.
+			 * @param effect effect rendering the leds, that must outlive
+			 * the strip
+			 * @param config RGB strip config
+			 */
+			ShaderStrip(gpio_num_t gpio_num, uint32_t pixel_count, rmt_channel_t channel,
+					const Effect& effect, RgbStripConfig config);
+			ShaderStrip(gpio_num_t gpio_num, uint32_t pixel_count, const Effect& effect, RgbStripConfig config);
+
+			ShaderStrip(const ShaderStrip&) = delete;
+			ShaderStrip(ShaderStrip&&) = delete;
+			ShaderStrip& operator=(const ShaderStrip&) = delete;
+			ShaderStrip& operator=(ShaderStrip&&) = delete;
+
+			/**
+			 * Renders the current frame of the effect, and transmits it to
+			 * the strip.
+			 */
+			void show() override;
+
+			/*
+			 * Setters and clear() are ignored : the leds are rendered by the
+			 * effect.
+			 */
+			void setRgbPixel(uint32_t index, uint8_t red, uint8_t green, uint8_t blue) override {ignoreSetter();}
+			void setHsbPixel(uint32_t index, float hue, float saturation, float brightness) override {ignoreSetter();}
+			void setRgbPixels(uint32_t index, const rgb_pixel* pixels, uint32_t count) override {ignoreSetter();}
+			void fillRgb(uint32_t index, uint32_t count, const rgb_pixel& color) override {ignoreSetter();}
+			void clear() override {ignoreSetter();}
+
+			/**
+			 * @return effect rendering the leds
+			 */
+			const Effect& effect() const {return *shader_context.effect;}
+
+			/**
+			 * Replaces the effect rendering the leds, from the next call to
+			 * show().
+			 *
+			 * @param effect effect of at least length() pixels, that must
+			 * outlive the strip
+			 */
+			void setEffect(const Effect& effect);
+
+			/**
+			 * Returns the strip config currently in use.
+			 *
+			 * @return strip config (t0h, t0l, t1h, t1l, RGB output order)
+			 */
+			const RgbStripConfig& rgbStripConfig() const {return rgb_strip_config;}
+
+		protected:
+			/*
+			 * Data required to render and encode the strip on the fly.
+			 */
+			struct ShaderContext {
+				rmt_item32_t bit0;
+				rmt_item32_t bit1;
+				const Effect* effect;
+				RgbSerializer serializer;
+				uint32_t pixel_count;
+				/*
+				 * Index of the first pixel of the next span to render.
+				 */
+				uint32_t next_pixel;
+				/*
+				 * Last rendered span, serialized in the chip order.
+				 */
+				uint8_t span[3 * SPAN_SIZE];
+				uint8_t span_size;
+				uint8_t position;
+
+				ShaderContext(const Effect& effect, RgbSerializer serializer, uint32_t pixel_count)
+					: effect(&effect), serializer(serializer), pixel_count(pixel_count),
+					next_pixel(0), span_size(0), position(0) {}
+			};
+			ShaderContext shader_context;
+
+			/*
+			 * Restarts the rendering from the first pixel.
+			 */
+			void startStream();
+
+			/*
+			 * Encodes at most `size` bytes of the strip, from the current
+			 * position of the context, producing at most `wanted_num`
+			 * items. Only whole bytes are encoded.
+			 */
+			static void encodeShader(ShaderContext& context, size_t size,
+					rmt_item32_t* dest, size_t wanted_num, size_t* translated_size, size_t* item_num);
+
+		private:
+			RgbStripConfig rgb_strip_config;
+			bool setter_warned;
+
+			/*
+			 * Logs a warning, once and only in debug builds, when a setter
+			 * is called.
+			 */
+			void ignoreSetter();
+
+			/*
+			 * RMT translator used in TransmitMode::STREAMING. The sample
+			 * pointer is never read : the position is kept in the context.
+			 */
+			static void translate(const void* src, rmt_item32_t* dest, size_t src_size,
+					size_t wanted_num, size_t* translated_size, size_t* item_num);
+	};
+}
+#endif
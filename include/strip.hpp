@@ -10,6 +10,8 @@
 #include "output.hpp"
 #include "converters.hpp"
 #include "strip_config.hpp"
+#include "frame_cache.hpp"
+#include "trace.hpp"
 
 #define RGB_TO_RGBW_CONVERTER ComplexRgbToRgbwConverter
 
@@ -23,14 +25,83 @@ namespace pixled {
 		public:
 
 			Strip(
-					gpio_num_t gpio_num, uint16_t pixel_count, uint8_t* _buffer,
+					gpio_num_t gpio_num, uint32_t pixel_count, uint8_t pixel_size, uint8_t* _buffer,
 					rmt_channel_t channel, rmt_item32_t* rmt_items, StripConfig strip_config);
 
-			uint16_t length() {return pixel_count;}
+			uint32_t length() {return pixel_count;}
+
+			/**
+			 * Returns the count of bytes used by each pixel in the internal
+			 * buffer (3 for RGB strips, 4 for RGBW strips).
+			 *
+			 * @return bytes per pixel
+			 */
+			uint8_t pixelSize() const {return pixel_size;}
+
 			virtual void show() = 0;
 
-			virtual void setRgbPixel(uint16_t index, uint8_t red, uint8_t green, uint8_t blue) = 0;
-			virtual void setHsbPixel(uint16_t index, float hue, float saturation, float brightness) = 0;
+			virtual void setRgbPixel(uint32_t index, uint8_t red, uint8_t green, uint8_t blue) = 0;
+			virtual void setHsbPixel(uint32_t index, float hue, float saturation, float brightness) = 0;
+
+			/**
+			 * Writes `count` consecutive RGB pixels, starting at `index`.
+			 *
+			 * Equivalent to `count` calls to setRgbPixel(), but performed with a
+			 * single virtual call.
+			 *
+			 * @param index position of the first led
+			 * @param pixels RGB colors to write
+			 * @param count number of pixels to write
+			 */
+			virtual void setRgbPixels(uint32_t index, const rgb_pixel* pixels, uint32_t count) = 0;
+
+			/**
+			 * Sets `count` consecutive pixels, starting at `index`, to the same
+			 * RGB color.
+			 *
+			 * The color is converted and serialized only once.
+			 *
+			 * @param index position of the first led
+			 * @param count number of pixels to fill
+			 * @param color RGB color
+			 */
+			virtual void fillRgb(uint32_t index, uint32_t count, const rgb_pixel& color) = 0;
+
+			/**
+			 * Writes `count` consecutive 16 bits per channel RGB pixels,
+			 * starting at `index`.
+			 *
+			 * Strips driving 16 bits leds store the colors as is. By default,
+			 * colors are rounded to 8 bits per channel and written with
+			 * setRgbPixels(), so that the same high depth render buffer can be
+			 * used to drive any strip.
+			 *
+			 * @param index position of the first led
+			 * @param pixels 16 bits RGB colors to write
+			 * @param count number of pixels to write
+			 */
+			virtual void setRgb16Pixels(uint32_t index, const rgb16_pixel* pixels, uint32_t count);
+
+			/**
+			 * Copies `count` pixels from position `from` to position `to`.
+			 *
+			 * Data is copied as is in the internal buffer, so the operation is
+			 * independent of the color order and of the led type. Source and
+			 * destination ranges may overlap.
+			 *
+			 * @param to position of the first destination pixel
+			 * @param from position of the first source pixel
+			 * @param count number of pixels to copy
+			 */
+			void copyPixels(uint32_t to, uint32_t from, uint32_t count);
+
+			/**
+			 * Reverses the order of `count` pixels, starting at `index`.
+			 *
+			 * @param index position of the first pixel
+			 * @param count number of pixels to reverse
+			 */
+			void reversePixels(uint32_t index, uint32_t count);
 
 			/**
 			 * Returns a pointer to the internal buffer.
@@ -43,9 +114,13 @@ namespace pixled {
 			 * respect color orders and buffer size, according to the led strip in
 			 * use.
 			 *
+			 * Since the buffer can then be written at any time, the skipping
+			 * of unchanged frames compares it at each show() once this was
+			 * called (see skipUnchangedFrames()).
+			 *
 			 * @return internal buffer color buffer
 			 */
-			uint8_t* const& buffer() {return _buffer;}
+			uint8_t* const& buffer() {buffer_shared = true; return _buffer;}
 
 			virtual void clear() = 0;
 
@@ -56,10 +131,132 @@ namespace pixled {
 			 */
 			const StripConfig& stripConfig() const {return strip_config;}
 
+			/**
+			 * Enables or disables the skipping of unchanged frames.
+			 *
+			 * When enabled, show() does nothing if the internal buffer is
+			 * identical to the last transmitted frame. The buffer is only
+			 * compared with a copy of that frame (pixelSize() bytes per pixel)
+			 * when a setter was called since the last show(), or at each
+			 * show() once buffer() was handed out for direct writes.
+			 *
+			 * Strips driven by a ParallelOutput are always transmitted. Not
+			 * available for strips without buffer (ShaderStrip).
+			 *
+			 * @param enable true to skip unchanged frames
+			 * @param keep_alive_ms if not 0, an unchanged frame is still
+			 * transmitted when the last transmission is older than
+			 * keep_alive_ms, for example to recover from glitches
+			 */
+			void skipUnchangedFrames(bool enable, uint32_t keep_alive_ms = 0);
+
+			/**
+			 * Forces the transmission of the next frame, even if the buffer
+			 * did not change (e.g. when a palette entry is modified).
+			 */
+			void markChanged() {changed = true; full_frame = true;}
+
+			/**
+			 * Transmits the frame on an other RMT channel, in addition to the
+			 * strip channel, to drive an identical strip with the same
+			 * content.
+			 *
+			 * The frame is still encoded once, in the items buffer of the
+			 * strip, and show() starts the transmission on all the channels
+			 * before waiting for their end. On targets supporting it (not
+			 * the original ESP32), the channels are added to the RMT
+			 * synchronization group so that they start on the same clock.
+			 *
+			 * Only available in TransmitMode::BUFFERED.
+			 *
+			 * @param gpio_num GPIO of the mirrored strip
+			 * @param channel RMT channel dedicated to the mirrored strip
+			 */
+			void addMirror(gpio_num_t gpio_num, rmt_channel_t channel);
+
+			/**
+			 * @return count of channels added with addMirror()
+			 */
+			uint8_t mirrorCount() const {return mirror_count;}
+
+			/**
+			 * Attaches a cache of encoded frames to the strip, or detaches it
+			 * if `cache` is null.
+			 *
+			 * show() then transmits frames found in the cache without
+			 * encoding them, and stores the other frames once encoded. See
+			 * FrameCache.
+			 *
+			 * Only available in TransmitMode::BUFFERED, for strips with a
+			 * buffer. The cache must outlive the strip, or be detached first.
+			 */
+			void setFrameCache(FrameCache* cache);
+
+			/**
+			 * Identifies the frame transmitted by the next show() in the
+			 * frame cache, instead of hashing the buffer.
+			 *
+			 * @param frame_id application defined ID, that must always
+			 * identify the same buffer content
+			 * @param pin true to never evict the frame from the cache
+			 */
+			void setFrameId(uint32_t frame_id, bool pin = false);
+
+			/**
+			 * @return count of show() calls skipped because the frame did not
+			 * change
+			 */
+			uint32_t skippedFrames() const {return skipped_frames;}
+
+			/**
+			 * Enables or disables the transmission of the changed prefix of
+			 * the frames only.
+			 *
+			 * WS281x leds keep their color when a data burst ends before
+			 * them. When enabled, show() compares the buffer with a copy of
+			 * the last transmitted frame, and only encodes and transmits the
+			 * pixels up to the last one that changed. Since the buffer itself
+			 * is checked, direct writes to buffer() are also detected. A frame
+			 * identical to the last one is not transmitted at all.
+			 *
+			 * The first frame after enabling, after markChanged() and after a
+			 * keep alive (see skipUnchangedFrames()) is transmitted in full.
+			 * Since frames can get much shorter, show() also waits, if
+			 * necessary, until the end of the last transmission is followed by
+			 * StripConfig::reset_us, so that the leds latch each frame.
+			 *
+			 * Only available for RMT strips with a buffer. Leds that do not
+			 * keep their color without data (or that are driven in a loop)
+			 * must not be used.
+			 *
+			 * @param enable true to only transmit the changed prefix
+			 */
+			void transmitChangedPrefix(bool enable);
+
+			/**
+			 * @return count of pixels transmitted by the last show()
+			 */
+			uint32_t transmittedPixels() const {return transmitted_pixels;}
+
+			/**
+			 * @return total count of pixels that were not transmitted thanks
+			 * to transmitChangedPrefix()
+			 */
+			uint64_t truncatedPixels() const {return truncated_pixels;}
+
+			/**
+			 * @return total transmission time saved by
+			 * transmitChangedPrefix(), in uS
+			 */
+			uint64_t savedWireTimeUs() const {
+				return saved_bits * strip_config.bitPeriodNs() / 1000;
+			}
+
 			virtual ~Strip();
 
 		protected:
-			uint16_t pixel_count;
+			uint32_t pixel_count;
+			uint8_t pixel_size;
 			uint8_t* _buffer;
 
 			rmt_channel_t  channel;
@@ -67,9 +264,203 @@ namespace pixled {
 
 			StripConfig strip_config;
 
+		private:
+			bool skip_unchanged;
+			bool changed;
+			uint32_t keep_alive_us;
+			/*
+			 * True if a setter modified the buffer since the last show().
+			 */
+			bool written;
+			/*
+			 * True once buffer() was handed out : the buffer can then be
+			 * written at any time.
+			 */
+			bool buffer_shared;
+			/*
+			 * Copy of the last transmitted frame, allocated when
+			 * skipUnchangedFrames() is enabled.
+			 */
+			uint8_t* shown_frame;
+			int64_t last_transmission;
+			uint32_t skipped_frames;
+
+			rmt_channel_t mirrors[RMT_CHANNEL_MAX];
+			uint8_t mirror_count;
+
+			FrameCache* frame_cache;
+			uint32_t frame_key;
+			bool frame_by_id;
+			bool frame_pinned;
+			/*
+			 * True if the frame being transmitted was not found in the cache,
+			 * and must be stored once encoded.
+			 */
+			bool frame_missed;
+
+			/*
+			 * Copy of the last transmitted frame, allocated when
+			 * transmitChangedPrefix() is enabled.
+			 */
+			uint8_t* last_frame;
+			bool full_frame;
+			/*
+			 * Maximum count of items transmitted for the current frame.
+			 */
+			uint32_t prefix_items;
+			uint32_t transmitted_pixels;
+			uint64_t truncated_pixels;
+			uint64_t saved_bits;
+			int64_t transmission_end;
+
+			/*
+			 * Waits until the last transmission is followed by the reset
+			 * duration.
+			 */
+			void waitReset();
+
+			void transmit(const rmt_item32_t* items, uint32_t count);
+
+			uint32_t hashBuffer() const;
+
+			/*
+			 * RMT translator used in TransmitMode::STREAMING, called by the
+			 * RMT driver (possibly from its interrupt) each time items are
+			 * required.
+			 */
+			static void translate(const void* src, rmt_item32_t* dest, size_t src_size,
+					size_t wanted_num, size_t* translated_size, size_t* item_num);
+
+		protected:
+			/*
+			 * Data required to encode the buffer on the fly.
+			 */
+			struct StreamContext {
+				rmt_item32_t bit0;
+				rmt_item32_t bit1;
+				const uint8_t* buffer;
+				uint8_t pixel_size;
+				/*
+				 * Offset in the buffer pixel of each transmitted byte.
+				 */
+				uint8_t order[8];
+			};
+			StreamContext stream_context;
+
+			/*
+			 * Returns a new buffer of `count` RMT items, or nullptr in
+			 * TransmitMode::STREAMING, where no item buffer is required.
+			 */
+			static rmt_item32_t* allocateItems(const StripConfig& config, uint32_t count);
+
+			/*
+			 * Transmits the buffer in TransmitMode::STREAMING, waiting for
+			 * the end of the transmission.
+			 *
+			 * `order` gives, for each transmitted byte of a pixel, its offset
+			 * in the pixel of the buffer (pixel_size bytes).
+			 */
+			void streamBuffer(const uint8_t* order);
+
+			/*
+			 * Transmits `size` bytes from `src` in TransmitMode::STREAMING,
+			 * with the translator installed on the channel, waiting for the
+			 * end of the transmission.
+			 */
+			void writeSample(const uint8_t* src, size_t size);
+
+			/*
+			 * Encodes at most `size` bytes of `data`, a position in
+			 * context.buffer, producing at most `wanted_num` items. Only
+			 * whole bytes are encoded.
+			 */
+			static void encodeStream(const StreamContext& context, const uint8_t* data, size_t size,
+					rmt_item32_t* dest, size_t wanted_num, size_t* translated_size, size_t* item_num);
+
 			void setItem1(rmt_item32_t* pItem);
 			void setItem0(rmt_item32_t* pItem);
 
+			/*
+			 * Transmits the first `count` items of rmt_items on the strip
+			 * channel and all its mirrors, waiting for the end of the
+			 * transmission.
+			 *
+			 * The items are stored in the frame cache if
+			 * transmitCachedFrame() missed.
+			 */
+			void writeItems(uint32_t count);
+
+			/*
+			 * Looks up the current frame of `count` items in the frame
+			 * cache. If it is found, it is transmitted and true is returned,
+			 * in which case show() must return immediately. Otherwise, show()
+			 * must encode the frame and transmit it with writeItems().
+			 *
+			 * Returns false if no cache is attached.
+			 */
+			bool transmitCachedFrame(uint32_t count);
+
+			/*
+			 * Returns the count of pixels of the current frame to transmit,
+			 * each pixel being `pixel_bits` items : pixel_count, or the
+			 * changed prefix if transmitChangedPrefix() is enabled, in which
+			 * case writeItems() and transmitCachedFrame() only transmit the
+			 * items of this prefix. If 0 is returned, show() must return
+			 * immediately.
+			 */
+			uint32_t changedPrefix(uint16_t pixel_bits);
+
+			/*
+			 * Records the transmission of the whole frame, for strips without
+			 * buffer that can not use changedPrefix().
+			 */
+			void transmitWholeFrame() {transmitted_pixels = pixel_count;}
+
+			/*
+			 * Returns the count of pixels to encode for a changed prefix of
+			 * `prefix` pixels : the whole frame must be encoded when it is
+			 * stored in the frame cache.
+			 */
+			uint32_t encodedPixels(uint32_t prefix) const {return frame_missed ? pixel_count : prefix;}
+
+			/*
+			 * Removes all the frames of the frame cache, when the encoding
+			 * of the buffer changes (e.g. palette entries).
+			 */
+			void invalidateFrameCache();
+
+			/*
+			 * Returns false if the skipping of unchanged frames is enabled
+			 * and the buffer did not change since the last transmitted
+			 * frame, in which case show() must return immediately.
+			 *
+			 * Otherwise, the current frame is recorded as transmitted.
+			 */
+			bool frameChanged();
+
+			/*
+			 * Records that the buffer was modified, so that the next
+			 * frameChanged() compares it. Called by all the setters.
+			 */
+			void markWritten() {written = true;}
+
+			/*
+			 * Constructor for strips that are not driven by the RMT
+			 * peripheral (e.g. SPI clocked strips).
+			 *
+			 * No RMT channel is installed. `strip_config` is only reported by
+			 * stripConfig().
+			 */
+			Strip(uint32_t pixel_count, uint8_t pixel_size, uint8_t* _buffer,
+					StripConfig strip_config = StripConfig(0, 0, 0, 0));
+
+			/*
+			 * Encodes `size` bytes of data to RMT items, MSB first.
+			 *
+			 * Returns the item following the last encoded item.
+			 */
+			rmt_item32_t* encodeBytes(const uint8_t* data, uint32_t size, rmt_item32_t* pItem);
+
 			/*
 			 * Add an RMT terminator into the RMT data.
 			 */
@@ -83,10 +474,26 @@ namespace pixled {
 		protected:
 			RgbStripConfig rgb_strip_config;
 			HsbToRgbConverter hsb_to_rgb;
+			/*
+			 * Order used to write components in the buffer : the chip order,
+			 * or RGB in BufferOrder::LOGICAL mode.
+			 */
+			RgbSerializer buffer_serializer;
+			/*
+			 * Offset, in each buffer pixel, of the byte transmitted at each
+			 * position.
+			 */
+			uint8_t chip_order[3];
+
+			/*
+			 * Constructor for RGB strips that are not driven by an RMT
+			 * channel. show() must be overridden.
+			 */
+			RgbStrip(uint32_t pixel_count, RgbStripConfig config);
 
 		public:
-			RgbStrip(gpio_num_t gpio_num, uint16_t pixel_count, rmt_channel_t channel, RgbStripConfig config);
-			RgbStrip(gpio_num_t gpio_num, uint16_t pixel_count, RgbStripConfig config);
+			RgbStrip(gpio_num_t gpio_num, uint32_t pixel_count, rmt_channel_t channel, RgbStripConfig config);
+			RgbStrip(gpio_num_t gpio_num, uint32_t pixel_count, RgbStripConfig config);
 
 			RgbStrip(const RgbStrip&) = delete;
 			RgbStrip(RgbStrip&&) = delete;
@@ -95,8 +502,21 @@ namespace pixled {
 
 			void show() override;
 
-			void setRgbPixel(uint16_t index, uint8_t red, uint8_t green, uint8_t blue) override;
-			void setHsbPixel(uint16_t index, float hue, float saturation, float brightness) override;
+			void setRgbPixel(uint32_t index, uint8_t red, uint8_t green, uint8_t blue) override;
+			void setHsbPixel(uint32_t index, float hue, float saturation, float brightness) override;
+			void setRgbPixels(uint32_t index, const rgb_pixel* pixels, uint32_t count) override;
+			void fillRgb(uint32_t index, uint32_t count, const rgb_pixel& color) override;
+
+			/**
+			 * Reads back the color of the led at position `index`, whatever
+			 * the buffer order is.
+			 *
+			 * @param index position of the led
+			 * @return RGB color
+			 */
+			rgb_pixel getRgbPixel(uint32_t index) const {
+				return buffer_serializer.deserialize(&_buffer[3*index]);
+			}
 
 			void clear() override;
 
@@ -115,8 +535,8 @@ namespace pixled {
 	 */
 	class RgbwStrip:  public Strip {
 		public:
-			RgbwStrip(gpio_num_t gpio_num, uint16_t pixel_count, rmt_channel_t channel, RgbwStripConfig config);
-			RgbwStrip(gpio_num_t gpio_num, uint16_t pixel_count, RgbwStripConfig config);
+			RgbwStrip(gpio_num_t gpio_num, uint32_t pixel_count, rmt_channel_t channel, RgbwStripConfig config);
+			RgbwStrip(gpio_num_t gpio_num, uint32_t pixel_count, RgbwStripConfig config);
 
 			RgbwStrip(const RgbwStrip&) = delete;
 			RgbwStrip(RgbwStrip&&) = delete;
@@ -125,9 +545,22 @@ namespace pixled {
 
 			void show() override;
 
-			void setRgbPixel(uint16_t index, uint8_t red, uint8_t green, uint8_t blue) override;
-			void setHsbPixel(uint16_t index, float hue, float saturation, float brightness) override;
-			void setRgbwPixel(uint16_t index, uint8_t red, uint8_t green, uint8_t blue, uint8_t white);
+			void setRgbPixel(uint32_t index, uint8_t red, uint8_t green, uint8_t blue) override;
+			void setHsbPixel(uint32_t index, float hue, float saturation, float brightness) override;
+			void setRgbPixels(uint32_t index, const rgb_pixel* pixels, uint32_t count) override;
+			void fillRgb(uint32_t index, uint32_t count, const rgb_pixel& color) override;
+			void setRgbwPixel(uint32_t index, uint8_t red, uint8_t green, uint8_t blue, uint8_t white);
+
+			/**
+			 * Reads back the color of the led at position `index`, whatever
+			 * the buffer order is.
+			 *
+			 * @param index position of the led
+			 * @return RGBW color
+			 */
+			rgbw_pixel getRgbwPixel(uint32_t index) const {
+				return buffer_serializer.deserialize(&_buffer[4*index]);
+			}
 
 			void clear() override;
 
@@ -140,10 +573,19 @@ namespace pixled {
 
 			virtual ~RgbwStrip();
 
+		protected:
+			/*
+			 * Constructor for RGBW strips that are not driven by an RMT
+			 * channel. show() must be overridden.
+			 */
+			RgbwStrip(uint32_t pixel_count, RgbwStripConfig config);
+
 		private:
 			RgbwStripConfig rgbw_strip_config;
 			HsbToRgbConverter hsb_to_rgb;
 			RGB_TO_RGBW_CONVERTER rgb_to_rgbw;
+			RgbwSerializer buffer_serializer;
+			uint8_t chip_order[4];
 	};
 }
 #endif
@@ -0,0 +1,98 @@
+#ifndef PIXLED_DRIVER_STRIP16_H
+#define PIXLED_DRIVER_STRIP16_H
+
+#include "strip.hpp"
+
+namespace pixled {
+	/**
+	 * @brief 16 bits per channel RGB strip class.
+	 *
+	 * Drives leds with 16 bits per channel, such as WS2816 or UCS8903 : 48 bits
+	 * are sent to each led.
+	 *
+	 * 8 bits colors set with the generic Strip interface are expanded to 16
+	 * bits.
+	 */
+	class Rgb16Strip: public Strip {
+		protected:
+			Rgb16StripConfig rgb16_strip_config;
+			HsbToRgbConverter hsb_to_rgb;
+
+		public:
+			Rgb16Strip(gpio_num_t gpio_num, uint32_t pixel_count, rmt_channel_t channel, Rgb16StripConfig config);
+			Rgb16Strip(gpio_num_t gpio_num, uint32_t pixel_count, Rgb16StripConfig config);
+
+			Rgb16Strip(const Rgb16Strip&) = delete;
+			Rgb16Strip(Rgb16Strip&&) = delete;
+			Rgb16Strip& operator=(const Rgb16Strip&) = delete;
+			Rgb16Strip& operator=(Rgb16Strip&&) = delete;
+
+			void show() override;
+
+			void setRgbPixel(uint32_t index, uint8_t red, uint8_t green, uint8_t blue) override;
+			void setHsbPixel(uint32_t index, float hue, float saturation, float brightness) override;
+			void setRgbPixels(uint32_t index, const rgb_pixel* pixels, uint32_t count) override;
+			void fillRgb(uint32_t index, uint32_t count, const rgb_pixel& color) override;
+
+			void setRgb16Pixel(uint32_t index, uint16_t red, uint16_t green, uint16_t blue);
+			void setRgb16Pixels(uint32_t index, const rgb16_pixel* pixels, uint32_t count) override;
+
+			void clear() override;
+
+			/**
+			 * Returns the strip config currently in use.
+			 *
+			 * @return strip config (t0h, t0l, t1h, t1l, RGB output order)
+			 */
+			const Rgb16StripConfig& rgb16StripConfig() const {return rgb16_strip_config;}
+
+			virtual ~Rgb16Strip();
+	};
+
+	/**
+	 * @brief 16 bits per channel RGBW strip class.
+	 *
+	 * Drives RGBW leds with 16 bits per channel, such as UCS8904 : 64 bits are
+	 * sent to each led.
+	 */
+	class Rgbw16Strip: public Strip {
+		public:
+			Rgbw16Strip(gpio_num_t gpio_num, uint32_t pixel_count, rmt_channel_t channel, Rgbw16StripConfig config);
+			Rgbw16Strip(gpio_num_t gpio_num, uint32_t pixel_count, Rgbw16StripConfig config);
+
+			Rgbw16Strip(const Rgbw16Strip&) = delete;
+			Rgbw16Strip(Rgbw16Strip&&) = delete;
+			Rgbw16Strip& operator=(const Rgbw16Strip&) = delete;
+			Rgbw16Strip& operator=(Rgbw16Strip&&) = delete;
+
+			void show() override;
+
+			void setRgbPixel(uint32_t index, uint8_t red, uint8_t green, uint8_t blue) override;
+			void setHsbPixel(uint32_t index, float hue, float saturation, float brightness) override;
+			void setRgbPixels(uint32_t index, const rgb_pixel* pixels, uint32_t count) override;
+			void fillRgb(uint32_t index, uint32_t count, const rgb_pixel& color) override;
+
+			void setRgb16Pixel(uint32_t index, uint16_t red, uint16_t green, uint16_t blue);
+			void setRgb16Pixels(uint32_t index, const rgb16_pixel* pixels, uint32_t count) override;
+			void setRgbw16Pixel(uint32_t index, uint16_t red, uint16_t green, uint16_t blue, uint16_t white);
+
+			void clear() override;
+
+			/**
+			 * Returns the strip config currently in use.
+			 *
+			 * @return strip config (t0h, t0l, t1h, t1l, RGBW output order)
+			 */
+			const Rgbw16StripConfig& rgbw16StripConfig() const {return rgbw16_strip_config;}
+
+			virtual ~Rgbw16Strip();
+
+		private:
+			Rgbw16StripConfig rgbw16_strip_config;
+			HsbToRgbConverter hsb_to_rgb;
+			RGB_TO_RGBW_CONVERTER rgb_to_rgbw;
+
+			rgbw16_pixel toRgbw16(const rgb_pixel& pixel) const;
+	};
+}
+#endif
@@ -5,6 +5,57 @@
 #include "constants.hpp"
 
 namespace pixled {
+	/**
+	 * How the phases of a bit are converted to RMT ticks.
+	 */
+	enum class TimingMode {
+		/**
+		 * Each phase is rounded to the nearest tick.
+		 */
+		NOMINAL,
+		/**
+		 * High phases are rounded to the nearest tick, and low phases are
+		 * shortened to the smallest duration allowed by the tolerance, to
+		 * reduce the bit period.
+		 */
+		COMPRESSED
+	};
+
+	/**
+	 * How the buffer of an RMT strip is encoded and transmitted.
+	 */
+	enum class TransmitMode {
+		/**
+		 * The whole frame is encoded to RMT items before the transmission.
+		 * This requires 4 bytes of RAM for each transmitted bit.
+		 */
+		BUFFERED,
+		/**
+		 * The frame is encoded on the fly by the RMT driver, in small
+		 * chunks, as the transmission goes. The memory used for the encoding
+		 * does not depend on the strip length.
+		 */
+		STREAMING
+	};
+
+	/**
+	 * Order of the color components in the internal buffer of RGB and RGBW
+	 * strips.
+	 */
+	enum class BufferOrder {
+		/**
+		 * Components are stored in the order expected by the chip, so that the
+		 * buffer can be transmitted as is.
+		 */
+		CHIP,
+		/**
+		 * Components are stored in the canonical RGB / RGBW order, and the
+		 * chip order is applied when the buffer is encoded. The buffer can
+		 * then be read and written without knowing the led type.
+		 */
+		LOGICAL
+	};
+
 	struct StripConfig {
 		/**
 		 * Base StripConfig constructor.
@@ -16,18 +67,35 @@ namespace pixled {
 		 * - t1h = 700
 		 * - t1l = 600
 		 *
-		 * Each constant is then automatically converted to RMT ticks.
+		 * The RMT clock divider (between 1 and RMT_MAX_DIVIDER) is selected
+		 * to minimize the total rounding error (ties go to the largest
+		 * divider), then each constant is rounded to the nearest RMT tick.
+		 *
+		 * Everything is computed at compile time when the parameters are
+		 * constants, so valid() can be used in a static_assert.
 		 *
 		 * @param t0h t0h in nS
 		 * @param t0l t0l in nS
 		 * @param t1h t1h in nS
 		 * @param t1l t1l in nS
+		 * @param tolerance maximum allowed difference between the
+		 * transmitted and specified duration of each phase, in nS
+		 * @param mode TimingMode::COMPRESSED to shorten low phases
 		 */
-		StripConfig(uint16_t t0h,  uint16_t t0l,  uint16_t t1h,  uint16_t t1l) :
-			t0h(NS_TO_RMT_TICKS(t0h)),
-			t0l(NS_TO_RMT_TICKS(t0l)),
-			t1h(NS_TO_RMT_TICKS(t1h)),
-			t1l(NS_TO_RMT_TICKS(t1l)) {}
+		constexpr StripConfig(uint16_t t0h,  uint16_t t0l,  uint16_t t1h,  uint16_t t1l,
+				uint16_t tolerance = DEFAULT_TOLERANCE, TimingMode mode = TimingMode::NOMINAL) :
+			clk_div(divider(t0h, t0l, t1h, t1l, tolerance, mode)),
+			t0h(nearestTicks(t0h, clk_div)),
+			t0l(lowTicks(t0l, tolerance, mode, clk_div)),
+			t1h(nearestTicks(t1h, clk_div)),
+			t1l(lowTicks(t1l, tolerance, mode, clk_div)),
+			nominal_t0h(t0h), nominal_t0l(t0l), nominal_t1h(t1h), nominal_t1l(t1l),
+			tolerance(tolerance), transmit_mode(TransmitMode::BUFFERED), reset_us(DEFAULT_RESET_US) {}
+
+		/**
+		 * RMT clock divider of the 80MHz APB clock.
+		 */
+		uint8_t clk_div;
 		/**
 		 * t0h, in *RMT ticks*.
 		 */
@@ -44,6 +112,111 @@ namespace pixled {
 		 * t1l, in *RMT ticks*.
 		 */
 		uint16_t t1l;
+
+		/**
+		 * Specified durations, in *nS*.
+		 */
+		uint16_t nominal_t0h;
+		uint16_t nominal_t0l;
+		uint16_t nominal_t1h;
+		uint16_t nominal_t1l;
+		/**
+		 * Tolerance of each phase, in *nS*.
+		 */
+		uint16_t tolerance;
+		/**
+		 * Encoding of the frames, BUFFERED by default. Indexed strips are
+		 * always BUFFERED.
+		 */
+		TransmitMode transmit_mode;
+		/**
+		 * Duration of the low level that latches a frame, in *uS*
+		 * (DEFAULT_RESET_US by default). Only enforced between frames when
+		 * Strip::transmitChangedPrefix() is enabled.
+		 */
+		uint16_t reset_us;
+
+		/**
+		 * Duration of an RMT tick, in *pS*.
+		 */
+		constexpr uint32_t tickPs() const {return tickPs(clk_div);}
+
+		/**
+		 * Converts RMT ticks to *nS*, rounded to the nearest nS.
+		 */
+		constexpr uint32_t ticksToNs(uint32_t ticks) const {return (ticks * tickPs() + 500) / 1000;}
+
+		/**
+		 * Actually transmitted durations, in *nS*.
+		 */
+		constexpr uint32_t t0hNs() const {return ticksToNs(t0h);}
+		constexpr uint32_t t0lNs() const {return ticksToNs(t0l);}
+		constexpr uint32_t t1hNs() const {return ticksToNs(t1h);}
+		constexpr uint32_t t1lNs() const {return ticksToNs(t1l);}
+
+		/**
+		 * Duration of the longest bit, in *nS*.
+		 */
+		constexpr uint32_t bitPeriodNs() const {
+			return ticksToNs(t0h + t0l > t1h + t1l ? t0h + t0l : t1h + t1l);
+		}
+
+		/**
+		 * Returns true if each transmitted phase is within the tolerance of
+		 * its specified duration, and if a 0 can be distinguished from a 1.
+		 */
+		constexpr bool valid() const {
+			return inRange(t0h, nominal_t0h) && inRange(t0l, nominal_t0l)
+				&& inRange(t1h, nominal_t1h) && inRange(t1l, nominal_t1l)
+				&& t0h < t1h;
+		}
+
+		private:
+		static constexpr uint32_t tickPs(uint8_t div) {
+			return div * (1000000000u / (RMT_SOURCE_CLOCK_HZ / 1000));
+		}
+		// A null duration would be interpreted as an RMT terminator
+		static constexpr uint16_t atLeastOne(uint32_t ticks) {
+			return ticks == 0 ? 1 : ticks;
+		}
+		static constexpr uint16_t nearestTicks(uint32_t ns, uint8_t div) {
+			return atLeastOne((ns * 1000 + tickPs(div) / 2) / tickPs(div));
+		}
+		static constexpr uint32_t minNs(uint32_t ns, uint16_t tolerance) {
+			return ns > tolerance ? ns - tolerance : 0;
+		}
+		static constexpr uint32_t lowTargetNs(uint32_t ns, uint16_t tolerance, TimingMode mode) {
+			return mode == TimingMode::COMPRESSED ? minNs(ns, tolerance) : ns;
+		}
+		static constexpr uint16_t lowTicks(uint32_t ns, uint16_t tolerance, TimingMode mode, uint8_t div) {
+			return mode == TimingMode::COMPRESSED ?
+				// Rounded up, so that the phase is not shorter than allowed
+				atLeastOne((minNs(ns, tolerance) * 1000 + tickPs(div) - 1) / tickPs(div)) :
+				nearestTicks(ns, div);
+		}
+		static constexpr uint32_t distancePs(uint32_t ticks, uint32_t ns, uint8_t div) {
+			return ticks * tickPs(div) > ns * 1000 ? ticks * tickPs(div) - ns * 1000 : ns * 1000 - ticks * tickPs(div);
+		}
+		static constexpr uint32_t error(
+				uint16_t t0h, uint16_t t0l, uint16_t t1h, uint16_t t1l,
+				uint16_t tolerance, TimingMode mode, uint8_t div) {
+			return distancePs(nearestTicks(t0h, div), t0h, div)
+				+ distancePs(nearestTicks(t1h, div), t1h, div)
+				+ distancePs(lowTicks(t0l, tolerance, mode, div), lowTargetNs(t0l, tolerance, mode), div)
+				+ distancePs(lowTicks(t1l, tolerance, mode, div), lowTargetNs(t1l, tolerance, mode), div);
+		}
+		static constexpr uint8_t divider(
+				uint16_t t0h, uint16_t t0l, uint16_t t1h, uint16_t t1l,
+				uint16_t tolerance, TimingMode mode, uint8_t div = 1, uint8_t best = 1) {
+			return div > RMT_MAX_DIVIDER ? best : divider(
+					t0h, t0l, t1h, t1l, tolerance, mode, div + 1,
+					error(t0h, t0l, t1h, t1l, tolerance, mode, div)
+					<= error(t0h, t0l, t1h, t1l, tolerance, mode, best) ? div : best);
+		}
+		constexpr bool inRange(uint16_t ticks, uint16_t ns) const {
+			return ticks * tickPs() >= minNs(ns, tolerance) * 1000
+				&& ticks * tickPs() <= (ns + tolerance) * 1000u;
+		}
 	};
 
 	struct RgbStripConfig : public StripConfig {
@@ -51,7 +224,8 @@ namespace pixled {
 		 * Base StripConfig constructor.
 		 *
 		 * Time constants are given in *nS*.
-		 * Each constant is then automatically converted to RMT ticks.
+		 * Each constant is then automatically converted to RMT ticks (see
+		 * StripConfig).
 		 *
 		 * Predefined constants defined in constants.hpp can be used as
 		 * RgbSerializer. (eg RGB, GBR, etc...)
@@ -61,11 +235,19 @@ namespace pixled {
 		 * @param t0l t0l in nS
 		 * @param t1h t1h in nS
 		 * @param t1l t1l in nS
+		 * @param tolerance tolerance of each phase in nS
+		 * @param mode TimingMode::COMPRESSED to shorten low phases
 		 */
-		RgbStripConfig(RgbSerializer serializer, uint16_t t0h,  uint16_t t0l,  uint16_t t1h,  uint16_t t1l)
-			: StripConfig(t0h, t0l, t1h, t1l), serializer(serializer) {}
+		RgbStripConfig(RgbSerializer serializer, uint16_t t0h,  uint16_t t0l,  uint16_t t1h,  uint16_t t1l,
+				uint16_t tolerance = DEFAULT_TOLERANCE, TimingMode mode = TimingMode::NOMINAL)
+			: StripConfig(t0h, t0l, t1h, t1l, tolerance, mode), serializer(serializer),
+			buffer_order(BufferOrder::CHIP) {}
 
 		RgbSerializer serializer;
+		/**
+		 * Order of the components in the strip buffer. CHIP by default.
+		 */
+		BufferOrder buffer_order;
 	};
 
 	struct RgbwStripConfig : public StripConfig {
@@ -73,7 +255,8 @@ namespace pixled {
 		 * Base StripConfig constructor.
 		 *
 		 * Time constants are given in *nS*.
-		 * Each constant is then automatically converted to RMT ticks.
+		 * Each constant is then automatically converted to RMT ticks (see
+		 * StripConfig).
 		 *
 		 * Predefined constants defined in constants.hpp can be used as
 		 * RgbSerializer. (eg RGBW, GBRW, etc...)
@@ -83,54 +266,314 @@ namespace pixled {
 		 * @param t0l t0l in nS
 		 * @param t1h t1h in nS
 		 * @param t1l t1l in nS
+		 * @param tolerance tolerance of each phase in nS
+		 * @param mode TimingMode::COMPRESSED to shorten low phases
 		 */
-		RgbwStripConfig(RgbwSerializer serializer, uint16_t t0h,  uint16_t t0l,  uint16_t t1h,  uint16_t t1l)
-			: StripConfig(t0h, t0l, t1h, t1l), serializer(serializer) {}
+		RgbwStripConfig(RgbwSerializer serializer, uint16_t t0h,  uint16_t t0l,  uint16_t t1h,  uint16_t t1l,
+				uint16_t tolerance = DEFAULT_TOLERANCE, TimingMode mode = TimingMode::NOMINAL)
+			: StripConfig(t0h, t0l, t1h, t1l, tolerance, mode), serializer(serializer),
+			buffer_order(BufferOrder::CHIP) {}
 
 		RgbwSerializer serializer;
+		/**
+		 * Order of the components in the strip buffer. CHIP by default.
+		 */
+		BufferOrder buffer_order;
+	};
+
+	struct Rgb16StripConfig : public StripConfig {
+		/**
+		 * 16 bits per channel RGB StripConfig constructor.
+		 *
+		 * Time constants are given in *nS*.
+		 * Each constant is then automatically converted to RMT ticks (see
+		 * StripConfig).
+		 *
+		 * Predefined constants defined in constants.hpp can be used as
+		 * color order. (eg RGB, GBR, etc...)
+		 *
+		 * @param order defines output color order
+		 * @param t0h t0h in nS
+		 * @param t0l t0l in nS
+		 * @param t1h t1h in nS
+		 * @param t1l t1l in nS
+		 * @param tolerance tolerance of each phase in nS
+		 * @param mode TimingMode::COMPRESSED to shorten low phases
+		 */
+		Rgb16StripConfig(RgbSerializer order, uint16_t t0h,  uint16_t t0l,  uint16_t t1h,  uint16_t t1l,
+				uint16_t tolerance = DEFAULT_TOLERANCE, TimingMode mode = TimingMode::NOMINAL)
+			: StripConfig(t0h, t0l, t1h, t1l, tolerance, mode), serializer(order) {}
+
+		Rgb16Serializer serializer;
+	};
+
+	struct Rgbw16StripConfig : public StripConfig {
+		/**
+		 * 16 bits per channel RGBW StripConfig constructor.
+		 *
+		 * Time constants are given in *nS*.
+		 * Each constant is then automatically converted to RMT ticks (see
+		 * StripConfig).
+		 *
+		 * Predefined constants defined in constants.hpp can be used as
+		 * color order. (eg RGBW, GBRW, etc...)
+		 *
+		 * @param order defines output color order
+		 * @param t0h t0h in nS
+		 * @param t0l t0l in nS
+		 * @param t1h t1h in nS
+		 * @param t1l t1l in nS
+		 * @param tolerance tolerance of each phase in nS
+		 * @param mode TimingMode::COMPRESSED to shorten low phases
+		 */
+		Rgbw16StripConfig(RgbwSerializer order, uint16_t t0h,  uint16_t t0l,  uint16_t t1h,  uint16_t t1l,
+				uint16_t tolerance = DEFAULT_TOLERANCE, TimingMode mode = TimingMode::NOMINAL)
+			: StripConfig(t0h, t0l, t1h, t1l, tolerance, mode), serializer(order) {}
+
+		Rgbw16Serializer serializer;
+	};
+
+	// Checks at compile time that the predefined timings can be transmitted
+	// within their tolerances, in both modes.
+#define PIXLED_CHECK_TIMINGS(CHIP) \
+	static_assert(StripConfig(CHIP##_T0H, CHIP##_T0L, CHIP##_T1H, CHIP##_T1L, CHIP##_TOLERANCE).valid(), \
+			#CHIP " timings can't be transmitted within tolerance"); \
+	static_assert(StripConfig(CHIP##_T0H, CHIP##_T0L, CHIP##_T1H, CHIP##_T1L, CHIP##_TOLERANCE, TimingMode::COMPRESSED).valid(), \
+			#CHIP " compressed timings can't be transmitted within tolerance");
+
+	PIXLED_CHECK_TIMINGS(WS2812)
+	PIXLED_CHECK_TIMINGS(WS2815)
+	PIXLED_CHECK_TIMINGS(SK6812)
+	PIXLED_CHECK_TIMINGS(SK6812W)
+	PIXLED_CHECK_TIMINGS(WS2816)
+	PIXLED_CHECK_TIMINGS(UCS8903)
+	PIXLED_CHECK_TIMINGS(UCS8904)
+#undef PIXLED_CHECK_TIMINGS
+
+	struct ClockedStripConfig {
+		/**
+		 * Config of SPI clocked strips.
+		 *
+		 * Predefined constants defined in constants.hpp can be used as
+		 * RgbSerializer. (eg RGB, BGR, etc...)
+		 *
+		 * @param serializer defines output color order
+		 * @param clock_speed SPI clock frequency, in Hz
+		 * @param reset_frame true if the leds require a reset frame after
+		 * the led frames (SK9822)
+		 */
+		ClockedStripConfig(RgbSerializer serializer, uint32_t clock_speed, bool reset_frame)
+			: serializer(serializer), clock_speed(clock_speed), reset_frame(reset_frame) {}
+
+		RgbSerializer serializer;
+		/**
+		 * SPI clock frequency, in *Hz*.
+		 */
+		uint32_t clock_speed;
+		bool reset_frame;
+	};
+
+	/**
+	 * Protocol used to send pixels to a remote controller.
+	 */
+	enum class NetworkProtocol {
+		/**
+		 * E1.31 (sACN) data packets, of up to 512 channels per universe.
+		 */
+		E131,
+		/**
+		 * Art-Net ArtDmx packets, of up to 512 channels per universe.
+		 */
+		ARTNET,
+		/**
+		 * DDP packets, of up to 1440 bytes, addressed by byte offset.
+		 */
+		DDP
+	};
+
+	struct NetworkStripConfig {
+		/**
+		 * Config of strips sent to a remote controller over UDP.
+		 *
+		 * The universe size defaults to 510 channels for E1.31 and Art-Net,
+		 * so that RGB pixels are not split across universes, and to 1440
+		 * bytes (480 RGB pixels) for DDP.
+		 *
+		 * @param protocol network protocol
+		 * @param address IPv4 address of the controller. With E1.31, a null
+		 * address sends each universe to its multicast address
+		 * (239.255.<universe>).
+		 * @param universe first universe (E1.31 and Art-Net)
+		 */
+		NetworkStripConfig(NetworkProtocol protocol, const char* address, uint16_t universe)
+			: protocol(protocol), address(address),
+			port(protocol == NetworkProtocol::E131 ? E131_PORT :
+					protocol == NetworkProtocol::ARTNET ? ARTNET_PORT : DDP_PORT),
+			universe(universe), universe_size(protocol == NetworkProtocol::DDP ? 1440 : 510),
+			packet_interval_us(0), serializer(RGB), priority(100), source_name("pixled"), cid(nullptr) {}
+
+		NetworkProtocol protocol;
+		const char* address;
+		/**
+		 * UDP port of the controller, set to the default port of the
+		 * protocol.
+		 */
+		uint16_t port;
+		uint16_t universe;
+		/**
+		 * Count of data bytes of each packet. At most 512 for E1.31 and
+		 * Art-Net, 1440 for DDP.
+		 */
+		uint16_t universe_size;
+		/**
+		 * Minimum delay between two packets, in *microseconds*, for
+		 * controllers that can't handle bursts. 0 by default.
+		 */
+		uint32_t packet_interval_us;
+		/**
+		 * Color order expected by the controller, RGB by default.
+		 */
+		RgbSerializer serializer;
+		/**
+		 * E1.31 priority, between 0 and 200.
+		 */
+		uint8_t priority;
+		/**
+		 * E1.31 source name, at most 63 characters.
+		 */
+		const char* source_name;
+		/**
+		 * E1.31 component identifier (16 bytes UUID). A constant default
+		 * CID is used if null : a unique CID must be set when several
+		 * sources send to the same controller.
+		 */
+		const uint8_t* cid;
 	};
 
 	struct WS2812 : public RgbStripConfig {
-		WS2812()
+		WS2812(TimingMode mode = TimingMode::NOMINAL)
 			: RgbStripConfig(
 					GRB,
 					WS2812_T0H,
 					WS2812_T0L,
 					WS2812_T1H,
-					WS2812_T1L)
+					WS2812_T1L,
+					WS2812_TOLERANCE,
+					mode)
 		{}
 	};
 
 	struct WS2815 : public RgbStripConfig {
-		WS2815()
+		WS2815(TimingMode mode = TimingMode::NOMINAL)
 			: RgbStripConfig(
 					GRB,
 					WS2815_T0H,
 					WS2815_T0L,
 					WS2815_T1H,
-					WS2815_T1L)
+					WS2815_T1L,
+					WS2815_TOLERANCE,
+					mode)
 		{}
 	};
 
 	struct SK6812 : public RgbStripConfig {
-		SK6812()
+		SK6812(TimingMode mode = TimingMode::NOMINAL)
 			: RgbStripConfig(
 					GRB,
 					SK6812_T0H,
 					SK6812_T0L,
 					SK6812_T1H,
-					SK6812_T1L)
+					SK6812_T1L,
+					SK6812_TOLERANCE,
+					mode)
 		{}
 	};
 
 	struct SK6812W : public RgbwStripConfig {
-		SK6812W()
+		SK6812W(TimingMode mode = TimingMode::NOMINAL)
 			: RgbwStripConfig(
 					GRBW,
 					SK6812W_T0H,
 					SK6812W_T0L,
 					SK6812W_T1H,
-					SK6812W_T1L)
+					SK6812W_T1L,
+					SK6812W_TOLERANCE,
+					mode)
+		{}
+	};
+
+	struct WS2816 : public Rgb16StripConfig {
+		WS2816(TimingMode mode = TimingMode::NOMINAL)
+			: Rgb16StripConfig(
+					GRB,
+					WS2816_T0H,
+					WS2816_T0L,
+					WS2816_T1H,
+					WS2816_T1L,
+					WS2816_TOLERANCE,
+					mode)
+		{}
+	};
+
+	struct UCS8903 : public Rgb16StripConfig {
+		UCS8903(TimingMode mode = TimingMode::NOMINAL)
+			: Rgb16StripConfig(
+					RGB,
+					UCS8903_T0H,
+					UCS8903_T0L,
+					UCS8903_T1H,
+					UCS8903_T1L,
+					UCS8903_TOLERANCE,
+					mode)
+		{}
+	};
+
+	struct UCS8904 : public Rgbw16StripConfig {
+		UCS8904(TimingMode mode = TimingMode::NOMINAL)
+			: Rgbw16StripConfig(
+					RGBW,
+					UCS8904_T0H,
+					UCS8904_T0L,
+					UCS8904_T1H,
+					UCS8904_T1L,
+					UCS8904_TOLERANCE,
+					mode)
+		{}
+	};
+
+	struct APA102 : public ClockedStripConfig {
+		APA102()
+			: ClockedStripConfig(
+					BGR,
+					APA102_CLOCK_SPEED,
+					false)
+		{}
+	};
+
+	struct SK9822 : public ClockedStripConfig {
+		SK9822()
+			: ClockedStripConfig(
+					BGR,
+					SK9822_CLOCK_SPEED,
+					true)
+		{}
+	};
+
+	struct E131 : public NetworkStripConfig {
+		E131(const char* address, uint16_t universe = 1)
+			: NetworkStripConfig(NetworkProtocol::E131, address, universe)
+		{}
+	};
+
+	struct ArtNet : public NetworkStripConfig {
+		ArtNet(const char* address, uint16_t universe = 0)
+			: NetworkStripConfig(NetworkProtocol::ARTNET, address, universe)
+		{}
+	};
+
+	struct DDP : public NetworkStripConfig {
+		DDP(const char* address)
+			: NetworkStripConfig(NetworkProtocol::DDP, address, 0)
 		{}
 	};
 }
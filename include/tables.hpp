@@ -0,0 +1,134 @@
+#ifndef PIXLED_DRIVER_TABLES_H
+#define PIXLED_DRIVER_TABLES_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pixel.hpp"
+#include "converters.hpp"
+
+namespace pixled {
+	/*
+	 * C++11 compatible constexpr helpers. Functions are limited to a single
+	 * return statement, so loops are written as recursions.
+	 */
+	namespace detail {
+		template<std::size_t... I>
+			struct index_sequence {};
+
+		template<std::size_t N, std::size_t... I>
+			struct make_index_sequence : make_index_sequence<N-1, N-1, I...> {};
+
+		template<std::size_t... I>
+			struct make_index_sequence<0, I...> {
+				typedef index_sequence<I...> type;
+			};
+
+		template<typename T, typename Generator, std::size_t... I>
+			constexpr std::array<T, sizeof...(I)> make_table(const Generator& generator, index_sequence<I...>) {
+				return {{ generator(I)... }};
+			}
+
+		constexpr double LN2 = 0.69314718055994530942;
+
+		/*
+		 * sum(z^(2k+1) / (2k+1)) for k in [n;20[, with term = z^(2n+1).
+		 */
+		constexpr double atanh_series(double z2, double term, unsigned int n) {
+			return n >= 20 ? 0.0 : term / (2*n+1) + atanh_series(z2, term * z2, n+1);
+		}
+
+		/*
+		 * Natural logarithm of x > 0. x is reduced to [1;2[, where
+		 * ln(m) = 2*atanh((m-1)/(m+1)) converges quickly.
+		 */
+		constexpr double ln(double x, int exponent = 0) {
+			return x >= 2.0 ? ln(x / 2.0, exponent + 1) :
+				x < 1.0 ? ln(x * 2.0, exponent - 1) :
+				exponent * LN2 + 2.0 * atanh_series(
+						((x-1)/(x+1)) * ((x-1)/(x+1)), (x-1)/(x+1), 0);
+		}
+
+		/*
+		 * sum(y^k / k!) for k in [n;16[, with term = y^n / n!.
+		 */
+		constexpr double exp_series(double y, double term, unsigned int n) {
+			return n >= 16 ? 0.0 : term + exp_series(y, term * y / (n+1), n+1);
+		}
+
+		constexpr double square(double x) {
+			return x * x;
+		}
+
+		/*
+		 * Exponential, computed as exp(y/2)^2 until |y| <= 0.5.
+		 */
+		constexpr double exp(double y) {
+			return y > 0.5 || y < -0.5 ? square(exp(y / 2.0)) : exp_series(y, 1.0, 0);
+		}
+
+		constexpr double pow(double base, double exponent) {
+			return base <= 0.0 ? 0.0 : exp(exponent * ln(base));
+		}
+	}
+
+	/**
+	 * Builds an `N` entries table, where entry `i` is `generator(i)`.
+	 *
+	 * The function is constexpr when `generator` is a literal type with a
+	 * constexpr `operator()(std::size_t)`, so that the table can be computed at
+	 * compile time and stored in flash :
+	 * ```cpp
+	 * static constexpr std::array<uint8_t, 256> gamma
+	 *     = make_table<uint8_t, 256>(GammaCurve(2.2));
+	 * ```
+	 *
+	 * @param generator entry generator
+	 * @return table of `N` entries
+	 */
+	template<typename T, std::size_t N, typename Generator>
+		constexpr std::array<T, N> make_table(const Generator& generator) {
+			return detail::make_table<T>(generator, typename detail::make_index_sequence<N>::type());
+		}
+
+	/**
+	 * Gamma correction curve, mapping an 8 bits component `i` to
+	 * `round(255 * (i/255)^gamma)`.
+	 *
+	 * The constexpr computation is accurate to less than 1e-9 before
+	 * rounding, so tables are identical to the ones computed with std::pow().
+	 */
+	class GammaCurve {
+		private:
+			double gamma;
+
+		public:
+			constexpr GammaCurve(double gamma) : gamma(gamma) {}
+
+			constexpr uint8_t operator()(std::size_t value) const {
+				return (uint8_t) (255.0 * detail::pow(value / 255.0, gamma) + 0.5);
+			}
+	};
+
+	/**
+	 * Color wheel of `size` colors, with evenly spaced hues, computed with
+	 * FastHsbToRgbConverter.
+	 */
+	class HueWheel {
+		private:
+			std::size_t size;
+			uint8_t saturation;
+			uint8_t brightness;
+
+		public:
+			constexpr HueWheel(std::size_t size, uint8_t saturation = 255, uint8_t brightness = 255)
+				: size(size), saturation(saturation), brightness(brightness) {}
+
+			constexpr rgb_pixel operator()(std::size_t index) const {
+				return FastHsbToRgbConverter::convert(
+						(uint16_t) (index * 65536 / size), saturation, brightness);
+			}
+	};
+}
+#endif
@@ -0,0 +1,189 @@
+#ifndef PIXLED_DRIVER_TRACE_H
+#define PIXLED_DRIVER_TRACE_H
+
+#include <cstdint>
+#include <cstdio>
+
+/*
+ * Span instrumentation of the library. Spans are only recorded when the
+ * library is built with PIXLED_TRACE defined (e.g.
+ * `target_compile_definitions(${COMPONENT_LIB} PUBLIC PIXLED_TRACE)`) :
+ * otherwise PIXLED_TRACE_SPAN() expands to nothing.
+ *
+ * This header does not depend on ESP-IDF, so that traces can also be
+ * recorded and dumped from a host build.
+ */
+
+#define PIXLED_TRACE_CONCAT_(a, b) a##b
+#define PIXLED_TRACE_CONCAT(a, b) PIXLED_TRACE_CONCAT_(a, b)
+
+#ifdef PIXLED_TRACE
+/**
+ * Records a span named `name` (a string literal), from this statement to the
+ * end of the enclosing scope.
+ */
+#define PIXLED_TRACE_SPAN(name) \
+	pixled::TraceSpan PIXLED_TRACE_CONCAT(pixled_trace_span_, __LINE__) {name}
+/**
+ * Starts a span named `name`, that ends at the matching
+ * PIXLED_TRACE_END(id) or at the end of the enclosing scope.
+ */
+#define PIXLED_TRACE_BEGIN(id, name) pixled::TraceSpan pixled_trace_##id {name}
+/**
+ * Ends the span started with PIXLED_TRACE_BEGIN(id, ...).
+ */
+#define PIXLED_TRACE_END(id) pixled_trace_##id.end()
+#else
+#define PIXLED_TRACE_SPAN(name) do {} while(0)
+#define PIXLED_TRACE_BEGIN(id, name) do {} while(0)
+#define PIXLED_TRACE_END(id) do {} while(0)
+#endif
+
+namespace pixled {
+	/**
+	 * A span recorded by the Trace.
+	 */
+	struct trace_event {
+		/**
+		 * Name of the span. Must have a static lifetime.
+		 */
+		const char* name;
+		/**
+		 * Start of the span, in microseconds.
+		 */
+		int64_t start;
+		/**
+		 * Duration of the span, in microseconds.
+		 */
+		uint32_t duration;
+		/**
+		 * Task (or thread) that recorded the span.
+		 */
+		uint32_t thread;
+		/**
+		 * Core on which the span ended.
+		 */
+		uint8_t core;
+	};
+
+	/**
+	 * Global recorder of spans, exported as Chrome trace JSON.
+	 *
+	 * Spans are written to a ring buffer of fixed capacity : when it is
+	 * full, the oldest spans are overwritten. Recording is lock-free and can
+	 * be performed from any task and any core : each writer reserves a slot
+	 * with a single atomic increment, and each slot has a sequence number so
+	 * that dump() skips slots that are being written.
+	 *
+	 * The JSON output can be opened in chrome://tracing or
+	 * https://ui.perfetto.dev. Each core is shown as a process, and each task
+	 * as a thread.
+	 *
+	 * Example usage :
+	 * ```
+	 * Trace::start(2048);
+	 * // ... render and show some frames
+	 * Trace::dump(stdout); // copy the console output to a .json file
+	 * ```
+	 */
+	class Trace {
+		public:
+			/**
+			 * Allocates a ring buffer of `capacity` spans, and starts
+			 * recording.
+			 *
+			 * Must not be called while spans are recorded by other tasks.
+			 */
+			static void start(uint32_t capacity = 1024);
+
+			/**
+			 * Stops recording. Recorded spans are kept for dump().
+			 */
+			static void stop();
+
+			/**
+			 * @return true if spans are currently recorded
+			 */
+			static bool enabled();
+
+			/**
+			 * @return current time, in microseconds
+			 */
+			static int64_t now();
+
+			/**
+			 * Records a span. Does nothing if the trace is not enabled.
+			 *
+			 * @param name name of the span, with a static lifetime
+			 * @param start start of the span, from now()
+			 * @param end end of the span, from now()
+			 */
+			static void record(const char* name, int64_t start, int64_t end);
+
+			/**
+			 * @return count of spans currently retained in the ring buffer
+			 */
+			static uint32_t eventCount();
+
+			/**
+			 * @return count of spans overwritten because the ring buffer was
+			 * full
+			 */
+			static uint32_t overwrittenCount();
+
+			/**
+			 * Copies the retained span at `index`, from the oldest one.
+			 *
+			 * @return false if the span is being written
+			 */
+			static bool event(uint32_t index, trace_event& event);
+
+			/**
+			 * Writes all the retained spans as Chrome trace JSON.
+			 *
+			 * Recording should be stopped first, so that no span is
+			 * overwritten during the dump.
+			 *
+			 * @param output output file, e.g. stdout to dump on the console
+			 * @return count of written spans
+			 */
+			static uint32_t dump(FILE* output);
+
+			/**
+			 * Removes all the spans and releases the ring buffer.
+			 *
+			 * Must not be called while spans are recorded by other tasks.
+			 */
+			static void clear();
+	};
+
+	/**
+	 * Records a span from its construction to its destruction. See
+	 * PIXLED_TRACE_SPAN().
+	 */
+	class TraceSpan {
+		private:
+			const char* name;
+			int64_t start;
+
+		public:
+			TraceSpan(const char* name) : name(name), start(Trace::enabled() ? Trace::now() : -1) {}
+
+			TraceSpan(const TraceSpan&) = delete;
+			TraceSpan& operator=(const TraceSpan&) = delete;
+
+			/**
+			 * Ends the span before the destruction.
+			 */
+			void end() {
+				if(start >= 0)
+					Trace::record(name, start, Trace::now());
+				start = -1;
+			}
+
+			~TraceSpan() {
+				end();
+			}
+	};
+}
+#endif
@@ -0,0 +1,158 @@
+#ifndef PIXLED_DRIVER_TRANSITION_H
+#define PIXLED_DRIVER_TRANSITION_H
+
+#include <cstdint>
+
+#include "strip.hpp"
+
+namespace pixled {
+	/**
+	 * Progression of a Transition over time.
+	 */
+	enum class Easing {
+		/**
+		 * Constant speed.
+		 */
+		LINEAR,
+		/**
+		 * Starts slowly, then accelerates (quadratic).
+		 */
+		EASE_IN,
+		/**
+		 * Starts quickly, then decelerates (quadratic).
+		 */
+		EASE_OUT,
+		/**
+		 * Starts and ends slowly (smoothstep).
+		 */
+		EASE_IN_OUT
+	};
+
+	/**
+	 * Crossfade between two frames of a strip.
+	 *
+	 * Source and target frames are captured from the strip buffer. When the
+	 * transition is started, the bytes that differ between both frames are
+	 * listed with a 16.16 fixed-point increment. Each step then only updates
+	 * those bytes, directly in the strip buffer : with a LINEAR easing, each
+	 * step costs a single add per changing byte, and pixels that are equal in
+	 * both frames are not processed at all.
+	 *
+	 * Since each byte of the buffer is interpolated independently, the color
+	 * order of the strip does not matter. Strips which bytes are not 8 bits
+	 * components (16 bits strips, indexed strips) can't be used.
+	 *
+	 * Example usage :
+	 * ```
+	 * Transition transition {strip};
+	 * scene_a.draw(strip);
+	 * transition.captureSource();
+	 * scene_b.draw(strip);
+	 * transition.captureTarget();
+	 *
+	 * transition.start(150, Easing::EASE_IN_OUT);
+	 * while(transition.step()) {
+	 *     strip.show();
+	 *     vTaskDelay(20 / portTICK_PERIOD_MS);
+	 * }
+	 * ```
+	 */
+	class Transition {
+		public:
+			/**
+			 * Maximum count of steps of a transition, so that rounding
+			 * errors of the increments never reach half a unit.
+			 */
+			static const uint16_t MAX_STEPS = 32768;
+
+		private:
+			Strip& strip;
+			uint32_t size;
+			uint8_t* source;
+			uint8_t* target;
+
+			uint32_t* offsets;
+			int32_t* values;
+			int32_t* increments;
+			uint32_t active_count;
+
+			uint16_t steps;
+			uint16_t current_step;
+			uint16_t position;
+			Easing easing;
+
+			uint16_t easedPosition(uint16_t step) const;
+
+		public:
+			/**
+			 * Transition constructor.
+			 *
+			 * All the memory used by the transition is allocated here.
+			 * Captured frames are initialized to black.
+			 *
+			 * @param strip strip to which the transition is applied
+			 */
+			Transition(Strip& strip);
+
+			Transition(const Transition&) = delete;
+			Transition(Transition&&) = delete;
+			Transition& operator=(const Transition&) = delete;
+			Transition& operator=(Transition&&) = delete;
+
+			/**
+			 * Copies the current strip buffer as the source frame.
+			 */
+			void captureSource();
+			/**
+			 * Copies the current strip buffer as the target frame.
+			 */
+			void captureTarget();
+
+			/**
+			 * Source frame, in the strip buffer format.
+			 */
+			uint8_t* sourceFrame() {return source;}
+			/**
+			 * Target frame, in the strip buffer format.
+			 */
+			uint8_t* targetFrame() {return target;}
+
+			/**
+			 * Starts a transition from the source frame to the target frame.
+			 *
+			 * The source frame is written to the strip buffer, and increments
+			 * are computed for each byte that differs between both frames.
+			 *
+			 * @param steps count of steps of the transition, in
+			 * [1;MAX_STEPS]
+			 * @param easing progression of the transition
+			 */
+			void start(uint16_t steps, Easing easing = Easing::LINEAR);
+
+			/**
+			 * Advances the transition by one step, and writes the
+			 * interpolated frame to the strip buffer.
+			 *
+			 * The last step writes exactly the target frame.
+			 *
+			 * The LEDs are not actually updated until a call to strip.show().
+			 *
+			 * @return false if the transition was already finished, in which
+			 * case nothing is written
+			 */
+			bool step();
+
+			/**
+			 * @return true if all the steps have been performed
+			 */
+			bool done() const {return current_step >= steps;}
+
+			/**
+			 * @return count of bytes updated at each step
+			 */
+			uint32_t activeCount() const {return active_count;}
+
+			~Transition();
+	};
+}
+#endif
@@ -0,0 +1,79 @@
+#ifndef PIXLED_DRIVER_TRANSPOSE_H
+#define PIXLED_DRIVER_TRANSPOSE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pixled {
+	/**
+	 * Bit transposition kernels, used to drive several strips in parallel.
+	 *
+	 * Parallel outputs send a single word at each clock cycle, where bit `s`
+	 * drives strip `s`. The per-strip byte buffers must then be converted to
+	 * bit slices : for each byte position, 8 words where bit `s` of word
+	 * `b` is bit `7 - b` of the byte of strip `s` (MSB first).
+	 *
+	 * Those kernels only use integer arithmetic and do not depend on any
+	 * driver.
+	 */
+	namespace transpose {
+		/**
+		 * Transposes an 8x8 bit matrix, where row `r` is the byte `r` of
+		 * `x` (bits 8r to 8r+7).
+		 *
+		 * Bit `c` of byte `r` of the result is bit `r` of byte `c` of `x`.
+		 */
+		inline uint64_t transpose8(uint64_t x) {
+			uint64_t t;
+			t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAull;
+			x = x ^ t ^ (t << 7);
+			t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCull;
+			x = x ^ t ^ (t << 14);
+			t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ull;
+			x = x ^ t ^ (t << 28);
+			return x;
+		}
+
+		/**
+		 * Transposes `size` bytes of up to 16 byte buffers into 16 bits
+		 * slices.
+		 *
+		 * For each byte position `i`, 8 words are written, MSB first, with
+		 * a distance of `stride` words between consecutive words. Bits of
+		 * strips with an index greater than or equal to `input_count` are
+		 * set to 0.
+		 *
+		 * @param inputs byte buffers, one for each strip
+		 * @param input_count number of buffers, at most 16
+		 * @param offset position of the first byte to transpose in each
+		 * buffer
+		 * @param size number of bytes to transpose in each buffer
+		 * @param output first output word, `8 * size * stride` words are
+		 * written
+		 * @param stride distance between two consecutive output words
+		 */
+		void bits16(
+				const uint8_t* const* inputs, uint8_t input_count,
+				uint32_t offset, uint32_t size, uint16_t* output, uint8_t stride = 1);
+
+		/**
+		 * Transposes `size` bytes of up to 8 byte buffers into 8 bits
+		 * slices.
+		 *
+		 * Same as bits16(), for outputs with at most 8 data lines.
+		 *
+		 * @param inputs byte buffers, one for each strip
+		 * @param input_count number of buffers, at most 8
+		 * @param offset position of the first byte to transpose in each
+		 * buffer
+		 * @param size number of bytes to transpose in each buffer
+		 * @param output first output word, `8 * size * stride` words are
+		 * written
+		 * @param stride distance between two consecutive output words
+		 */
+		void bits8(
+				const uint8_t* const* inputs, uint8_t input_count,
+				uint32_t offset, uint32_t size, uint8_t* output, uint8_t stride = 1);
+	}
+}
+#endif
@@ -0,0 +1,120 @@
+#include <cassert>
+#include <cstring>
+
+#include "esp_timer.h"
+#include "esp_attr.h"
+#include "boot_frame.hpp"
+
+static const char* PIXLED_LOG_TAG = "PIXLED_DRIVER";
+
+namespace pixled {
+	uint32_t BootFrame::length() const {
+		uint32_t length = 0;
+		for(uint32_t i = 0; i < run_count; i++)
+			length += runs[i].count;
+		return length;
+	} // length
+
+	BootFrame::EncodeState BootFrame::encodeState(const StripConfig& config) const {
+		EncodeState state;
+		state.bit0.level0 = 1;
+		state.bit0.duration0 = config.t0h;
+		state.bit0.level1 = 0;
+		state.bit0.duration1 = config.t0l;
+		state.bit1.level0 = 1;
+		state.bit1.duration0 = config.t1h;
+		state.bit1.level1 = 0;
+		state.bit1.duration1 = config.t1l;
+		state.pixel_size = pixel_size;
+		state.pixel = 0;
+		state.byte = 0;
+		return state;
+	} // encodeState
+
+	/**
+	 * Expands runs to RMT items, one byte (8 items) at a time.
+	 */
+	void IRAM_ATTR BootFrame::encode(EncodeState& state, const void* data, size_t size,
+			rmt_item32_t* dest, size_t wanted_num, size_t* translated_size, size_t* item_num) {
+		const boot_run* run = static_cast<const boot_run*>(data);
+		const boot_run* end = run + size / sizeof(boot_run);
+		size_t num = 0;
+		while(run < end && num + 8 <= wanted_num) {
+			if(state.pixel >= run->count) {
+				state.pixel = 0;
+				run++;
+				continue;
+			}
+			const uint8_t byte = run->bytes[state.byte];
+			for(uint8_t mask = 0x80; mask != 0; mask >>= 1)
+				dest[num++] = (byte & mask) ? state.bit1 : state.bit0;
+			if(++state.byte == state.pixel_size) {
+				state.byte = 0;
+				state.pixel++;
+			}
+		}
+		// Completes the current run if all its pixels are encoded, so that
+		// the driver does not call the translator again only to skip it
+		if(run < end && state.pixel >= run->count) {
+			state.pixel = 0;
+			run++;
+		}
+		*translated_size = (run - static_cast<const boot_run*>(data)) * sizeof(boot_run);
+		*item_num = num;
+	} // encode
+
+	void IRAM_ATTR BootFrame::translate(const void* src, rmt_item32_t* dest, size_t src_size,
+			size_t wanted_num, size_t* translated_size, size_t* item_num) {
+		void* state;
+		rmt_translator_get_context(item_num, &state);
+		encode(*static_cast<EncodeState*>(state), src, src_size, dest, wanted_num, translated_size, item_num);
+	} // translate
+
+	/**
+	 * Transmits the frame with a temporary RMT driver installation.
+	 *
+	 * esp_timer starts counting early in the boot, before app_main(), so
+	 * its value is used as the time elapsed since boot.
+	 */
+	int64_t BootFrame::show(gpio_num_t gpio_num, rmt_channel_t channel, const StripConfig& config) const {
+		assert(pixel_size <= 4);
+		rmt_config_t rmt;
+		std::memset(&rmt, 0, sizeof(rmt));
+		rmt.rmt_mode = RMT_MODE_TX;
+		rmt.channel = channel;
+		rmt.gpio_num = gpio_num;
+		rmt.mem_block_num = 1;
+		rmt.clk_div = config.clk_div;
+		rmt.tx_config.idle_output_en = 1;
+		rmt.tx_config.idle_level = RMT_IDLE_LEVEL_LOW;
+
+		ESP_ERROR_CHECK(rmt_config(&rmt));
+		ESP_ERROR_CHECK(rmt_driver_install(channel, 0, 0));
+
+		EncodeState state = encodeState(config);
+		ESP_ERROR_CHECK(rmt_translator_init(channel, translate));
+		ESP_ERROR_CHECK(rmt_translator_set_context(channel, &state));
+		ESP_ERROR_CHECK(rmt_write_sample(channel, reinterpret_cast<const uint8_t*>(runs),
+					run_count * sizeof(boot_run), true /* wait till done */));
+		const int64_t first_light = esp_timer_get_time();
+
+		ESP_ERROR_CHECK(rmt_driver_uninstall(channel));
+		ESP_LOGI(PIXLED_LOG_TAG, "Boot frame shown %lld us after boot", (long long) first_light);
+		return first_light;
+	} // show
+
+	void BootFrame::copyTo(Strip& strip) const {
+		assert(strip.pixelSize() == pixel_size);
+		uint8_t* output = strip.buffer();
+		uint32_t remaining = strip.length();
+		for(uint32_t i = 0; i < run_count && remaining > 0; i++) {
+			const uint32_t count = runs[i].count < remaining ? runs[i].count : remaining;
+			for(uint32_t j = 0; j < count; j++) {
+				std::memcpy(output, runs[i].bytes, pixel_size);
+				output += pixel_size;
+			}
+			remaining -= count;
+		}
+		strip.markChanged();
+	} // copyTo
+}
@@ -0,0 +1,35 @@
+#include <cstring>
+
+#include "clocked_frame.hpp"
+
+namespace pixled {
+	uint32_t ClockedFrame::endFrameSize(uint32_t pixel_count, bool reset_frame) {
+		// pixel_count / 2 bits, rounded up to bytes
+		return (reset_frame ? RESET_FRAME_SIZE : 0) + (pixel_count + 15) / 16;
+	} // endFrameSize
+
+	uint32_t ClockedFrame::frameSize(uint32_t pixel_count, bool reset_frame) {
+		return START_FRAME_SIZE + LED_FRAME_SIZE * pixel_count + endFrameSize(pixel_count, reset_frame);
+	} // frameSize
+
+	ClockedFrame::ClockedFrame(uint8_t* data, uint32_t pixel_count, bool reset_frame)
+		: _data(data), pixel_count(pixel_count), _size(frameSize(pixel_count, reset_frame)) {
+			std::memset(_data, 0, START_FRAME_SIZE);
+			std::memset(
+					&_data[START_FRAME_SIZE + LED_FRAME_SIZE * pixel_count],
+					0, endFrameSize(pixel_count, reset_frame));
+			clear();
+		} // ClockedFrame
+
+	void ClockedFrame::clear(uint8_t brightness) {
+		uint8_t* led = pixels();
+		const uint8_t header = 0xE0 | (brightness > MAX_BRIGHTNESS ? MAX_BRIGHTNESS : brightness);
+		for(uint32_t i = 0; i < pixel_count; i++) {
+			led[0] = header;
+			led[1] = 0;
+			led[2] = 0;
+			led[3] = 0;
+			led += LED_FRAME_SIZE;
+		}
+	} // clear
+}
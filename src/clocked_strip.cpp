@@ -0,0 +1,196 @@
+#include <cstdlib>
+#include <cstring>
+
+#include "esp_heap_caps.h"
+#include "clocked_strip.hpp"
+
+static const char* PIXLED_LOG_TAG = "PIXLED_DRIVER";
+
+namespace pixled {
+	/*
+	 * Number of strips using each SPI host, and whether the bus of the host
+	 * was initialized by one of them.
+	 */
+	static uint8_t bus_strips[SPI_HOST_MAX];
+	static bool bus_owned[SPI_HOST_MAX];
+
+	/*
+	 * Allocates a DMA capable frame buffer, and returns the address of its
+	 * first led frame, used as the Strip buffer.
+	 *
+	 * As with the `new` allocation of other strips, running out of DMA
+	 * memory is fatal.
+	 */
+	static uint8_t* allocate_frame(uint32_t pixel_count, bool reset_frame) {
+		const uint32_t size = ClockedFrame::frameSize(pixel_count, reset_frame);
+		uint8_t* frame = static_cast<uint8_t*>(heap_caps_malloc(size, MALLOC_CAP_DMA));
+		if(frame == nullptr) {
+			ESP_LOGE(PIXLED_LOG_TAG, "Unable to allocate a DMA frame of %u bytes",
+					(unsigned int) size);
+			std::abort();
+		}
+		return frame + ClockedFrame::START_FRAME_SIZE;
+	}
+
+	/**
+	 * ClockedStrip constructor.
+	 *
+	 * Initializes the SPI bus `host` with DMA, and adds the strip to it. If
+	 * the bus is already initialized, by another ClockedStrip or by the
+	 * application, it is used as is : `data_gpio` and `clock_gpio` are then
+	 * ignored, and the bus must accept transfers of frame().size() bytes.
+	 *
+	 * Errors are logged, and leave the strip disabled : show() then does
+	 * nothing.
+	 *
+	 * Predefined configurations are available for the following clocked LED
+	 * strip models :
+	 * - APA102
+	 * - SK9822
+	 *
+	 * All the leds are initialized to black, at maximum brightness.
+	 *
+	 * @param data_gpio GPIO connected to the data input of the strip
+	 * @param clock_gpio GPIO connected to the clock input of the strip
+	 * @param pixel_count Number of leds.
+	 * @param host SPI host to use (SPI2_HOST or SPI3_HOST)
+	 * @param config clocked strip config
+	 */
+	ClockedStrip::ClockedStrip(gpio_num_t data_gpio, gpio_num_t clock_gpio, uint32_t pixel_count,
+			spi_host_device_t host, ClockedStripConfig config)
+		: Strip(pixel_count, ClockedFrame::LED_FRAME_SIZE, allocate_frame(pixel_count, config.reset_frame)),
+		clocked_strip_config(config), host(host), device(nullptr),
+		_frame(this->_buffer - ClockedFrame::START_FRAME_SIZE, pixel_count, config.reset_frame) {
+			spi_bus_config_t bus_config;
+			std::memset(&bus_config, 0, sizeof(bus_config));
+			bus_config.mosi_io_num = data_gpio;
+			bus_config.miso_io_num = -1;
+			bus_config.sclk_io_num = clock_gpio;
+			bus_config.quadwp_io_num = -1;
+			bus_config.quadhd_io_num = -1;
+			bus_config.max_transfer_sz = _frame.size();
+			esp_err_t err = spi_bus_initialize(host, &bus_config, SPI_DMA_CH_AUTO);
+			if(err == ESP_OK) {
+				bus_owned[host] = true;
+			} else if(err != ESP_ERR_INVALID_STATE) {
+				// ESP_ERR_INVALID_STATE : the bus is already initialized
+				ESP_LOGE(PIXLED_LOG_TAG, "Unable to initialize the SPI bus : %s", esp_err_to_name(err));
+				return;
+			}
+
+			spi_device_interface_config_t device_config;
+			std::memset(&device_config, 0, sizeof(device_config));
+			device_config.mode = 0;
+			device_config.clock_speed_hz = config.clock_speed;
+			device_config.spics_io_num = -1;
+			device_config.queue_size = 1;
+			err = spi_bus_add_device(host, &device_config, &device);
+			if(err != ESP_OK) {
+				ESP_LOGE(PIXLED_LOG_TAG, "Unable to add the SPI device : %s", esp_err_to_name(err));
+				device = nullptr;
+			} else {
+				bus_strips[host]++;
+			}
+			if(device == nullptr && bus_strips[host] == 0 && bus_owned[host]) {
+				bus_owned[host] = false;
+				spi_bus_free(host);
+			}
+		} // ClockedStrip
+
+	/**
+	 * ClockedStrip constructor with a default SPI host set to SPI2_HOST.
+	 */
+	ClockedStrip::ClockedStrip(gpio_num_t data_gpio, gpio_num_t clock_gpio, uint32_t pixel_count,
+			ClockedStripConfig config)
+		: ClockedStrip(data_gpio, clock_gpio, pixel_count, SPI2_HOST, config) {
+		}
+
+	/**
+	 * Transmits the frame to the strip.
+	 *
+	 * The frame buffer is read by the SPI DMA, so no encoding is required.
+	 */
+	void ClockedStrip::show() {
+		if(device == nullptr || !frameChanged())
+			return;
+		spi_transaction_t transaction;
+		std::memset(&transaction, 0, sizeof(transaction));
+		transaction.length = _frame.size() * 8; // In bits
+		transaction.tx_buffer = _frame.data();
+		PIXLED_TRACE_SPAN("spi transmit");
+		esp_err_t err = spi_device_transmit(device, &transaction);
+		if(err != ESP_OK)
+			ESP_LOGE(PIXLED_LOG_TAG, "Transmission failed : %s", esp_err_to_name(err));
+	} // show
+
+	void ClockedStrip::setRgbPixel(uint32_t index, uint8_t red, uint8_t green, uint8_t blue) {
+		markWritten();
+		clocked_strip_config.serializer.serialize({red, green, blue}, &_buffer[4*index+1]);
+	} // setRgbPixel
+
+	void ClockedStrip::setHsbPixel(uint32_t index, float hue, float saturation, float brightness) {
+		markWritten();
+		clocked_strip_config.serializer.serialize(
+				hsb_to_rgb({hue, saturation, brightness}),
+				&_buffer[4*index+1]);
+	} // setHsbPixel
+
+	void ClockedStrip::setRgbPixels(uint32_t index, const rgb_pixel* pixels, uint32_t count) {
+		PIXLED_TRACE_SPAN("setRgbPixels");
+		markWritten();
+		uint8_t* output = &_buffer[4*index+1];
+		for(uint32_t i = 0; i < count; i++) {
+			clocked_strip_config.serializer.serialize(pixels[i], output);
+			output+=4;
+		}
+	} // setRgbPixels
+
+	void ClockedStrip::fillRgb(uint32_t index, uint32_t count, const rgb_pixel& color) {
+		PIXLED_TRACE_SPAN("fillRgb");
+		markWritten();
+		uint8_t serialized[3];
+		clocked_strip_config.serializer.serialize(color, serialized);
+		uint8_t* output = &_buffer[4*index+1];
+		for(uint32_t i = 0; i < count; i++) {
+			std::memcpy(output, serialized, 3);
+			output+=4;
+		}
+	} // fillRgb
+
+	void ClockedStrip::setBrightness(uint8_t brightness) {
+		markWritten();
+		for(uint32_t i = 0; i < this->pixel_count; i++)
+			_frame.setBrightness(i, brightness);
+	} // setBrightness
+
+	void ClockedStrip::clear() {
+		markWritten();
+		for(uint32_t i = 0; i < this->pixel_count; i++) {
+			_buffer[4*i+1] = 0;
+			_buffer[4*i+2] = 0;
+			_buffer[4*i+3] = 0;
+		}
+	} // clear
+
+	/**
+	 * ClockedStrip destructor.
+	 *
+	 * The SPI device is removed and the frame buffer is deleted. The SPI bus
+	 * is freed with its last strip, only if it was initialized by a
+	 * ClockedStrip.
+	 */
+	ClockedStrip::~ClockedStrip() {
+		if(device != nullptr) {
+			esp_err_t err = spi_bus_remove_device(device);
+			if(err != ESP_OK)
+				ESP_LOGE(PIXLED_LOG_TAG, "Unable to remove the SPI device : %s", esp_err_to_name(err));
+			if(--bus_strips[host] == 0 && bus_owned[host]) {
+				bus_owned[host] = false;
+				err = spi_bus_free(host);
+				if(err != ESP_OK)
+					ESP_LOGE(PIXLED_LOG_TAG, "Unable to free the SPI bus : %s", esp_err_to_name(err));
+			}
+		}
+		heap_caps_free(_frame.data());
+	} // ~ClockedStrip
+}
@@ -0,0 +1,151 @@
+#include <cstring>
+
+#include "compositor.hpp"
+
+namespace pixled {
+	namespace blend {
+		/*
+		 * Rounded division by 255 of a value in [0;65535].
+		 */
+		static inline uint16_t div255(uint16_t value) {
+			value += 128;
+			return (value + (value >> 8)) >> 8;
+		}
+
+		/*
+		 * Linear interpolation from `from` to `to`, with alpha in [0;255].
+		 */
+		static inline uint8_t mix(uint8_t from, uint8_t to, uint8_t alpha) {
+			return div255(from * (255 - alpha) + to * alpha);
+		}
+
+		void normal(uint8_t* dst, const uint8_t* src, const uint8_t* alpha, size_t count) {
+			for(size_t i = 0; i < count; i++)
+				dst[i] = mix(dst[i], src[i], alpha[i]);
+		} // normal
+
+		void add(uint8_t* dst, const uint8_t* src, const uint8_t* alpha, size_t count) {
+			for(size_t i = 0; i < count; i++) {
+				uint16_t sum = dst[i] + div255(src[i] * alpha[i]);
+				dst[i] = sum > 255 ? 255 : sum;
+			}
+		} // add
+
+		void multiply(uint8_t* dst, const uint8_t* src, const uint8_t* alpha, size_t count) {
+			for(size_t i = 0; i < count; i++)
+				dst[i] = mix(dst[i], div255(dst[i] * src[i]), alpha[i]);
+		} // multiply
+
+		void max(uint8_t* dst, const uint8_t* src, const uint8_t* alpha, size_t count) {
+			for(size_t i = 0; i < count; i++)
+				dst[i] = mix(dst[i], dst[i] > src[i] ? dst[i] : src[i], alpha[i]);
+		} // max
+	}
+
+	/**
+	 * Compositor constructor.
+	 *
+	 * All the layers are initialized to black, fully opaque, in NORMAL mode.
+	 *
+	 * @param length number of pixels of each layer
+	 * @param layer_count number of layers
+	 * @param pixel_alpha if true, a per-pixel alpha buffer is allocated for
+	 * each layer, initialized to 255
+	 */
+	Compositor::Compositor(uint32_t length, uint8_t layer_count, bool pixel_alpha)
+		: _length(length), layer_count(layer_count), layers(new Layer[layer_count]) {
+			for(uint8_t i = 0; i < layer_count; i++) {
+				layers[i].pixels = new rgb_pixel[length];
+				std::memset(layers[i].pixels, 0, length * sizeof(rgb_pixel));
+				if(pixel_alpha) {
+					layers[i].alpha = new uint8_t[length];
+					std::memset(layers[i].alpha, 255, length);
+				} else {
+					layers[i].alpha = nullptr;
+				}
+				layers[i].opacity = 255;
+				layers[i].mode = BlendMode::NORMAL;
+				layers[i].visible = true;
+			}
+		} // Compositor
+
+	/*
+	 * Composes `count` pixels, starting at `index`, into `output`.
+	 *
+	 * `count` must not exceed BLOCK_SIZE.
+	 */
+	void Compositor::composeBlock(uint32_t index, uint16_t count, rgb_pixel* output) const {
+		uint8_t* dst = reinterpret_cast<uint8_t*>(output);
+		const size_t bytes = 3 * count;
+		uint8_t alpha[3 * BLOCK_SIZE];
+
+		std::memset(dst, 0, bytes);
+		for(uint8_t l = 0; l < layer_count; l++) {
+			const Layer& layer = layers[l];
+			if(!layer.visible || layer.opacity == 0)
+				continue;
+			const uint8_t* src = reinterpret_cast<const uint8_t*>(&layer.pixels[index]);
+
+			if(layer.alpha == nullptr) {
+				if(layer.mode == BlendMode::NORMAL && layer.opacity == 255) {
+					std::memcpy(dst, src, bytes);
+					continue;
+				}
+				std::memset(alpha, layer.opacity, bytes);
+			} else {
+				for(uint16_t i = 0; i < count; i++) {
+					uint8_t a = blend::div255(layer.alpha[index + i] * layer.opacity);
+					alpha[3*i] = a;
+					alpha[3*i+1] = a;
+					alpha[3*i+2] = a;
+				}
+			}
+
+			switch(layer.mode) {
+				case BlendMode::ADD:
+					blend::add(dst, src, alpha, bytes);
+					break;
+				case BlendMode::MULTIPLY:
+					blend::multiply(dst, src, alpha, bytes);
+					break;
+				case BlendMode::MAX:
+					blend::max(dst, src, alpha, bytes);
+					break;
+				case BlendMode::NORMAL:
+				default:
+					blend::normal(dst, src, alpha, bytes);
+					break;
+			}
+		}
+	} // composeBlock
+
+	void Compositor::compose(rgb_pixel* output) const {
+		for(uint32_t index = 0; index < _length; index += BLOCK_SIZE) {
+			uint16_t count = _length - index < BLOCK_SIZE ? _length - index : BLOCK_SIZE;
+			composeBlock(index, count, &output[index]);
+		}
+	} // compose
+
+	void Compositor::compose(Strip& strip, uint32_t offset) const {
+		PIXLED_TRACE_SPAN("compose");
+		rgb_pixel block[BLOCK_SIZE];
+		for(uint32_t index = 0; index < _length; index += BLOCK_SIZE) {
+			uint16_t count = _length - index < BLOCK_SIZE ? _length - index : BLOCK_SIZE;
+			composeBlock(index, count, block);
+			strip.setRgbPixels(offset + index, block, count);
+		}
+	} // compose
+
+	/**
+	 * Compositor destructor.
+	 *
+	 * All the layer buffers are deleted.
+	 */
+	Compositor::~Compositor() {
+		for(uint8_t i = 0; i < layer_count; i++) {
+			delete[] layers[i].pixels;
+			delete[] layers[i].alpha;
+		}
+		delete[] layers;
+	} // ~Compositor
+}
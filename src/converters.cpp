@@ -1,107 +1,298 @@
 #include "converters.hpp"
-#include <algorithm>
+#include "tables.hpp"
 
 namespace pixled {
-	rgb_pixel HsbToRgbConverter::operator()(const hsb_pixel& pixel) const {
-		double      hh, p, q, t, ff;
-		long        i;
-		double      r_out;
-		double      g_out;
-		double 	    b_out;
-
-		float hue = pixel.hue;
-		float saturation = pixel.saturation;
-		float brightness = pixel.brightness;
-
-		if(saturation <= 0.0) {       // < is bogus, just shuts up warnings
-			r_out = brightness;
-			g_out = brightness;
-			b_out = brightness;
-			return rgb_pixel(r_out * 255, g_out * 255, b_out * 255);
+	void Rgb16ToRgbConverter::operator()(const rgb16_pixel* input, rgb_pixel* output, size_t count) const {
+		for(size_t i = 0; i < count; i++) {
+			output[i].red = convert(input[i].red);
+			output[i].green = convert(input[i].green);
+			output[i].blue = convert(input[i].blue);
 		}
-		hh = hue;
-		if(hh >= 360.0) hh = 0.0;
-		hh /= 60.0;
-		i = (long)hh;
-		ff = hh - i;
-		p = brightness * (1.0 - saturation);
-		q = brightness * (1.0 - (saturation * ff));
-		t = brightness * (1.0 - (saturation * (1.0 - ff)));
-
-		switch(i) {
-			case 0:
-				r_out = brightness;
-				g_out = t;
-				b_out = p;
-				break;
-			case 1:
-				r_out = q;
-				g_out = brightness;
-				b_out = p;
-				break;
-			case 2:
-				r_out = p;
-				g_out = brightness;
-				b_out = t;
-				break;
-
-			case 3:
-				r_out = p;
-				g_out = q;
-				b_out = brightness;
-				break;
-			case 4:
-				r_out = t;
-				g_out = p;
-				b_out = brightness;
-				break;
-			case 5:
-			default:
-				r_out = brightness;
-				g_out = p;
-				b_out = q;
-				break;
+	}
+
+	/*
+	 * Tables of the OKLab conversions, computed at compile time.
+	 */
+	namespace oklab {
+		constexpr double PI = 3.14159265358979323846;
+
+		/*
+		 * sum((-1)^k x^(2k+1) / (2k+1)!) for k in [n;12[, with term the
+		 * n-th term.
+		 */
+		constexpr double sin_series(double x2, double term, unsigned int n) {
+			return n >= 12 ? 0.0 : term + sin_series(x2, -term * x2 / ((2*n+2) * (2*n+3)), n+1);
+		}
+
+		/*
+		 * sum((-1)^k x^(2k+1) / (2k+1)) for k in [n;40[, for x in [0;1].
+		 * Only used for x <= tan(PI/8), see atan().
+		 */
+		constexpr double atan_series(double x2, double term, unsigned int n) {
+			return n >= 40 ? 0.0 : term / (2*n+1) + atan_series(x2, -term * x2, n+1);
+		}
+
+		/*
+		 * atan(x) = PI/4 + atan((x-1)/(x+1)), so that the series converges
+		 * quickly for x in [0;1].
+		 */
+		constexpr double atan(double x) {
+			return x <= 0.4142135623730950 ? atan_series(x * x, x, 0) :
+				PI / 4 + atan_series(((x-1)/(x+1)) * ((x-1)/(x+1)), (x-1)/(x+1), 0);
+		}
+
+		constexpr double srgb_to_linear(double c) {
+			return c <= 0.04045 ? c / 12.92 : detail::pow((c + 0.055) / 1.055, 2.4);
+		}
+
+		constexpr double linear_to_srgb(double l) {
+			return l <= 0.0031308 ? 12.92 * l : 1.055 * detail::pow(l, 1.0 / 2.4) - 0.055;
+		}
+
+		/*
+		 * Linear value of each sRGB component, scaled by 65535.
+		 */
+		struct SrgbToLinear {
+			constexpr uint16_t operator()(std::size_t value) const {
+				return (uint16_t) (65535.0 * srgb_to_linear(value / 255.0) + 0.5);
+			}
+		};
+
+		/*
+		 * sRGB component of the center of each linear interval of 16 values,
+		 * in 16 chunks of 256 entries (each make_table() instantiates one
+		 * template per entry).
+		 */
+		struct LinearToSrgb {
+			std::size_t offset;
+			constexpr LinearToSrgb(std::size_t offset) : offset(offset) {}
+			constexpr uint8_t operator()(std::size_t value) const {
+				return (uint8_t) (255.0 * linear_to_srgb(((offset + value) * 16 + 7.5) / 65535.0) + 0.5);
+			}
+		};
+		struct LinearToSrgbChunk {
+			constexpr std::array<uint8_t, 256> operator()(std::size_t chunk) const {
+				return make_table<uint8_t, 256>(LinearToSrgb(chunk * 256));
+			}
+		};
+
+		/*
+		 * Cube root of x in [1/8;1], scaled by 32768, for x = 1/8 + i/256.
+		 */
+		struct CubeRoot {
+			constexpr uint16_t operator()(std::size_t i) const {
+				return (uint16_t) (32768.0 * detail::pow(0.125 + i / 256.0, 1.0 / 3.0) + 0.5);
+			}
+		};
+
+		/*
+		 * Sine of a quarter turn, scaled by 32768.
+		 */
+		struct QuarterSine {
+			constexpr uint16_t operator()(std::size_t i) const {
+				return (uint16_t) (32768.0 * sin_series(
+							(PI / 2 * i / 256) * (PI / 2 * i / 256), PI / 2 * i / 256, 0) + 0.5);
+			}
+		};
+
+		/*
+		 * atan(i/256) for i in [0;256], with 65536 units per turn.
+		 */
+		struct Arctangent {
+			constexpr uint16_t operator()(std::size_t i) const {
+				return (uint16_t) (65536.0 / (2 * PI) * atan(i / 256.0) + 0.5);
+			}
+		};
+
+		static constexpr std::array<uint16_t, 256> srgb_to_linear_table
+			= make_table<uint16_t, 256>(SrgbToLinear());
+		static constexpr std::array<std::array<uint8_t, 256>, 16> linear_to_srgb_table
+			= make_table<std::array<uint8_t, 256>, 16>(LinearToSrgbChunk());
+		static constexpr std::array<uint16_t, 226> cube_root_table
+			= make_table<uint16_t, 226>(CubeRoot());
+		static constexpr std::array<uint16_t, 257> sine_table
+			= make_table<uint16_t, 257>(QuarterSine());
+		static constexpr std::array<uint16_t, 257> arctangent_table
+			= make_table<uint16_t, 257>(Arctangent());
+
+		/*
+		 * Cube root of x / 2^31, scaled by 32768, for x in [0;2^31].
+		 *
+		 * x is first multiplied by 8 until it is in [1/8;1] (which divides
+		 * the cube root by 2), then the cube root is linearly interpolated
+		 * between two entries of the table.
+		 */
+		static inline int32_t cube_root(uint32_t x) {
+			if(x == 0)
+				return 0;
+			uint8_t shift = 0;
+			while(x < (1u << 28)) {
+				x <<= 3;
+				shift++;
+			}
+			const uint32_t index = (x - (1u << 28)) >> 23;
+			const int32_t fraction = ((x - (1u << 28)) >> 15) & 0xFF;
+			const int32_t low = cube_root_table[index];
+			const int32_t root = low + (((cube_root_table[index + 1] - low) * fraction + 128) >> 8);
+			return shift == 0 ? root : (root + (1 << (shift - 1))) >> shift;
+		}
+
+		static inline int32_t clamp(int32_t value, int32_t min, int32_t max) {
+			return value < min ? min : value > max ? max : value;
+		}
+
+		/*
+		 * sRGB component of a linear value scaled by 65536.
+		 */
+		static inline uint8_t encode(int32_t linear) {
+			linear = clamp(linear, 0, 65535);
+			return linear_to_srgb_table[linear >> 12][(linear >> 4) & 0xFF];
+		}
+
+		/*
+		 * Sine of `angle` (65536 units per turn), scaled by 32768.
+		 */
+		static inline int32_t sine(uint16_t angle) {
+			const uint16_t quadrant = angle >> 14;
+			uint32_t position = angle & 0x3FFF;
+			if(quadrant & 1)
+				position = 16384 - position;
+			const uint32_t index = position >> 6;
+			int32_t value = sine_table[index];
+			if(index < 256)
+				value += ((sine_table[index + 1] - value) * (int32_t) (position & 0x3F) + 32) >> 6;
+			return quadrant & 2 ? -value : value;
+		}
+
+		/*
+		 * Arctangent of `ratio` / 65536, for ratio in [0;65536], with 65536
+		 * units per turn.
+		 */
+		static inline uint32_t arctangent(uint32_t ratio) {
+			const uint32_t index = ratio >> 8;
+			int32_t value = arctangent_table[index];
+			if(index < 256)
+				value += ((arctangent_table[index + 1] - value) * (int32_t) (ratio & 0xFF) + 128) >> 8;
+			return value;
 		}
 
-		return rgb_pixel(r_out * 255, g_out * 255, b_out * 255);
+		static inline uint32_t square_root(uint32_t value) {
+			uint32_t root = 0;
+			uint32_t bit = 1u << 30;
+			while(bit > value)
+				bit >>= 2;
+			while(bit != 0) {
+				if(value >= root + bit) {
+					value -= root + bit;
+					root = (root >> 1) + bit;
+				} else {
+					root >>= 1;
+				}
+				bit >>= 2;
+			}
+			return root;
+		}
 	}
 
-	rgbw_pixel SimpleRgbToRgbwConverter::operator()(const rgb_pixel& pixel) const {
-		uint8_t white = std::min({pixel.red, pixel.green, pixel.blue});
-		return rgbw_pixel(
-				pixel.red - white,
-				pixel.green - white,
-				pixel.blue - white,
-				white
-				);
+	/**
+	 * Converts an sRGB color to OKLab.
+	 *
+	 * All the matrices of https://bottosson.github.io/posts/oklab/ are
+	 * rounded so that each row keeps its exact sum (white stays white, and
+	 * greys have null a and b).
+	 */
+	oklab_pixel RgbToOklabConverter::convert(const rgb_pixel& pixel) {
+		using namespace oklab;
+		// Linear components, scaled by 65535
+		const uint32_t r = srgb_to_linear_table[pixel.red];
+		const uint32_t g = srgb_to_linear_table[pixel.green];
+		const uint32_t b = srgb_to_linear_table[pixel.blue];
+		// Cone responses, with 15 bits coefficients (at most 2^31 for
+		// white), and their cube roots scaled by 32768
+		const int32_t l = cube_root(13508 * r + 17574 * g + 1686 * b);
+		const int32_t m = cube_root(6944 * r + 22305 * g + 3519 * b);
+		const int32_t s = cube_root(2894 * r + 9231 * g + 20643 * b);
+		// 13 bits coefficients
+		return oklab_pixel(
+				clamp((1724 * l + 6501 * m - 33 * s + 4096) >> 13, 0, 32768),
+				clamp((16204 * l - 19895 * m + 3691 * s + 4096) >> 13, -32768, 32767),
+				clamp((212 * l + 6413 * m - 6625 * s + 4096) >> 13, -32768, 32767));
+	} // convert
+
+	void RgbToOklabConverter::operator()(const rgb_pixel* input, oklab_pixel* output, size_t count) const {
+		for(size_t i = 0; i < count; i++)
+			output[i] = convert(input[i]);
 	}
 
-	rgbw_pixel ComplexRgbToRgbwConverter::operator()(const rgb_pixel& pixel) const {
-		//Get the maximum between R, G, and B
-		float tM = std::max({pixel.red, pixel.green, pixel.blue});
+	/**
+	 * Converts an OKLab color to sRGB.
+	 *
+	 * Cone responses are clipped to [0;1[ before they are cubed, so that
+	 * the cubes fit in 32 bits.
+	 */
+	rgb_pixel OklabToRgbConverter::convert(const oklab_pixel& pixel) {
+		using namespace oklab;
+		const int32_t lightness = pixel.lightness;
+		// 14 bits coefficients
+		const uint32_t l = clamp(lightness + ((6494 * pixel.a + 3536 * pixel.b + 8192) >> 14), 0, 32767);
+		const uint32_t m = clamp(lightness + ((-1730 * pixel.a - 1046 * pixel.b + 8192) >> 14), 0, 32767);
+		const uint32_t s = clamp(lightness + ((-1466 * pixel.a - 21160 * pixel.b + 8192) >> 14), 0, 32767);
+		// Cubes scaled by 2^18
+		const int32_t l3 = (((l * l) >> 13) * l) >> 14;
+		const int32_t m3 = (((m * m) >> 13) * m) >> 14;
+		const int32_t s3 = (((s * s) >> 13) * s) >> 14;
+		// 16 bits coefficients : linear components of saturated colors are
+		// small differences of large products, that require 64 bits
+		return rgb_pixel(
+				encode((267173ll * l3 - 216774ll * m3 + 15137ll * s3 + (1 << 17)) >> 18),
+				encode((-83128ll * l3 + 171033ll * m3 - 22369ll * s3 + (1 << 17)) >> 18),
+				encode((-275ll * l3 - 46099ll * m3 + 111910ll * s3 + (1 << 17)) >> 18));
+	} // convert
 
-		//If the maximum value is 0, immediately return pure black.
-		if(tM == 0)
-		{ return rgbw_pixel(0, 0, 0, 0); }
+	void OklabToRgbConverter::operator()(const oklab_pixel* input, rgb_pixel* output, size_t count) const {
+		for(size_t i = 0; i < count; i++)
+			output[i] = convert(input[i]);
+	}
 
-		//This section serves to figure out what the color with 100% hue is
-		float multiplier = 255.0f / tM;
-		float hR = pixel.red * multiplier;
-		float hG = pixel.green * multiplier;
-		float hB = pixel.blue * multiplier;
+	oklch_pixel OklabToOklchConverter::convert(const oklab_pixel& pixel) {
+		using namespace oklab;
+		const int32_t a = pixel.a;
+		const int32_t b = pixel.b;
+		const uint32_t x = a < 0 ? -a : a;
+		const uint32_t y = b < 0 ? -b : b;
+		const uint32_t chroma = square_root(x * x + y * y);
+		if(chroma == 0)
+			return oklch_pixel(pixel.lightness, 0, 0);
+		// Angle in the first quadrant, from the octant
+		uint32_t hue = y <= x ? arctangent((y << 16) / x) : 16384 - arctangent((x << 16) / y);
+		if(a < 0)
+			hue = 32768 - hue;
+		if(b < 0)
+			hue = 65536 - hue;
+		return oklch_pixel(pixel.lightness, chroma, (uint16_t) hue);
+	} // convert
 
-		//This calculates the Whiteness (not strictly speaking Luminance) of the color
-		float M = std::max(hR, std::max(hG, hB));
-		float m = std::min(hR, std::min(hG, hB));
-		float Luminance = ((M + m) / 2.0f - 127.5f) * (255.0f/127.5f) / multiplier;
+	void OklabToOklchConverter::operator()(const oklab_pixel* input, oklch_pixel* output, size_t count) const {
+		for(size_t i = 0; i < count; i++)
+			output[i] = convert(input[i]);
+	}
 
-		//Calculate the output values
-		uint8_t Wo = Luminance;
-		uint8_t  Bo = pixel.blue - Luminance;
-		uint8_t  Ro = pixel.red - Luminance;
-		uint8_t  Go = pixel.green - Luminance;
+	oklab_pixel OklchToOklabConverter::convert(const oklch_pixel& pixel) {
+		using namespace oklab;
+		const int32_t chroma = pixel.chroma > 32767 ? 32767 : pixel.chroma;
+		return oklab_pixel(
+				pixel.lightness,
+				(chroma * sine(pixel.hue + 16384) + 16384) >> 15,
+				(chroma * sine(pixel.hue) + 16384) >> 15);
+	} // convert
 
-		return rgbw_pixel(Ro, Go, Bo, Wo);
+	void OklchToOklabConverter::operator()(const oklch_pixel* input, oklab_pixel* output, size_t count) const {
+		for(size_t i = 0; i < count; i++)
+			output[i] = convert(input[i]);
+	}
 
+	void OklchToRgbConverter::operator()(const oklch_pixel* input, rgb_pixel* output, size_t count) const {
+		for(size_t i = 0; i < count; i++)
+			output[i] = convert(input[i]);
 	}
 }
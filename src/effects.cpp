@@ -0,0 +1,225 @@
+#include <cstring>
+
+#include "effects.hpp"
+
+namespace pixled {
+	/*
+	 * Scales `value` by `scale`/256, where a scale of 255 leaves value
+	 * unchanged.
+	 */
+	static inline uint8_t scale8(uint8_t value, uint8_t scale) {
+		return (value * (scale + 1)) >> 8;
+	}
+
+	static inline rgb_pixel scale(const rgb_pixel& color, uint8_t scale) {
+		return rgb_pixel(scale8(color.red, scale), scale8(color.green, scale), scale8(color.blue, scale));
+	}
+
+	/**********/
+	/* Effect */
+	/**********/
+
+	void Effect::draw(Strip& strip, uint32_t offset) const {
+		PIXLED_TRACE_SPAN("render");
+		rgb_pixel block[BLOCK_SIZE];
+		for(uint32_t index = 0; index < _length; index += BLOCK_SIZE) {
+			uint16_t count = _length - index < BLOCK_SIZE ? _length - index : BLOCK_SIZE;
+			render(index, count, block);
+			strip.setRgbPixels(offset + index, block, count);
+		}
+	} // draw
+
+	/***********/
+	/* Rainbow */
+	/***********/
+
+	Rainbow::Rainbow(uint32_t length, uint16_t hue_step, uint16_t speed, uint8_t saturation, uint8_t brightness)
+		: Effect(length), hue(0),
+		hue_step(hue_step == 0 && length > 0 ? (length <= 65536 ? 65536 / length : 1) : hue_step),
+		speed(speed), saturation(saturation), brightness(brightness) {
+		}
+
+	void Rainbow::update() {
+		hue += speed;
+	} // update
+
+	void Rainbow::render(uint32_t index, uint32_t count, rgb_pixel* output) const {
+		uint16_t h = hue + index * hue_step;
+		for(uint32_t i = 0; i < count; i++) {
+			output[i] = hsb_to_rgb(h, saturation, brightness);
+			h += hue_step;
+		}
+	} // render
+
+	/*********/
+	/* Chase */
+	/*********/
+
+	Chase::Chase(uint32_t length, rgb_pixel color, uint8_t width, uint8_t spacing, uint16_t speed)
+		// A null spacing would divide by zero in render() and never end
+		// update() : both sizes are clamped to 1
+		: Effect(length), color(color), width(width > 0 ? width : 1), spacing(spacing > 0 ? spacing : 1),
+		speed(speed), position(0),
+		// Brightness decrease for each 1/256 pixel of the tail, in 16.16
+		fade_step((255 << 8) / this->width) {
+		}
+
+	void Chase::update() {
+		uint32_t period = spacing << 8;
+		uint32_t next = position + speed;
+		while(next >= period)
+			next -= period;
+		position = next;
+	} // update
+
+	void Chase::render(uint32_t index, uint32_t count, rgb_pixel* output) const {
+		const int32_t period = spacing << 8;
+		const int32_t tail = width << 8;
+
+		// Distance, in 8.8, from the pixel to the head of the segment in
+		// front of it
+		int32_t distance = position - ((index % spacing) << 8);
+		if(distance < 0)
+			distance += period;
+
+		for(uint32_t i = 0; i < count; i++) {
+			if(distance < tail)
+				output[i] = scale(color, 255 - ((distance * fade_step) >> 16));
+			else
+				output[i] = rgb_pixel(0, 0, 0);
+			distance -= 256;
+			if(distance < 0)
+				distance += period;
+		}
+	} // render
+
+	/********/
+	/* Fire */
+	/********/
+
+	Fire::Fire(uint32_t length, uint8_t cooling, uint8_t sparking, uint32_t seed)
+		: Effect(length), cooling(cooling), sparking(sparking),
+		_heat(new uint8_t[length]), random_state(seed == 0 ? 1 : seed) {
+			std::memset(_heat, 0, length);
+		}
+
+	/*
+	 * xorshift32 pseudo random generator.
+	 */
+	uint8_t Fire::random8() {
+		random_state ^= random_state << 13;
+		random_state ^= random_state >> 17;
+		random_state ^= random_state << 5;
+		return random_state >> 24;
+	} // random8
+
+	void Fire::update() {
+		if(_length == 0)
+			return;
+
+		// Cools down every cell a little (short strips cool faster)
+		uint32_t max_cooling = (cooling * 10u) / _length + 2;
+		if(max_cooling > 255)
+			max_cooling = 255;
+		for(uint32_t i = 0; i < _length; i++) {
+			uint8_t cooldown = random8() % max_cooling;
+			_heat[i] = _heat[i] > cooldown ? _heat[i] - cooldown : 0;
+		}
+
+		// Heat drifts up and diffuses a little
+		for(uint32_t k = _length - 1; k >= 2; k--)
+			_heat[k] = (_heat[k-1] + _heat[k-2] + _heat[k-2]) / 3;
+
+		// Randomly ignites new sparks near the bottom
+		if(random8() < sparking) {
+			uint16_t y = random8() % (_length < 7 ? _length : 7);
+			uint16_t heat = _heat[y] + 160 + random8() % 96;
+			_heat[y] = heat > 255 ? 255 : heat;
+		}
+	} // update
+
+	void Fire::render(uint32_t index, uint32_t count, rgb_pixel* output) const {
+		for(uint32_t i = 0; i < count; i++) {
+			// Scales heat to [0;191], and splits it in three ramps of 64
+			uint8_t t192 = scale8(_heat[index + i], 191);
+			uint8_t ramp = (t192 & 0x3F) << 2;
+			if(t192 & 0x80)
+				output[i] = rgb_pixel(255, 255, ramp);
+			else if(t192 & 0x40)
+				output[i] = rgb_pixel(255, ramp, 0);
+			else
+				output[i] = rgb_pixel(ramp, 0, 0);
+		}
+	} // render
+
+	Fire::~Fire() {
+		delete[] _heat;
+	} // ~Fire
+
+	/***********/
+	/* Twinkle */
+	/***********/
+
+	Twinkle::Twinkle(uint32_t length, rgb_pixel color, uint8_t density, uint16_t speed)
+		: Effect(length), color(color), density(density), speed(speed), time(0) {
+		}
+
+	void Twinkle::update() {
+		time += speed;
+	} // update
+
+	/*
+	 * Integer hash, used to derive stable pseudo random values from a pixel
+	 * index.
+	 */
+	static inline uint32_t hash(uint32_t value) {
+		value *= 2654435761u;
+		value ^= value >> 15;
+		value *= 0x2c1b3c6d;
+		value ^= value >> 12;
+		return value;
+	}
+
+	void Twinkle::render(uint32_t index, uint32_t count, rgb_pixel* output) const {
+		for(uint32_t i = 0; i < count; i++) {
+			uint32_t h = hash(index + i);
+			if((h & 0xFF) >= density) {
+				output[i] = rgb_pixel(0, 0, 0);
+				continue;
+			}
+			uint8_t rate = ((h >> 8) & 0x3) + 1;
+			uint16_t t = time * rate + (h >> 16);
+			uint8_t triangle = (t < 0x8000 ? t : 0xFFFF - t) >> 7;
+			output[i] = scale(color, (triangle * triangle) >> 8);
+		}
+	} // render
+
+	/************/
+	/* Gradient */
+	/************/
+
+	Gradient::Gradient(uint32_t length, rgb_pixel from, rgb_pixel to, uint16_t speed)
+		: Effect(length), from(from), to(to), speed(speed), phase(0),
+		phase_step(length > 1 ? 0x7FFF0000u / (length - 1) : 0) {
+		}
+
+	void Gradient::update() {
+		phase += speed << 16;
+	} // update
+
+	void Gradient::render(uint32_t index, uint32_t count, rgb_pixel* output) const {
+		uint32_t position = phase + index * phase_step;
+		for(uint32_t i = 0; i < count; i++) {
+			// Position between from (0) and to (65534)
+			const uint16_t p = position >> 16;
+			uint32_t f = (p < 0x8000 ? p : 0xFFFF - p) * 2;
+			uint32_t g = 65536 - f;
+			output[i] = rgb_pixel(
+					(from.red * g + to.red * f + 0x8000) >> 16,
+					(from.green * g + to.green * f + 0x8000) >> 16,
+					(from.blue * g + to.blue * f + 0x8000) >> 16
+					);
+			position += phase_step;
+		}
+	} // render
+}
@@ -0,0 +1,144 @@
+#include <cstring>
+
+#include "frame_cache.hpp"
+
+namespace pixled {
+	FrameCache::FrameCache(size_t budget)
+		: _budget(budget), memory_usage(0), first(nullptr), last(nullptr), entry_count(0),
+		_hits(0), _misses(0), _evictions(0) {
+		} // FrameCache
+
+	size_t FrameCache::entrySize(uint32_t item_count, uint32_t buffer_size) {
+		return sizeof(Entry) + item_count * sizeof(rmt_item32_t) + buffer_size;
+	} // entrySize
+
+	FrameCache::Entry* FrameCache::find(uint32_t key, bool by_id) const {
+		for(Entry* entry = first; entry != nullptr; entry = entry->next)
+			if(entry->key == key && entry->by_id == by_id)
+				return entry;
+		return nullptr;
+	} // find
+
+	void FrameCache::unlink(Entry* entry) {
+		if(entry->previous != nullptr)
+			entry->previous->next = entry->next;
+		else
+			first = entry->next;
+		if(entry->next != nullptr)
+			entry->next->previous = entry->previous;
+		else
+			last = entry->previous;
+	} // unlink
+
+	void FrameCache::pushFront(Entry* entry) {
+		entry->previous = nullptr;
+		entry->next = first;
+		if(first != nullptr)
+			first->previous = entry;
+		else
+			last = entry;
+		first = entry;
+	} // pushFront
+
+	void FrameCache::remove(Entry* entry) {
+		unlink(entry);
+		memory_usage -= entrySize(entry->item_count, entry->buffer_size);
+		entry_count--;
+		delete[] entry->items;
+		delete[] entry->buffer;
+		delete entry;
+	} // remove
+
+	/**
+	 * Looks up a frame, and moves it to the front of the LRU list on a hit.
+	 *
+	 * A frame identified by its content only hits if its item count and its
+	 * buffer copy are identical, so that hash collisions never transmit a
+	 * wrong frame.
+	 */
+	const rmt_item32_t* FrameCache::lookup(uint32_t key, bool by_id,
+			const uint8_t* buffer, uint32_t buffer_size, uint32_t item_count) {
+		Entry* entry = find(key, by_id);
+		if(entry == nullptr || entry->item_count != item_count
+				|| (!by_id && (entry->buffer_size != buffer_size
+						|| std::memcmp(entry->buffer, buffer, buffer_size) != 0))) {
+			_misses++;
+			return nullptr;
+		}
+		if(entry != first) {
+			unlink(entry);
+			pushFront(entry);
+		}
+		_hits++;
+		return entry->items;
+	} // lookup
+
+	bool FrameCache::insert(uint32_t key, bool by_id, bool pinned,
+			const uint8_t* buffer, uint32_t buffer_size,
+			const rmt_item32_t* items, uint32_t item_count) {
+		// A stale frame with the same key is replaced
+		Entry* previous = find(key, by_id);
+		if(previous != nullptr) {
+			pinned = pinned || previous->pinned;
+			remove(previous);
+		}
+
+		if(by_id)
+			buffer_size = 0;
+		const size_t size = entrySize(item_count, buffer_size);
+		if(size > _budget)
+			return false;
+		// Evicts unpinned frames, from the least recently used
+		Entry* candidate = last;
+		while(memory_usage + size > _budget && candidate != nullptr) {
+			Entry* next_candidate = candidate->previous;
+			if(!candidate->pinned) {
+				remove(candidate);
+				_evictions++;
+			}
+			candidate = next_candidate;
+		}
+		if(memory_usage + size > _budget)
+			return false;
+
+		Entry* entry = new Entry;
+		entry->key = key;
+		entry->by_id = by_id;
+		entry->pinned = pinned;
+		entry->item_count = item_count;
+		entry->items = new rmt_item32_t[item_count];
+		std::memcpy(entry->items, items, item_count * sizeof(rmt_item32_t));
+		entry->buffer_size = buffer_size;
+		entry->buffer = nullptr;
+		if(buffer_size > 0) {
+			entry->buffer = new uint8_t[buffer_size];
+			std::memcpy(entry->buffer, buffer, buffer_size);
+		}
+		pushFront(entry);
+		memory_usage += size;
+		entry_count++;
+		return true;
+	} // insert
+
+	bool FrameCache::pin(uint32_t frame_id, bool pinned) {
+		Entry* entry = find(frame_id, true);
+		if(entry == nullptr)
+			return false;
+		entry->pinned = pinned;
+		return true;
+	} // pin
+
+	void FrameCache::clear() {
+		while(first != nullptr)
+			remove(first);
+	} // clear
+
+	/**
+	 * FrameCache destructor.
+	 *
+	 * All the cached frames are deleted.
+	 */
+	FrameCache::~FrameCache() {
+		clear();
+	} // ~FrameCache
+}
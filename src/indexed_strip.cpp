@@ -0,0 +1,326 @@
+#include <cstring>
+
+#include "esp_attr.h"
+#include "indexed_strip.hpp"
+
+namespace pixled {
+	/****************/
+	/* IndexedStrip */
+	/****************/
+
+	/**
+	 * IndexedStrip constructor.
+	 *
+	 * Because IndexedStrip is abstract, this constructor should not be used
+	 * directly, but will be call by implementing classes (IndexedRgbStrip,
+	 * IndexedRgbwStrip).
+	 *
+	 * All the palette entries are initialized to black.
+	 *
+	 * @param gpio_num Led Strip GPIO.
+	 * @param pixel_count Number of leds.
+	 * @param channel RMT channel to use.
+	 * @param palette_size count of colors in the palette
+	 * @param entry_size bytes sent to each led (3 for RGB, 4 for RGBW)
+	 * @param config strip config
+	 */
+	IndexedStrip::IndexedStrip(
+			gpio_num_t gpio_num, uint32_t pixel_count, rmt_channel_t channel,
+			PaletteSize palette_size, uint8_t entry_size, StripConfig config)
+		: Strip(
+				gpio_num, pixel_count, 1, new uint8_t[pixel_count],
+				channel, allocateItems(config, pixel_count * entry_size * 8 + 1), config),
+		stream_component(0),
+		palette_size(static_cast<uint16_t>(palette_size)),
+		entry_size(entry_size),
+		palette(new uint8_t[static_cast<uint16_t>(palette_size) * entry_size]),
+		palette_colors(new rgb_pixel[static_cast<uint16_t>(palette_size)]),
+		encoded_palette(palette_size == PaletteSize::PALETTE_16 ?
+				new rmt_item32_t[16 * entry_size * 8] : nullptr) {
+			for(uint8_t nibble = 0; nibble < 16; nibble++) {
+				for(uint8_t bit = 0; bit < 4; bit++) {
+					if(nibble & (0x8 >> bit))
+						setItem1(&nibble_items[nibble][bit]);
+					else
+						setItem0(&nibble_items[nibble][bit]);
+				}
+			}
+
+			const uint8_t black[4] = {0, 0, 0, 0};
+			for(uint16_t entry = 0; entry < this->palette_size; entry++)
+				setPaletteEntry(entry, black, rgb_pixel(0, 0, 0));
+			clear();
+			if(config.transmit_mode == TransmitMode::STREAMING) {
+				ESP_ERROR_CHECK(rmt_translator_init(channel, translate));
+				ESP_ERROR_CHECK(rmt_translator_set_context(channel, this));
+			}
+		} // IndexedStrip
+
+	void IndexedStrip::setPaletteEntry(uint8_t entry, const uint8_t* serialized, const rgb_pixel& color) {
+		if(entry >= palette_size)
+			return;
+		std::memcpy(&palette[entry * entry_size], serialized, entry_size);
+		palette_colors[entry] = color;
+		markChanged();
+		invalidateFrameCache();
+
+		if(encoded_palette != nullptr) {
+			rmt_item32_t* item = &encoded_palette[entry * entry_size * 8];
+			for(uint8_t i = 0; i < entry_size; i++) {
+				std::memcpy(item, nibble_items[serialized[i] >> 4], sizeof(nibble_items[0]));
+				std::memcpy(item + 4, nibble_items[serialized[i] & 0x0F], sizeof(nibble_items[0]));
+				item += 8;
+			}
+		}
+	} // setPaletteEntry
+
+	/**
+	 * Transmits the current buffer to the strip.
+	 *
+	 * Each palette index is directly expanded to pre-encoded RMT items.
+	 */
+	void IndexedStrip::show() {
+		if(!frameChanged())
+			return;
+		const uint16_t bits = entry_size * 8;
+		const uint32_t prefix = changedPrefix(bits);
+		if(prefix == 0)
+			return;
+		if(strip_config.transmit_mode == TransmitMode::STREAMING) {
+			stream_component = 0;
+			writeSample(_buffer, prefix);
+			return;
+		}
+		if(transmitCachedFrame(this->pixel_count * bits))
+			return;
+		PIXLED_TRACE_BEGIN(encode, "encode");
+		rmt_item32_t* pCurrentItem = this->rmt_items;
+		const uint32_t encoded = encodedPixels(prefix);
+
+		if(encoded_palette != nullptr) {
+			// 16 colors palette : a single copy of pre-encoded items for each
+			// pixel
+			for(uint32_t i = 0; i < encoded; i++) {
+				std::memcpy(pCurrentItem, &encoded_palette[(_buffer[i] & 0x0F) * bits], bits * sizeof(rmt_item32_t));
+				pCurrentItem += bits;
+			}
+		} else {
+			// 256 colors palette : fully pre-encoded entries would use too much
+			// memory, so serialized entries are expanded half byte by half byte
+			for(uint32_t i = 0; i < encoded; i++) {
+				const uint8_t* entry = &palette[_buffer[i] * entry_size];
+				for(uint8_t j = 0; j < entry_size; j++) {
+					std::memcpy(pCurrentItem, nibble_items[entry[j] >> 4], sizeof(nibble_items[0]));
+					std::memcpy(pCurrentItem + 4, nibble_items[entry[j] & 0x0F], sizeof(nibble_items[0]));
+					pCurrentItem += 8;
+				}
+			}
+		}
+		setTerminator(pCurrentItem); // Write the RMT terminator.
+		PIXLED_TRACE_END(encode);
+
+		// Show the pixels.
+		writeItems(encoded * bits);
+	} // show
+
+	/**
+	 * Expands indexes, as requested by the RMT driver.
+	 *
+	 * Each byte of a palette entry is copied from the pre-encoded palette
+	 * (16 colors palettes), or expanded half byte by half byte (256 colors
+	 * palettes).
+	 *
+	 * @param strip indexed strip being transmitted
+	 * @param data next index to expand, in the strip buffer
+	 * @param size count of indexes remaining in the buffer
+	 * @param dest items to write
+	 * @param wanted_num maximum count of items to write
+	 * @param translated_size count of expanded indexes
+	 * @param item_num count of written items
+	 */
+	void IRAM_ATTR IndexedStrip::encodeIndexes(IndexedStrip& strip, const uint8_t* data, size_t size,
+			rmt_item32_t* dest, size_t wanted_num, size_t* translated_size, size_t* item_num) {
+		const uint16_t bits = strip.entry_size * 8;
+		size_t translated = 0;
+		size_t num = 0;
+		while(translated < size && num + 8 <= wanted_num) {
+			const uint8_t component = strip.stream_component;
+			if(strip.encoded_palette != nullptr) {
+				std::memcpy(&dest[num], &strip.encoded_palette[(data[translated] & 0x0F) * bits + component * 8],
+						8 * sizeof(rmt_item32_t));
+			} else {
+				const uint8_t byte = strip.palette[data[translated] * strip.entry_size + component];
+				std::memcpy(&dest[num], strip.nibble_items[byte >> 4], sizeof(strip.nibble_items[0]));
+				std::memcpy(&dest[num + 4], strip.nibble_items[byte & 0x0F], sizeof(strip.nibble_items[0]));
+			}
+			num += 8;
+			if(++strip.stream_component == strip.entry_size) {
+				strip.stream_component = 0;
+				translated++;
+			}
+		}
+		*translated_size = translated;
+		*item_num = num;
+	} // encodeIndexes
+
+	void IRAM_ATTR IndexedStrip::translate(const void* src, rmt_item32_t* dest, size_t src_size,
+			size_t wanted_num, size_t* translated_size, size_t* item_num) {
+		void* context;
+		rmt_translator_get_context(item_num, &context);
+		encodeIndexes(*static_cast<IndexedStrip*>(context), static_cast<const uint8_t*>(src), src_size,
+				dest, wanted_num, translated_size, item_num);
+	} // translate
+
+	uint8_t IndexedStrip::closestEntry(const rgb_pixel& color) const {
+		uint8_t closest = 0;
+		uint32_t closest_distance = UINT32_MAX;
+		for(uint16_t entry = 0; entry < palette_size; entry++) {
+			const rgb_pixel& candidate = palette_colors[entry];
+			int32_t dr = candidate.red - color.red;
+			int32_t dg = candidate.green - color.green;
+			int32_t db = candidate.blue - color.blue;
+			uint32_t distance = dr*dr + dg*dg + db*db;
+			if(distance < closest_distance) {
+				closest = entry;
+				closest_distance = distance;
+				if(distance == 0)
+					break;
+			}
+		}
+		return closest;
+	} // closestEntry
+
+	/**
+	 * Sets the led at position `index` to the palette entry closest to the
+	 * specified RGB color.
+	 */
+	void IndexedStrip::setRgbPixel(uint32_t index, uint8_t red, uint8_t green, uint8_t blue) {
+		markWritten();
+		_buffer[index] = closestEntry({red, green, blue});
+	} // setRgbPixel
+
+	/**
+	 * Sets the led at position `index` to the palette entry closest to the
+	 * specified HSB color.
+	 */
+	void IndexedStrip::setHsbPixel(uint32_t index, float hue, float saturation, float brightness) {
+		markWritten();
+		_buffer[index] = closestEntry(hsb_to_rgb({hue, saturation, brightness}));
+	} // setHsbPixel
+
+	void IndexedStrip::setRgbPixels(uint32_t index, const rgb_pixel* pixels, uint32_t count) {
+		PIXLED_TRACE_SPAN("setRgbPixels");
+		markWritten();
+		for(uint32_t i = 0; i < count; i++)
+			_buffer[index + i] = closestEntry(pixels[i]);
+	} // setRgbPixels
+
+	void IndexedStrip::fillRgb(uint32_t index, uint32_t count, const rgb_pixel& color) {
+		PIXLED_TRACE_SPAN("fillRgb");
+		fillIndex(index, count, closestEntry(color));
+	} // fillRgb
+
+	bool IndexedStrip::fillIndex(uint32_t index, uint32_t count, uint8_t entry) {
+		if(entry >= palette_size)
+			return false;
+		markWritten();
+		std::memset(&_buffer[index], entry, count);
+		return true;
+	} // fillIndex
+
+	void IndexedStrip::clear() {
+		markWritten();
+		std::memset(_buffer, 0, pixel_count);
+	} // clear
+
+	/**
+	 * IndexedStrip destructor.
+	 *
+	 * The internal buffer and the palette are deleted.
+	 */
+	IndexedStrip::~IndexedStrip() {
+		delete[] this->_buffer;
+		delete[] palette;
+		delete[] palette_colors;
+		delete[] encoded_palette;
+	} // ~IndexedStrip
+
+	/*******************/
+	/* IndexedRgbStrip */
+	/*******************/
+
+	/**
+	 * IndexedRgbStrip constructor.
+	 *
+	 * @param gpio_num Led Strip GPIO.
+	 * @param pixel_count Number of leds.
+	 * @param channel RMT channel to use.
+	 * @param palette_size count of colors in the palette
+	 * @param config RGB strip config
+	 */
+	IndexedRgbStrip::IndexedRgbStrip(gpio_num_t gpio_num, uint32_t pixel_count, rmt_channel_t channel,
+			PaletteSize palette_size, RgbStripConfig config)
+		: IndexedStrip(gpio_num, pixel_count, channel, palette_size, 3, config),
+		rgb_strip_config(config) {
+		}
+
+	/**
+	 * IndexedRgbStrip constructor with a default RMT channel set to
+	 * RMT_CHANNEL_0.
+	 */
+	IndexedRgbStrip::IndexedRgbStrip(gpio_num_t gpio_num, uint32_t pixel_count, PaletteSize palette_size, RgbStripConfig config)
+		: IndexedRgbStrip(gpio_num, pixel_count, RMT_CHANNEL_0, palette_size, config) {
+		}
+
+	void IndexedRgbStrip::setPaletteColor(uint8_t entry, const rgb_pixel& color) {
+		uint8_t serialized[3];
+		rgb_strip_config.serializer.serialize(color, serialized);
+		setPaletteEntry(entry, serialized, color);
+	} // setPaletteColor
+
+	/********************/
+	/* IndexedRgbwStrip */
+	/********************/
+
+	/**
+	 * IndexedRgbwStrip constructor.
+	 *
+	 * @param gpio_num Led Strip GPIO.
+	 * @param pixel_count Number of leds.
+	 * @param channel RMT channel to use.
+	 * @param palette_size count of colors in the palette
+	 * @param config RGBW strip config
+	 */
+	IndexedRgbwStrip::IndexedRgbwStrip(gpio_num_t gpio_num, uint32_t pixel_count, rmt_channel_t channel,
+			PaletteSize palette_size, RgbwStripConfig config)
+		: IndexedStrip(gpio_num, pixel_count, channel, palette_size, 4, config),
+		rgbw_strip_config(config) {
+		}
+
+	/**
+	 * IndexedRgbwStrip constructor with a default RMT channel set to
+	 * RMT_CHANNEL_0.
+	 */
+	IndexedRgbwStrip::IndexedRgbwStrip(gpio_num_t gpio_num, uint32_t pixel_count, PaletteSize palette_size, RgbwStripConfig config)
+		: IndexedRgbwStrip(gpio_num, pixel_count, RMT_CHANNEL_0, palette_size, config) {
+		}
+
+	void IndexedRgbwStrip::setPaletteColor(uint8_t entry, const rgb_pixel& color) {
+		uint8_t serialized[4];
+		rgbw_strip_config.serializer.serialize(rgb_to_rgbw(color), serialized);
+		setPaletteEntry(entry, serialized, color);
+	} // setPaletteColor
+
+	void IndexedRgbwStrip::setPaletteColor(uint8_t entry, const rgbw_pixel& color) {
+		uint8_t serialized[4];
+		rgbw_strip_config.serializer.serialize(color, serialized);
+		// Approximate RGB equivalent, used to select the closest color
+		uint16_t red = color.red + color.white;
+		uint16_t green = color.green + color.white;
+		uint16_t blue = color.blue + color.white;
+		setPaletteEntry(entry, serialized, rgb_pixel(
+					red > 255 ? 255 : red,
+					green > 255 ? 255 : green,
+					blue > 255 ? 255 : blue));
+	} // setPaletteColor
+}
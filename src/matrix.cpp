@@ -0,0 +1,285 @@
+#include "matrix.hpp"
+
+namespace pixled {
+	/****************/
+	/* MatrixLayout */
+	/****************/
+
+	uint16_t MatrixLayout::index(uint16_t x, uint16_t y) const {
+		uint16_t tile_x = x / panel_width;
+		uint16_t tile_y = y / panel_height;
+		uint16_t px = x % panel_width;
+		uint16_t py = y % panel_height;
+
+		// Coordinates and dimensions of the panel before rotation
+		uint16_t native_x;
+		uint16_t native_y;
+		uint16_t native_width;
+		switch(rotation) {
+			case MatrixRotation::ROTATION_90:
+				native_width = panel_height;
+				native_x = py;
+				native_y = panel_width - 1 - px;
+				break;
+			case MatrixRotation::ROTATION_180:
+				native_width = panel_width;
+				native_x = panel_width - 1 - px;
+				native_y = panel_height - 1 - py;
+				break;
+			case MatrixRotation::ROTATION_270:
+				native_width = panel_height;
+				native_x = panel_height - 1 - py;
+				native_y = px;
+				break;
+			case MatrixRotation::ROTATION_0:
+			default:
+				native_width = panel_width;
+				native_x = px;
+				native_y = py;
+				break;
+		}
+
+		if(wiring == MatrixWiring::SERPENTINE && native_y % 2 == 1)
+			native_x = native_width - 1 - native_x;
+		if(tile_wiring == MatrixWiring::SERPENTINE && tile_y % 2 == 1)
+			tile_x = tiles_x - 1 - tile_x;
+
+		uint16_t tile = tile_y * tiles_x + tile_x;
+		return tile * panel_width * panel_height + native_y * native_width + native_x;
+	} // index
+
+	/**********/
+	/* Matrix */
+	/**********/
+
+	/*
+	 * Splits a row of strip indexes into runs of consecutive indexes.
+	 *
+	 * Runs are written to `output`, unless it is null.
+	 *
+	 * @return count of runs in the row
+	 */
+	static uint16_t buildRuns(const uint16_t* row, uint16_t width, Matrix::run* output) {
+		uint16_t count = 0;
+		Matrix::run current {0, 1, row[0], false};
+		for(uint16_t x = 1; x < width; x++) {
+			int step = row[x] - row[x-1];
+			if(current.length == 1 && (step == 1 || step == -1)) {
+				current.reversed = (step == -1);
+				current.length++;
+			} else if(current.length > 1 && step == (current.reversed ? -1 : 1)) {
+				current.length++;
+			} else {
+				if(output)
+					output[count] = current;
+				count++;
+				current = {x, 1, row[x], false};
+			}
+		}
+		if(output)
+			output[count] = current;
+		return count + 1;
+	} // buildRuns
+
+	/**
+	 * Matrix constructor.
+	 *
+	 * The XY lookup table and the runs of each row are computed once for all,
+	 * so that no layout computation is required afterwards.
+	 *
+	 * @param strip strip on which the matrix is wired
+	 * @param layout physical wiring of the matrix
+	 * @param offset index of the first led of the matrix on the strip
+	 */
+	Matrix::Matrix(Strip& strip, MatrixLayout layout, uint16_t offset)
+		: strip(strip), _layout(layout), _width(layout.width()), _height(layout.height()),
+		xy_lookup(new uint16_t[layout.width() * layout.height()]),
+		row_runs(new uint16_t[layout.height() + 1]) {
+			for(uint16_t y = 0; y < _height; y++)
+				for(uint16_t x = 0; x < _width; x++)
+					xy_lookup[y * _width + x] = offset + _layout.index(x, y);
+
+			uint16_t run_count = 0;
+			for(uint16_t y = 0; y < _height; y++)
+				run_count += buildRuns(&xy_lookup[y * _width], _width, nullptr);
+
+			runs = new run[run_count];
+			row_runs[0] = 0;
+			for(uint16_t y = 0; y < _height; y++)
+				row_runs[y+1] = row_runs[y] + buildRuns(&xy_lookup[y * _width], _width, &runs[row_runs[y]]);
+		} // Matrix
+
+	const Matrix::run* Matrix::rowRuns(uint16_t y, uint16_t& count) const {
+		count = row_runs[y+1] - row_runs[y];
+		return &runs[row_runs[y]];
+	} // rowRuns
+
+	/*
+	 * Returns the run of row `y` that contains column `x`.
+	 */
+	static const Matrix::run* findRun(const Matrix::run* row, uint16_t count, uint16_t x) {
+		uint16_t low = 0;
+		uint16_t high = count;
+		while(high - low > 1) {
+			uint16_t middle = (low + high) / 2;
+			if(row[middle].x <= x)
+				low = middle;
+			else
+				high = middle;
+		}
+		return &row[low];
+	} // findRun
+
+	/*
+	 * Returns the lowest strip index of the `length` pixels starting at column
+	 * `x` in the run.
+	 */
+	static uint16_t lowIndex(const Matrix::run& run, uint16_t x, uint16_t length) {
+		if(run.reversed)
+			return run.index - (x - run.x) - (length - 1);
+		return run.index + (x - run.x);
+	} // lowIndex
+
+	void Matrix::setRgbPixel(uint16_t x, uint16_t y, uint8_t red, uint8_t green, uint8_t blue) {
+		strip.setRgbPixel(index(x, y), red, green, blue);
+	} // setRgbPixel
+
+	void Matrix::fillRowSegment(uint16_t y, uint16_t x, uint16_t length, const rgb_pixel& color) {
+		uint16_t count;
+		const run* row = rowRuns(y, count);
+		uint16_t end = x + length;
+		for(const run* r = row; r < row + count; r++) {
+			uint16_t begin = r->x > x ? r->x : x;
+			uint16_t stop = r->x + r->length < end ? r->x + r->length : end;
+			if(begin < stop)
+				strip.fillRgb(lowIndex(*r, begin, stop - begin), stop - begin, color);
+		}
+	} // fillRowSegment
+
+	void Matrix::fillRect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const rgb_pixel& color) {
+		if(x >= _width || y >= _height)
+			return;
+		if(width > _width - x)
+			width = _width - x;
+		if(height > _height - y)
+			height = _height - y;
+		for(uint16_t j = y; j < y + height; j++)
+			fillRowSegment(j, x, width, color);
+	} // fillRect
+
+	void Matrix::blit(uint16_t x, uint16_t y, const rgb_pixel* image, uint16_t width, uint16_t height) {
+		if(x >= _width || y >= _height)
+			return;
+		uint16_t visible_width = width > _width - x ? _width - x : width;
+		uint16_t visible_height = height > _height - y ? _height - y : height;
+		uint16_t end = x + visible_width;
+
+		for(uint16_t j = 0; j < visible_height; j++) {
+			const rgb_pixel* image_row = &image[j * width];
+			uint16_t count;
+			const run* row = rowRuns(y + j, count);
+			for(const run* r = row; r < row + count; r++) {
+				uint16_t begin = r->x > x ? r->x : x;
+				uint16_t stop = r->x + r->length < end ? r->x + r->length : end;
+				if(begin >= stop)
+					continue;
+				uint16_t low = lowIndex(*r, begin, stop - begin);
+				strip.setRgbPixels(low, &image_row[begin - x], stop - begin);
+				if(r->reversed)
+					strip.reversePixels(low, stop - begin);
+			}
+		}
+	} // blit
+
+	/*
+	 * Copies `length` pixels from (from_x, from_y) to (to_x, to_y), along the
+	 * rows.
+	 *
+	 * The segment is split into pieces that lie within a single run both in
+	 * the source and the destination rows, so that each piece is a single raw
+	 * copy in the strip buffer. When source and destination are on the same
+	 * row, pieces are processed in an order that does not overwrite source
+	 * pixels that have not been copied yet.
+	 */
+	void Matrix::copyRowSegment(uint16_t to_y, uint16_t to_x, uint16_t from_y, uint16_t from_x, uint16_t length) {
+		uint16_t to_count;
+		const run* to_row = rowRuns(to_y, to_count);
+		uint16_t from_count;
+		const run* from_row = rowRuns(from_y, from_count);
+
+		bool descending = (to_y == from_y) && (to_x > from_x);
+		uint16_t done = 0;
+		while(done < length) {
+			// Offset, from the start of the segment, of the column used to
+			// find the current runs
+			uint16_t offset = descending ? length - 1 - done : done;
+			const run* to_run = findRun(to_row, to_count, to_x + offset);
+			const run* from_run = findRun(from_row, from_count, from_x + offset);
+
+			uint16_t piece;
+			uint16_t piece_offset;
+			if(descending) {
+				piece = offset + 1;
+				if(to_x + offset - to_run->x + 1 < piece)
+					piece = to_x + offset - to_run->x + 1;
+				if(from_x + offset - from_run->x + 1 < piece)
+					piece = from_x + offset - from_run->x + 1;
+				piece_offset = offset + 1 - piece;
+			} else {
+				piece = length - offset;
+				if(to_run->x + to_run->length - (to_x + offset) < piece)
+					piece = to_run->x + to_run->length - (to_x + offset);
+				if(from_run->x + from_run->length - (from_x + offset) < piece)
+					piece = from_run->x + from_run->length - (from_x + offset);
+				piece_offset = offset;
+			}
+
+			uint16_t to_low = lowIndex(*to_run, to_x + piece_offset, piece);
+			uint16_t from_low = lowIndex(*from_run, from_x + piece_offset, piece);
+			strip.copyPixels(to_low, from_low, piece);
+			if(to_run->reversed != from_run->reversed)
+				strip.reversePixels(to_low, piece);
+			done += piece;
+		}
+	} // copyRowSegment
+
+	void Matrix::scroll(int16_t dx, int16_t dy, const rgb_pixel& fill) {
+		if(dx >= _width || -dx >= _width || dy >= _height || -dy >= _height) {
+			this->fill(fill);
+			return;
+		}
+
+		if(dx > 0) {
+			for(uint16_t y = 0; y < _height; y++) {
+				copyRowSegment(y, dx, y, 0, _width - dx);
+				fillRowSegment(y, 0, dx, fill);
+			}
+		} else if(dx < 0) {
+			for(uint16_t y = 0; y < _height; y++) {
+				copyRowSegment(y, 0, y, -dx, _width + dx);
+				fillRowSegment(y, _width + dx, -dx, fill);
+			}
+		}
+
+		if(dy > 0) {
+			for(uint16_t y = _height - 1; y >= dy; y--)
+				copyRowSegment(y, 0, y - dy, 0, _width);
+			fillRect(0, 0, _width, dy, fill);
+		} else if(dy < 0) {
+			for(uint16_t y = 0; y < _height + dy; y++)
+				copyRowSegment(y, 0, y - dy, 0, _width);
+			fillRect(0, _height + dy, _width, -dy, fill);
+		}
+	} // scroll
+
+	/**
+	 * Matrix destructor.
+	 *
+	 * The lookup tables are deleted. The underlying strip is left untouched.
+	 */
+	Matrix::~Matrix() {
+		delete[] xy_lookup;
+		delete[] runs;
+		delete[] row_runs;
+	} // ~Matrix
+}
@@ -0,0 +1,238 @@
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+
+#include "lwip/sockets.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "network_strip.hpp"
+
+static const char* PIXLED_LOG_TAG = "PIXLED_DRIVER";
+
+namespace pixled {
+	/*
+	 * Default E1.31 component identifier.
+	 */
+	static const uint8_t DEFAULT_CID[16] {
+		0x70, 0x69, 0x78, 0x6c, 0x65, 0x64, 0x2d, 0x64,
+		0x72, 0x69, 0x76, 0x65, 0x72, 0x00, 0x00, 0x01
+	};
+
+	/*
+	 * Art-Net data length must be even : odd packets are completed with this
+	 * byte.
+	 */
+	static uint8_t artnet_padding = 0;
+
+	static inline void write16(uint8_t* output, uint16_t value) {
+		output[0] = value >> 8;
+		output[1] = value;
+	}
+
+	static inline void write32(uint8_t* output, uint32_t value) {
+		output[0] = value >> 24;
+		output[1] = value >> 16;
+		output[2] = value >> 8;
+		output[3] = value;
+	}
+
+	NetworkStrip::NetworkStrip(uint32_t pixel_count, NetworkStripConfig config)
+		: RgbStrip(pixel_count, RgbStripConfig(config.serializer, 0, 0, 0, 0)),
+		network_config(config), sock(-1), destination(0),
+		sequence(0), dropped_packets(0), last_packet(0) {
+			assert(config.universe_size > 0);
+			assert(config.universe_size <= (config.protocol == NetworkProtocol::DDP ? 1440 : 512));
+			initHeader();
+
+			if(config.address != nullptr) {
+				struct in_addr address;
+				if(inet_pton(AF_INET, config.address, &address) != 1) {
+					ESP_LOGE(PIXLED_LOG_TAG, "Invalid controller address : %s", config.address);
+					return;
+				}
+				destination = address.s_addr;
+			} else {
+				assert(config.protocol == NetworkProtocol::E131);
+			}
+
+			sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+			if(sock < 0)
+				ESP_LOGE(PIXLED_LOG_TAG, "Unable to open UDP socket : errno %d", errno);
+		} // NetworkStrip
+
+	uint32_t NetworkStrip::packetCount() const {
+		const uint32_t size = pixel_count * 3;
+		return size == 0 ? 0 : (size + network_config.universe_size - 1) / network_config.universe_size;
+	} // packetCount
+
+	/*
+	 * Writes the fields of the header that do not change between packets.
+	 */
+	void NetworkStrip::initHeader() {
+		std::memset(header, 0, sizeof(header));
+		switch(network_config.protocol) {
+			case NetworkProtocol::E131:
+				{
+					// Root layer
+					write16(&header[0], 0x0010);
+					std::memcpy(&header[4], "ASC-E1.17\0\0\0", 12);
+					write32(&header[18], 0x00000004);
+					std::memcpy(&header[22], network_config.cid != nullptr ? network_config.cid : DEFAULT_CID, 16);
+					// Framing layer
+					write32(&header[40], 0x00000002);
+					std::strncpy((char*) &header[44], network_config.source_name, 63);
+					header[108] = network_config.priority;
+					// DMP layer
+					header[117] = 0x02;
+					header[118] = 0xa1;
+					write16(&header[121], 0x0001);
+				}
+				break;
+			case NetworkProtocol::ARTNET:
+				std::memcpy(&header[0], "Art-Net\0", 8);
+				// OpDmx, little endian
+				header[8] = 0x00;
+				header[9] = 0x50;
+				// Protocol version 14
+				header[11] = 14;
+				break;
+			case NetworkProtocol::DDP:
+				// RGB, 8 bits per component
+				header[2] = 0x0b;
+				// Default output device
+				header[3] = 0x01;
+				break;
+		}
+	} // initHeader
+
+	/*
+	 * Writes the fields of the header specific to a packet.
+	 *
+	 * @param packet index of the packet in the frame
+	 * @param offset offset of the packet data in the buffer
+	 * @param size count of data bytes of the packet
+	 * @param last true for the last packet of the frame
+	 * @return header size
+	 */
+	uint8_t NetworkStrip::updateHeader(uint32_t packet, uint32_t offset, uint16_t size, bool last) {
+		switch(network_config.protocol) {
+			case NetworkProtocol::E131:
+				write16(&header[16], 0x7000 | (110 + size));
+				write16(&header[38], 0x7000 | (88 + size));
+				header[111] = sequence;
+				write16(&header[113], network_config.universe + packet);
+				write16(&header[115], 0x7000 | (11 + size));
+				// Start code included
+				write16(&header[123], size + 1);
+				return E131_HEADER_SIZE;
+			case NetworkProtocol::ARTNET:
+				{
+					const uint16_t universe = network_config.universe + packet;
+					header[12] = sequence;
+					header[14] = universe;
+					header[15] = (universe >> 8) & 0x7f;
+					write16(&header[16], size + (size & 1));
+				}
+				return ARTNET_HEADER_SIZE;
+			case NetworkProtocol::DDP:
+			default:
+				// Version 1, with the PUSH flag on the last packet
+				header[0] = last ? 0x41 : 0x40;
+				header[1] = sequence;
+				write32(&header[4], offset);
+				write16(&header[8], size);
+				return DDP_HEADER_SIZE;
+		}
+	} // updateHeader
+
+	/*
+	 * Waits until the configured interval has elapsed since the last packet.
+	 * Long waits yield to other tasks, the remaining time is busy-waited.
+	 */
+	void NetworkStrip::pace() {
+		if(network_config.packet_interval_us == 0)
+			return;
+		const int64_t next = last_packet + network_config.packet_interval_us;
+		int64_t remaining = next - esp_timer_get_time();
+		if(remaining >= portTICK_PERIOD_MS * 1000)
+			vTaskDelay(remaining / (portTICK_PERIOD_MS * 1000));
+		while(esp_timer_get_time() < next);
+	} // pace
+
+	/**
+	 * Sends the buffer to the controller.
+	 *
+	 * The buffer is in the controller color order, so each packet is sent as
+	 * its header followed by a slice of the buffer, gathered by sendmsg().
+	 */
+	void NetworkStrip::show() {
+		if(!frameChanged())
+			return;
+		if(sock < 0)
+			return;
+		PIXLED_TRACE_SPAN("network send");
+
+		// 0 disables sequence checks with Art-Net and DDP, that also only
+		// use 4 bits
+		switch(network_config.protocol) {
+			case NetworkProtocol::E131:
+				sequence++;
+				break;
+			case NetworkProtocol::ARTNET:
+				sequence = sequence == 255 ? 1 : sequence + 1;
+				break;
+			case NetworkProtocol::DDP:
+				sequence = sequence == 15 ? 1 : sequence + 1;
+				break;
+		}
+
+		struct sockaddr_in address;
+		std::memset(&address, 0, sizeof(address));
+		address.sin_family = AF_INET;
+		address.sin_port = htons(network_config.port);
+		address.sin_addr.s_addr = destination;
+
+		struct iovec iov[3];
+		struct msghdr message;
+		std::memset(&message, 0, sizeof(message));
+		message.msg_name = &address;
+		message.msg_namelen = sizeof(address);
+		message.msg_iov = iov;
+
+		const uint32_t size = pixel_count * 3;
+		const uint16_t universe_size = network_config.universe_size;
+		uint32_t packet = 0;
+		for(uint32_t offset = 0; offset < size; offset += universe_size) {
+			const uint16_t length = size - offset < universe_size ? size - offset : universe_size;
+			iov[0].iov_base = header;
+			iov[0].iov_len = updateHeader(packet, offset, length, offset + length == size);
+			iov[1].iov_base = &_buffer[offset];
+			iov[1].iov_len = length;
+			message.msg_iovlen = 2;
+			if(network_config.protocol == NetworkProtocol::ARTNET && (length & 1)) {
+				iov[2].iov_base = &artnet_padding;
+				iov[2].iov_len = 1;
+				message.msg_iovlen = 3;
+			}
+			if(network_config.protocol == NetworkProtocol::E131 && network_config.address == nullptr) {
+				// 239.255.<universe high byte>.<universe low byte>
+				const uint16_t universe = network_config.universe + packet;
+				address.sin_addr.s_addr = htonl(0xefff0000 | universe);
+			}
+
+			pace();
+			if(sendmsg(sock, &message, 0) < 0) {
+				ESP_LOGD(PIXLED_LOG_TAG, "Packet %u dropped : errno %d", (unsigned int) packet, errno);
+				dropped_packets++;
+			}
+			last_packet = esp_timer_get_time();
+			packet++;
+		}
+	} // show
+
+	NetworkStrip::~NetworkStrip() {
+		if(sock >= 0)
+			close(sock);
+	} // ~NetworkStrip
+}
@@ -0,0 +1,199 @@
+#include <cassert>
+#include <cstring>
+
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "parallel_output.hpp"
+
+static const char* PIXLED_LOG_TAG = "PIXLED_DRIVER";
+
+namespace pixled {
+	/********************/
+	/* ParallelRgbStrip */
+	/********************/
+
+	ParallelRgbStrip::ParallelRgbStrip(ParallelOutput& output, uint32_t pixel_count, RgbStripConfig config)
+		: RgbStrip(pixel_count, config), output(output) {
+		}
+
+	/**
+	 * Transmits all the strips of the output.
+	 */
+	void ParallelRgbStrip::show() {
+		output.show();
+	} // show
+
+	/*********************/
+	/* ParallelRgbwStrip */
+	/*********************/
+
+	ParallelRgbwStrip::ParallelRgbwStrip(ParallelOutput& output, uint32_t pixel_count, RgbwStripConfig config)
+		: RgbwStrip(pixel_count, config), output(output) {
+		}
+
+	/**
+	 * Transmits all the strips of the output.
+	 */
+	void ParallelRgbwStrip::show() {
+		output.show();
+	} // show
+
+	/******************/
+	/* ParallelOutput */
+	/******************/
+
+	/*
+	 * Called from the DMA interrupt at the end of each transmission.
+	 */
+	static bool IRAM_ATTR on_transmitted(
+			esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t* event, void* transmitted) {
+		BaseType_t woken = pdFALSE;
+		xSemaphoreGiveFromISR(static_cast<SemaphoreHandle_t>(transmitted), &woken);
+		return woken == pdTRUE;
+	}
+
+	ParallelOutput::ParallelOutput(const gpio_num_t* gpios, uint8_t strip_count, uint32_t pixel_count,
+			gpio_num_t clock_gpio, gpio_num_t dc_gpio, RgbStripConfig config)
+		: strip_count(strip_count < MAX_STRIPS ? strip_count : MAX_STRIPS),
+		bus_width(strip_count <= 8 ? 8 : 16), strip_size(pixel_count * 3),
+		dma_buffer(nullptr), buffer_size(0), bus(nullptr), io(nullptr), transmitted(nullptr) {
+			assert(config.buffer_order == BufferOrder::CHIP);
+			assert(strip_count <= MAX_STRIPS);
+			for(uint8_t i = 0; i < this->strip_count; i++)
+				strips[i] = new ParallelRgbStrip(*this, pixel_count, config);
+			init(gpios, clock_gpio, dc_gpio, config);
+		} // ParallelOutput
+
+	ParallelOutput::ParallelOutput(const gpio_num_t* gpios, uint8_t strip_count, uint32_t pixel_count,
+			gpio_num_t clock_gpio, gpio_num_t dc_gpio, RgbwStripConfig config)
+		: strip_count(strip_count < MAX_STRIPS ? strip_count : MAX_STRIPS),
+		bus_width(strip_count <= 8 ? 8 : 16), strip_size(pixel_count * 4),
+		dma_buffer(nullptr), buffer_size(0), bus(nullptr), io(nullptr), transmitted(nullptr) {
+			assert(config.buffer_order == BufferOrder::CHIP);
+			assert(strip_count <= MAX_STRIPS);
+			for(uint8_t i = 0; i < this->strip_count; i++)
+				strips[i] = new ParallelRgbwStrip(*this, pixel_count, config);
+			init(gpios, clock_gpio, dc_gpio, config);
+		} // ParallelOutput
+
+	/*
+	 * Allocates and pre-fills the DMA buffer, and sets up the i80 bus.
+	 *
+	 * Only the data slots of the DMA buffer are written by show() : the
+	 * leading high slots, trailing low slots and the final reset are
+	 * written once.
+	 *
+	 * Errors are logged, and leave the output disabled.
+	 */
+	void ParallelOutput::init(const gpio_num_t* gpios, gpio_num_t clock_gpio, gpio_num_t dc_gpio, const StripConfig& config) {
+		const uint8_t word_size = bus_width / 8;
+
+		uint16_t active_lines = 0;
+		for(uint8_t i = 0; i < strip_count; i++) {
+			inputs[i] = strips[i]->buffer();
+			active_lines |= 1 << i;
+		}
+
+		const uint32_t bit_ns = config.ticksToNs(config.t0h + config.t0l);
+		const uint32_t slot_clock = (uint64_t) SLOTS_PER_BIT * 1000000000 / bit_ns;
+		const uint32_t reset_slots = (uint64_t) RESET_NS * slot_clock / 1000000000;
+		const uint32_t data_slots = strip_size * 8 * SLOTS_PER_BIT;
+
+		buffer_size = data_slots + reset_slots;
+		dma_buffer = static_cast<uint8_t*>(heap_caps_malloc(buffer_size * word_size, MALLOC_CAP_DMA));
+		if(dma_buffer == nullptr) {
+			ESP_LOGE(PIXLED_LOG_TAG, "Unable to allocate a DMA buffer of %u bytes",
+					(unsigned int) (buffer_size * word_size));
+			return;
+		}
+		if(bus_width == 8) {
+			for(uint32_t i = 0; i < data_slots; i += SLOTS_PER_BIT) {
+				dma_buffer[i] = active_lines;
+				dma_buffer[i+1] = 0;
+				dma_buffer[i+2] = 0;
+			}
+		} else {
+			uint16_t* words = reinterpret_cast<uint16_t*>(dma_buffer);
+			for(uint32_t i = 0; i < data_slots; i += SLOTS_PER_BIT) {
+				words[i] = active_lines;
+				words[i+1] = 0;
+				words[i+2] = 0;
+			}
+		}
+		std::memset(&dma_buffer[data_slots * word_size], 0, reset_slots * word_size);
+
+		esp_lcd_i80_bus_config_t bus_config;
+		std::memset(&bus_config, 0, sizeof(bus_config));
+		bus_config.dc_gpio_num = dc_gpio;
+		bus_config.wr_gpio_num = clock_gpio;
+		bus_config.clk_src = LCD_CLK_SRC_DEFAULT;
+		// The driver requires a GPIO for each line of the bus : unused lines
+		// are routed to dc_gpio, which is not connected to the strips
+		for(uint8_t i = 0; i < bus_width; i++)
+			bus_config.data_gpio_nums[i] = i < strip_count ? gpios[i] : dc_gpio;
+		bus_config.bus_width = bus_width;
+		bus_config.max_transfer_bytes = buffer_size * word_size;
+		esp_err_t err = esp_lcd_new_i80_bus(&bus_config, &bus);
+		if(err != ESP_OK) {
+			ESP_LOGE(PIXLED_LOG_TAG, "Unable to create the i80 bus : %s", esp_err_to_name(err));
+			bus = nullptr;
+			return;
+		}
+
+		transmitted = xSemaphoreCreateBinary();
+		xSemaphoreGive(transmitted);
+
+		esp_lcd_panel_io_i80_config_t io_config;
+		std::memset(&io_config, 0, sizeof(io_config));
+		io_config.cs_gpio_num = -1;
+		io_config.pclk_hz = slot_clock;
+		io_config.trans_queue_depth = 1;
+		io_config.on_color_trans_done = on_transmitted;
+		io_config.user_ctx = transmitted;
+		io_config.lcd_cmd_bits = 0;
+		io_config.lcd_param_bits = 0;
+		io_config.dc_levels.dc_data_level = 1;
+		err = esp_lcd_new_panel_io_i80(bus, &io_config, &io);
+		if(err != ESP_OK) {
+			ESP_LOGE(PIXLED_LOG_TAG, "Unable to create the i80 panel IO : %s", esp_err_to_name(err));
+			io = nullptr;
+		}
+	} // init
+
+	void ParallelOutput::show() {
+		if(io == nullptr)
+			return;
+		// The DMA buffer can't be written until the previous frame is sent
+		xSemaphoreTake(transmitted, portMAX_DELAY);
+		if(bus_width == 8)
+			transpose::bits8(inputs, strip_count, 0, strip_size, &dma_buffer[1], SLOTS_PER_BIT);
+		else
+			transpose::bits16(inputs, strip_count, 0, strip_size,
+					&reinterpret_cast<uint16_t*>(dma_buffer)[1], SLOTS_PER_BIT);
+		const esp_err_t err = esp_lcd_panel_io_tx_color(io, -1, dma_buffer, buffer_size * (bus_width / 8));
+		if(err != ESP_OK) {
+			ESP_LOGE(PIXLED_LOG_TAG, "Transmission failed : %s", esp_err_to_name(err));
+			xSemaphoreGive(transmitted);
+		}
+	} // show
+
+	/**
+	 * ParallelOutput destructor.
+	 *
+	 * Waits for the end of the current transmission, then releases the
+	 * peripheral, the DMA buffer and all the strips.
+	 */
+	ParallelOutput::~ParallelOutput() {
+		if(io != nullptr) {
+			xSemaphoreTake(transmitted, portMAX_DELAY);
+			ESP_ERROR_CHECK(esp_lcd_panel_io_del(io));
+		}
+		if(bus != nullptr)
+			ESP_ERROR_CHECK(esp_lcd_del_i80_bus(bus));
+		if(transmitted != nullptr)
+			vSemaphoreDelete(transmitted);
+		heap_caps_free(dma_buffer);
+		for(uint8_t i = 0; i < strip_count; i++)
+			delete strips[i];
+	} // ~ParallelOutput
+}
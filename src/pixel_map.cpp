@@ -0,0 +1,121 @@
+#include <cstring>
+
+#include "pixel_map.hpp"
+
+namespace pixled {
+	PixelMap::PixelMap(Strip& strip, uint32_t count, uint32_t offset, uint8_t cell_shift)
+		: strip(strip), offset(offset), count(count), cell_shift(cell_shift),
+		xs(new int16_t[count]), ys(new int16_t[count]), zs(new int16_t[count]),
+		bounds_min({0, 0, 0}), bounds_max({0, 0, 0}), cells_x(0), cells_y(0), cells_z(0),
+		cell_start(nullptr), cell_pixels(new uint32_t[count]) {
+			assert(offset + count <= strip.length());
+			assert(cell_shift < 16);
+			std::memset(xs, 0, count * sizeof(int16_t));
+			std::memset(ys, 0, count * sizeof(int16_t));
+			std::memset(zs, 0, count * sizeof(int16_t));
+		} // PixelMap
+
+	void PixelMap::setPosition(uint32_t index, int16_t x, int16_t y, int16_t z) {
+		xs[index] = x;
+		ys[index] = y;
+		zs[index] = z;
+	} // setPosition
+
+	/**
+	 * Builds the grid index with a counting sort : leds are counted in each
+	 * cell, counts are turned into start indexes with a prefix sum, then each
+	 * led is written at the next free slot of its cell.
+	 */
+	void PixelMap::buildIndex() {
+		bounds_min = {INT16_MAX, INT16_MAX, INT16_MAX};
+		bounds_max = {INT16_MIN, INT16_MIN, INT16_MIN};
+		for(uint32_t i = 0; i < count; i++) {
+			if(xs[i] < bounds_min.x) bounds_min.x = xs[i];
+			if(ys[i] < bounds_min.y) bounds_min.y = ys[i];
+			if(zs[i] < bounds_min.z) bounds_min.z = zs[i];
+			if(xs[i] > bounds_max.x) bounds_max.x = xs[i];
+			if(ys[i] > bounds_max.y) bounds_max.y = ys[i];
+			if(zs[i] > bounds_max.z) bounds_max.z = zs[i];
+		}
+		if(count == 0) {
+			bounds_min = {0, 0, 0};
+			bounds_max = {0, 0, 0};
+		}
+
+		while(true) {
+			cells_x = cellX(bounds_max.x) + 1;
+			cells_y = cellY(bounds_max.y) + 1;
+			cells_z = cellZ(bounds_max.z) + 1;
+			if((uint64_t) cells_x * cells_y * cells_z <= MAX_CELLS)
+				break;
+			cell_shift++;
+		}
+
+		const uint32_t cell_count = cellCount();
+		delete[] cell_start;
+		cell_start = new uint32_t[cell_count + 1];
+		std::memset(cell_start, 0, (cell_count + 1) * sizeof(uint32_t));
+
+		for(uint32_t i = 0; i < count; i++)
+			cell_start[cell(cellX(xs[i]), cellY(ys[i]), cellZ(zs[i])) + 1]++;
+		for(uint32_t c = 0; c < cell_count; c++)
+			cell_start[c+1] += cell_start[c];
+		// cell_start[c] is used as the next free slot of cell c-1, so
+		// that it ends up as the start of cell c
+		for(uint32_t i = 0; i < count; i++) {
+			const uint32_t c = cell(cellX(xs[i]), cellY(ys[i]), cellZ(zs[i]));
+			cell_pixels[cell_start[c]++] = i;
+		}
+		for(uint32_t c = cell_count; c > 0; c--)
+			cell_start[c] = cell_start[c-1];
+		cell_start[0] = 0;
+	} // buildIndex
+
+	/*
+	 * Clips the box [min;max] to the bounding box of the leds.
+	 *
+	 * @return false if the box does not intersect the bounding box
+	 */
+	bool PixelMap::clip(map_point& min, map_point& max) const {
+		if(min.x > bounds_max.x || max.x < bounds_min.x
+				|| min.y > bounds_max.y || max.y < bounds_min.y
+				|| min.z > bounds_max.z || max.z < bounds_min.z)
+			return false;
+		if(min.x < bounds_min.x) min.x = bounds_min.x;
+		if(min.y < bounds_min.y) min.y = bounds_min.y;
+		if(min.z < bounds_min.z) min.z = bounds_min.z;
+		if(max.x > bounds_max.x) max.x = bounds_max.x;
+		if(max.y > bounds_max.y) max.y = bounds_max.y;
+		if(max.z > bounds_max.z) max.z = bounds_max.z;
+		return min.x <= max.x && min.y <= max.y && min.z <= max.z;
+	} // clip
+
+	void PixelMap::fillSphere(map_point center, uint16_t radius, const rgb_pixel& color) {
+		Strip& strip = this->strip;
+		const uint32_t offset = this->offset;
+		forEachInSphere(center, radius, [&] (uint32_t index, uint32_t) {
+				strip.setRgbPixel(offset + index, color.red, color.green, color.blue);
+			});
+	} // fillSphere
+
+	void PixelMap::fillBox(map_point min, map_point max, const rgb_pixel& color) {
+		Strip& strip = this->strip;
+		const uint32_t offset = this->offset;
+		forEachInBox(min, max, [&] (uint32_t index) {
+				strip.setRgbPixel(offset + index, color.red, color.green, color.blue);
+			});
+	} // fillBox
+
+	/**
+	 * PixelMap destructor.
+	 *
+	 * Coordinates and grid index are deleted.
+	 */
+	PixelMap::~PixelMap() {
+		delete[] xs;
+		delete[] ys;
+		delete[] zs;
+		delete[] cell_start;
+		delete[] cell_pixels;
+	} // ~PixelMap
+}
@@ -0,0 +1,309 @@
+#include <cassert>
+#include <cstring>
+
+#include "esp_attr.h"
+#include "run_strip.hpp"
+
+static const char* PIXLED_LOG_TAG = "PIXLED_DRIVER";
+
+namespace pixled {
+	/************/
+	/* RunStrip */
+	/************/
+
+	/**
+	 * RunStrip constructor.
+	 *
+	 * Because RunStrip is abstract, this constructor should not be used
+	 * directly, but will be call by implementing classes (RunRgbStrip,
+	 * RunRgbwStrip).
+	 *
+	 * The strip is initialized to black, as a single run.
+	 *
+	 * @param gpio_num Led Strip GPIO.
+	 * @param pixel_count Number of leds.
+	 * @param channel RMT channel to use.
+	 * @param max_runs maximum count of runs
+	 * @param entry_size bytes sent to each led (3 for RGB, 4 for RGBW)
+	 * @param config strip config
+	 */
+	RunStrip::RunStrip(
+			gpio_num_t gpio_num, uint32_t pixel_count, rmt_channel_t channel,
+			uint32_t max_runs, uint8_t entry_size, StripConfig config)
+		: Strip(
+				gpio_num, pixel_count, entry_size, nullptr,
+				channel, allocateItems(config, pixel_count * entry_size * 8 + 1), config),
+		max_runs(max_runs), entry_size(entry_size), runs(new color_run[max_runs]),
+		run_count(0), dropped_updates(0) {
+			assert(max_runs > 0);
+			run_context.runs = runs;
+			run_context.run_count = 0;
+			run_context.pixel_count = pixel_count;
+			run_context.entry_size = entry_size;
+			setItem0(&run_context.bit0);
+			setItem1(&run_context.bit1);
+			if(config.transmit_mode == TransmitMode::STREAMING) {
+				ESP_ERROR_CHECK(rmt_translator_init(channel, translate));
+				ESP_ERROR_CHECK(rmt_translator_set_context(channel, &run_context));
+			}
+			clear();
+		} // RunStrip
+
+	uint32_t RunStrip::findRun(uint32_t index) const {
+		// Last run starting at or before index (runs[0] starts at 0)
+		uint32_t low = 0;
+		uint32_t high = run_count;
+		while(high - low > 1) {
+			const uint32_t middle = low + (high - low) / 2;
+			if(runs[middle].start <= index)
+				low = middle;
+			else
+				high = middle;
+		}
+		return low;
+	} // findRun
+
+	/**
+	 * Replaces the runs covered by [index;index+count[ by a run of `color`.
+	 *
+	 * The runs that start in the range are removed, and the last one is
+	 * split at the end of the range if it goes on after it. Runs of the same
+	 * color as `color` before or after the range are extended instead of
+	 * adding a new run, so that two consecutive runs never have the same
+	 * color.
+	 */
+	bool RunStrip::fill(uint32_t index, uint32_t count, const uint8_t* color) {
+		if(count == 0)
+			return true;
+		assert(index + count <= pixel_count);
+		const uint32_t end = index + count;
+		const uint32_t first = findRun(index);
+		const uint32_t last = findRun(end - 1);
+
+		// Runs [lo;hi[ are replaced by the runs of replacement
+		const uint32_t lo = runs[first].start == index ? first : first + 1;
+		uint32_t hi = last + 1;
+		color_run replacement[2];
+		uint8_t replacement_count = 0;
+
+		if(lo == 0 || std::memcmp(runs[lo-1].color, color, entry_size) != 0) {
+			replacement[replacement_count].start = index;
+			std::memcpy(replacement[replacement_count].color, color, entry_size);
+			replacement_count++;
+		}
+		if(end < pixel_count && (hi == run_count || runs[hi].start > end)) {
+			// The last run goes on after the range
+			if(std::memcmp(runs[last].color, color, entry_size) != 0) {
+				replacement[replacement_count].start = end;
+				std::memcpy(replacement[replacement_count].color, runs[last].color, entry_size);
+				replacement_count++;
+			}
+		} else if(hi < run_count && std::memcmp(runs[hi].color, color, entry_size) == 0) {
+			// The next run starts at the end of the range, with the same
+			// color
+			hi++;
+		}
+
+		const uint32_t new_count = run_count - (hi - lo) + replacement_count;
+		if(new_count > max_runs) {
+			if(dropped_updates++ == 0)
+				ESP_LOGW(PIXLED_LOG_TAG, "RunStrip update dropped : more than %u runs", (unsigned int) max_runs);
+			return false;
+		}
+		std::memmove(&runs[lo + replacement_count], &runs[hi], (run_count - hi) * sizeof(color_run));
+		std::memcpy(&runs[lo], replacement, replacement_count * sizeof(color_run));
+		run_count = new_count;
+		return true;
+	} // fill
+
+	void RunStrip::setRgbPixel(uint32_t index, uint8_t red, uint8_t green, uint8_t blue) {
+		fillRgb(index, 1, {red, green, blue});
+	} // setRgbPixel
+
+	void RunStrip::setHsbPixel(uint32_t index, float hue, float saturation, float brightness) {
+		fillRgb(index, 1, hsb_to_rgb({hue, saturation, brightness}));
+	} // setHsbPixel
+
+	void RunStrip::setRgbPixels(uint32_t index, const rgb_pixel* pixels, uint32_t count) {
+		trySetRgbPixels(index, pixels, count);
+	} // setRgbPixels
+
+	void RunStrip::fillRgb(uint32_t index, uint32_t count, const rgb_pixel& color) {
+		tryFillRgb(index, count, color);
+	} // fillRgb
+
+	bool RunStrip::trySetRgbPixels(uint32_t index, const rgb_pixel* pixels, uint32_t count) {
+		PIXLED_TRACE_SPAN("setRgbPixels");
+		uint32_t i = 0;
+		while(i < count) {
+			uint32_t j = i + 1;
+			while(j < count && pixels[j].red == pixels[i].red
+					&& pixels[j].green == pixels[i].green && pixels[j].blue == pixels[i].blue)
+				j++;
+			if(!tryFillRgb(index + i, j - i, pixels[i]))
+				return false;
+			i = j;
+		}
+		return true;
+	} // trySetRgbPixels
+
+	bool RunStrip::tryFillRgb(uint32_t index, uint32_t count, const rgb_pixel& color) {
+		uint8_t serialized[4] = {0, 0, 0, 0};
+		serialize(color, serialized);
+		return fill(index, count, serialized);
+	} // tryFillRgb
+
+	void RunStrip::clear() {
+		runs[0].start = 0;
+		std::memset(runs[0].color, 0, sizeof(runs[0].color));
+		run_count = 1;
+	} // clear
+
+	void IRAM_ATTR RunStrip::encodePattern(const RunContext& context, const uint8_t* color, rmt_item32_t* pattern) {
+		for(uint8_t i = 0; i < context.entry_size; i++)
+			for(uint8_t mask = 0x80; mask != 0; mask >>= 1)
+				*pattern++ = (color[i] & mask) ? context.bit1 : context.bit0;
+	} // encodePattern
+
+	void RunStrip::startStream() {
+		run_context.run_count = run_count;
+		run_context.run = 0;
+		run_context.remaining = run_count > 1 ? runs[1].start : pixel_count;
+		run_context.position = 0;
+		encodePattern(run_context, runs[0].color, run_context.pattern);
+	} // startStream
+
+	/**
+	 * Encodes runs, as requested by the RMT driver.
+	 *
+	 * The pattern of a pixel is encoded once for each run, and copied for
+	 * each of its pixels.
+	 *
+	 * @param context run context of the strip
+	 * @param size count of bytes remaining in the frame
+	 * @param dest items to write
+	 * @param wanted_num maximum count of items to write
+	 * @param translated_size count of encoded bytes
+	 * @param item_num count of written items
+	 */
+	void IRAM_ATTR RunStrip::encodeRuns(RunContext& context, size_t size,
+			rmt_item32_t* dest, size_t wanted_num, size_t* translated_size, size_t* item_num) {
+		const uint8_t bits = context.entry_size * 8;
+		size_t translated = 0;
+		size_t num = 0;
+		while(translated < size && num + 8 <= wanted_num) {
+			if(context.position == bits) {
+				context.position = 0;
+				if(--context.remaining == 0) {
+					const uint32_t run = ++context.run;
+					const uint32_t end = run + 1 < context.run_count ?
+						context.runs[run + 1].start : context.pixel_count;
+					context.remaining = end - context.runs[run].start;
+					encodePattern(context, context.runs[run].color, context.pattern);
+				}
+			}
+			std::memcpy(&dest[num], &context.pattern[context.position], 8 * sizeof(rmt_item32_t));
+			context.position += 8;
+			num += 8;
+			translated++;
+		}
+		*translated_size = translated;
+		*item_num = num;
+	} // encodeRuns
+
+	void IRAM_ATTR RunStrip::translate(const void* src, rmt_item32_t* dest, size_t src_size,
+			size_t wanted_num, size_t* translated_size, size_t* item_num) {
+		void* context;
+		rmt_translator_get_context(item_num, &context);
+		encodeRuns(*static_cast<RunContext*>(context), src_size,
+				dest, wanted_num, translated_size, item_num);
+	} // translate
+
+	/**
+	 * Transmits the runs to the strip.
+	 *
+	 * In TransmitMode::BUFFERED, the first pixel of each run is encoded,
+	 * then copied in blocks that double at each copy, so that a run costs a
+	 * logarithmic count of memcpy() calls.
+	 */
+	void RunStrip::show() {
+		const uint16_t bits = entry_size * 8;
+		transmitWholeFrame();
+		if(strip_config.transmit_mode == TransmitMode::STREAMING) {
+			startStream();
+			// Any valid pointer : only the size is used by the translator
+			writeSample(reinterpret_cast<const uint8_t*>(runs), pixel_count * entry_size);
+			return;
+		}
+		PIXLED_TRACE_BEGIN(encode, "encode");
+		rmt_item32_t* pCurrentItem = this->rmt_items;
+		for(uint32_t run = 0; run < run_count; run++) {
+			const uint32_t end = run + 1 < run_count ? runs[run + 1].start : pixel_count;
+			const uint32_t length = end - runs[run].start;
+			const rmt_item32_t* pattern = pCurrentItem;
+			encodePattern(run_context, runs[run].color, pCurrentItem);
+			uint32_t copied = 1;
+			while(copied < length) {
+				const uint32_t block = copied < length - copied ? copied : length - copied;
+				std::memcpy(&pCurrentItem[copied * bits], pattern, block * bits * sizeof(rmt_item32_t));
+				copied += block;
+			}
+			pCurrentItem += length * bits;
+		}
+		setTerminator(pCurrentItem); // Write the RMT terminator.
+		PIXLED_TRACE_END(encode);
+
+		writeItems(pixel_count * bits);
+	} // show
+
+	/**
+	 * RunStrip destructor.
+	 *
+	 * Runs are deleted.
+	 */
+	RunStrip::~RunStrip() {
+		delete[] runs;
+	} // ~RunStrip
+
+	/***************/
+	/* RunRgbStrip */
+	/***************/
+
+	RunRgbStrip::RunRgbStrip(gpio_num_t gpio_num, uint32_t pixel_count, rmt_channel_t channel,
+			uint32_t max_runs, RgbStripConfig config)
+		: RunStrip(gpio_num, pixel_count, channel, max_runs, 3, config),
+		rgb_strip_config(config) {
+		}
+
+	/**
+	 * RunRgbStrip constructor with a default RMT channel set to
+	 * RMT_CHANNEL_0.
+	 */
+	RunRgbStrip::RunRgbStrip(gpio_num_t gpio_num, uint32_t pixel_count, uint32_t max_runs, RgbStripConfig config)
+		: RunRgbStrip(gpio_num, pixel_count, RMT_CHANNEL_0, max_runs, config) {
+		}
+
+	/****************/
+	/* RunRgbwStrip */
+	/****************/
+
+	RunRgbwStrip::RunRgbwStrip(gpio_num_t gpio_num, uint32_t pixel_count, rmt_channel_t channel,
+			uint32_t max_runs, RgbwStripConfig config)
+		: RunStrip(gpio_num, pixel_count, channel, max_runs, 4, config),
+		rgbw_strip_config(config) {
+		}
+
+	/**
+	 * RunRgbwStrip constructor with a default RMT channel set to
+	 * RMT_CHANNEL_0.
+	 */
+	RunRgbwStrip::RunRgbwStrip(gpio_num_t gpio_num, uint32_t pixel_count, uint32_t max_runs, RgbwStripConfig config)
+		: RunRgbwStrip(gpio_num, pixel_count, RMT_CHANNEL_0, max_runs, config) {
+		}
+
+	bool RunRgbwStrip::fillRgbw(uint32_t index, uint32_t count, const rgbw_pixel& color) {
+		uint8_t serialized[4];
+		rgbw_strip_config.serializer.serialize(color, serialized);
+		return fill(index, count, serialized);
+	} // fillRgbw
+}
@@ -0,0 +1,142 @@
+#include <cassert>
+
+#include "esp_attr.h"
+#include "shader_strip.hpp"
+
+static const char* PIXLED_LOG_TAG = "PIXLED_DRIVER";
+
+namespace pixled {
+	/**
+	 * ShaderStrip constructor.
+	 *
+	 * No pixel buffer is allocated, and no item buffer either in
+	 * TransmitMode::STREAMING, where the strip installs its own RMT
+	 * translator.
+	 *
+	 * @param gpio_num Led Strip GPIO.
+	 * @param pixel_count Number of leds, at most effect.length()
+	 * @param channel RMT channel to use.
+	 * @param effect effect rendering the leds
+	 * @param config RGB strip config
+	 */
+	ShaderStrip::ShaderStrip(gpio_num_t gpio_num, uint32_t pixel_count, rmt_channel_t channel,
+			const Effect& effect, RgbStripConfig config)
+		: Strip(
+				gpio_num, pixel_count, 3, nullptr,
+				channel, allocateItems(config, pixel_count * 24 + 1), config),
+		shader_context(effect, config.serializer, pixel_count),
+		rgb_strip_config(config), setter_warned(false) {
+			assert(pixel_count <= effect.length());
+			setItem0(&shader_context.bit0);
+			setItem1(&shader_context.bit1);
+			if(config.transmit_mode == TransmitMode::STREAMING) {
+				ESP_ERROR_CHECK(rmt_translator_init(channel, translate));
+				ESP_ERROR_CHECK(rmt_translator_set_context(channel, &shader_context));
+			}
+		} // ShaderStrip
+
+	/**
+	 * ShaderStrip constructor with a default RMT channel set to
+	 * RMT_CHANNEL_0.
+	 */
+	ShaderStrip::ShaderStrip(gpio_num_t gpio_num, uint32_t pixel_count, const Effect& effect, RgbStripConfig config) :
+		ShaderStrip(gpio_num, pixel_count, RMT_CHANNEL_0, effect, config) {
+		}
+
+	void ShaderStrip::setEffect(const Effect& effect) {
+		assert(pixel_count <= effect.length());
+		shader_context.effect = &effect;
+	} // setEffect
+
+	void ShaderStrip::ignoreSetter() {
+#ifndef NDEBUG
+		if(!setter_warned) {
+			ESP_LOGW(PIXLED_LOG_TAG, "ShaderStrip setters are ignored : the leds are rendered by the effect");
+			setter_warned = true;
+		}
+#endif
+	} // ignoreSetter
+
+	void ShaderStrip::startStream() {
+		shader_context.next_pixel = 0;
+		shader_context.span_size = 0;
+		shader_context.position = 0;
+	} // startStream
+
+	/**
+	 * Renders and encodes the strip, as requested by the RMT driver.
+	 *
+	 * A span of SPAN_SIZE pixels is rendered and serialized each time the
+	 * last one is fully encoded.
+	 *
+	 * @param context shader context of the strip
+	 * @param size count of bytes remaining in the frame
+	 * @param dest items to write
+	 * @param wanted_num maximum count of items to write
+	 * @param translated_size count of encoded bytes
+	 * @param item_num count of written items
+	 */
+	void IRAM_ATTR ShaderStrip::encodeShader(ShaderContext& context, size_t size,
+			rmt_item32_t* dest, size_t wanted_num, size_t* translated_size, size_t* item_num) {
+		size_t translated = 0;
+		size_t num = 0;
+		while(translated < size && num + 8 <= wanted_num) {
+			if(context.position == context.span_size) {
+				const uint32_t remaining = context.pixel_count - context.next_pixel;
+				const uint8_t count = remaining < SPAN_SIZE ? remaining : SPAN_SIZE;
+				rgb_pixel pixels[SPAN_SIZE];
+				context.effect->render(context.next_pixel, count, pixels);
+				for(uint8_t i = 0; i < count; i++)
+					context.serializer.serialize(pixels[i], &context.span[3*i]);
+				context.next_pixel += count;
+				context.span_size = 3 * count;
+				context.position = 0;
+			}
+			const uint8_t byte = context.span[context.position++];
+			for(uint8_t mask = 0x80; mask != 0; mask >>= 1)
+				dest[num++] = (byte & mask) ? context.bit1 : context.bit0;
+			translated++;
+		}
+		*translated_size = translated;
+		*item_num = num;
+	} // encodeShader
+
+	void IRAM_ATTR ShaderStrip::translate(const void* src, rmt_item32_t* dest, size_t src_size,
+			size_t wanted_num, size_t* translated_size, size_t* item_num) {
+		void* context;
+		rmt_translator_get_context(item_num, &context);
+		encodeShader(*static_cast<ShaderContext*>(context), src_size,
+				dest, wanted_num, translated_size, item_num);
+	} // translate
+
+	/**
+	 * Renders and transmits the current frame of the effect.
+	 *
+	 * In TransmitMode::BUFFERED, the effect is rendered by blocks of
+	 * Effect::BLOCK_SIZE pixels, directly encoded to the item buffer.
+	 */
+	void ShaderStrip::show() {
+		transmitWholeFrame();
+		if(strip_config.transmit_mode == TransmitMode::STREAMING) {
+			startStream();
+			// Any valid pointer : only the size is used by the translator
+			writeSample(shader_context.span, pixel_count * 3);
+			return;
+		}
+		PIXLED_TRACE_BEGIN(encode, "encode");
+		rgb_pixel block[Effect::BLOCK_SIZE];
+		uint8_t serialized[3 * Effect::BLOCK_SIZE];
+		rmt_item32_t* pCurrentItem = this->rmt_items;
+		for(uint32_t index = 0; index < pixel_count; index += Effect::BLOCK_SIZE) {
+			const uint16_t count = pixel_count - index < Effect::BLOCK_SIZE ? pixel_count - index : Effect::BLOCK_SIZE;
+			shader_context.effect->render(index, count, block);
+			for(uint16_t i = 0; i < count; i++)
+				shader_context.serializer.serialize(block[i], &serialized[3*i]);
+			pCurrentItem = encodeBytes(serialized, 3 * count, pCurrentItem);
+		}
+		setTerminator(pCurrentItem); // Write the RMT terminator.
+		PIXLED_TRACE_END(encode);
+
+		writeItems(pixel_count * 24);
+	} // show
+}
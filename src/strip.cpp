@@ -1,4 +1,11 @@
+#include <cassert>
+#include <cstring>
+
 #include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
+#include "soc/soc_caps.h"
 #include "strip.hpp"
 
 static const char* PIXLED_LOG_TAG = "PIXLED_DRIVER";
@@ -50,6 +57,31 @@ namespace pixled {
 		pItem->duration1 = strip_config.t0l;
 	} // setItem0
 
+	/**
+	 * Encodes `size` bytes of data to RMT items.
+	 *
+	 * Each byte is encoded to 8 items, from the most significant bit to the
+	 * least significant bit.
+	 *
+	 * @param data bytes to encode
+	 * @param size count of bytes to encode
+	 * @param pItem first item to write
+	 * @return item following the last written item
+	 */
+	rmt_item32_t* Strip::encodeBytes(const uint8_t* data, uint32_t size, rmt_item32_t* pItem) {
+		for(uint32_t i = 0; i < size; i++) {
+			for(int8_t j = 7; j >= 0; j--) {
+				if(data[i] & (1 << j)) {
+					setItem1(pItem);
+				} else {
+					setItem0(pItem);
+				}
+				pItem++;
+			}
+		}
+		return pItem;
+	} // encodeBytes
+
 	/**
 	 * Adds an RMT terminator into the RMT data.
 	 */
@@ -72,22 +104,30 @@ namespace pixled {
 	 *
 	 * @param gpio_num Led Strip GPIO. See https://docs.espressif.com/projects/esp-idf/en/stable/api-reference/peripherals/gpio.html#_CPPv410gpio_num_t
 	 * @param pixel_count Number of leds.
+	 * @param pixel_size Number of bytes used by each pixel in the buffer.
+	 * @param _buffer dynamically allocated color buffer, of size
+	 * pixel_count * pixel_size
 	 * @param channel RMT channel to use. See https://docs.espressif.com/projects/esp-idf/en/stable/api-reference/peripherals/rmt.html#_CPPv413rmt_channel_t
 	 * @param rmt_items dynamically allocated rmt buffer, according to the led type
 	 * and the strip length
-	 * @param config strip config, defined t0h, t0l, t1h and t1l
+	 * @param config strip config, defined t0h, t0l, t1h and t1l and the RMT
+	 * clock divider. A warning is logged if the timings are not valid.
 	 *
 	 */
 	Strip::Strip(
-			gpio_num_t gpio_num, uint16_t pixel_count, uint8_t* _buffer,
+			gpio_num_t gpio_num, uint32_t pixel_count, uint8_t pixel_size, uint8_t* _buffer,
 			rmt_channel_t channel, rmt_item32_t* rmt_items, StripConfig config)
-		: pixel_count(pixel_count), _buffer(_buffer), channel(channel), rmt_items(rmt_items), strip_config(config) {
+		: pixel_count(pixel_count), pixel_size(pixel_size), _buffer(_buffer), channel(channel), rmt_items(rmt_items), strip_config(config),
+		skip_unchanged(false), changed(true), keep_alive_us(0), written(false), buffer_shared(false), shown_frame(nullptr), last_transmission(0), skipped_frames(0),
+		mirror_count(0), frame_cache(nullptr), frame_key(0), frame_by_id(false), frame_pinned(false), frame_missed(false),
+		last_frame(nullptr), full_frame(true), prefix_items(UINT32_MAX), transmitted_pixels(0), truncated_pixels(0),
+		saved_bits(0), transmission_end(0) {
 			_rmt_config.rmt_mode                  = RMT_MODE_TX;
 			_rmt_config.channel                   = channel;
 			_rmt_config.gpio_num                  = gpio_num;
 			//_rmt_config.mem_block_num             = 8 - channel;
 			_rmt_config.mem_block_num             = 1;
-			_rmt_config.clk_div                   = 8;
+			_rmt_config.clk_div                   = config.clk_div;
 			_rmt_config.tx_config.loop_en         = 0;
 			_rmt_config.tx_config.carrier_en      = 0;
 			_rmt_config.tx_config.idle_output_en  = 1;
@@ -96,10 +136,331 @@ namespace pixled {
 			_rmt_config.tx_config.carrier_level   = RMT_CARRIER_LEVEL_HIGH;
 			_rmt_config.tx_config.carrier_duty_percent = 50;
 
+			if(!config.valid())
+				ESP_LOGW(PIXLED_LOG_TAG,
+						"Timings out of tolerance : t0h=%unS t0l=%unS t1h=%unS t1l=%unS",
+						(unsigned int) config.t0hNs(), (unsigned int) config.t0lNs(),
+						(unsigned int) config.t1hNs(), (unsigned int) config.t1lNs());
+
 			ESP_ERROR_CHECK(rmt_config(&_rmt_config));
 			ESP_ERROR_CHECK(rmt_driver_install(channel, 0, 0));
+
+			if(config.transmit_mode == TransmitMode::STREAMING) {
+				setItem0(&stream_context.bit0);
+				setItem1(&stream_context.bit1);
+				stream_context.buffer = _buffer;
+				stream_context.pixel_size = pixel_size;
+				ESP_ERROR_CHECK(rmt_translator_init(channel, translate));
+				ESP_ERROR_CHECK(rmt_translator_set_context(channel, &stream_context));
+			}
 		} // Strip
 
+	/**
+	 * Strip constructor for strips that do not use RMT.
+	 *
+	 * The channel is set to RMT_CHANNEL_MAX, and no RMT item buffer is
+	 * allocated.
+	 *
+	 * @param pixel_count Number of leds.
+	 * @param pixel_size Number of bytes used by each pixel in the buffer.
+	 * @param _buffer color buffer, of size pixel_count * pixel_size
+	 * @param config strip config, reported by stripConfig()
+	 */
+	Strip::Strip(uint32_t pixel_count, uint8_t pixel_size, uint8_t* _buffer, StripConfig config)
+		: pixel_count(pixel_count), pixel_size(pixel_size), _buffer(_buffer),
+		channel(RMT_CHANNEL_MAX), rmt_items(nullptr), strip_config(config),
+		skip_unchanged(false), changed(true), keep_alive_us(0), written(false), buffer_shared(false), shown_frame(nullptr), last_transmission(0), skipped_frames(0),
+		mirror_count(0), frame_cache(nullptr), frame_key(0), frame_by_id(false), frame_pinned(false), frame_missed(false),
+		last_frame(nullptr), full_frame(true), prefix_items(UINT32_MAX), transmitted_pixels(0), truncated_pixels(0),
+		saved_bits(0), transmission_end(0) {
+		} // Strip
+
+	rmt_item32_t* Strip::allocateItems(const StripConfig& config, uint32_t count) {
+		return config.transmit_mode == TransmitMode::STREAMING ? nullptr : new rmt_item32_t[count];
+	} // allocateItems
+
+	/**
+	 * Encodes buffer bytes, as requested by the RMT driver.
+	 *
+	 * Bytes are read in the order defined by `context.order`, so that the
+	 * color order can be applied on the fly.
+	 *
+	 * @param context stream context of the strip
+	 * @param data next byte to encode, in context.buffer
+	 * @param size count of bytes remaining in the buffer
+	 * @param dest items to write
+	 * @param wanted_num maximum count of items to write
+	 * @param translated_size count of encoded bytes
+	 * @param item_num count of written items
+	 */
+	void IRAM_ATTR Strip::encodeStream(const StreamContext& context, const uint8_t* data, size_t size,
+			rmt_item32_t* dest, size_t wanted_num, size_t* translated_size, size_t* item_num) {
+		uint8_t component = (data - context.buffer) % context.pixel_size;
+		const uint8_t* pixel = data - component;
+		size_t translated = 0;
+		size_t num = 0;
+		while(translated < size && num + 8 <= wanted_num) {
+			const uint8_t byte = pixel[context.order[component]];
+			for(uint8_t mask = 0x80; mask != 0; mask >>= 1)
+				dest[num++] = (byte & mask) ? context.bit1 : context.bit0;
+			translated++;
+			if(++component == context.pixel_size) {
+				component = 0;
+				pixel += context.pixel_size;
+			}
+		}
+		*translated_size = translated;
+		*item_num = num;
+	} // encodeStream
+
+	void IRAM_ATTR Strip::translate(const void* src, rmt_item32_t* dest, size_t src_size,
+			size_t wanted_num, size_t* translated_size, size_t* item_num) {
+		void* context;
+		rmt_translator_get_context(item_num, &context);
+		encodeStream(*static_cast<const StreamContext*>(context), static_cast<const uint8_t*>(src), src_size,
+				dest, wanted_num, translated_size, item_num);
+	} // translate
+
+	void Strip::streamBuffer(const uint8_t* order) {
+		std::memcpy(stream_context.order, order, pixel_size);
+		writeSample(_buffer, transmitted_pixels * pixel_size);
+	} // streamBuffer
+
+	void Strip::writeSample(const uint8_t* src, size_t size) {
+		waitReset();
+		PIXLED_TRACE_SPAN("rmt stream");
+		ESP_ERROR_CHECK(rmt_write_sample(channel, src, size, true /* wait till done */));
+		if(last_frame != nullptr)
+			transmission_end = esp_timer_get_time();
+	} // writeSample
+
+	void Strip::addMirror(gpio_num_t gpio_num, rmt_channel_t channel) {
+		assert(this->channel != RMT_CHANNEL_MAX);
+		assert(strip_config.transmit_mode == TransmitMode::BUFFERED);
+		assert(mirror_count < RMT_CHANNEL_MAX - 1);
+
+		rmt_config_t mirror_config = _rmt_config;
+		mirror_config.channel = channel;
+		mirror_config.gpio_num = gpio_num;
+		ESP_ERROR_CHECK(rmt_config(&mirror_config));
+		ESP_ERROR_CHECK(rmt_driver_install(channel, 0, 0));
+#if SOC_RMT_SUPPORT_TX_SYNCHRO
+		if(mirror_count == 0)
+			ESP_ERROR_CHECK(rmt_add_channel_to_group(this->channel));
+		ESP_ERROR_CHECK(rmt_add_channel_to_group(channel));
+#endif
+		mirrors[mirror_count++] = channel;
+	} // addMirror
+
+	/**
+	 * Transmits the encoded items on all the channels of the strip.
+	 *
+	 * All the transmissions are started without waiting, so that mirrors run
+	 * at the same time (or start on the same clock, in the synchronization
+	 * group), then each channel is waited for. This also separates the
+	 * submission from the transmission in traces.
+	 */
+	void Strip::transmit(const rmt_item32_t* items, uint32_t count) {
+		if(count > prefix_items)
+			count = prefix_items;
+		waitReset();
+		PIXLED_TRACE_BEGIN(submit, "rmt submit");
+		ESP_ERROR_CHECK(rmt_write_items(channel, items, count, false));
+		for(uint8_t i = 0; i < mirror_count; i++)
+			ESP_ERROR_CHECK(rmt_write_items(mirrors[i], items, count, false));
+		PIXLED_TRACE_END(submit);
+		PIXLED_TRACE_SPAN("rmt transmit");
+		ESP_ERROR_CHECK(rmt_wait_tx_done(channel, portMAX_DELAY));
+		for(uint8_t i = 0; i < mirror_count; i++)
+			ESP_ERROR_CHECK(rmt_wait_tx_done(mirrors[i], portMAX_DELAY));
+		if(last_frame != nullptr)
+			transmission_end = esp_timer_get_time();
+	} // transmit
+
+	void Strip::waitReset() {
+		if(last_frame == nullptr)
+			return;
+		const int64_t ready = transmission_end + strip_config.reset_us;
+		while(esp_timer_get_time() < ready);
+	} // waitReset
+
+	void Strip::writeItems(uint32_t count) {
+		transmit(rmt_items, count);
+		if(frame_missed) {
+			frame_cache->insert(frame_key, frame_by_id, frame_pinned,
+					_buffer, pixel_count * pixel_size, rmt_items, count);
+			frame_missed = false;
+		}
+		frame_by_id = false;
+	} // writeItems
+
+	void Strip::setFrameCache(FrameCache* cache) {
+		assert(cache == nullptr || (strip_config.transmit_mode == TransmitMode::BUFFERED && _buffer != nullptr));
+		frame_cache = cache;
+		frame_missed = false;
+	} // setFrameCache
+
+	void Strip::invalidateFrameCache() {
+		if(frame_cache != nullptr)
+			frame_cache->clear();
+	} // invalidateFrameCache
+
+	void Strip::setFrameId(uint32_t frame_id, bool pin) {
+		frame_key = frame_id;
+		frame_by_id = true;
+		frame_pinned = pin;
+	} // setFrameId
+
+	/**
+	 * Transmits the current frame from the frame cache, if possible.
+	 *
+	 * The frame ID set with setFrameId() is only used for this frame : the
+	 * next frames are identified by their content, unless a new ID is set.
+	 */
+	bool Strip::transmitCachedFrame(uint32_t count) {
+		if(frame_cache == nullptr)
+			return false;
+		if(!frame_by_id) {
+			frame_key = hashBuffer();
+			frame_pinned = false;
+		}
+		const rmt_item32_t* items = frame_cache->lookup(
+				frame_key, frame_by_id, _buffer, pixel_count * pixel_size, count);
+		frame_missed = (items == nullptr);
+		if(items != nullptr) {
+			transmit(items, count);
+			frame_by_id = false;
+		}
+		return items != nullptr;
+	} // transmitCachedFrame
+
+	void Strip::transmitChangedPrefix(bool enable) {
+		assert(!enable || (channel != RMT_CHANNEL_MAX && _buffer != nullptr));
+		delete[] last_frame;
+		last_frame = enable ? new uint8_t[pixel_count * pixel_size] : nullptr;
+		full_frame = true;
+		prefix_items = UINT32_MAX;
+		transmission_end = 0;
+	} // transmitChangedPrefix
+
+	/**
+	 * Finds the changed prefix of the current frame.
+	 *
+	 * The buffer is compared with the last transmitted frame from its end,
+	 * so that only the unchanged suffix is read. The prefix is then copied
+	 * as the last transmitted frame : the pixels after it are unchanged.
+	 */
+	uint32_t Strip::changedPrefix(uint16_t pixel_bits) {
+		if(last_frame == nullptr) {
+			transmitted_pixels = pixel_count;
+			return pixel_count;
+		}
+		uint32_t prefix = pixel_count;
+		if(!full_frame) {
+			uint32_t size = pixel_count * pixel_size;
+			while(size > 0 && _buffer[size-1] == last_frame[size-1])
+				size--;
+			prefix = (size + pixel_size - 1) / pixel_size;
+		}
+		full_frame = false;
+		if(prefix == 0)
+			// Nothing is transmitted
+			frame_by_id = false;
+		std::memcpy(last_frame, _buffer, prefix * pixel_size);
+		prefix_items = prefix * pixel_bits;
+		transmitted_pixels = prefix;
+		truncated_pixels += pixel_count - prefix;
+		saved_bits += (uint64_t) (pixel_count - prefix) * pixel_bits;
+		return prefix;
+	} // changedPrefix
+
+	void Strip::skipUnchangedFrames(bool enable, uint32_t keep_alive_ms) {
+		assert(!enable || _buffer != nullptr);
+		skip_unchanged = enable;
+		keep_alive_us = keep_alive_ms * 1000;
+		changed = true;
+		delete[] shown_frame;
+		shown_frame = enable ? new uint8_t[pixel_count * pixel_size] : nullptr;
+	} // skipUnchangedFrames
+
+	/*
+	 * FNV-1a like hash of the internal buffer, processed 32 bits at a time.
+	 */
+	uint32_t Strip::hashBuffer() const {
+		const uint32_t size = pixel_count * pixel_size;
+		uint32_t hash = 2166136261u;
+		uint32_t i = 0;
+		for(; i + 4 <= size; i += 4) {
+			uint32_t word;
+			std::memcpy(&word, &_buffer[i], 4);
+			hash = (hash ^ word) * 16777619u;
+		}
+		for(; i < size; i++)
+			hash = (hash ^ _buffer[i]) * 16777619u;
+		return hash;
+	} // hashBuffer
+
+	/*
+	 * The buffer is only compared with the last transmitted frame if it may
+	 * have been modified : a frame without any setter call is skipped in
+	 * constant time.
+	 */
+	bool Strip::frameChanged() {
+		if(!skip_unchanged)
+			return true;
+		const uint32_t size = pixel_count * pixel_size;
+		bool same = !changed;
+		if(same && (written || buffer_shared))
+			same = std::memcmp(_buffer, shown_frame, size) == 0;
+		written = false;
+		const int64_t now = esp_timer_get_time();
+		if(same && (keep_alive_us == 0 || now - last_transmission < keep_alive_us)) {
+			skipped_frames++;
+			frame_by_id = false;
+			return false;
+		}
+		if(same)
+			// Keep alive transmission
+			full_frame = true;
+		else
+			std::memcpy(shown_frame, _buffer, size);
+		changed = false;
+		last_transmission = now;
+		return true;
+	} // frameChanged
+
+	void Strip::copyPixels(uint32_t to, uint32_t from, uint32_t count) {
+		markWritten();
+		std::memmove(&_buffer[to*pixel_size], &_buffer[from*pixel_size], count*pixel_size);
+	} // copyPixels
+
+	void Strip::reversePixels(uint32_t index, uint32_t count) {
+		if(count < 2)
+			return;
+		markWritten();
+		uint8_t* low = &_buffer[index*pixel_size];
+		uint8_t* high = &_buffer[(index+count-1)*pixel_size];
+		uint8_t swap[4];
+		while(low < high) {
+			std::memcpy(swap, low, pixel_size);
+			std::memcpy(low, high, pixel_size);
+			std::memcpy(high, swap, pixel_size);
+			low += pixel_size;
+			high -= pixel_size;
+		}
+	} // reversePixels
+
+	void Strip::setRgb16Pixels(uint32_t index, const rgb16_pixel* pixels, uint32_t count) {
+		const uint32_t block_size = 32;
+		rgb_pixel block[block_size];
+		Rgb16ToRgbConverter rgb16_to_rgb;
+		for(uint32_t i = 0; i < count; i += block_size) {
+			uint32_t block_count = count - i < block_size ? count - i : block_size;
+			rgb16_to_rgb(&pixels[i], block, block_count);
+			setRgbPixels(index + i, block, block_count);
+		}
+	} // setRgb16Pixels
+
 	/**
 	 * Strip instance destructor.
 	 *
@@ -108,7 +469,20 @@ namespace pixled {
 	 */
 	Strip::~Strip() {
 		delete[] this->rmt_items;
-		ESP_ERROR_CHECK(rmt_driver_uninstall(channel));
+		delete[] last_frame;
+		delete[] shown_frame;
+		for(uint8_t i = 0; i < mirror_count; i++) {
+#if SOC_RMT_SUPPORT_TX_SYNCHRO
+			ESP_ERROR_CHECK(rmt_remove_channel_from_group(mirrors[i]));
+#endif
+			ESP_ERROR_CHECK(rmt_driver_uninstall(mirrors[i]));
+		}
+#if SOC_RMT_SUPPORT_TX_SYNCHRO
+		if(mirror_count > 0)
+			ESP_ERROR_CHECK(rmt_remove_channel_from_group(channel));
+#endif
+		if(channel != RMT_CHANNEL_MAX)
+			ESP_ERROR_CHECK(rmt_driver_uninstall(channel));
 	} // ~Strip()
 
 	/************/
@@ -140,11 +514,14 @@ namespace pixled {
 	 * @param channel RMT channel to use. See https://docs.espressif.com/projects/esp-idf/en/stable/api-reference/peripherals/rmt.html#_CPPv413rmt_channel_t
 	 * @param config RGB strip config
 	 */
-	RgbStrip::RgbStrip(gpio_num_t gpio_num, uint16_t pixel_count, rmt_channel_t channel, RgbStripConfig config) :
+	RgbStrip::RgbStrip(gpio_num_t gpio_num, uint32_t pixel_count, rmt_channel_t channel, RgbStripConfig config) :
 		Strip(
-				gpio_num, pixel_count, new uint8_t[pixel_count*3],
-				channel, new rmt_item32_t[pixel_count * 24 + 1], config),
-		rgb_strip_config(config)  {
+				gpio_num, pixel_count, 3, new uint8_t[pixel_count*3],
+				channel, allocateItems(config, pixel_count * 24 + 1), config),
+		rgb_strip_config(config),
+		buffer_serializer(config.buffer_order == BufferOrder::LOGICAL ? RGB : config.serializer) {
+			(config.buffer_order == BufferOrder::LOGICAL ? config.serializer : RGB)
+				.serialize({0, 1, 2}, chip_order);
 			clear();
 		};
 
@@ -157,21 +534,46 @@ namespace pixled {
 	 * @param pixel_count Number of leds.
 	 * @param config RGB strip config
 	 */
-	RgbStrip::RgbStrip(gpio_num_t gpio_num, uint16_t pixel_count, RgbStripConfig config) :
+	RgbStrip::RgbStrip(gpio_num_t gpio_num, uint32_t pixel_count, RgbStripConfig config) :
 		RgbStrip(gpio_num, pixel_count, RMT_CHANNEL_0, config) {
 		};
 
+	RgbStrip::RgbStrip(uint32_t pixel_count, RgbStripConfig config) :
+		Strip(pixel_count, 3, new uint8_t[pixel_count*3], config),
+		rgb_strip_config(config),
+		buffer_serializer(config.buffer_order == BufferOrder::LOGICAL ? RGB : config.serializer) {
+			(config.buffer_order == BufferOrder::LOGICAL ? config.serializer : RGB)
+				.serialize({0, 1, 2}, chip_order);
+			clear();
+		}
+
 	/**
 	 * Transmits the current buffer to the RGB strip.
+	 *
+	 * Bytes of each pixel are read in the chip order, so that the color order
+	 * is applied at no cost in BufferOrder::LOGICAL mode.
 	 */
 	void RgbStrip::show() {
+		if(!frameChanged())
+			return;
+		const uint32_t prefix = changedPrefix(24);
+		if(prefix == 0)
+			return;
+		if(strip_config.transmit_mode == TransmitMode::STREAMING) {
+			streamBuffer(chip_order);
+			return;
+		}
+		if(transmitCachedFrame(this->pixel_count * 24))
+			return;
+		PIXLED_TRACE_BEGIN(encode, "encode");
 		rmt_item32_t* pCurrentItem = this->rmt_items;
+		const uint32_t encoded = encodedPixels(prefix);
 
-		for (uint16_t i = 0; i < this->pixel_count; i++) {
+		for(uint32_t i = 0; i < encoded; i++) {
 			uint32_t current_pixel =
-				(_buffer[3*i] << 16) |
-				(_buffer[3*i+1] << 8)  |
-				_buffer[3*i+2];
+				(_buffer[3*i+chip_order[0]] << 16) |
+				(_buffer[3*i+chip_order[1]] << 8)  |
+				_buffer[3*i+chip_order[2]];
 
 			ESP_LOGD(PIXLED_LOG_TAG, "Pixel value: %x", current_pixel);
 			for (int8_t j = 23; j >= 0; j--) {
@@ -188,9 +590,10 @@ namespace pixled {
 			}
 		}
 		setTerminator(pCurrentItem); // Write the RMT terminator.
+		PIXLED_TRACE_END(encode);
 
 		// Show the pixels.
-		ESP_ERROR_CHECK(rmt_write_items(this->channel, this->rmt_items, this->pixel_count * 24, 1 /*[> wait till done <]*/));
+		writeItems(encoded * 24);
 	} // show
 
 	/**
@@ -207,8 +610,9 @@ namespace pixled {
 	 * @param blue blue value, between 0 and 255.
 	 *
 	 */
-	void RgbStrip::setRgbPixel(uint16_t index, uint8_t red, uint8_t green, uint8_t blue) {
-		rgb_strip_config.serializer.serialize({red, green, blue}, &_buffer[index*3]);
+	void RgbStrip::setRgbPixel(uint32_t index, uint8_t red, uint8_t green, uint8_t blue) {
+		markWritten();
+		buffer_serializer.serialize({red, green, blue}, &_buffer[index*3]);
 	} // setRgbPixel
 
 	/**
@@ -224,12 +628,54 @@ namespace pixled {
 	 * @param saturation saturation value, between 0 and 1.
 	 * @param brightness brightness value, between 0 and 1.
 	 */
-	void RgbStrip::setHsbPixel(uint16_t index, float hue, float saturation, float brightness) {
-		rgb_strip_config.serializer.serialize(
+	void RgbStrip::setHsbPixel(uint32_t index, float hue, float saturation, float brightness) {
+		markWritten();
+		buffer_serializer.serialize(
 				hsb_to_rgb({hue, saturation, brightness}),
 				&_buffer[3*index]);
 	} // setHsbPixel
 
+	/**
+	 * Writes `count` consecutive RGB pixels, starting at `index`.
+	 *
+	 * The LEDs are not actually updated until a call to show().
+	 *
+	 * @param index position of the first led
+	 * @param pixels RGB colors to write
+	 * @param count number of pixels to write
+	 */
+	void RgbStrip::setRgbPixels(uint32_t index, const rgb_pixel* pixels, uint32_t count) {
+		PIXLED_TRACE_SPAN("setRgbPixels");
+		markWritten();
+		uint8_t* output = &_buffer[3*index];
+		for(uint32_t i = 0; i < count; i++) {
+			buffer_serializer.serialize(pixels[i], output);
+			output+=3;
+		}
+	} // setRgbPixels
+
+	/**
+	 * Sets `count` consecutive pixels, starting at `index`, to the same RGB
+	 * color.
+	 *
+	 * The LEDs are not actually updated until a call to show().
+	 *
+	 * @param index position of the first led
+	 * @param count number of pixels to fill
+	 * @param color RGB color
+	 */
+	void RgbStrip::fillRgb(uint32_t index, uint32_t count, const rgb_pixel& color) {
+		PIXLED_TRACE_SPAN("fillRgb");
+		markWritten();
+		uint8_t serialized[3];
+		buffer_serializer.serialize(color, serialized);
+		uint8_t* output = &_buffer[3*index];
+		for(uint32_t i = 0; i < count; i++) {
+			std::memcpy(output, serialized, 3);
+			output+=3;
+		}
+	} // fillRgb
+
 	/**
 	 * Clears all the pixel colors.
 	 *
@@ -238,7 +684,8 @@ namespace pixled {
 	 * The LEDs are not actually updated until a call to show().
 	 */
 	void RgbStrip::clear() {
-		for (uint16_t i = 0; i < this->pixel_count; i++) {
+		markWritten();
+		for(uint32_t i = 0; i < this->pixel_count; i++) {
 			_buffer[3*i] = 0;
 			_buffer[3*i+1] = 0;
 			_buffer[3*i+2] = 0;
@@ -291,13 +738,16 @@ namespace pixled {
 	 * @param config RGBW strip config
 	 *
 	 */
-	RgbwStrip::RgbwStrip(gpio_num_t gpio_num, uint16_t pixel_count, rmt_channel_t channel, RgbwStripConfig config):
+	RgbwStrip::RgbwStrip(gpio_num_t gpio_num, uint32_t pixel_count, rmt_channel_t channel, RgbwStripConfig config):
 		Strip(
-				gpio_num, pixel_count, new uint8_t[pixel_count*4],
-				channel, new rmt_item32_t[pixel_count * 32 + 1], config),
+				gpio_num, pixel_count, 4, new uint8_t[pixel_count*4],
+				channel, allocateItems(config, pixel_count * 32 + 1), config),
 		rgbw_strip_config(config),
-		rgb_to_rgbw()
+		rgb_to_rgbw(),
+		buffer_serializer(config.buffer_order == BufferOrder::LOGICAL ? RGBW : config.serializer)
 	{
+		(config.buffer_order == BufferOrder::LOGICAL ? config.serializer : RGBW)
+			.serialize({0, 1, 2, 3}, chip_order);
 		/*
 		 *if (RGB_TO_RGBW_1) {
 		 *    ESP_LOGI(PIXLED_LOG_TAG, "RGB_TO_RGBW_1 selected");
@@ -319,21 +769,46 @@ namespace pixled {
 	 * @param pixel_count Number of leds.
 	 * @param config RGBW strip config
 	 */
-	RgbwStrip::RgbwStrip(gpio_num_t gpio_num, uint16_t pixel_count, RgbwStripConfig config)
+	RgbwStrip::RgbwStrip(gpio_num_t gpio_num, uint32_t pixel_count, RgbwStripConfig config)
 		: RgbwStrip(gpio_num, pixel_count, RMT_CHANNEL_0, config) {}
 
+	RgbwStrip::RgbwStrip(uint32_t pixel_count, RgbwStripConfig config) :
+		Strip(pixel_count, 4, new uint8_t[pixel_count*4], config),
+		rgbw_strip_config(config),
+		buffer_serializer(config.buffer_order == BufferOrder::LOGICAL ? RGBW : config.serializer) {
+			(config.buffer_order == BufferOrder::LOGICAL ? config.serializer : RGBW)
+				.serialize({0, 1, 2, 3}, chip_order);
+			clear();
+		}
+
 	/**
 	 * Transmits the current buffer to the RGBW strip.
+	 *
+	 * Bytes of each pixel are read in the chip order, so that the color order
+	 * is applied at no cost in BufferOrder::LOGICAL mode.
 	 */
 	void RgbwStrip::show() {
+		if(!frameChanged())
+			return;
+		const uint32_t prefix = changedPrefix(32);
+		if(prefix == 0)
+			return;
+		if(strip_config.transmit_mode == TransmitMode::STREAMING) {
+			streamBuffer(chip_order);
+			return;
+		}
+		if(transmitCachedFrame(this->pixel_count * 32))
+			return;
+		PIXLED_TRACE_BEGIN(encode, "encode");
 		rmt_item32_t* pCurrentItem = this->rmt_items;
+		const uint32_t encoded = encodedPixels(prefix);
 
-		for (uint16_t i = 0; i < this->pixel_count; i++) {
+		for(uint32_t i = 0; i < encoded; i++) {
 			uint32_t current_pixel =
-				(_buffer[4*i] << 24) |
-				(_buffer[4*i+1] << 16) |
-				(_buffer[4*i+2] << 8) |
-				_buffer[4*i+3];
+				(_buffer[4*i+chip_order[0]] << 24) |
+				(_buffer[4*i+chip_order[1]] << 16) |
+				(_buffer[4*i+chip_order[2]] << 8) |
+				_buffer[4*i+chip_order[3]];
 
 			ESP_LOGD(PIXLED_LOG_TAG, "RGBW Pixel value: %x", current_pixel);
 			for (int8_t j = 31; j >= 0; j--) {
@@ -350,9 +825,10 @@ namespace pixled {
 			}
 		}
 		setTerminator(pCurrentItem); // Write the RMT terminator.
+		PIXLED_TRACE_END(encode);
 
 		// Show the pixels.
-		ESP_ERROR_CHECK(rmt_write_items(this->channel, this->rmt_items, this->pixel_count * 32, 1 /* wait till done */));
+		writeItems(encoded * 32);
 	} // show
 
 	/**
@@ -369,8 +845,9 @@ namespace pixled {
 	 * @param blue blue value, between 0 and 255.
 	 *
 	 */
-	void RgbwStrip::setRgbPixel(uint16_t index, uint8_t red, uint8_t green, uint8_t blue) {
-		rgbw_strip_config.serializer.serialize(rgb_to_rgbw({red, green, blue}), &_buffer[index*4]);
+	void RgbwStrip::setRgbPixel(uint32_t index, uint8_t red, uint8_t green, uint8_t blue) {
+		markWritten();
+		buffer_serializer.serialize(rgb_to_rgbw({red, green, blue}), &_buffer[index*4]);
 	} // setRgbPixel
 
 	/**
@@ -387,8 +864,9 @@ namespace pixled {
 	 * @param blue blue value, between 0 and 255.
 	 * @param white white value, between 0 and 255.
 	 */
-	void RgbwStrip::setRgbwPixel(uint16_t index, uint8_t red, uint8_t green, uint8_t blue, uint8_t white) {
-		rgbw_strip_config.serializer.serialize({red, green, blue, white}, &_buffer[index*4]);
+	void RgbwStrip::setRgbwPixel(uint32_t index, uint8_t red, uint8_t green, uint8_t blue, uint8_t white) {
+		markWritten();
+		buffer_serializer.serialize({red, green, blue, white}, &_buffer[index*4]);
 	} // setRgbPixel
 
 	/**
@@ -404,13 +882,59 @@ namespace pixled {
 	 * @param saturation saturation value, between 0 and 1.
 	 * @param brightness brightness value, between 0 and 1.
 	 */
-	void RgbwStrip::setHsbPixel(uint16_t index, float hue, float saturation, float brightness) {
-		rgbw_strip_config.serializer.serialize(
+	void RgbwStrip::setHsbPixel(uint32_t index, float hue, float saturation, float brightness) {
+		markWritten();
+		buffer_serializer.serialize(
 				rgb_to_rgbw(hsb_to_rgb({hue, saturation, brightness})),
 				&_buffer[index*4]
 				);
 	} // setHsbPixel
 
+	/**
+	 * Writes `count` consecutive RGB pixels, starting at `index`.
+	 *
+	 * Each color is converted to RGBW, as with setRgbPixel().
+	 *
+	 * The LEDs are not actually updated until a call to show().
+	 *
+	 * @param index position of the first led
+	 * @param pixels RGB colors to write
+	 * @param count number of pixels to write
+	 */
+	void RgbwStrip::setRgbPixels(uint32_t index, const rgb_pixel* pixels, uint32_t count) {
+		PIXLED_TRACE_SPAN("setRgbPixels");
+		markWritten();
+		uint8_t* output = &_buffer[4*index];
+		for(uint32_t i = 0; i < count; i++) {
+			buffer_serializer.serialize(rgb_to_rgbw(pixels[i]), output);
+			output+=4;
+		}
+	} // setRgbPixels
+
+	/**
+	 * Sets `count` consecutive pixels, starting at `index`, to the same RGB
+	 * color.
+	 *
+	 * The color is converted to RGBW only once.
+	 *
+	 * The LEDs are not actually updated until a call to show().
+	 *
+	 * @param index position of the first led
+	 * @param count number of pixels to fill
+	 * @param color RGB color
+	 */
+	void RgbwStrip::fillRgb(uint32_t index, uint32_t count, const rgb_pixel& color) {
+		PIXLED_TRACE_SPAN("fillRgb");
+		markWritten();
+		uint8_t serialized[4];
+		buffer_serializer.serialize(rgb_to_rgbw(color), serialized);
+		uint8_t* output = &_buffer[4*index];
+		for(uint32_t i = 0; i < count; i++) {
+			std::memcpy(output, serialized, 4);
+			output+=4;
+		}
+	} // fillRgb
+
 	/**
 	 * Clears all the pixel colors.
 	 *
@@ -419,7 +943,8 @@ namespace pixled {
 	 * The LEDs are not actually updated until a call to show().
 	 */
 	void RgbwStrip::clear() {
-		for (uint16_t i = 0; i < this->pixel_count; i++) {
+		markWritten();
+		for(uint32_t i = 0; i < this->pixel_count; i++) {
 			_buffer[4*i] = 0;
 			_buffer[4*i+1] = 0;
 			_buffer[4*i+2] = 0;
@@ -0,0 +1,285 @@
+#include <cstring>
+
+#include "strip16.hpp"
+
+namespace pixled {
+	/*
+	 * Expands an 8 bits channel value to 16 bits, so that 255 maps to 65535.
+	 */
+	static inline uint16_t expand(uint8_t value) {
+		return value * 257;
+	}
+
+	/**************/
+	/* Rgb16Strip */
+	/**************/
+
+	/**
+	 * Rgb16Strip constructor.
+	 *
+	 * Predefined configurations are available for the following 16 bits RGB
+	 * LED strip models :
+	 * - WS2816
+	 * - UCS8903
+	 *
+	 * Example usage :
+	 * ```
+	 * Rgb16Strip strip {GPIO_NUM_12, 20, RMT_CHANNEL_0, UCS8903()};
+	 * ```
+	 *
+	 * @param gpio_num Led Strip GPIO.
+	 * @param pixel_count Number of leds.
+	 * @param channel RMT channel to use.
+	 * @param config 16 bits RGB strip config
+	 */
+	Rgb16Strip::Rgb16Strip(gpio_num_t gpio_num, uint32_t pixel_count, rmt_channel_t channel, Rgb16StripConfig config) :
+		Strip(
+				gpio_num, pixel_count, 6, new uint8_t[pixel_count*6],
+				channel, allocateItems(config, pixel_count * 48 + 1), config),
+		rgb16_strip_config(config) {
+			clear();
+		}
+
+	/**
+	 * Rgb16Strip constructor with a default RMT channel set to RMT_CHANNEL_0.
+	 */
+	Rgb16Strip::Rgb16Strip(gpio_num_t gpio_num, uint32_t pixel_count, Rgb16StripConfig config) :
+		Rgb16Strip(gpio_num, pixel_count, RMT_CHANNEL_0, config) {
+		}
+
+	/**
+	 * Transmits the current buffer to the strip, 48 bits per led.
+	 */
+	void Rgb16Strip::show() {
+		if(!frameChanged())
+			return;
+		const uint32_t prefix = changedPrefix(48);
+		if(prefix == 0)
+			return;
+		if(strip_config.transmit_mode == TransmitMode::STREAMING) {
+			const uint8_t order[6] = {0, 1, 2, 3, 4, 5};
+			streamBuffer(order);
+			return;
+		}
+		if(transmitCachedFrame(pixel_count * 48))
+			return;
+		PIXLED_TRACE_BEGIN(encode, "encode");
+		const uint32_t encoded = encodedPixels(prefix);
+		rmt_item32_t* pCurrentItem = encodeBytes(_buffer, encoded * 6, rmt_items);
+		setTerminator(pCurrentItem); // Write the RMT terminator.
+		PIXLED_TRACE_END(encode);
+
+		// Show the pixels.
+		writeItems(encoded * 48);
+	} // show
+
+	void Rgb16Strip::setRgbPixel(uint32_t index, uint8_t red, uint8_t green, uint8_t blue) {
+		setRgb16Pixel(index, expand(red), expand(green), expand(blue));
+	} // setRgbPixel
+
+	void Rgb16Strip::setHsbPixel(uint32_t index, float hue, float saturation, float brightness) {
+		rgb_pixel rgb = hsb_to_rgb({hue, saturation, brightness});
+		setRgb16Pixel(index, expand(rgb.red), expand(rgb.green), expand(rgb.blue));
+	} // setHsbPixel
+
+	void Rgb16Strip::setRgbPixels(uint32_t index, const rgb_pixel* pixels, uint32_t count) {
+		PIXLED_TRACE_SPAN("setRgbPixels");
+		markWritten();
+		for(uint32_t i = 0; i < count; i++)
+			rgb16_strip_config.serializer.serialize(
+					{expand(pixels[i].red), expand(pixels[i].green), expand(pixels[i].blue)},
+					&_buffer[6*(index+i)]);
+	} // setRgbPixels
+
+	void Rgb16Strip::fillRgb(uint32_t index, uint32_t count, const rgb_pixel& color) {
+		PIXLED_TRACE_SPAN("fillRgb");
+		markWritten();
+		uint8_t serialized[6];
+		rgb16_strip_config.serializer.serialize(
+				{expand(color.red), expand(color.green), expand(color.blue)}, serialized);
+		for(uint32_t i = 0; i < count; i++)
+			std::memcpy(&_buffer[6*(index+i)], serialized, 6);
+	} // fillRgb
+
+	/**
+	 * Sets the value of the led at position `index` with the specified 16 bits
+	 * RGB values.
+	 *
+	 * The LEDs are not actually updated until a call to show().
+	 *
+	 * @param index position of the led
+	 * @param red red value, between 0 and 65535.
+	 * @param green green value, between 0 and 65535.
+	 * @param blue blue value, between 0 and 65535.
+	 */
+	void Rgb16Strip::setRgb16Pixel(uint32_t index, uint16_t red, uint16_t green, uint16_t blue) {
+		markWritten();
+		rgb16_strip_config.serializer.serialize({red, green, blue}, &_buffer[6*index]);
+	} // setRgb16Pixel
+
+	void Rgb16Strip::setRgb16Pixels(uint32_t index, const rgb16_pixel* pixels, uint32_t count) {
+		PIXLED_TRACE_SPAN("setRgb16Pixels");
+		markWritten();
+		for(uint32_t i = 0; i < count; i++)
+			rgb16_strip_config.serializer.serialize(pixels[i], &_buffer[6*(index+i)]);
+	} // setRgb16Pixels
+
+	void Rgb16Strip::clear() {
+		markWritten();
+		std::memset(_buffer, 0, pixel_count * 6);
+	} // clear
+
+	/**
+	 * Rgb16Strip destructor.
+	 *
+	 * The internal buffer is deleted, and should not be accessed any more.
+	 */
+	Rgb16Strip::~Rgb16Strip() {
+		delete[] this->_buffer;
+	}
+
+	/***************/
+	/* Rgbw16Strip */
+	/***************/
+
+	/**
+	 * Rgbw16Strip constructor.
+	 *
+	 * Predefined configurations are available for the following 16 bits RGBW
+	 * LED strip models :
+	 * - UCS8904
+	 *
+	 * 8 bits RGB colors are converted to RGBW as with RgbwStrip, and then
+	 * expanded to 16 bits. 16 bits RGB colors are converted by extracting
+	 * their white component.
+	 *
+	 * @param gpio_num Led Strip GPIO.
+	 * @param pixel_count Number of leds.
+	 * @param channel RMT channel to use.
+	 * @param config 16 bits RGBW strip config
+	 */
+	Rgbw16Strip::Rgbw16Strip(gpio_num_t gpio_num, uint32_t pixel_count, rmt_channel_t channel, Rgbw16StripConfig config) :
+		Strip(
+				gpio_num, pixel_count, 8, new uint8_t[pixel_count*8],
+				channel, allocateItems(config, pixel_count * 64 + 1), config),
+		rgbw16_strip_config(config) {
+			clear();
+		}
+
+	/**
+	 * Rgbw16Strip constructor with a default RMT channel set to RMT_CHANNEL_0.
+	 */
+	Rgbw16Strip::Rgbw16Strip(gpio_num_t gpio_num, uint32_t pixel_count, Rgbw16StripConfig config) :
+		Rgbw16Strip(gpio_num, pixel_count, RMT_CHANNEL_0, config) {
+		}
+
+	/**
+	 * Transmits the current buffer to the strip, 64 bits per led.
+	 */
+	void Rgbw16Strip::show() {
+		if(!frameChanged())
+			return;
+		const uint32_t prefix = changedPrefix(64);
+		if(prefix == 0)
+			return;
+		if(strip_config.transmit_mode == TransmitMode::STREAMING) {
+			const uint8_t order[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+			streamBuffer(order);
+			return;
+		}
+		if(transmitCachedFrame(pixel_count * 64))
+			return;
+		PIXLED_TRACE_BEGIN(encode, "encode");
+		const uint32_t encoded = encodedPixels(prefix);
+		rmt_item32_t* pCurrentItem = encodeBytes(_buffer, encoded * 8, rmt_items);
+		setTerminator(pCurrentItem); // Write the RMT terminator.
+		PIXLED_TRACE_END(encode);
+
+		// Show the pixels.
+		writeItems(encoded * 64);
+	} // show
+
+	rgbw16_pixel Rgbw16Strip::toRgbw16(const rgb_pixel& pixel) const {
+		rgbw_pixel rgbw = rgb_to_rgbw(pixel);
+		return {expand(rgbw.red), expand(rgbw.green), expand(rgbw.blue), expand(rgbw.white)};
+	} // toRgbw16
+
+	void Rgbw16Strip::setRgbPixel(uint32_t index, uint8_t red, uint8_t green, uint8_t blue) {
+		markWritten();
+		rgbw16_strip_config.serializer.serialize(toRgbw16({red, green, blue}), &_buffer[8*index]);
+	} // setRgbPixel
+
+	void Rgbw16Strip::setHsbPixel(uint32_t index, float hue, float saturation, float brightness) {
+		markWritten();
+		rgbw16_strip_config.serializer.serialize(
+				toRgbw16(hsb_to_rgb({hue, saturation, brightness})), &_buffer[8*index]);
+	} // setHsbPixel
+
+	void Rgbw16Strip::setRgbPixels(uint32_t index, const rgb_pixel* pixels, uint32_t count) {
+		PIXLED_TRACE_SPAN("setRgbPixels");
+		markWritten();
+		for(uint32_t i = 0; i < count; i++)
+			rgbw16_strip_config.serializer.serialize(toRgbw16(pixels[i]), &_buffer[8*(index+i)]);
+	} // setRgbPixels
+
+	void Rgbw16Strip::fillRgb(uint32_t index, uint32_t count, const rgb_pixel& color) {
+		PIXLED_TRACE_SPAN("fillRgb");
+		markWritten();
+		uint8_t serialized[8];
+		rgbw16_strip_config.serializer.serialize(toRgbw16(color), serialized);
+		for(uint32_t i = 0; i < count; i++)
+			std::memcpy(&_buffer[8*(index+i)], serialized, 8);
+	} // fillRgb
+
+	/**
+	 * Sets the value of the led at position `index` with the specified 16 bits
+	 * RGB values.
+	 *
+	 * The white component is extracted as in RgbwStrip::setRgbPixel(), with
+	 * RGB_TO_RGBW_CONVERTER scaled to 16 bits.
+	 *
+	 * @param index position of the led
+	 * @param red red value, between 0 and 65535.
+	 * @param green green value, between 0 and 65535.
+	 * @param blue blue value, between 0 and 65535.
+	 */
+	void Rgbw16Strip::setRgb16Pixel(uint32_t index, uint16_t red, uint16_t green, uint16_t blue) {
+		const rgbw16_pixel rgbw = RGB_TO_RGBW_CONVERTER::convert16({red, green, blue});
+		setRgbw16Pixel(index, rgbw.red, rgbw.green, rgbw.blue, rgbw.white);
+	} // setRgb16Pixel
+
+	void Rgbw16Strip::setRgb16Pixels(uint32_t index, const rgb16_pixel* pixels, uint32_t count) {
+		PIXLED_TRACE_SPAN("setRgb16Pixels");
+		for(uint32_t i = 0; i < count; i++)
+			setRgb16Pixel(index + i, pixels[i].red, pixels[i].green, pixels[i].blue);
+	} // setRgb16Pixels
+
+	/**
+	 * Sets the value of the led at position `index` with the specified 16 bits
+	 * RGBW values.
+	 *
+	 * @param index position of the led
+	 * @param red red value, between 0 and 65535.
+	 * @param green green value, between 0 and 65535.
+	 * @param blue blue value, between 0 and 65535.
+	 * @param white white value, between 0 and 65535.
+	 */
+	void Rgbw16Strip::setRgbw16Pixel(uint32_t index, uint16_t red, uint16_t green, uint16_t blue, uint16_t white) {
+		markWritten();
+		rgbw16_strip_config.serializer.serialize({red, green, blue, white}, &_buffer[8*index]);
+	} // setRgbw16Pixel
+
+	void Rgbw16Strip::clear() {
+		markWritten();
+		std::memset(_buffer, 0, pixel_count * 8);
+	} // clear
+
+	/**
+	 * Rgbw16Strip destructor.
+	 *
+	 * The internal buffer is deleted, and should not be accessed any more.
+	 */
+	Rgbw16Strip::~Rgbw16Strip() {
+		delete[] this->_buffer;
+	}
+}
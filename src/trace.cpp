@@ -0,0 +1,171 @@
+#include <atomic>
+#include <cassert>
+#include <cinttypes>
+
+#include "trace.hpp"
+
+#ifdef ESP_PLATFORM
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#else
+#include <chrono>
+#include <functional>
+#include <thread>
+#endif
+
+namespace pixled {
+	/*
+	 * A slot of the ring buffer.
+	 *
+	 * `sequence` is 2*n+1 while the n-th span is written to the slot, and
+	 * 2*n+2 once it is complete.
+	 */
+	struct trace_slot {
+		std::atomic<uint32_t> sequence;
+		trace_event event;
+	};
+
+	static trace_slot* ring = nullptr;
+	static uint32_t ring_capacity = 0;
+	static std::atomic<uint32_t> ring_head {0};
+	static std::atomic<bool> recording {false};
+
+	static uint32_t current_thread() {
+#ifdef ESP_PLATFORM
+		return (uint32_t) (uintptr_t) xTaskGetCurrentTaskHandle();
+#else
+		return (uint32_t) std::hash<std::thread::id>()(std::this_thread::get_id());
+#endif
+	} // current_thread
+
+	static uint8_t current_core() {
+#ifdef ESP_PLATFORM
+		return xPortGetCoreID();
+#else
+		return 0;
+#endif
+	} // current_core
+
+	void Trace::start(uint32_t capacity) {
+		assert(capacity > 0);
+		recording.store(false);
+		if(capacity != ring_capacity) {
+			delete[] ring;
+			ring = new trace_slot[capacity];
+			ring_capacity = capacity;
+		}
+		for(uint32_t i = 0; i < capacity; i++)
+			ring[i].sequence.store(0, std::memory_order_relaxed);
+		ring_head.store(0);
+		recording.store(true);
+	} // start
+
+	void Trace::stop() {
+		recording.store(false);
+	} // stop
+
+	bool Trace::enabled() {
+		return recording.load(std::memory_order_relaxed);
+	} // enabled
+
+	int64_t Trace::now() {
+#ifdef ESP_PLATFORM
+		return esp_timer_get_time();
+#else
+		return std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+	} // now
+
+	/**
+	 * Records a span.
+	 *
+	 * The slot is reserved with a single fetch_add() on the head, so that
+	 * concurrent writers never wait for each other.
+	 */
+	void Trace::record(const char* name, int64_t start, int64_t end) {
+		if(!recording.load(std::memory_order_relaxed))
+			return;
+		const uint32_t index = ring_head.fetch_add(1, std::memory_order_relaxed);
+		trace_slot& slot = ring[index % ring_capacity];
+		slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		slot.event.name = name;
+		slot.event.start = start;
+		slot.event.duration = (uint32_t) (end - start);
+		slot.event.thread = current_thread();
+		slot.event.core = current_core();
+		slot.sequence.store(2 * index + 2, std::memory_order_release);
+	} // record
+
+	uint32_t Trace::eventCount() {
+		const uint32_t head = ring_head.load();
+		return head < ring_capacity ? head : ring_capacity;
+	} // eventCount
+
+	uint32_t Trace::overwrittenCount() {
+		const uint32_t head = ring_head.load();
+		return head < ring_capacity ? 0 : head - ring_capacity;
+	} // overwrittenCount
+
+	/**
+	 * Copies a span, following the seqlock protocol : the copy is only valid
+	 * if the slot sequence is the expected one before and after the copy.
+	 */
+	bool Trace::event(uint32_t index, trace_event& event) {
+		const uint32_t head = ring_head.load(std::memory_order_acquire);
+		const uint32_t first = head < ring_capacity ? 0 : head - ring_capacity;
+		if(index >= head - first)
+			return false;
+		const uint32_t n = first + index;
+		const trace_slot& slot = ring[n % ring_capacity];
+		if(slot.sequence.load(std::memory_order_acquire) != 2 * n + 2)
+			return false;
+		event = slot.event;
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return slot.sequence.load(std::memory_order_relaxed) == 2 * n + 2;
+	} // event
+
+	/**
+	 * Writes all the retained spans as Chrome trace JSON.
+	 *
+	 * Complete events ("ph":"X") are used, so that each span is a single
+	 * object. Each core is a process, named with a metadata event.
+	 */
+	uint32_t Trace::dump(FILE* output) {
+		std::fprintf(output, "{\"traceEvents\":[\n");
+#ifdef ESP_PLATFORM
+		const int cores = portNUM_PROCESSORS;
+#else
+		const int cores = 1;
+#endif
+		for(int core = 0; core < cores; core++)
+			std::fprintf(output,
+					"%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"core %d\"}}",
+					core > 0 ? ",\n" : "", core, core);
+
+		uint32_t written = 0;
+		const uint32_t count = eventCount();
+		trace_event event;
+		for(uint32_t i = 0; i < count; i++) {
+			if(!Trace::event(i, event))
+				continue;
+			std::fprintf(output,
+					",\n{\"name\":\"%s\",\"cat\":\"pixled\",\"ph\":\"X\",\"ts\":%" PRId64
+					",\"dur\":%" PRIu32 ",\"pid\":%u,\"tid\":%" PRIu32 "}",
+					event.name, event.start, event.duration, (unsigned int) event.core, event.thread);
+			written++;
+		}
+		std::fprintf(output, "\n],\"displayTimeUnit\":\"ms\"}\n");
+		return written;
+	} // dump
+
+	void Trace::clear() {
+		recording.store(false);
+		delete[] ring;
+		ring = nullptr;
+		ring_capacity = 0;
+		ring_head.store(0);
+	} // clear
+}
@@ -0,0 +1,119 @@
+#include <cassert>
+#include <cstring>
+
+#include "transition.hpp"
+
+namespace pixled {
+	Transition::Transition(Strip& strip)
+		: strip(strip), size(strip.length() * strip.pixelSize()),
+		source(new uint8_t[size]), target(new uint8_t[size]),
+		offsets(new uint32_t[size]), values(new int32_t[size]), increments(new int32_t[size]),
+		active_count(0), steps(0), current_step(0), position(0), easing(Easing::LINEAR) {
+			std::memset(source, 0, size);
+			std::memset(target, 0, size);
+		} // Transition
+
+	void Transition::captureSource() {
+		std::memcpy(source, strip.buffer(), size);
+	} // captureSource
+
+	void Transition::captureTarget() {
+		std::memcpy(target, strip.buffer(), size);
+	} // captureTarget
+
+	/**
+	 * Starts a transition from the source frame to the target frame.
+	 *
+	 * Each value is a 16.16 fixed-point value, initialized with a half unit
+	 * bias so that the integer part is always the rounded value. Increments
+	 * are truncated towards 0 : after `steps` increments, the accumulated
+	 * error is lower than `steps` / 65536, so the last step exactly reaches
+	 * the target as long as `steps` does not exceed MAX_STEPS.
+	 */
+	void Transition::start(uint16_t steps, Easing easing) {
+		assert(steps > 0 && steps <= MAX_STEPS);
+		this->steps = steps;
+		this->easing = easing;
+		current_step = 0;
+		position = 0;
+
+		std::memcpy(strip.buffer(), source, size);
+		active_count = 0;
+		for(uint32_t i = 0; i < size; i++) {
+			if(source[i] != target[i]) {
+				offsets[active_count] = i;
+				values[active_count] = (source[i] << 16) + 0x8000;
+				increments[active_count] = (target[i] - source[i]) * 65536 / steps;
+				active_count++;
+			}
+		}
+	} // start
+
+	/*
+	 * Count of linear steps reached at `step`, according to the easing : the
+	 * eased progression is computed in 0.16 fixed-point, and scaled back to
+	 * [0;steps].
+	 */
+	uint16_t Transition::easedPosition(uint16_t step) const {
+		const uint64_t t = ((uint64_t) step << 16) / steps;
+		uint64_t eased;
+		switch(easing) {
+			case Easing::EASE_IN:
+				eased = (t * t) >> 16;
+				break;
+			case Easing::EASE_OUT:
+				eased = 65536 - (((65536 - t) * (65536 - t)) >> 16);
+				break;
+			case Easing::EASE_IN_OUT:
+				eased = (t * t * (3 * 65536 - 2 * t)) >> 32;
+				break;
+			case Easing::LINEAR:
+			default:
+				return step;
+		}
+		return (eased * steps + 0x8000) >> 16;
+	} // easedPosition
+
+	/**
+	 * Advances the transition by one step.
+	 *
+	 * With a LINEAR easing, each active byte is advanced by exactly one
+	 * increment. Other easings advance all the bytes by the same integer
+	 * count of increments, that might be 0 or more than 1.
+	 */
+	bool Transition::step() {
+		if(current_step >= steps)
+			return false;
+		current_step++;
+		const uint16_t next_position = easedPosition(current_step);
+		const int32_t advance = next_position - position;
+		position = next_position;
+
+		uint8_t* buffer = strip.buffer();
+		if(advance == 1) {
+			for(uint32_t i = 0; i < active_count; i++) {
+				values[i] += increments[i];
+				buffer[offsets[i]] = values[i] >> 16;
+			}
+		} else if(advance > 0) {
+			for(uint32_t i = 0; i < active_count; i++) {
+				values[i] += increments[i] * advance;
+				buffer[offsets[i]] = values[i] >> 16;
+			}
+		}
+		return true;
+	} // step
+
+	/**
+	 * Transition destructor.
+	 *
+	 * Captured frames and increments are deleted.
+	 */
+	Transition::~Transition() {
+		delete[] source;
+		delete[] target;
+		delete[] offsets;
+		delete[] values;
+		delete[] increments;
+	} // ~Transition
+}
@@ -0,0 +1,53 @@
+#include "transpose.hpp"
+
+namespace pixled {
+	namespace transpose {
+		/*
+		 * Packs the bytes at position `index` of up to 8 buffers in a
+		 * single 64 bits row matrix.
+		 */
+		static inline uint64_t gather(const uint8_t* const* inputs, uint8_t count, uint32_t index) {
+			uint64_t rows = 0;
+			for(uint8_t s = 0; s < count; s++)
+				rows |= static_cast<uint64_t>(inputs[s][index]) << (8*s);
+			return rows;
+		}
+
+		void bits16(
+				const uint8_t* const* inputs, uint8_t input_count,
+				uint32_t offset, uint32_t size, uint16_t* output, uint8_t stride) {
+			const uint8_t low_count = input_count < 8 ? input_count : 8;
+			const uint8_t high_count = input_count - low_count;
+
+			for(uint32_t i = offset; i < offset + size; i++) {
+				uint64_t low = transpose8(gather(inputs, low_count, i));
+				if(high_count == 0) {
+					// Strips 8 to 15 unused : only the low byte of each word
+					// is set
+					for(int8_t bit = 7; bit >= 0; bit--) {
+						*output = (low >> (8*bit)) & 0xFF;
+						output += stride;
+					}
+				} else {
+					uint64_t high = transpose8(gather(&inputs[8], high_count, i));
+					for(int8_t bit = 7; bit >= 0; bit--) {
+						*output = ((low >> (8*bit)) & 0xFF) | (((high >> (8*bit)) & 0xFF) << 8);
+						output += stride;
+					}
+				}
+			}
+		} // bits16
+
+		void bits8(
+				const uint8_t* const* inputs, uint8_t input_count,
+				uint32_t offset, uint32_t size, uint8_t* output, uint8_t stride) {
+			for(uint32_t i = offset; i < offset + size; i++) {
+				uint64_t slices = transpose8(gather(inputs, input_count, i));
+				for(int8_t bit = 7; bit >= 0; bit--) {
+					*output = (slices >> (8*bit)) & 0xFF;
+					output += stride;
+				}
+			}
+		} // bits8
+	}
+}
@@ -0,0 +1,99 @@
+/*
+ * Host tests of the coroutine effect runtime.
+ *
+ * The runtime is driven with a minimal strip, that only counts the calls to
+ * show().
+ */
+#include <cassert>
+#include <cstdio>
+#include <vector>
+
+#include "coroutine_effects.hpp"
+
+using namespace pixled;
+
+struct HostStrip {
+	std::vector<uint8_t> pixels;
+	int shows = 0;
+
+	HostStrip(std::size_t length) : pixels(length, 0) {}
+	void show() {shows++;}
+};
+
+/*
+ * Toggles a pixel every `period_ms`.
+ */
+static EffectTask blink(HostStrip& strip, std::size_t index, uint32_t period_ms) {
+	while(true) {
+		strip.pixels[index] = 255;
+		co_await delay(period_ms);
+		strip.pixels[index] = 0;
+		co_await delay(period_ms);
+	}
+}
+
+/*
+ * Fades a pixel in, one step per frame, then finishes.
+ */
+static EffectTask fade_in(HostStrip& strip, std::size_t index, uint8_t steps, std::vector<uint32_t>& frames) {
+	for(uint8_t i = 1; i <= steps; i++) {
+		strip.pixels[index] = i * (255 / steps);
+		frames.push_back(co_await nextFrame());
+	}
+}
+
+static void test_blink() {
+	HostStrip strip {2};
+	EffectScheduler scheduler {20};
+	scheduler.spawn(blink(strip, 0, 40));
+	scheduler.spawn(blink(strip, 1, 60));
+	assert(scheduler.effectCount() == 2);
+
+	const uint8_t expected_0[] = {255, 255, 0, 0, 255, 255, 0};
+	const uint8_t expected_1[] = {255, 255, 255, 0, 0, 0, 255};
+	for(int frame = 0; frame < 7; frame++) {
+		scheduler.tick(strip);
+		assert(strip.pixels[0] == expected_0[frame]);
+		assert(strip.pixels[1] == expected_1[frame]);
+	}
+	assert(strip.shows == 7);
+}
+
+static void test_finished_effect() {
+	HostStrip strip {1};
+	EffectScheduler scheduler {10};
+	std::vector<uint32_t> frames;
+	scheduler.spawn(fade_in(strip, 0, 5, frames));
+
+	for(int frame = 0; frame < 10; frame++)
+		scheduler.tick(strip);
+	assert(strip.pixels[0] == 255);
+	assert(scheduler.effectCount() == 0);
+	assert(scheduler.memoryUsage() == 0);
+	assert((frames == std::vector<uint32_t> {1, 2, 3, 4, 5}));
+}
+
+/*
+ * Compares the memory used by coroutine effects with the stack that a
+ * FreeRTOS task would require for each effect.
+ */
+static void test_memory_usage() {
+	HostStrip strip {64};
+	EffectScheduler scheduler {20};
+	for(std::size_t i = 0; i < 64; i++)
+		scheduler.spawn(blink(strip, i, 100 + i));
+	scheduler.tick(strip);
+
+	const std::size_t per_effect = scheduler.memoryUsage() / 64;
+	std::printf("coroutine frame : %zu bytes per effect\n", per_effect);
+	std::printf("task per effect : >= 2048 bytes of stack per effect, plus the TCB\n");
+	assert(per_effect > 0 && per_effect < 256);
+}
+
+int main() {
+	test_blink();
+	test_finished_effect();
+	test_memory_usage();
+	std::printf("coroutine effects : OK\n");
+	return 0;
+}
@@ -0,0 +1,178 @@
+/*
+ * Host accuracy sweep and benchmark of the fixed-point OKLab conversions.
+ *
+ * All the 2^24 sRGB colors are converted to OKLab and back, and compared
+ * to a double precision implementation. OKLCH to sRGB conversions are then
+ * timed against a float implementation.
+ */
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "converters.hpp"
+
+using namespace pixled;
+
+static double to_linear(double c) {
+	c /= 255;
+	return c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+}
+
+static double to_srgb(double l) {
+	l = l < 0 ? 0 : l > 1 ? 1 : l;
+	return 255 * (l <= 0.0031308 ? 12.92 * l : 1.055 * std::pow(l, 1 / 2.4) - 0.055);
+}
+
+static void reference_oklab(const rgb_pixel& pixel, double* lab) {
+	const double r = to_linear(pixel.red);
+	const double g = to_linear(pixel.green);
+	const double b = to_linear(pixel.blue);
+	const double l = std::cbrt(0.4122214708 * r + 0.5363325363 * g + 0.0514459929 * b);
+	const double m = std::cbrt(0.2119034982 * r + 0.6806995451 * g + 0.1073969566 * b);
+	const double s = std::cbrt(0.0883024619 * r + 0.2817188376 * g + 0.6299787005 * b);
+	lab[0] = 0.2104542553 * l + 0.7936177850 * m - 0.0040720468 * s;
+	lab[1] = 1.9779984951 * l - 2.4285922050 * m + 0.4505937099 * s;
+	lab[2] = 0.0259040371 * l + 0.7827717662 * m - 0.8086757660 * s;
+}
+
+static void reference_rgb(const oklab_pixel& pixel, int* rgb) {
+	const double L = pixel.lightness / 32768.;
+	const double A = pixel.a / 32768.;
+	const double B = pixel.b / 32768.;
+	const double l = std::pow(L + 0.3963377774 * A + 0.2158037573 * B, 3);
+	const double m = std::pow(L - 0.1055613458 * A - 0.0638541728 * B, 3);
+	const double s = std::pow(L - 0.0894841775 * A - 1.2914855480 * B, 3);
+	rgb[0] = (int) std::lround(to_srgb(4.0767416621 * l - 3.3077115913 * m + 0.2309699292 * s));
+	rgb[1] = (int) std::lround(to_srgb(-1.2684380046 * l + 2.6097574011 * m - 0.3413193965 * s));
+	rgb[2] = (int) std::lround(to_srgb(-0.0041960863 * l - 0.7034186147 * m + 1.7076147010 * s));
+}
+
+static int max_error(const rgb_pixel& pixel, const int* expected) {
+	const int errors[3] {
+		std::abs(pixel.red - expected[0]),
+		std::abs(pixel.green - expected[1]),
+		std::abs(pixel.blue - expected[2])};
+	int error = errors[0] > errors[1] ? errors[0] : errors[1];
+	return error > errors[2] ? error : errors[2];
+}
+
+/*
+ * Converts all the sRGB colors to OKLab, then back to sRGB.
+ */
+static void test_accuracy_sweep() {
+	double oklab_error = 0;
+	int rgb_error = 0;
+	int round_trip_error = 0;
+	uint32_t exact = 0;
+	for(int r = 0; r < 256; r++) {
+		for(int g = 0; g < 256; g++) {
+			for(int b = 0; b < 256; b++) {
+				const rgb_pixel pixel(r, g, b);
+				const oklab_pixel lab = RgbToOklabConverter::convert(pixel);
+				double expected_lab[3];
+				reference_oklab(pixel, expected_lab);
+				oklab_error = std::fmax(oklab_error, std::fabs(lab.lightness - expected_lab[0] * 32768));
+				oklab_error = std::fmax(oklab_error, std::fabs(lab.a - expected_lab[1] * 32768));
+				oklab_error = std::fmax(oklab_error, std::fabs(lab.b - expected_lab[2] * 32768));
+
+				const rgb_pixel rgb = OklabToRgbConverter::convert(lab);
+				int expected_rgb[3];
+				reference_rgb(lab, expected_rgb);
+				const int error = max_error(rgb, expected_rgb);
+				rgb_error = error > rgb_error ? error : rgb_error;
+
+				const int original[3] {r, g, b};
+				const int round_trip = max_error(rgb, original);
+				round_trip_error = round_trip > round_trip_error ? round_trip : round_trip_error;
+				if(round_trip == 0)
+					exact++;
+			}
+		}
+	}
+	const double exact_ratio = 100. * exact / (1 << 24);
+	std::printf("RgbToOklabConverter   max error %.2f/32768\n", oklab_error);
+	std::printf("OklabToRgbConverter   max error %d\n", rgb_error);
+	std::printf("sRGB round trip       max error %d, %.2f%% exact\n", round_trip_error, exact_ratio);
+	assert(oklab_error <= 7.1);
+	assert(rgb_error <= 2);
+	assert(round_trip_error <= 2);
+	assert(exact_ratio >= 98);
+}
+
+static const int BENCHMARK_PIXELS = 1000;
+static const int BENCHMARK_FRAMES = 1000;
+
+template<typename F>
+static double benchmark(const char* name, F frame) {
+	const auto start = std::chrono::steady_clock::now();
+	for(int i = 0; i < BENCHMARK_FRAMES; i++)
+		frame(i);
+	const std::chrono::duration<double, std::micro> duration = std::chrono::steady_clock::now() - start;
+	const double us = duration.count() / BENCHMARK_FRAMES;
+	std::printf("%-20s %8.1f us/frame (%d pixels)\n", name, us, BENCHMARK_PIXELS);
+	return us;
+}
+
+/*
+ * Same workload as test_benchmark_oklab on the device : 1000 OKLCH pixels
+ * converted to sRGB, with a hue rotation at each frame.
+ */
+static void test_benchmark() {
+	static oklch_pixel lch[BENCHMARK_PIXELS];
+	static rgb_pixel rgb[BENCHMARK_PIXELS];
+	for(int i = 0; i < BENCHMARK_PIXELS; i++)
+		lch[i] = {(uint16_t) (8000 + i * 20), 6000, (uint16_t) (i * 65536 / BENCHMARK_PIXELS)};
+
+	uint32_t checksum = 0;
+	benchmark("float OKLCH to sRGB", [&](int frame) {
+			for(int i = 0; i < BENCHMARK_PIXELS; i++) {
+				const float L = lch[i].lightness / 32768.f;
+				const float h = (uint16_t) (lch[i].hue + frame * 256) * 6.2831853f / 65536;
+				const float a = lch[i].chroma / 32768.f * std::cos(h);
+				const float b = lch[i].chroma / 32768.f * std::sin(h);
+				const float l = std::pow(L + 0.3963377774f * a + 0.2158037573f * b, 3.f);
+				const float m = std::pow(L - 0.1055613458f * a - 0.0638541728f * b, 3.f);
+				const float s = std::pow(L - 0.0894841775f * a - 1.2914855480f * b, 3.f);
+				float linear[3] {
+					4.0767416621f * l - 3.3077115913f * m + 0.2309699292f * s,
+					-1.2684380046f * l + 2.6097574011f * m - 0.3413193965f * s,
+					-0.0041960863f * l - 0.7034186147f * m + 1.7076147010f * s};
+				uint8_t srgb[3];
+				for(int c = 0; c < 3; c++) {
+					const float x = linear[c] < 0 ? 0 : linear[c] > 1 ? 1 : linear[c];
+					srgb[c] = 255 * (x <= 0.0031308f ? x * 12.92f : 1.055f * std::pow(x, 1 / 2.4f) - 0.055f) + 0.5f;
+				}
+				rgb[i] = {srgb[0], srgb[1], srgb[2]};
+			}
+			checksum += rgb[frame % BENCHMARK_PIXELS].red;
+			});
+
+	benchmark("OklchToRgbConverter", [&](int frame) {
+			for(int i = 0; i < BENCHMARK_PIXELS; i++)
+				lch[i].hue += 256;
+			OklchToRgbConverter()(lch, rgb, BENCHMARK_PIXELS);
+			checksum += rgb[frame % BENCHMARK_PIXELS].red;
+			});
+
+	static oklab_pixel lab[BENCHMARK_PIXELS];
+	OklchToOklabConverter()(lch, lab, BENCHMARK_PIXELS);
+	benchmark("OklabToRgbConverter", [&](int frame) {
+			OklabToRgbConverter()(lab, rgb, BENCHMARK_PIXELS);
+			checksum += rgb[frame % BENCHMARK_PIXELS].red;
+			});
+	benchmark("RgbToOklabConverter", [&](int frame) {
+			RgbToOklabConverter()(rgb, lab, BENCHMARK_PIXELS);
+			checksum += lab[frame % BENCHMARK_PIXELS].lightness;
+			});
+	// Keeps the conversions from being optimized out
+	std::printf("checksum %u\n", (unsigned int) checksum);
+}
+
+int main() {
+	test_accuracy_sweep();
+	test_benchmark();
+	std::printf("OKLab host tests passed\n");
+	return 0;
+}
@@ -0,0 +1,117 @@
+/*
+ * Host tests of the span recorder.
+ *
+ * Spans are recorded concurrently from several threads, and the trace is
+ * dumped to trace.json, that can be opened in https://ui.perfetto.dev.
+ */
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "trace.hpp"
+#include "coroutine_effects.hpp"
+
+using namespace pixled;
+
+struct HostStrip {
+	int shows = 0;
+
+	void show() {
+		PIXLED_TRACE_SPAN("show");
+		shows++;
+	}
+};
+
+static EffectTask idle() {
+	while(true)
+		co_await nextFrame();
+}
+
+/*
+ * Writers wrap around the ring buffer many times : all the retained spans
+ * must be complete.
+ */
+static void test_concurrent_writers() {
+	const uint32_t capacity = 256;
+	const int threads = 4;
+	const int spans = 10000;
+	static const char* names[threads] = {"writer 0", "writer 1", "writer 2", "writer 3"};
+
+	Trace::start(capacity);
+	std::vector<std::thread> writers;
+	for(int t = 0; t < threads; t++)
+		writers.emplace_back([t] {
+				for(int i = 0; i < spans; i++) {
+					PIXLED_TRACE_SPAN(names[t]);
+				}
+			});
+	for(std::thread& writer : writers)
+		writer.join();
+	Trace::stop();
+
+	assert(Trace::eventCount() == capacity);
+	assert(Trace::overwrittenCount() == threads * spans - capacity);
+	trace_event event;
+	for(uint32_t i = 0; i < capacity; i++) {
+		assert(Trace::event(i, event));
+		assert(std::strncmp(event.name, "writer ", 7) == 0);
+	}
+}
+
+static void test_effect_spans() {
+	HostStrip strip;
+	EffectScheduler scheduler {10};
+	scheduler.spawn(idle());
+	scheduler.spawn(idle());
+
+	Trace::start(64);
+	for(int frame = 0; frame < 10; frame++)
+		scheduler.tick(strip);
+	Trace::stop();
+
+	// Two effects and one show per frame
+	assert(Trace::eventCount() == 30);
+	trace_event event;
+	assert(Trace::event(0, event) && std::strcmp(event.name, "effect") == 0);
+	assert(Trace::event(2, event) && std::strcmp(event.name, "show") == 0);
+
+	FILE* output = std::fopen("trace.json", "w");
+	assert(output != nullptr);
+	assert(Trace::dump(output) == 30);
+	std::fclose(output);
+
+	output = std::fopen("trace.json", "r");
+	std::string json;
+	char chunk[256];
+	std::size_t size;
+	while((size = std::fread(chunk, 1, sizeof(chunk), output)) > 0)
+		json.append(chunk, size);
+	std::fclose(output);
+
+	// Minimal structure check : balanced braces and brackets, and one
+	// complete event per span
+	int depth = 0;
+	for(char c : json) {
+		if(c == '{' || c == '[')
+			depth++;
+		else if(c == '}' || c == ']')
+			depth--;
+		assert(depth >= 0);
+	}
+	assert(depth == 0);
+	std::size_t events = 0;
+	for(std::size_t i = json.find("\"ph\":\"X\""); i != std::string::npos; i = json.find("\"ph\":\"X\"", i + 1))
+		events++;
+	assert(events == 30);
+	Trace::clear();
+}
+
+int main() {
+	test_concurrent_writers();
+	test_effect_spans();
+	std::printf("trace : OK\n");
+	return 0;
+}
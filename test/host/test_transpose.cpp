@@ -0,0 +1,117 @@
+/*
+ * Host tests and benchmark of the bit transposition kernels.
+ *
+ * transpose::bits8() and transpose::bits16() are checked against a bit by
+ * bit reference for all the strip counts, then timed against it on 8 and 16
+ * RGB strips of 1000 pixels.
+ */
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+
+#include "transpose.hpp"
+
+using namespace pixled;
+
+static const int PIXELS = 1000;
+static const int SIZE = 3 * PIXELS;
+static const int FRAMES = 200;
+
+static uint8_t data[16][SIZE];
+static const uint8_t* inputs[16];
+
+/*
+ * Reference bit slice : bit `s` of the result is bit `bit` of the byte
+ * `index` of strip `s`.
+ */
+static uint16_t reference_slice(uint8_t count, uint32_t index, uint8_t bit) {
+	uint16_t slice = 0;
+	for(uint8_t s = 0; s < count; s++)
+		slice |= ((inputs[s][index] >> bit) & 1) << s;
+	return slice;
+}
+
+static void fill_random() {
+	uint32_t seed = 42;
+	for(int s = 0; s < 16; s++) {
+		for(int i = 0; i < SIZE; i++) {
+			seed ^= seed << 13;
+			seed ^= seed >> 17;
+			seed ^= seed << 5;
+			data[s][i] = seed >> 24;
+		}
+		inputs[s] = data[s];
+	}
+}
+
+static void test_kernels() {
+	static uint8_t output8[8 * SIZE];
+	static uint16_t output16[8 * SIZE];
+	for(uint8_t count = 1; count <= 16; count++) {
+		transpose::bits16(inputs, count, 0, SIZE, output16);
+		if(count <= 8)
+			transpose::bits8(inputs, count, 0, SIZE, output8);
+		for(uint32_t i = 0; i < SIZE; i++) {
+			for(int bit = 7; bit >= 0; bit--) {
+				const uint16_t expected = reference_slice(count, i, bit);
+				assert(output16[8*i + 7 - bit] == expected);
+				if(count <= 8)
+					assert(output8[8*i + 7 - bit] == expected);
+			}
+		}
+	}
+}
+
+template<typename F>
+static double benchmark(const char* name, F frame) {
+	const auto start = std::chrono::steady_clock::now();
+	for(int i = 0; i < FRAMES; i++)
+		frame();
+	const std::chrono::duration<double, std::micro> duration = std::chrono::steady_clock::now() - start;
+	const double us = duration.count() / FRAMES;
+	std::printf("%-24s %8.1f us/frame (%d pixels)\n", name, us, PIXELS);
+	return us;
+}
+
+/*
+ * Same workload as test_benchmark_transpose on the device.
+ */
+static void test_benchmark() {
+	static uint8_t output8[8 * SIZE];
+	static uint16_t output16[8 * SIZE];
+	uint32_t checksum = 0;
+
+	const double naive16 = benchmark("naive transpose x16", [&] {
+			uint16_t* slice = output16;
+			for(int i = 0; i < SIZE; i++)
+				for(int bit = 7; bit >= 0; bit--)
+					*slice++ = reference_slice(16, i, bit);
+			checksum += output16[SIZE];
+			});
+	const double bits16 = benchmark("transpose::bits16 x16", [&] {
+			transpose::bits16(inputs, 16, 0, SIZE, output16);
+			checksum += output16[SIZE];
+			});
+	const double naive8 = benchmark("naive transpose x8", [&] {
+			uint8_t* slice = output8;
+			for(int i = 0; i < SIZE; i++)
+				for(int bit = 7; bit >= 0; bit--)
+					*slice++ = reference_slice(8, i, bit);
+			checksum += output8[SIZE];
+			});
+	const double bits8 = benchmark("transpose::bits8 x8", [&] {
+			transpose::bits8(inputs, 8, 0, SIZE, output8);
+			checksum += output8[SIZE];
+			});
+	std::printf("speedup : %.1fx (16 strips), %.1fx (8 strips)\n", naive16 / bits16, naive8 / bits8);
+	// Keeps the kernels from being optimized out
+	std::printf("checksum %u\n", (unsigned int) checksum);
+}
+
+int main() {
+	fill_random();
+	test_kernels();
+	test_benchmark();
+	std::printf("transpose host tests passed\n");
+	return 0;
+}
@@ -1,6 +1,26 @@
 #include "test_output.hpp"
 #include "test_strip.hpp"
+#include "test_frame_cache.hpp"
+#include "test_trace.hpp"
 #include "test_config.hpp"
+#include "test_boot_frame.hpp"
+#include "test_matrix.hpp"
+#include "test_pixel_map.hpp"
+#include "test_compositor.hpp"
+#include "test_effects.hpp"
+#include "test_transition.hpp"
+#include "test_coroutine_effects.hpp"
+#include "test_indexed_strip.hpp"
+#include "test_shader_strip.hpp"
+#include "test_run_strip.hpp"
+#include "test_strip16.hpp"
+#include "test_clocked_strip.hpp"
+#include "test_parallel_output.hpp"
+#include "test_network_strip.hpp"
+#include "test_conformance.hpp"
+#include "test_tables.hpp"
+#include "test_oklab.hpp"
+#include "test_benchmark.hpp"
 #include "unity.h"
 #include "pixled_driver.hpp"
 
@@ -19,6 +39,7 @@ extern "C" void app_main() {
 
 	RUN_TEST(test_gbr_strip_set_rgb);
 	RUN_TEST(test_gbr_strip_set_hsb);
+	RUN_TEST(test_gbr_strip_set_rgb_pixels);
 
 	printf("\n>> Testing rgbw strip\n");
 	RUN_TEST(test_rgbw_strip_set_rgbw);
@@ -26,12 +47,187 @@ extern "C" void app_main() {
 	RUN_TEST(test_gbrw_strip_set_rgbw);
 	RUN_TEST(test_gbrw_strip_set_rgb);
 	RUN_TEST(test_gbrw_strip_set_hsb);
+	RUN_TEST(test_gbrw_strip_fill_rgb);
+	RUN_TEST(test_rgbw_strip_copy_reverse_pixels);
+	RUN_TEST(test_logical_rgb_strip);
+	RUN_TEST(test_logical_rgbw_strip);
+	RUN_TEST(test_skip_unchanged_frames);
+	RUN_TEST(test_skip_unchanged_frames_setters);
+	RUN_TEST(test_skip_unchanged_frames_keep_alive);
+	RUN_TEST(test_streaming_rgb_strip);
+	RUN_TEST(test_streaming_rgbw_strip);
+	RUN_TEST(test_stream_translators);
+	RUN_TEST(test_mirrored_strip);
+	RUN_TEST(test_changed_prefix_transmission);
+	RUN_TEST(test_changed_prefix_reset);
+
+	printf("\n>> Testing frame cache\n");
+	RUN_TEST(test_frame_cache_content_hits);
+	RUN_TEST(test_frame_cache_frame_ids);
+	RUN_TEST(test_frame_cache_eviction);
+	RUN_TEST(test_frame_cache_indexed_palette);
+
+	printf("\n>> Testing trace\n");
+	RUN_TEST(test_trace_ring_buffer);
+	RUN_TEST(test_trace_dump);
+	RUN_TEST(test_trace_strip_spans);
 
 	printf("\n>> Testing predefined strip configs\n");
 	RUN_TEST(test_ws2812);
 	RUN_TEST(test_ws2815);
 	RUN_TEST(test_sk6812);
 	RUN_TEST(test_sk6812w);
+	RUN_TEST(test_ws2816);
+	RUN_TEST(test_ucs8903);
+	RUN_TEST(test_ucs8904);
+	RUN_TEST(test_timing_rounding);
+	RUN_TEST(test_timing_compressed);
+	RUN_TEST(test_timing_validation);
+
+	printf("\n>> Testing boot frames\n");
+	RUN_TEST(test_boot_frame_encoding);
+	RUN_TEST(test_boot_frame_copy);
+
+	printf("\n>> Testing matrix\n");
+	RUN_TEST(test_matrix_serpentine_lookup);
+	RUN_TEST(test_matrix_rotated_tiled_lookup);
+	RUN_TEST(test_matrix_runs);
+	RUN_TEST(test_matrix_fill_rect);
+	RUN_TEST(test_matrix_blit);
+	RUN_TEST(test_matrix_scroll);
+
+	printf("\n>> Testing pixel maps\n");
+	RUN_TEST(test_pixel_map_evaluate);
+	RUN_TEST(test_pixel_map_box_query);
+	RUN_TEST(test_pixel_map_sphere_query);
+	RUN_TEST(test_pixel_map_large_bounds);
+
+	printf("\n>> Testing compositor\n");
+	RUN_TEST(test_blend_normal);
+	RUN_TEST(test_blend_add);
+	RUN_TEST(test_blend_multiply);
+	RUN_TEST(test_blend_max);
+	RUN_TEST(test_compositor_compose_strip);
+	RUN_TEST(test_compositor_pixel_alpha);
+	RUN_TEST(test_compositor_hidden_layer);
+
+	printf("\n>> Testing effects\n");
+	RUN_TEST(test_fast_hsb_to_rgb);
+	RUN_TEST(test_rainbow);
+	RUN_TEST(test_chase);
+	RUN_TEST(test_fire);
+	RUN_TEST(test_twinkle);
+	RUN_TEST(test_gradient);
+	RUN_TEST(test_effect_draw_strip);
+	RUN_TEST(test_effect_draw_max_length);
+	RUN_TEST(test_effect_long_length);
+
+	printf("\n>> Testing transitions\n");
+	RUN_TEST(test_transition_linear);
+	RUN_TEST(test_transition_skip_equal);
+	RUN_TEST(test_transition_easing);
+
+#ifdef __cpp_impl_coroutine
+	printf("\n>> Testing coroutine effects\n");
+	RUN_TEST(test_coroutine_scheduler);
+#endif
+
+	printf("\n>> Testing indexed strips\n");
+	RUN_TEST(test_indexed_rgb_strip_16);
+	RUN_TEST(test_indexed_rgb_strip_256);
+	RUN_TEST(test_indexed_rgbw_strip);
+	RUN_TEST(test_indexed_strip_recolor);
+	RUN_TEST(test_indexed_strip_closest_color);
+	RUN_TEST(test_indexed_strip_out_of_palette);
+	RUN_TEST(test_indexed_strip_streaming);
+
+	printf("\n>> Testing shader strips\n");
+	RUN_TEST(test_shader_strip_buffered);
+	RUN_TEST(test_shader_strip_streaming);
+	RUN_TEST(test_pixel_shader);
+
+	printf("\n>> Testing run-length strips\n");
+	RUN_TEST(test_run_strip_fill);
+	RUN_TEST(test_run_strip_merge);
+	RUN_TEST(test_run_strip_set_pixels);
+	RUN_TEST(test_run_strip_overflow);
+	RUN_TEST(test_run_strip_streaming);
+	RUN_TEST(test_run_rgbw_strip);
+
+	printf("\n>> Testing 16 bits strips\n");
+	RUN_TEST(test_serializer_grb16_output);
+	RUN_TEST(test_serializer_grbw16_output);
+	RUN_TEST(test_rgb16_strip_set_rgb16);
+	RUN_TEST(test_rgb16_strip_set_rgb);
+	RUN_TEST(test_rgb16_strip_show);
+	RUN_TEST(test_rgbw16_strip_set_rgb16);
+	RUN_TEST(test_rgbw16_strip_show);
+	RUN_TEST(test_rgbw16_strip_streaming);
+	RUN_TEST(test_rgb_strip_set_rgb16_pixels);
+
+	printf("\n>> Testing clocked strips\n");
+	RUN_TEST(test_clocked_frame_layout);
+	RUN_TEST(test_clocked_frame_reset_frame);
+	RUN_TEST(test_apa102_strip_frame);
+	RUN_TEST(test_sk9822_strip_brightness);
+	RUN_TEST(test_clocked_strips_share_bus);
+	RUN_TEST(test_clocked_strip_external_bus);
+
+	printf("\n>> Testing parallel output\n");
+	RUN_TEST(test_transpose8);
+	RUN_TEST(test_transpose_bits16);
+	RUN_TEST(test_transpose_bits8);
+	RUN_TEST(test_transpose_bits16_stride);
+	RUN_TEST(test_parallel_output_buffer);
+	RUN_TEST(test_parallel_output_buffer16);
+
+	printf("\n>> Testing network strips\n");
+	RUN_TEST(test_network_strip_e131);
+	RUN_TEST(test_network_strip_artnet);
+	RUN_TEST(test_network_strip_ddp);
+	RUN_TEST(test_network_strip_pacing);
+
+	printf("\n>> Testing compile-time tables\n");
+	RUN_TEST(test_pixel_types_trivial);
+	RUN_TEST(test_gamma_table);
+	RUN_TEST(test_hue_wheel_table);
+	RUN_TEST(test_constexpr_converters);
+
+	printf("\n>> Testing OKLab conversions\n");
+	RUN_TEST(test_rgb_to_oklab);
+	RUN_TEST(test_oklab_to_rgb);
+	RUN_TEST(test_oklab_round_trip);
+	RUN_TEST(test_oklch_conversions);
+	RUN_TEST(test_oklab_batch_conversions);
+
+	printf("\n>> Testing waveform conformance\n");
+	RUN_TEST(test_waveform_decoder);
+	RUN_TEST(test_waveform_decoder_violations);
+	RUN_TEST(test_conformance_rgb_strip);
+	RUN_TEST(test_conformance_rgbw_strip);
+	RUN_TEST(test_conformance_rgb16_strip);
+	RUN_TEST(test_conformance_rgbw16_strip);
+	RUN_TEST(test_conformance_indexed_strip);
+
+	printf("\n>> Benchmarks\n");
+	RUN_TEST(test_benchmark_compositor);
+	RUN_TEST(test_benchmark_hsb_rainbow);
+	RUN_TEST(test_benchmark_rainbow);
+	RUN_TEST(test_benchmark_chase);
+	RUN_TEST(test_benchmark_fire);
+	RUN_TEST(test_benchmark_twinkle);
+	RUN_TEST(test_benchmark_gradient);
+	RUN_TEST(test_benchmark_transpose);
+	RUN_TEST(test_benchmark_transition);
+	RUN_TEST(test_benchmark_pixel_map);
+	RUN_TEST(test_benchmark_frame_cache);
+	RUN_TEST(test_benchmark_changed_prefix);
+	RUN_TEST(test_benchmark_oklab);
+	RUN_TEST(test_benchmark_shader_strip);
+	RUN_TEST(test_benchmark_run_strip);
+#ifdef __cpp_impl_coroutine
+	RUN_TEST(test_benchmark_effect_memory);
+#endif
 
 	UNITY_END();
 }
@@ -0,0 +1,349 @@
+#include "test_benchmark.hpp"
+#include "unity.h"
+#include "esp_timer.h"
+
+#include <cmath>
+
+#include "compositor.hpp"
+#include "effects.hpp"
+#include "transition.hpp"
+#include "shader_strip.hpp"
+#include "run_strip.hpp"
+#include "pixel_map.hpp"
+#include "frame_cache.hpp"
+#include "transpose.hpp"
+#include "converters.hpp"
+#include "strip.hpp"
+#include "constants.hpp"
+
+using namespace pixled;
+
+#define BENCHMARK_PIXELS 1000
+#define BENCHMARK_FRAMES 100
+
+/*
+ * Runs `frame` BENCHMARK_FRAMES times, and prints the average time per frame.
+ */
+template<typename Frame>
+static void benchmark(const char* name, Frame frame) {
+	int64_t start = esp_timer_get_time();
+	for(int i = 0; i < BENCHMARK_FRAMES; i++)
+		frame(i);
+	int64_t elapsed = esp_timer_get_time() - start;
+	printf("%-32s %8.1f us/frame (%d pixels)\n",
+			name, (double) elapsed / BENCHMARK_FRAMES, BENCHMARK_PIXELS);
+}
+
+void test_benchmark_compositor() {
+	RgbStrip strip {GPIO_NUM_12, BENCHMARK_PIXELS, RMT_CHANNEL_0, WS2812()};
+	Compositor compositor {BENCHMARK_PIXELS, 3};
+	for(uint16_t i = 0; i < BENCHMARK_PIXELS; i++) {
+		compositor.layer(0).pixels[i] = {(uint8_t) i, 50, 200};
+		compositor.layer(1).pixels[i] = {0, (uint8_t) i, 100};
+		compositor.layer(2).pixels[i] = {10, 10, (uint8_t) i};
+	}
+	compositor.layer(1).opacity = 100;
+	compositor.layer(2).mode = BlendMode::ADD;
+
+	benchmark("compositor 3 layers", [&](int frame) {
+			compositor.layer(1).opacity = frame;
+			compositor.compose(strip);
+			});
+}
+
+/*
+ * Reference rainbow, computed with setHsbPixel() for each pixel.
+ */
+void test_benchmark_hsb_rainbow() {
+	RgbStrip strip {GPIO_NUM_12, BENCHMARK_PIXELS, RMT_CHANNEL_0, WS2812()};
+	benchmark("setHsbPixel rainbow", [&](int frame) {
+			for(uint16_t i = 0; i < BENCHMARK_PIXELS; i++)
+				strip.setHsbPixel(i, (frame + i * 360.f / BENCHMARK_PIXELS), 1, 1);
+			});
+}
+
+/*
+ * Runs an effect frame (update and draw) on a strip of BENCHMARK_PIXELS
+ * pixels.
+ */
+static void benchmark_effect(const char* name, Effect& effect) {
+	RgbStrip strip {GPIO_NUM_12, BENCHMARK_PIXELS, RMT_CHANNEL_0, WS2812()};
+	benchmark(name, [&](int) {
+			effect.update();
+			effect.draw(strip);
+			});
+}
+
+void test_benchmark_rainbow() {
+	Rainbow rainbow {BENCHMARK_PIXELS};
+	benchmark_effect("rainbow", rainbow);
+}
+
+void test_benchmark_chase() {
+	Chase chase {BENCHMARK_PIXELS, {255, 0, 0}, 16, 64, 100};
+	benchmark_effect("chase", chase);
+}
+
+void test_benchmark_fire() {
+	Fire fire {BENCHMARK_PIXELS};
+	benchmark_effect("fire", fire);
+}
+
+void test_benchmark_twinkle() {
+	Twinkle twinkle {BENCHMARK_PIXELS, {255, 255, 255}};
+	benchmark_effect("twinkle", twinkle);
+}
+
+void test_benchmark_gradient() {
+	Gradient gradient {BENCHMARK_PIXELS, {255, 0, 0}, {0, 0, 255}, 100};
+	benchmark_effect("gradient", gradient);
+}
+
+/*
+ * Transposes 16 RGB strips of BENCHMARK_PIXELS pixels.
+ */
+void test_benchmark_transpose() {
+	static uint8_t data[16][3 * BENCHMARK_PIXELS];
+	static uint16_t output[8 * 3 * BENCHMARK_PIXELS];
+	const uint8_t* inputs[16];
+	for(int s = 0; s < 16; s++) {
+		for(int i = 0; i < 3 * BENCHMARK_PIXELS; i++)
+			data[s][i] = s * 31 + i;
+		inputs[s] = data[s];
+	}
+
+	// Baseline : bit by bit
+	benchmark("naive transpose x16", [&](int) {
+			uint16_t* slice = output;
+			for(int i = 0; i < 3 * BENCHMARK_PIXELS; i++) {
+				for(int bit = 7; bit >= 0; bit--) {
+					uint16_t word = 0;
+					for(int s = 0; s < 16; s++)
+						word |= ((inputs[s][i] >> bit) & 1) << s;
+					*slice++ = word;
+				}
+			}
+			});
+	benchmark("transpose::bits16 x16", [&](int) {
+			transpose::bits16(inputs, 16, 0, 3 * BENCHMARK_PIXELS, output);
+			});
+}
+
+/*
+ * Crossfade between two full frames of BENCHMARK_PIXELS pixels.
+ */
+void test_benchmark_transition() {
+	static rgb_pixel source[BENCHMARK_PIXELS];
+	static rgb_pixel target[BENCHMARK_PIXELS];
+	static rgb_pixel blended[BENCHMARK_PIXELS];
+	RgbStrip strip {GPIO_NUM_12, BENCHMARK_PIXELS, RMT_CHANNEL_0, WS2812()};
+	for(uint16_t i = 0; i < BENCHMARK_PIXELS; i++) {
+		source[i] = {(uint8_t) i, 50, 200};
+		target[i] = {100, (uint8_t) (3*i), 0};
+	}
+
+	// Baseline : float blend of both frames
+	benchmark("float crossfade", [&](int frame) {
+			float progress = (float) frame / BENCHMARK_FRAMES;
+			for(uint16_t i = 0; i < BENCHMARK_PIXELS; i++) {
+				blended[i].red = source[i].red + (target[i].red - source[i].red) * progress;
+				blended[i].green = source[i].green + (target[i].green - source[i].green) * progress;
+				blended[i].blue = source[i].blue + (target[i].blue - source[i].blue) * progress;
+			}
+			strip.setRgbPixels(0, blended, BENCHMARK_PIXELS);
+			});
+
+	Transition transition {strip};
+	strip.setRgbPixels(0, source, BENCHMARK_PIXELS);
+	transition.captureSource();
+	strip.setRgbPixels(0, target, BENCHMARK_PIXELS);
+	transition.captureTarget();
+	transition.start(BENCHMARK_FRAMES);
+	benchmark("Transition linear step", [&](int) {
+			transition.step();
+			});
+}
+
+/*
+ * Sphere of light on BENCHMARK_PIXELS leds mapped on a 10x10x10 cube.
+ */
+void test_benchmark_pixel_map() {
+	static float positions[BENCHMARK_PIXELS][3];
+	RgbStrip strip {GPIO_NUM_12, BENCHMARK_PIXELS, RMT_CHANNEL_0, WS2812()};
+	PixelMap map {strip, BENCHMARK_PIXELS};
+	for(uint16_t i = 0; i < BENCHMARK_PIXELS; i++) {
+		positions[i][0] = 0.1f * (i % 10);
+		positions[i][1] = 0.1f * ((i / 10) % 10);
+		positions[i][2] = 0.1f * (i / 100);
+		map.setPosition(i,
+				PixelMap::quantize(positions[i][0], 0.01f),
+				PixelMap::quantize(positions[i][1], 0.01f),
+				PixelMap::quantize(positions[i][2], 0.01f));
+	}
+	map.buildIndex();
+
+	// Baseline : float distance of each led to the center
+	benchmark("float sphere", [&](int frame) {
+			float center = 0.01f * frame;
+			for(uint16_t i = 0; i < BENCHMARK_PIXELS; i++) {
+				float dx = positions[i][0] - center;
+				float dy = positions[i][1] - 0.5f;
+				float dz = positions[i][2] - 0.5f;
+				float d = 1.f - std::sqrt(dx*dx + dy*dy + dz*dz) / 0.3f;
+				uint8_t v = d > 0 ? 255 * d : 0;
+				strip.setRgbPixel(i, v, v, v);
+			}
+			});
+
+	benchmark("PixelMap sphere field", [&](int frame) {
+			const int16_t center = frame;
+			map.evaluate([center] (int16_t x, int16_t y, int16_t z) {
+					const int32_t dx = x - center;
+					const int32_t dy = y - 50;
+					const int32_t dz = z - 50;
+					// Squared falloff, without any square root
+					const int32_t d = 255 - (dx*dx + dy*dy + dz*dz) * 255 / (30*30);
+					const uint8_t v = d > 0 ? d : 0;
+					return rgb_pixel(v, v, v);
+				});
+			});
+
+	benchmark("PixelMap fillSphere", [&](int frame) {
+			map.fillSphere({(int16_t) frame, 50, 50}, 30, {255, 255, 255});
+			});
+}
+
+/*
+ * Loop of 10 frames, shown with and without a frame cache.
+ */
+void test_benchmark_frame_cache() {
+	RgbStrip strip {GPIO_NUM_12, BENCHMARK_PIXELS, RMT_CHANNEL_0, WS2812()};
+	Rainbow rainbow {BENCHMARK_PIXELS};
+	rainbow.speed = 65536 / 10;
+
+	benchmark("show", [&](int) {
+			rainbow.update();
+			rainbow.draw(strip);
+			strip.show();
+			});
+
+	FrameCache cache {10 * (BENCHMARK_PIXELS * 24 * sizeof(rmt_item32_t) + 1024)};
+	strip.setFrameCache(&cache);
+	benchmark("show with frame cache", [&](int frame) {
+			rainbow.update();
+			rainbow.draw(strip);
+			strip.setFrameId(frame % 10);
+			strip.show();
+			});
+	printf("%-32s %8u hits, %u misses\n", "frame cache", (unsigned int) cache.hits(), (unsigned int) cache.misses());
+	strip.setFrameCache(nullptr);
+}
+
+/*
+ * A UI that only updates the first 50 leds of the strip.
+ */
+void test_benchmark_changed_prefix() {
+	RgbStrip strip {GPIO_NUM_12, BENCHMARK_PIXELS, RMT_CHANNEL_0, WS2812()};
+	benchmark("show", [&](int frame) {
+			strip.fillRgb(0, frame % 50, {0, 0, 255});
+			strip.show();
+			});
+
+	strip.transmitChangedPrefix(true);
+	benchmark("show changed prefix", [&](int frame) {
+			strip.fillRgb(0, frame % 50, {0, 255, 0});
+			strip.show();
+			});
+	printf("%-32s %8.1f us/frame (%d pixels)\n", "saved wire time",
+			(double) strip.savedWireTimeUs() / BENCHMARK_FRAMES, BENCHMARK_PIXELS);
+	strip.transmitChangedPrefix(false);
+}
+
+/*
+ * OKLCH gradient converted to sRGB, with a float reference implementation
+ * and with the fixed-point converters.
+ */
+void test_benchmark_oklab() {
+	static oklch_pixel lch[BENCHMARK_PIXELS];
+	static rgb_pixel rgb[BENCHMARK_PIXELS];
+	for(uint16_t i = 0; i < BENCHMARK_PIXELS; i++)
+		lch[i] = {(uint16_t) (8000 + i * 20), 6000, (uint16_t) (i * 65536 / BENCHMARK_PIXELS)};
+
+	benchmark("float OKLCH to sRGB", [&](int frame) {
+			for(uint16_t i = 0; i < BENCHMARK_PIXELS; i++) {
+				const float L = lch[i].lightness / 32768.f;
+				const float h = (uint16_t) (lch[i].hue + frame * 256) * 6.2831853f / 65536;
+				const float a = lch[i].chroma / 32768.f * std::cos(h);
+				const float b = lch[i].chroma / 32768.f * std::sin(h);
+				const float l = std::pow(L + 0.3963377774f * a + 0.2158037573f * b, 3.f);
+				const float m = std::pow(L - 0.1055613458f * a - 0.0638541728f * b, 3.f);
+				const float s = std::pow(L - 0.0894841775f * a - 1.2914855480f * b, 3.f);
+				float linear[3] {
+					4.0767416621f * l - 3.3077115913f * m + 0.2309699292f * s,
+					-1.2684380046f * l + 2.6097574011f * m - 0.3413193965f * s,
+					-0.0041960863f * l - 0.7034186147f * m + 1.7076147010f * s};
+				uint8_t srgb[3];
+				for(int c = 0; c < 3; c++) {
+					const float x = linear[c] < 0 ? 0 : linear[c] > 1 ? 1 : linear[c];
+					srgb[c] = 255 * (x <= 0.0031308f ? x * 12.92f : 1.055f * std::pow(x, 1 / 2.4f) - 0.055f) + 0.5f;
+				}
+				rgb[i] = {srgb[0], srgb[1], srgb[2]};
+			}
+			});
+
+	benchmark("OklchToRgbConverter", [&](int) {
+			for(uint16_t i = 0; i < BENCHMARK_PIXELS; i++)
+				lch[i].hue += 256;
+			OklchToRgbConverter()(lch, rgb, BENCHMARK_PIXELS);
+			});
+
+	static oklab_pixel lab[BENCHMARK_PIXELS];
+	OklchToOklabConverter()(lch, lab, BENCHMARK_PIXELS);
+	benchmark("OklabToRgbConverter", [&](int) {
+			OklabToRgbConverter()(lab, rgb, BENCHMARK_PIXELS);
+			});
+	benchmark("RgbToOklabConverter", [&](int) {
+			RgbToOklabConverter()(rgb, lab, BENCHMARK_PIXELS);
+			});
+}
+
+/*
+ * Rainbow rendered to a strip buffer then encoded, and rendered while
+ * encoded by a ShaderStrip.
+ */
+void test_benchmark_shader_strip() {
+	Rainbow rainbow {BENCHMARK_PIXELS};
+	RgbStrip strip {GPIO_NUM_12, BENCHMARK_PIXELS, RMT_CHANNEL_0, WS2812()};
+	benchmark("draw and show", [&](int) {
+			rainbow.update();
+			rainbow.draw(strip);
+			strip.show();
+			});
+
+	ShaderStrip shader {GPIO_NUM_13, BENCHMARK_PIXELS, RMT_CHANNEL_1, rainbow, WS2812()};
+	benchmark("ShaderStrip show", [&](int) {
+			rainbow.update();
+			shader.show();
+			});
+}
+
+/*
+ * Architectural scene of 5 solid zones, shown with a pixel buffer and with
+ * runs.
+ */
+void test_benchmark_run_strip() {
+	const rgb_pixel zones[5] {{255, 80, 0}, {0, 0, 80}, {255, 255, 255}, {0, 0, 80}, {255, 80, 0}};
+	RgbStrip strip {GPIO_NUM_12, BENCHMARK_PIXELS, RMT_CHANNEL_0, WS2812()};
+	benchmark("zones show", [&](int frame) {
+			for(uint16_t i = 0; i < 5; i++)
+				strip.fillRgb(i * BENCHMARK_PIXELS / 5, BENCHMARK_PIXELS / 5, zones[(i + frame) % 5]);
+			strip.show();
+			});
+
+	RunRgbStrip runs {GPIO_NUM_13, BENCHMARK_PIXELS, RMT_CHANNEL_1, 16, WS2812()};
+	benchmark("RunRgbStrip zones show", [&](int frame) {
+			for(uint16_t i = 0; i < 5; i++)
+				runs.fillRgb(i * BENCHMARK_PIXELS / 5, BENCHMARK_PIXELS / 5, zones[(i + frame) % 5]);
+			runs.show();
+			});
+}
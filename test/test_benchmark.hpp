@@ -0,0 +1,15 @@
+void test_benchmark_compositor();
+void test_benchmark_hsb_rainbow();
+void test_benchmark_rainbow();
+void test_benchmark_chase();
+void test_benchmark_fire();
+void test_benchmark_twinkle();
+void test_benchmark_gradient();
+void test_benchmark_transpose();
+void test_benchmark_transition();
+void test_benchmark_pixel_map();
+void test_benchmark_frame_cache();
+void test_benchmark_changed_prefix();
+void test_benchmark_oklab();
+void test_benchmark_shader_strip();
+void test_benchmark_run_strip();
@@ -0,0 +1,79 @@
+#include "test_boot_frame.hpp"
+#include "test_helpers.hpp"
+#include "unity.h"
+
+#include "boot_frame.hpp"
+#include "strip_config.hpp"
+#include "constants.hpp"
+
+using namespace pixled;
+
+/*
+ * Exposes the RMT items produced by a BootFrame.
+ */
+class ItemsBootFrame : public BootFrame {
+	public:
+		using BootFrame::BootFrame;
+
+		/*
+		 * Encodes the frame as the RMT driver does in show(), requesting at
+		 * most `chunk` items at a time.
+		 *
+		 * Returns the count of encoded items.
+		 */
+		uint32_t items(const boot_run* runs, uint32_t run_count, const StripConfig& config,
+				rmt_item32_t* items, size_t chunk) const {
+			EncodeState state = encodeState(config);
+			const uint8_t* data = reinterpret_cast<const uint8_t*>(runs);
+			size_t remaining = run_count * sizeof(boot_run);
+			uint32_t count = 0;
+			while(remaining > 0) {
+				size_t translated;
+				size_t num;
+				encode(state, data, remaining, &items[count], chunk, &translated, &num);
+				data += translated;
+				remaining -= translated;
+				count += num;
+			}
+			return count;
+		}
+};
+
+static const boot_run rgb_runs[] {{3, {16, 64, 0}}, {0, {1, 2, 3}}, {1, {255, 0, 255}}, {6, {0, 0, 7}}};
+
+void test_boot_frame_encoding() {
+	RgbStripConfig config {GRB, 300, 900, 600, 600};
+	ItemsStrip<RgbStrip> strip {GPIO_NUM_12, 10, RMT_CHANNEL_0, config};
+	// Same frame, with a GRB strip
+	strip.fillRgb(0, 3, {64, 16, 0});
+	strip.setRgbPixel(3, 0, 255, 255);
+	strip.fillRgb(4, 6, {0, 0, 7});
+	strip.show();
+
+	ItemsBootFrame frame {rgb_runs, 4, 3};
+	TEST_ASSERT_EQUAL_UINT32(10, frame.length());
+
+	rmt_item32_t items[10 * 24];
+	TEST_ASSERT_EQUAL_UINT32(10 * 24, frame.items(rgb_runs, 4, config, items, 64));
+	assert_same_items(strip.items(), items, 10 * 24);
+	TEST_ASSERT_EQUAL_UINT32(10 * 24, frame.items(rgb_runs, 4, config, items, 20));
+	assert_same_items(strip.items(), items, 10 * 24);
+
+	TEST_ASSERT_TRUE(frame.show(GPIO_NUM_12, RMT_CHANNEL_1, config) >= 0);
+}
+
+void test_boot_frame_copy() {
+	static const boot_run rgbw_runs[] {{2, {1, 2, 3, 4}}, {100, {5, 6, 7, 8}}};
+	BootFrame frame {rgbw_runs, 2, 4};
+	RgbwStrip strip {GPIO_NUM_12, 5, RMT_CHANNEL_0, SK6812W()};
+	strip.skipUnchangedFrames(true);
+	strip.show();
+
+	frame.copyTo(strip);
+	const uint8_t expected[20] {1, 2, 3, 4, 1, 2, 3, 4, 5, 6, 7, 8, 5, 6, 7, 8, 5, 6, 7, 8};
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, strip.buffer(), 20);
+
+	// The copied frame is transmitted, even if nothing else changed
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(0, strip.skippedFrames());
+}
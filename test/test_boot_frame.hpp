@@ -0,0 +1,2 @@
+void test_boot_frame_encoding();
+void test_boot_frame_copy();
@@ -0,0 +1,141 @@
+#include <cstring>
+
+#include "test_clocked_strip.hpp"
+#include "unity.h"
+
+#include "clocked_frame.hpp"
+#include "clocked_strip.hpp"
+#include "strip_config.hpp"
+#include "constants.hpp"
+
+using namespace pixled;
+
+void test_clocked_frame_layout() {
+	// 20 leds : 4 + 20 * 4 + 2 bytes
+	TEST_ASSERT_EQUAL_UINT32(86, ClockedFrame::frameSize(20, false));
+	TEST_ASSERT_EQUAL_UINT32(1, ClockedFrame::endFrameSize(16, false));
+	TEST_ASSERT_EQUAL_UINT32(2, ClockedFrame::endFrameSize(17, false));
+
+	uint8_t data[4 + 3*4 + 1];
+	std::memset(data, 0xAA, sizeof(data));
+	ClockedFrame frame {data, 3, false};
+	frame.pixels()[1] = 0x12;
+	frame.setBrightness(1, 10);
+	frame.setBrightness(2, 200);
+
+	uint8_t expected[] = {
+		0x00, 0x00, 0x00, 0x00,
+		0xFF, 0x12, 0x00, 0x00,
+		0xEA, 0x00, 0x00, 0x00,
+		0xFF, 0x00, 0x00, 0x00,
+		0x00
+	};
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expected), frame.size());
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, data, sizeof(expected));
+	TEST_ASSERT_EQUAL_UINT8(10, frame.brightness(1));
+	TEST_ASSERT_EQUAL_UINT8(31, frame.brightness(2));
+}
+
+void test_clocked_frame_reset_frame() {
+	uint8_t data[4 + 2*4 + 5];
+	std::memset(data, 0xAA, sizeof(data));
+	ClockedFrame frame {data, 2, true};
+	frame.clear(1);
+
+	uint8_t expected[] = {
+		0x00, 0x00, 0x00, 0x00,
+		0xE1, 0x00, 0x00, 0x00,
+		0xE1, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00
+	};
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expected), frame.size());
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, data, sizeof(expected));
+}
+
+void test_apa102_strip_frame() {
+	ClockedStrip strip {GPIO_NUM_13, GPIO_NUM_14, 4, APA102()};
+
+	strip.setRgbPixel(0, 0x10, 0x20, 0x30);
+	rgb_pixel pixels[2] {{1, 2, 3}, {4, 5, 6}};
+	strip.setRgbPixels(1, pixels, 2);
+	strip.fillRgb(3, 1, {0xFF, 0x80, 0x00});
+	strip.show();
+
+	// Recorded APA102 stream : start frame, BGR led frames, end frame
+	uint8_t expected[] = {
+		0x00, 0x00, 0x00, 0x00,
+		0xFF, 0x30, 0x20, 0x10,
+		0xFF, 0x03, 0x02, 0x01,
+		0xFF, 0x06, 0x05, 0x04,
+		0xFF, 0x00, 0x80, 0xFF,
+		0x00
+	};
+	TEST_ASSERT_EQUAL_UINT8(4, strip.pixelSize());
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expected), strip.frame().size());
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, strip.frame().data(), sizeof(expected));
+}
+
+void test_sk9822_strip_brightness() {
+	ClockedStrip strip {GPIO_NUM_13, GPIO_NUM_14, 3, SK9822()};
+
+	strip.fillRgb(0, 3, {0x11, 0x22, 0x33});
+	strip.setBrightness(4);
+	strip.setBrightness(1, 16);
+	strip.clear();
+	strip.setRgbPixel(2, 0xAB, 0, 0);
+
+	uint8_t expected[] = {
+		0x00, 0x00, 0x00, 0x00,
+		0xE4, 0x00, 0x00, 0x00,
+		0xF0, 0x00, 0x00, 0x00,
+		0xE4, 0x00, 0x00, 0xAB,
+		0x00, 0x00, 0x00, 0x00, 0x00
+	};
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expected), strip.frame().size());
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, strip.frame().data(), sizeof(expected));
+	TEST_ASSERT_EQUAL_UINT8(16, strip.brightness(1));
+}
+
+/*
+ * Initializes an SPI bus as the application would.
+ */
+static esp_err_t initialize_spi_bus(spi_host_device_t host) {
+	spi_bus_config_t bus_config;
+	std::memset(&bus_config, 0, sizeof(bus_config));
+	bus_config.mosi_io_num = GPIO_NUM_13;
+	bus_config.miso_io_num = -1;
+	bus_config.sclk_io_num = GPIO_NUM_14;
+	bus_config.quadwp_io_num = -1;
+	bus_config.quadhd_io_num = -1;
+	return spi_bus_initialize(host, &bus_config, SPI_DMA_CH_AUTO);
+}
+
+void test_clocked_strips_share_bus() {
+	{
+		ClockedStrip strip_a {GPIO_NUM_13, GPIO_NUM_14, 2, SPI2_HOST, APA102()};
+		{
+			// The bus initialized by strip_a is reused
+			ClockedStrip strip_b {GPIO_NUM_13, GPIO_NUM_14, 2, SPI2_HOST, APA102()};
+			TEST_ASSERT_TRUE(strip_a.ready());
+			TEST_ASSERT_TRUE(strip_b.ready());
+		}
+		// strip_b does not free the bus still used by strip_a
+		TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, spi_bus_free(SPI2_HOST));
+		TEST_ASSERT_TRUE(strip_a.ready());
+		strip_a.fillRgb(0, 2, {1, 2, 3});
+		strip_a.show();
+	}
+	// The bus is freed with its last strip
+	TEST_ASSERT_EQUAL(ESP_OK, initialize_spi_bus(SPI2_HOST));
+	TEST_ASSERT_EQUAL(ESP_OK, spi_bus_free(SPI2_HOST));
+}
+
+void test_clocked_strip_external_bus() {
+	TEST_ASSERT_EQUAL(ESP_OK, initialize_spi_bus(SPI2_HOST));
+	{
+		ClockedStrip strip {GPIO_NUM_13, GPIO_NUM_14, 2, SPI2_HOST, SK9822()};
+		TEST_ASSERT_TRUE(strip.ready());
+	}
+	// The bus initialized by the application is left to it
+	TEST_ASSERT_EQUAL(ESP_OK, spi_bus_free(SPI2_HOST));
+}
@@ -0,0 +1,6 @@
+void test_clocked_frame_layout();
+void test_clocked_frame_reset_frame();
+void test_apa102_strip_frame();
+void test_sk9822_strip_brightness();
+void test_clocked_strips_share_bus();
+void test_clocked_strip_external_bus();
@@ -0,0 +1,128 @@
+#include "test_compositor.hpp"
+#include "unity.h"
+
+#include "compositor.hpp"
+#include "strip.hpp"
+#include "constants.hpp"
+
+using namespace pixled;
+
+void test_blend_normal() {
+	uint8_t dst[4] = {0, 100, 200, 255};
+	uint8_t src[4] = {255, 0, 100, 255};
+	uint8_t alpha[4] = {255, 0, 128, 77};
+
+	blend::normal(dst, src, alpha, 4);
+
+	TEST_ASSERT_EQUAL_UINT8(255, dst[0]);
+	TEST_ASSERT_EQUAL_UINT8(100, dst[1]);
+	TEST_ASSERT_EQUAL_UINT8(150, dst[2]);
+	TEST_ASSERT_EQUAL_UINT8(255, dst[3]);
+}
+
+void test_blend_add() {
+	uint8_t dst[3] = {200, 10, 100};
+	uint8_t src[3] = {100, 100, 255};
+	uint8_t alpha[3] = {255, 128, 51};
+
+	blend::add(dst, src, alpha, 3);
+
+	TEST_ASSERT_EQUAL_UINT8(255, dst[0]);
+	TEST_ASSERT_EQUAL_UINT8(60, dst[1]);
+	TEST_ASSERT_EQUAL_UINT8(151, dst[2]);
+}
+
+void test_blend_multiply() {
+	uint8_t dst[3] = {255, 200, 200};
+	uint8_t src[3] = {128, 128, 0};
+	uint8_t alpha[3] = {255, 255, 128};
+
+	blend::multiply(dst, src, alpha, 3);
+
+	TEST_ASSERT_EQUAL_UINT8(128, dst[0]);
+	TEST_ASSERT_EQUAL_UINT8(100, dst[1]);
+	TEST_ASSERT_EQUAL_UINT8(100, dst[2]);
+}
+
+void test_blend_max() {
+	uint8_t dst[3] = {10, 200, 0};
+	uint8_t src[3] = {100, 100, 200};
+	uint8_t alpha[3] = {255, 255, 128};
+
+	blend::max(dst, src, alpha, 3);
+
+	TEST_ASSERT_EQUAL_UINT8(100, dst[0]);
+	TEST_ASSERT_EQUAL_UINT8(200, dst[1]);
+	TEST_ASSERT_EQUAL_UINT8(100, dst[2]);
+}
+
+void test_compositor_compose_strip() {
+	// Length is not a multiple of the block size
+	const uint16_t length = Compositor::BLOCK_SIZE * 2 + 5;
+	RgbStrip strip {GPIO_NUM_12, length + 2, RMT_CHANNEL_0, {GRB, 10, 10, 10, 10}};
+	Compositor compositor {length, 3};
+
+	for(uint16_t i = 0; i < length; i++) {
+		compositor.layer(0).pixels[i] = {(uint8_t) i, 50, 200};
+		compositor.layer(1).pixels[i] = {0, 255, 100};
+		compositor.layer(2).pixels[i] = {10, 10, 10};
+	}
+	compositor.layer(1).opacity = 51;
+	compositor.layer(2).mode = BlendMode::ADD;
+
+	compositor.compose(strip, 2);
+
+	uint8_t* buffer = strip.buffer();
+	for(uint16_t i = 0; i < length; i++) {
+		uint8_t* pixel = &buffer[3*(i+2)];
+		TEST_ASSERT_EQUAL_UINT8(101, pixel[0]);
+		TEST_ASSERT_EQUAL_UINT8((i * 204 + 127) / 255 + 10, pixel[1]);
+		TEST_ASSERT_EQUAL_UINT8(190, pixel[2]);
+	}
+	TEST_ASSERT_EQUAL_UINT8(0, buffer[0]);
+	TEST_ASSERT_EQUAL_UINT8(0, buffer[5]);
+}
+
+void test_compositor_pixel_alpha() {
+	Compositor compositor {4, 2, true};
+	for(uint16_t i = 0; i < 4; i++) {
+		compositor.layer(0).pixels[i] = {100, 100, 100};
+		compositor.layer(1).pixels[i] = {200, 0, 255};
+	}
+	compositor.layer(1).alpha[0] = 0;
+	compositor.layer(1).alpha[1] = 255;
+	compositor.layer(1).alpha[2] = 255;
+	compositor.layer(1).alpha[3] = 255;
+	compositor.layer(1).opacity = 255;
+	compositor.layer(1).alpha[2] = 128;
+	compositor.layer(1).mode = BlendMode::MAX;
+
+	rgb_pixel output[4];
+	compositor.compose(output);
+
+	TEST_ASSERT_EQUAL_UINT8(100, output[0].red);
+	TEST_ASSERT_EQUAL_UINT8(100, output[0].blue);
+	TEST_ASSERT_EQUAL_UINT8(200, output[1].red);
+	TEST_ASSERT_EQUAL_UINT8(100, output[1].green);
+	TEST_ASSERT_EQUAL_UINT8(255, output[1].blue);
+	TEST_ASSERT_EQUAL_UINT8(150, output[2].red);
+	TEST_ASSERT_EQUAL_UINT8(100, output[2].green);
+	TEST_ASSERT_EQUAL_UINT8(178, output[2].blue);
+}
+
+void test_compositor_hidden_layer() {
+	Compositor compositor {3, 2};
+	for(uint16_t i = 0; i < 3; i++) {
+		compositor.layer(0).pixels[i] = {1, 2, 3};
+		compositor.layer(1).pixels[i] = {4, 5, 6};
+	}
+	compositor.layer(1).visible = false;
+
+	rgb_pixel output[3];
+	compositor.compose(output);
+	for(uint16_t i = 0; i < 3; i++) {
+		TEST_ASSERT_EQUAL_UINT8(1, output[i].red);
+		TEST_ASSERT_EQUAL_UINT8(2, output[i].green);
+		TEST_ASSERT_EQUAL_UINT8(3, output[i].blue);
+	}
+}
@@ -0,0 +1,7 @@
+void test_blend_normal();
+void test_blend_add();
+void test_blend_multiply();
+void test_blend_max();
+void test_compositor_compose_strip();
+void test_compositor_pixel_alpha();
+void test_compositor_hidden_layer();
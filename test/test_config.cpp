@@ -3,9 +3,21 @@
 
 #include "strip_config.hpp"
 #include "strip.hpp"
+#include "strip16.hpp"
 
 using namespace pixled;
 
+/*
+ * Checks that the timings of `config` are exactly transmitted.
+ */
+static void assert_timings(const StripConfig& config, uint32_t t0h, uint32_t t0l, uint32_t t1h, uint32_t t1l) {
+	TEST_ASSERT_TRUE(config.valid());
+	TEST_ASSERT_EQUAL_UINT32(t0h, config.t0hNs());
+	TEST_ASSERT_EQUAL_UINT32(t0l, config.t0lNs());
+	TEST_ASSERT_EQUAL_UINT32(t1h, config.t1hNs());
+	TEST_ASSERT_EQUAL_UINT32(t1l, config.t1lNs());
+}
+
 template<typename Config>
 void test_rgb(RgbSerializer serializer, uint32_t t0h, uint32_t t0l, uint32_t t1h, uint32_t t1l) {
 	RgbStrip rgb_strip(GPIO_NUM_12, 50, RMT_CHANNEL_0, Config());
@@ -14,15 +26,9 @@ void test_rgb(RgbSerializer serializer, uint32_t t0h, uint32_t t0l, uint32_t t1h
 	const RgbStripConfig& config = rgb_strip.rgbStripConfig();
 
 	TEST_ASSERT(config.serializer == serializer);
-	TEST_ASSERT_EQUAL_UINT32(config.t0h, t0h * RMT_RATIO);
-	TEST_ASSERT_EQUAL_UINT32(config.t0l, t0l * RMT_RATIO);
-	TEST_ASSERT_EQUAL_UINT32(config.t1h, t1h * RMT_RATIO);
-	TEST_ASSERT_EQUAL_UINT32(config.t1l, t1l * RMT_RATIO);
+	assert_timings(config, t0h, t0l, t1h, t1l);
 
-	TEST_ASSERT_EQUAL_UINT32(strip_config.t0h, t0h * RMT_RATIO);
-	TEST_ASSERT_EQUAL_UINT32(strip_config.t0l, t0l * RMT_RATIO);
-	TEST_ASSERT_EQUAL_UINT32(strip_config.t1h, t1h * RMT_RATIO);
-	TEST_ASSERT_EQUAL_UINT32(strip_config.t1l, t1l * RMT_RATIO);
+	assert_timings(strip_config, t0h, t0l, t1h, t1l);
 }
 
 void test_ws2812() {
@@ -45,17 +51,91 @@ void test_rgbw(RgbwSerializer serializer, uint32_t t0h, uint32_t t0l, uint32_t t
 	const RgbwStripConfig& config = rgbw_strip.rgbwStripConfig();
 
 	TEST_ASSERT(config.serializer == serializer);
-	TEST_ASSERT_EQUAL_UINT32(config.t0h, t0h * RMT_RATIO);
-	TEST_ASSERT_EQUAL_UINT32(config.t0l, t0l * RMT_RATIO);
-	TEST_ASSERT_EQUAL_UINT32(config.t1h, t1h * RMT_RATIO);
-	TEST_ASSERT_EQUAL_UINT32(config.t1l, t1l * RMT_RATIO);
+	assert_timings(config, t0h, t0l, t1h, t1l);
 
-	TEST_ASSERT_EQUAL_UINT32(strip_config.t0h, t0h * RMT_RATIO);
-	TEST_ASSERT_EQUAL_UINT32(strip_config.t0l, t0l * RMT_RATIO);
-	TEST_ASSERT_EQUAL_UINT32(strip_config.t1h, t1h * RMT_RATIO);
-	TEST_ASSERT_EQUAL_UINT32(strip_config.t1l, t1l * RMT_RATIO);
+	assert_timings(strip_config, t0h, t0l, t1h, t1l);
 }
 
 void test_sk6812w() {
 	test_rgbw<SK6812W>(GRBW, SK6812_T0H, SK6812_T0L, SK6812_T1H, SK6812_T1L);
 }
+
+template<typename Config>
+void test_rgb16(RgbSerializer order, uint32_t t0h, uint32_t t0l, uint32_t t1h, uint32_t t1l) {
+	Rgb16Strip rgb16_strip(GPIO_NUM_12, 50, RMT_CHANNEL_0, Config());
+
+	const StripConfig& strip_config = rgb16_strip.stripConfig();
+	const Rgb16StripConfig& config = rgb16_strip.rgb16StripConfig();
+
+	TEST_ASSERT(config.serializer == Rgb16Serializer(order));
+	assert_timings(strip_config, t0h, t0l, t1h, t1l);
+}
+
+void test_ws2816() {
+	test_rgb16<WS2816>(GRB, WS2816_T0H, WS2816_T0L, WS2816_T1H, WS2816_T1L);
+}
+
+void test_ucs8903() {
+	test_rgb16<UCS8903>(RGB, UCS8903_T0H, UCS8903_T0L, UCS8903_T1H, UCS8903_T1L);
+}
+
+void test_ucs8904() {
+	Rgbw16Strip rgbw16_strip(GPIO_NUM_12, 50, RMT_CHANNEL_0, UCS8904());
+
+	const StripConfig& strip_config = rgbw16_strip.stripConfig();
+	const Rgbw16StripConfig& config = rgbw16_strip.rgbw16StripConfig();
+
+	TEST_ASSERT(config.serializer == Rgbw16Serializer(RGBW));
+	assert_timings(strip_config, UCS8904_T0H, UCS8904_T0L, UCS8904_T1H, UCS8904_T1L);
+}
+
+// The timing model is evaluated at compile time
+static_assert(StripConfig(WS2812_T0H, WS2812_T0L, WS2812_T1H, WS2812_T1L).clk_div == 4,
+		"50nS timings must use 50nS ticks");
+static_assert(StripConfig(WS2815_T0H, WS2815_T0L, WS2815_T1H, WS2815_T1L).clk_div == 8,
+		"100nS timings must use 100nS ticks");
+
+void test_timing_rounding() {
+	StripConfig config {333, 777, 666, 555};
+
+	// No divider represents those timings exactly : the finest tick is used
+	TEST_ASSERT_EQUAL_UINT8(1, config.clk_div);
+	TEST_ASSERT_EQUAL_UINT32(12500, config.tickPs());
+	// 333nS = 26.64 ticks of 12.5nS
+	TEST_ASSERT_EQUAL_UINT16(27, config.t0h);
+	TEST_ASSERT_EQUAL_UINT16(62, config.t0l);
+	TEST_ASSERT_EQUAL_UINT16(53, config.t1h);
+	TEST_ASSERT_EQUAL_UINT16(44, config.t1l);
+	TEST_ASSERT_EQUAL_UINT32(338, config.t0hNs());
+	TEST_ASSERT_EQUAL_UINT32(1213, config.bitPeriodNs());
+	TEST_ASSERT_TRUE(config.valid());
+
+	// WS2812 350nS was previously truncated to 300nS
+	WS2812 ws2812;
+	TEST_ASSERT_EQUAL_UINT32(350, ws2812.t0hNs());
+}
+
+void test_timing_compressed() {
+	WS2812 nominal;
+	WS2812 compressed {TimingMode::COMPRESSED};
+
+	TEST_ASSERT_TRUE(compressed.valid());
+	TEST_ASSERT_EQUAL_UINT32(WS2812_T0H, compressed.t0hNs());
+	TEST_ASSERT_EQUAL_UINT32(WS2812_T1H, compressed.t1hNs());
+	TEST_ASSERT_EQUAL_UINT32(WS2812_T0L - WS2812_TOLERANCE, compressed.t0lNs());
+	TEST_ASSERT_EQUAL_UINT32(WS2812_T1L - WS2812_TOLERANCE, compressed.t1lNs());
+	TEST_ASSERT_EQUAL_UINT32(1300, nominal.bitPeriodNs());
+	TEST_ASSERT_EQUAL_UINT32(1150, compressed.bitPeriodNs());
+}
+
+void test_timing_validation() {
+	// Not representable within 0nS
+	TEST_ASSERT_FALSE(StripConfig(333, 777, 666, 555, 0).valid());
+	// A 0 can't be distinguished from a 1
+	TEST_ASSERT_FALSE(StripConfig(400, 800, 400, 800).valid());
+	// Null durations are never generated, since they would terminate the
+	// transmission
+	StripConfig tiny {1, 1, 2, 2};
+	TEST_ASSERT_EQUAL_UINT16(1, tiny.t0h);
+	TEST_ASSERT_EQUAL_UINT16(1, tiny.t0l);
+}
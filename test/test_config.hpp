@@ -4,3 +4,9 @@ void test_ws2812();
 void test_ws2815();
 void test_sk6812();
 void test_sk6812w();
+void test_ws2816();
+void test_ucs8903();
+void test_ucs8904();
+void test_timing_rounding();
+void test_timing_compressed();
+void test_timing_validation();
@@ -0,0 +1,194 @@
+#include <cstring>
+
+#include "test_conformance.hpp"
+#include "unity.h"
+#include "test_helpers.hpp"
+#include "waveform.hpp"
+
+#include "strip.hpp"
+#include "strip16.hpp"
+#include "indexed_strip.hpp"
+#include "strip_config.hpp"
+#include "constants.hpp"
+
+using namespace pixled;
+
+#define CONFORMANCE_TRIALS 20
+#define CONFORMANCE_MAX_PIXELS 48
+
+/*
+ * Items and bytes of the largest frame : 48 RGBW 16 bits pixels.
+ */
+static rmt_item32_t reference_items[CONFORMANCE_MAX_PIXELS * 8 * 8 + 1];
+static uint8_t expected_bytes[CONFORMANCE_MAX_PIXELS * 8];
+static uint8_t decoded_bytes[CONFORMANCE_MAX_PIXELS * 8];
+
+static uint32_t random_state = 0x12345678;
+
+/*
+ * xorshift32 pseudo random generator, with a fixed seed so that failures
+ * can be reproduced.
+ */
+static uint32_t random32() {
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	return random_state;
+}
+
+static uint32_t random_range(uint32_t min, uint32_t max) {
+	return min + random32() % (max - min + 1);
+}
+
+/*
+ * Random timings around the WS2812 ones, in both timing modes, so that
+ * different RMT dividers are used.
+ */
+struct RandomTimings {
+	RandomTimings() :
+		t0h(random_range(250, 450)), t0l(random_range(700, 900)),
+		t1h(random_range(600, 800)), t1l(random_range(500, 700)),
+		mode(random32() & 1 ? TimingMode::COMPRESSED : TimingMode::NOMINAL) {}
+
+	uint16_t t0h, t0l, t1h, t1l;
+	TimingMode mode;
+};
+
+/*
+ * Checks that the items emitted by show() are the items of the reference
+ * encoder, and that they decode to `size` expected_bytes without timing
+ * violation.
+ */
+static void assert_conforms(const StripConfig& config, const rmt_item32_t* items, uint32_t size) {
+	reference_encode(config, expected_bytes, size, reference_items);
+	assert_same_items(reference_items, items, size * 8 + 1);
+
+	DecodedWaveform waveform = decode_waveform(config, items, size * 8 + 1, decoded_bytes, sizeof(decoded_bytes));
+	TEST_ASSERT_TRUE(waveform.terminated);
+	TEST_ASSERT_EQUAL_UINT32(size * 8, waveform.bits);
+	TEST_ASSERT_EQUAL_UINT32(0, waveform.violations);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expected_bytes, decoded_bytes, size);
+}
+
+void test_waveform_decoder() {
+	WS2812 config;
+	const uint8_t data[3] {0xA5, 0x00, 0xFF};
+	rmt_item32_t items[25];
+	reference_encode(config, data, 3, items);
+
+	uint8_t output[3];
+	DecodedWaveform waveform = decode_waveform(config, items, 25, output, 3);
+	TEST_ASSERT_TRUE(waveform.terminated);
+	TEST_ASSERT_EQUAL_UINT32(24, waveform.bits);
+	TEST_ASSERT_EQUAL_UINT32(0, waveform.violations);
+	TEST_ASSERT_EQUAL_INT32(-1, waveform.first_violation);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(data, output, 3);
+}
+
+void test_waveform_decoder_violations() {
+	WS2812 config;
+	const uint8_t data[2] {0x0F, 0xF0};
+	rmt_item32_t items[17];
+	reference_encode(config, data, 2, items);
+
+	// t1h 200nS too long : still decoded as a 1
+	items[5].duration0 += 200000 / config.tickPs();
+	// Inverted levels
+	items[9].level0 = 0;
+	// Missing terminator
+	items[16].duration0 = config.t0h;
+	items[16].duration1 = config.t0l;
+	items[16].level0 = 1;
+
+	uint8_t output[2];
+	DecodedWaveform waveform = decode_waveform(config, items, 17, output, 2);
+	TEST_ASSERT_FALSE(waveform.terminated);
+	TEST_ASSERT_EQUAL_UINT32(17, waveform.bits);
+	TEST_ASSERT_EQUAL_UINT32(2, waveform.violations);
+	TEST_ASSERT_EQUAL_INT32(5, waveform.first_violation);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(data, output, 2);
+}
+
+void test_conformance_rgb_strip() {
+	for(int trial = 0; trial < CONFORMANCE_TRIALS; trial++) {
+		uint16_t length = random_range(1, CONFORMANCE_MAX_PIXELS);
+		RandomTimings t;
+		RgbStripConfig config {GRB, t.t0h, t.t0l, t.t1h, t.t1l, DEFAULT_TOLERANCE, t.mode};
+		ItemsStrip<RgbStrip> strip {GPIO_NUM_12, length, RMT_CHANNEL_0, config};
+
+		for(uint16_t i = 0; i < length; i++)
+			strip.setRgbPixel(i, random32(), random32(), random32());
+		strip.show();
+
+		std::memcpy(expected_bytes, strip.buffer(), length * 3);
+		assert_conforms(strip.stripConfig(), strip.items(), length * 3);
+	}
+}
+
+void test_conformance_rgbw_strip() {
+	for(int trial = 0; trial < CONFORMANCE_TRIALS; trial++) {
+		uint16_t length = random_range(1, CONFORMANCE_MAX_PIXELS);
+		RandomTimings t;
+		RgbwStripConfig config {GRBW, t.t0h, t.t0l, t.t1h, t.t1l, DEFAULT_TOLERANCE, t.mode};
+		ItemsStrip<RgbwStrip> strip {GPIO_NUM_12, length, RMT_CHANNEL_0, config};
+
+		for(uint16_t i = 0; i < length; i++)
+			strip.setRgbwPixel(i, random32(), random32(), random32(), random32());
+		strip.show();
+
+		std::memcpy(expected_bytes, strip.buffer(), length * 4);
+		assert_conforms(strip.stripConfig(), strip.items(), length * 4);
+	}
+}
+
+void test_conformance_rgb16_strip() {
+	for(int trial = 0; trial < CONFORMANCE_TRIALS; trial++) {
+		uint16_t length = random_range(1, CONFORMANCE_MAX_PIXELS);
+		RandomTimings t;
+		Rgb16StripConfig config {GRB, t.t0h, t.t0l, t.t1h, t.t1l, DEFAULT_TOLERANCE, t.mode};
+		ItemsStrip<Rgb16Strip> strip {GPIO_NUM_12, length, RMT_CHANNEL_0, config};
+
+		for(uint16_t i = 0; i < length; i++)
+			strip.setRgb16Pixel(i, random32(), random32(), random32());
+		strip.show();
+
+		std::memcpy(expected_bytes, strip.buffer(), length * 6);
+		assert_conforms(strip.stripConfig(), strip.items(), length * 6);
+	}
+}
+
+void test_conformance_rgbw16_strip() {
+	for(int trial = 0; trial < CONFORMANCE_TRIALS; trial++) {
+		uint16_t length = random_range(1, CONFORMANCE_MAX_PIXELS);
+		RandomTimings t;
+		Rgbw16StripConfig config {GRBW, t.t0h, t.t0l, t.t1h, t.t1l, DEFAULT_TOLERANCE, t.mode};
+		ItemsStrip<Rgbw16Strip> strip {GPIO_NUM_12, length, RMT_CHANNEL_0, config};
+
+		for(uint16_t i = 0; i < length; i++)
+			strip.setRgbw16Pixel(i, random32(), random32(), random32(), random32());
+		strip.show();
+
+		std::memcpy(expected_bytes, strip.buffer(), length * 8);
+		assert_conforms(strip.stripConfig(), strip.items(), length * 8);
+	}
+}
+
+void test_conformance_indexed_strip() {
+	for(int trial = 0; trial < CONFORMANCE_TRIALS; trial++) {
+		uint16_t length = random_range(1, CONFORMANCE_MAX_PIXELS);
+		PaletteSize palette_size = trial % 2 ? PaletteSize::PALETTE_16 : PaletteSize::PALETTE_256;
+		RandomTimings t;
+		RgbStripConfig config {BRG, t.t0h, t.t0l, t.t1h, t.t1l, DEFAULT_TOLERANCE, t.mode};
+		ItemsStrip<IndexedRgbStrip> strip {GPIO_NUM_12, length, RMT_CHANNEL_0, palette_size, config};
+
+		for(uint16_t entry = 0; entry < strip.paletteSize(); entry++)
+			strip.setPaletteColor(entry, rgb_pixel(random32(), random32(), random32()));
+		for(uint16_t i = 0; i < length; i++)
+			strip.setIndex(i, random32() % strip.paletteSize());
+		strip.show();
+
+		for(uint16_t i = 0; i < length; i++)
+			config.serializer.serialize(strip.paletteColor(strip.getIndex(i)), &expected_bytes[3*i]);
+		assert_conforms(strip.stripConfig(), strip.items(), length * 3);
+	}
+}
@@ -0,0 +1,7 @@
+void test_waveform_decoder();
+void test_waveform_decoder_violations();
+void test_conformance_rgb_strip();
+void test_conformance_rgbw_strip();
+void test_conformance_rgb16_strip();
+void test_conformance_rgbw16_strip();
+void test_conformance_indexed_strip();
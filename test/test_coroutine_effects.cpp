@@ -0,0 +1,83 @@
+#include "test_coroutine_effects.hpp"
+
+#ifdef __cpp_impl_coroutine
+#include "unity.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "coroutine_effects.hpp"
+#include "strip.hpp"
+#include "constants.hpp"
+
+using namespace pixled;
+
+#define MEMORY_EFFECTS 8
+#define EFFECT_TASK_STACK 2048
+
+static EffectTask blink(Strip& strip, uint32_t index, rgb_pixel color, uint32_t period_ms) {
+	while(true) {
+		strip.setRgbPixel(index, color.red, color.green, color.blue);
+		co_await delay(period_ms);
+		strip.setRgbPixel(index, 0, 0, 0);
+		co_await delay(period_ms);
+	}
+}
+
+void test_coroutine_scheduler() {
+	RgbStrip strip {GPIO_NUM_12, 2, RMT_CHANNEL_0, WS2812()};
+	EffectScheduler scheduler {20};
+	scheduler.spawn(blink(strip, 0, {255, 0, 0}, 20));
+	scheduler.spawn(blink(strip, 1, {0, 0, 255}, 40));
+
+	const uint8_t expected_red[] = {255, 0, 255, 0};
+	const uint8_t expected_blue[] = {255, 255, 0, 0};
+	for(int frame = 0; frame < 4; frame++) {
+		scheduler.tick(strip);
+		TEST_ASSERT_EQUAL_UINT8(expected_red[frame], strip.getRgbPixel(0).red);
+		TEST_ASSERT_EQUAL_UINT8(expected_blue[frame], strip.getRgbPixel(1).blue);
+	}
+	TEST_ASSERT_EQUAL(2, scheduler.effectCount());
+}
+
+/*
+ * Same effect, run by its own task.
+ */
+static void blink_task(void* parameter) {
+	Strip& strip = *static_cast<Strip*>(parameter);
+	while(true) {
+		strip.setRgbPixel(0, 255, 255, 255);
+		vTaskDelay(20 / portTICK_PERIOD_MS);
+		strip.setRgbPixel(0, 0, 0, 0);
+		vTaskDelay(20 / portTICK_PERIOD_MS);
+	}
+}
+
+/*
+ * Heap used by MEMORY_EFFECTS effects, run as coroutines or as tasks.
+ */
+void test_benchmark_effect_memory() {
+	RgbStrip strip {GPIO_NUM_12, MEMORY_EFFECTS, RMT_CHANNEL_0, WS2812()};
+
+	size_t free_heap = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+	{
+		EffectScheduler scheduler {20};
+		for(uint32_t i = 0; i < MEMORY_EFFECTS; i++)
+			scheduler.spawn(blink(strip, i, {255, 255, 255}, 20));
+		scheduler.tick(strip);
+		size_t used = free_heap - heap_caps_get_free_size(MALLOC_CAP_8BIT);
+		printf("%-32s %8u bytes/effect (frame : %u bytes)\n", "coroutine effect",
+				(unsigned) (used / MEMORY_EFFECTS), (unsigned) (scheduler.memoryUsage() / MEMORY_EFFECTS));
+	}
+
+	free_heap = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+	TaskHandle_t tasks[MEMORY_EFFECTS];
+	for(uint32_t i = 0; i < MEMORY_EFFECTS; i++)
+		xTaskCreate(blink_task, "blink", EFFECT_TASK_STACK, &strip, 1, &tasks[i]);
+	size_t used = free_heap - heap_caps_get_free_size(MALLOC_CAP_8BIT);
+	printf("%-32s %8u bytes/effect (stack : %u bytes)\n", "task effect",
+			(unsigned) (used / MEMORY_EFFECTS), (unsigned) EFFECT_TASK_STACK);
+	for(uint32_t i = 0; i < MEMORY_EFFECTS; i++)
+		vTaskDelete(tasks[i]);
+}
+#endif
@@ -0,0 +1,4 @@
+#ifdef __cpp_impl_coroutine
+void test_coroutine_scheduler();
+void test_benchmark_effect_memory();
+#endif
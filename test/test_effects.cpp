@@ -0,0 +1,205 @@
+#include "test_effects.hpp"
+#include "unity.h"
+
+#include "effects.hpp"
+#include "converters.hpp"
+#include "strip.hpp"
+#include "run_strip.hpp"
+#include "constants.hpp"
+
+using namespace pixled;
+
+void test_fast_hsb_to_rgb() {
+	HsbToRgbConverter reference;
+	FastHsbToRgbConverter fast;
+
+	for(uint32_t hue = 0; hue < 65536; hue += 97) {
+		for(uint16_t saturation = 0; saturation < 256; saturation += 51) {
+			for(uint16_t brightness = 0; brightness < 256; brightness += 51) {
+				rgb_pixel expected = reference({hue * 360.f / 65536, saturation / 255.f, brightness / 255.f});
+				rgb_pixel rgb = fast(hue, saturation, brightness);
+				TEST_ASSERT_UINT_WITHIN(2, expected.red, rgb.red);
+				TEST_ASSERT_UINT_WITHIN(2, expected.green, rgb.green);
+				TEST_ASSERT_UINT_WITHIN(2, expected.blue, rgb.blue);
+			}
+		}
+	}
+}
+
+void test_rainbow() {
+	Rainbow rainbow {6};
+	rgb_pixel output[6];
+
+	rainbow.draw(output);
+	TEST_ASSERT_EQUAL_UINT8(255, output[0].red);
+	TEST_ASSERT_EQUAL_UINT8(0, output[0].green);
+	TEST_ASSERT_EQUAL_UINT8(0, output[0].blue);
+	// A third of a turn
+	TEST_ASSERT_UINT_WITHIN(1, 0, output[2].red);
+	TEST_ASSERT_UINT_WITHIN(1, 255, output[2].green);
+	TEST_ASSERT_UINT_WITHIN(1, 0, output[2].blue);
+
+	// Each frame shifts the hue by speed
+	Rainbow shifted {6, 0, 65536 / 3};
+	shifted.update();
+	shifted.draw(output);
+	TEST_ASSERT_UINT_WITHIN(1, 0, output[0].red);
+	TEST_ASSERT_UINT_WITHIN(1, 255, output[0].green);
+}
+
+void test_chase() {
+	Chase chase {12, {200, 100, 0}, 2, 4};
+	rgb_pixel output[12];
+
+	chase.draw(output);
+	for(uint16_t i = 0; i < 12; i++) {
+		if(i % 4 == 0) {
+			TEST_ASSERT_EQUAL_UINT8(200, output[i].red);
+			TEST_ASSERT_EQUAL_UINT8(100, output[i].green);
+		} else if(i % 4 == 3) {
+			// Tail of the segment in front of the pixel
+			TEST_ASSERT_EQUAL_UINT8(100, output[i].red);
+			TEST_ASSERT_EQUAL_UINT8(50, output[i].green);
+		} else {
+			TEST_ASSERT_EQUAL_UINT8(0, output[i].red);
+			TEST_ASSERT_EQUAL_UINT8(0, output[i].green);
+		}
+	}
+
+	chase.update();
+	chase.draw(output);
+	TEST_ASSERT_EQUAL_UINT8(200, output[1].red);
+	TEST_ASSERT_EQUAL_UINT8(100, output[0].red);
+	TEST_ASSERT_EQUAL_UINT8(0, output[3].red);
+
+	// Wraps around after `spacing` frames
+	for(int i = 0; i < 3; i++)
+		chase.update();
+	chase.draw(output);
+	TEST_ASSERT_EQUAL_UINT8(200, output[0].red);
+	TEST_ASSERT_EQUAL_UINT8(100, output[3].red);
+
+	// Null sizes are used as 1 : every pixel is a segment head
+	Chase full {4, {200, 100, 0}, 0, 0};
+	full.update();
+	full.draw(output);
+	for(uint16_t i = 0; i < 4; i++)
+		TEST_ASSERT_EQUAL_UINT8(200, output[i].red);
+}
+
+void test_fire() {
+	Fire fire {60, 55, 255, 42};
+	rgb_pixel output[60];
+
+	fire.draw(output);
+	for(uint16_t i = 0; i < 60; i++) {
+		TEST_ASSERT_EQUAL_UINT8(0, output[i].red);
+	}
+
+	for(int frame = 0; frame < 50; frame++)
+		fire.update();
+	fire.draw(output);
+
+	// The base of the fire is hot
+	TEST_ASSERT_GREATER_THAN(0, fire.heat()[0] + fire.heat()[1] + fire.heat()[2]);
+	TEST_ASSERT_EQUAL_UINT8(255, output[2].red);
+	// The fire never turns blue without being white
+	for(uint16_t i = 0; i < 60; i++)
+		if(output[i].blue > 0)
+			TEST_ASSERT_EQUAL_UINT8(255, output[i].green);
+
+	// The cooling range of short strips exceeds 8 bits, and is clamped
+	Fire short_fire {5, 255, 0, 42};
+	for(int frame = 0; frame < 10; frame++)
+		short_fire.update();
+	for(uint16_t i = 0; i < 5; i++)
+		TEST_ASSERT_EQUAL_UINT8(0, short_fire.heat()[i]);
+}
+
+void test_twinkle() {
+	rgb_pixel output[100];
+
+	Twinkle off {100, {255, 255, 255}, 0};
+	off.update();
+	off.draw(output);
+	for(uint16_t i = 0; i < 100; i++)
+		TEST_ASSERT_EQUAL_UINT8(0, output[i].red);
+
+	Twinkle twinkle {100, {255, 255, 255}, 128, 4096};
+	uint16_t lit = 0;
+	for(int frame = 0; frame < 8; frame++) {
+		twinkle.update();
+		twinkle.draw(output);
+		for(uint16_t i = 0; i < 100; i++) {
+			TEST_ASSERT_EQUAL_UINT8(output[i].red, output[i].blue);
+			if(output[i].red > 0)
+				lit++;
+		}
+	}
+	TEST_ASSERT_GREATER_THAN(0, lit);
+	TEST_ASSERT_LESS_THAN(800, lit);
+}
+
+void test_gradient() {
+	Gradient gradient {11, {0, 255, 100}, {255, 0, 100}};
+	rgb_pixel output[11];
+
+	gradient.draw(output);
+	TEST_ASSERT_EQUAL_UINT8(0, output[0].red);
+	TEST_ASSERT_EQUAL_UINT8(255, output[0].green);
+	TEST_ASSERT_UINT_WITHIN(1, 255, output[10].red);
+	TEST_ASSERT_UINT_WITHIN(1, 0, output[10].green);
+	for(uint16_t i = 0; i < 11; i++) {
+		TEST_ASSERT_UINT_WITHIN(1, i * 255 / 10, output[i].red);
+		TEST_ASSERT_EQUAL_UINT8(100, output[i].blue);
+	}
+}
+
+void test_effect_draw_strip() {
+	const uint16_t length = Effect::BLOCK_SIZE * 3 + 7;
+	RgbStrip strip {GPIO_NUM_12, length + 3, RMT_CHANNEL_0, {GRB, 10, 10, 10, 10}};
+	RgbStrip reference {GPIO_NUM_13, length + 3, RMT_CHANNEL_1, {GRB, 10, 10, 10, 10}};
+	Rainbow rainbow {length, 300, 100, 200, 150};
+	rainbow.update();
+
+	rainbow.draw(strip, 3);
+
+	rgb_pixel output[length];
+	rainbow.draw(output);
+	for(uint16_t i = 0; i < length; i++)
+		reference.setRgbPixel(i + 3, output[i].red, output[i].green, output[i].blue);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(reference.buffer(), strip.buffer(), (length + 3) * 3);
+}
+
+void test_effect_draw_max_length() {
+	// Run strips store runs instead of a pixel buffer
+	RgbStripConfig config = WS2812();
+	config.transmit_mode = TransmitMode::STREAMING;
+	RunRgbStrip strip {GPIO_NUM_12, 70000, RMT_CHANNEL_0, 4, config};
+	Gradient gradient {70000, {10, 20, 30}, {10, 20, 30}};
+
+	gradient.draw(strip);
+	TEST_ASSERT_EQUAL_UINT32(1, strip.runCount());
+	TEST_ASSERT_EQUAL_UINT8(30, strip.getRgbPixel(65534).blue);
+	TEST_ASSERT_EQUAL_UINT8(30, strip.getRgbPixel(69999).blue);
+}
+
+void test_effect_long_length() {
+	Gradient gradient {100001, {0, 0, 0}, {255, 255, 255}};
+	TEST_ASSERT_EQUAL_UINT32(100001, gradient.length());
+	rgb_pixel pixel;
+	gradient.render(50000, 1, &pixel);
+	TEST_ASSERT_UINT_WITHIN(1, 128, pixel.red);
+	gradient.render(100000, 1, &pixel);
+	TEST_ASSERT_UINT_WITHIN(1, 255, pixel.red);
+
+	// A full turn on each 65536 pixels
+	Rainbow rainbow {200000};
+	rgb_pixel pixels[2];
+	rainbow.render(0, 1, &pixels[0]);
+	rainbow.render(65536, 1, &pixels[1]);
+	TEST_ASSERT_EQUAL_UINT8(pixels[0].red, pixels[1].red);
+	TEST_ASSERT_EQUAL_UINT8(pixels[0].green, pixels[1].green);
+	rainbow.render(32768, 1, &pixels[1]);
+	TEST_ASSERT_NOT_EQUAL(pixels[0].red, pixels[1].red);
+}
@@ -0,0 +1,9 @@
+void test_fast_hsb_to_rgb();
+void test_rainbow();
+void test_chase();
+void test_fire();
+void test_twinkle();
+void test_gradient();
+void test_effect_draw_strip();
+void test_effect_draw_max_length();
+void test_effect_long_length();
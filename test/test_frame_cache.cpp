@@ -0,0 +1,164 @@
+#include <vector>
+
+#include "test_frame_cache.hpp"
+#include "test_helpers.hpp"
+#include "unity.h"
+
+#include "frame_cache.hpp"
+#include "strip.hpp"
+#include "indexed_strip.hpp"
+#include "strip_config.hpp"
+#include "constants.hpp"
+
+using namespace pixled;
+
+static void draw(RgbStrip& strip, uint8_t frame) {
+	for(uint32_t i = 0; i < strip.length(); i++)
+		strip.setRgbPixel(i, frame, i, 255 - frame);
+}
+
+/*
+ * Returns a copy of the items encoded for `frame`.
+ */
+static std::vector<uint32_t> encoded(uint8_t frame) {
+	ItemsStrip<RgbStrip> strip {GPIO_NUM_12, 10, RMT_CHANNEL_1, WS2812()};
+	draw(strip, frame);
+	strip.show();
+	std::vector<uint32_t> items;
+	for(uint32_t i = 0; i < 10 * 24; i++)
+		items.push_back(strip.items()[i].val);
+	return items;
+}
+
+static void assert_items(const std::vector<uint32_t>& expected, const rmt_item32_t* items) {
+	for(uint32_t i = 0; i < expected.size(); i++)
+		TEST_ASSERT_EQUAL_UINT32(expected[i], items[i].val);
+}
+
+void test_frame_cache_content_hits() {
+	const std::vector<uint32_t> frame_0 = encoded(0);
+	const std::vector<uint32_t> frame_1 = encoded(1);
+
+	FrameCache cache {64 * 1024};
+	ItemsStrip<RgbStrip> strip {GPIO_NUM_12, 10, RMT_CHANNEL_0, WS2812()};
+	strip.setFrameCache(&cache);
+
+	draw(strip, 0);
+	strip.show();
+	draw(strip, 1);
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(0, cache.hits());
+	TEST_ASSERT_EQUAL_UINT32(2, cache.misses());
+	TEST_ASSERT_EQUAL_UINT32(2, cache.entryCount());
+	assert_items(frame_1, strip.items());
+
+	// Hit : the frame is transmitted from the cache, and the items buffer
+	// of the strip is not encoded
+	draw(strip, 0);
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(1, cache.hits());
+	assert_items(frame_1, strip.items());
+
+	strip.setRgbPixel(3, 1, 2, 3);
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(3, cache.misses());
+	TEST_ASSERT_EQUAL_UINT32(3, cache.entryCount());
+	TEST_ASSERT_TRUE(cache.memoryUsage() >= 3 * (10 * 24 * sizeof(rmt_item32_t) + 30));
+
+	// A hash collision never hits : the buffer copy is checked
+	const uint8_t buffer[30] {};
+	TEST_ASSERT_NULL(cache.lookup(0, false, buffer, 30, 240));
+	TEST_ASSERT_EQUAL_UINT32(4, cache.misses());
+	strip.setFrameCache(nullptr);
+}
+
+void test_frame_cache_frame_ids() {
+	const std::vector<uint32_t> frame_0 = encoded(0);
+
+	FrameCache cache {64 * 1024};
+	ItemsStrip<RgbStrip> strip {GPIO_NUM_12, 10, RMT_CHANNEL_0, WS2812()};
+	strip.setFrameCache(&cache);
+
+	draw(strip, 0);
+	strip.setFrameId(42);
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(1, cache.misses());
+	const size_t id_usage = cache.memoryUsage();
+
+	// The ID identifies the frame, whatever the buffer content
+	draw(strip, 1);
+	strip.setFrameId(42);
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(1, cache.hits());
+
+	// Without ID, the next frame is identified by its content
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(2, cache.misses());
+	TEST_ASSERT_EQUAL_UINT32(2, cache.entryCount());
+	// Only frames identified by their content store a copy of the buffer
+	TEST_ASSERT_EQUAL_UINT32(2 * id_usage + 30, cache.memoryUsage());
+	strip.setFrameCache(nullptr);
+}
+
+void test_frame_cache_eviction() {
+	FrameCache cache {3 * (10 * 24 * sizeof(rmt_item32_t) + 64)};
+	RgbStrip strip {GPIO_NUM_12, 10, RMT_CHANNEL_0, WS2812()};
+	strip.setFrameCache(&cache);
+
+	// Frames 0 to 2 fit in the budget, frame 0 is pinned
+	for(uint8_t frame = 0; frame < 3; frame++) {
+		draw(strip, frame);
+		strip.setFrameId(frame, frame == 0);
+		strip.show();
+	}
+	TEST_ASSERT_EQUAL_UINT32(3, cache.entryCount());
+	TEST_ASSERT_EQUAL_UINT32(0, cache.evictions());
+
+	// Frame 1 is the least recently used unpinned frame
+	draw(strip, 3);
+	strip.setFrameId(3);
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(3, cache.entryCount());
+	TEST_ASSERT_EQUAL_UINT32(1, cache.evictions());
+	TEST_ASSERT_TRUE(cache.memoryUsage() <= cache.budget());
+
+	const uint32_t misses = cache.misses();
+	for(uint8_t frame : {0, 2, 3}) {
+		strip.setFrameId(frame);
+		strip.show();
+	}
+	TEST_ASSERT_EQUAL_UINT32(3, cache.hits());
+	TEST_ASSERT_EQUAL_UINT32(misses, cache.misses());
+
+	// Frame 0 is the least recently used, but is pinned : frame 2 is
+	// evicted
+	strip.setFrameId(1);
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(misses + 1, cache.misses());
+	TEST_ASSERT_EQUAL_UINT32(2, cache.evictions());
+	TEST_ASSERT_FALSE(cache.pin(2));
+	TEST_ASSERT_TRUE(cache.pin(0, false));
+	cache.clear();
+	TEST_ASSERT_EQUAL_UINT32(0, cache.entryCount());
+	TEST_ASSERT_EQUAL_UINT32(0, cache.memoryUsage());
+	strip.setFrameCache(nullptr);
+}
+
+void test_frame_cache_indexed_palette() {
+	FrameCache cache {64 * 1024};
+	ItemsStrip<IndexedRgbStrip> strip {GPIO_NUM_12, 10, RMT_CHANNEL_0, PaletteSize::PALETTE_16, WS2812()};
+	strip.setFrameCache(&cache);
+	strip.setPaletteColor(1, {255, 0, 0});
+	strip.fillIndex(0, 10, 1);
+	strip.show();
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(1, cache.hits());
+
+	// The buffer is unchanged, but its encoding is not
+	strip.setPaletteColor(1, {0, 0, 255});
+	TEST_ASSERT_EQUAL_UINT32(0, cache.entryCount());
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(1, cache.hits());
+	TEST_ASSERT_EQUAL_UINT32(2, cache.misses());
+	strip.setFrameCache(nullptr);
+}
@@ -0,0 +1,4 @@
+void test_frame_cache_content_hits();
+void test_frame_cache_frame_ids();
+void test_frame_cache_eviction();
+void test_frame_cache_indexed_palette();
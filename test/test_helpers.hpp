@@ -0,0 +1,84 @@
+#ifndef PIXLED_DRIVER_TEST_HELPERS_H
+#define PIXLED_DRIVER_TEST_HELPERS_H
+
+#include <memory>
+
+#include "unity.h"
+#include <driver/rmt.h>
+#include "soc/soc_caps.h"
+#include "soc/rmt_struct.h"
+
+/*
+ * Encodes `size` bytes of `data` as the RMT driver does in
+ * TransmitMode::STREAMING, calling `encode` with the translator arguments
+ * and requesting at most `chunk` items at a time.
+ *
+ * Returns the count of encoded items.
+ */
+template<typename Encode>
+uint32_t stream_items(Encode encode, const uint8_t* data, size_t size, rmt_item32_t* items, size_t chunk) {
+	uint32_t count = 0;
+	while(size > 0) {
+		size_t translated;
+		size_t num;
+		encode(data, size, &items[count], chunk, &translated, &num);
+		data += translated;
+		size -= translated;
+		count += num;
+	}
+	return count;
+}
+
+/*
+ * Exposes the RMT items of a strip, to check the output of show().
+ */
+template<typename S>
+class ItemsStrip : public S {
+	public:
+		using S::S;
+		const rmt_item32_t* items() const {return this->rmt_items;}
+
+		/*
+		 * Encodes the buffer as the RMT driver does in
+		 * TransmitMode::STREAMING, requesting at most `chunk` items at a time.
+		 * show() must have been called first.
+		 *
+		 * Returns the count of encoded items.
+		 */
+		uint32_t streamItems(rmt_item32_t* items, size_t chunk) const {
+			const auto& context = this->stream_context;
+			return stream_items([&context] (const uint8_t* data, size_t size, rmt_item32_t* dest,
+						size_t wanted_num, size_t* translated_size, size_t* item_num) {
+					S::encodeStream(context, data, size, dest, wanted_num, translated_size, item_num);
+					}, context.buffer, this->pixel_count * this->pixel_size, items, chunk);
+		}
+};
+
+inline void assert_same_items(const rmt_item32_t* expected, const rmt_item32_t* items, uint32_t count) {
+	for(uint32_t i = 0; i < count; i++)
+		TEST_ASSERT_EQUAL_UINT32(expected[i].val, items[i].val);
+}
+
+/*
+ * Streams `strip` with its streamItems(), requesting at most `chunk` items
+ * at a time, and checks the result against the `count` items `expected`.
+ */
+template<typename S>
+void assert_streamed_items(S& strip, const rmt_item32_t* expected, uint32_t count, size_t chunk) {
+	std::unique_ptr<rmt_item32_t[]> items {new rmt_item32_t[count + chunk]};
+	TEST_ASSERT_EQUAL_UINT32(count, strip.streamItems(items.get(), chunk));
+	assert_same_items(expected, items.get(), count);
+}
+
+/*
+ * Checks the items written by the RMT driver in the memory of `channel`,
+ * through the translator of a strip in TransmitMode::STREAMING. The frame
+ * must fit in a single memory block.
+ */
+inline void assert_translated_items(rmt_channel_t channel, const rmt_item32_t* expected, uint32_t count) {
+	TEST_ASSERT_LESS_THAN_UINT32(SOC_RMT_MEM_WORDS_PER_CHANNEL, count);
+	for(uint32_t i = 0; i < count; i++)
+		TEST_ASSERT_EQUAL_UINT32(expected[i].val, RMTMEM.chan[channel].data32[i].val);
+}
+
+#endif
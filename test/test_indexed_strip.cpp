@@ -0,0 +1,156 @@
+#include "test_indexed_strip.hpp"
+#include "unity.h"
+#include "test_helpers.hpp"
+
+#include "indexed_strip.hpp"
+#include "strip_config.hpp"
+#include "constants.hpp"
+
+using namespace pixled;
+
+/*
+ * Expands the indexes as the RMT driver does in TransmitMode::STREAMING,
+ * requesting at most `chunk` items at a time.
+ */
+template<typename S>
+class StreamedIndexedStrip : public ItemsStrip<S> {
+	public:
+		using ItemsStrip<S>::ItemsStrip;
+
+		uint32_t streamItems(rmt_item32_t* items, size_t chunk) {
+			this->stream_component = 0;
+			IndexedStrip& strip = *this;
+			return stream_items([&strip] (const uint8_t* data, size_t size, rmt_item32_t* dest,
+						size_t wanted_num, size_t* translated_size, size_t* item_num) {
+					S::encodeIndexes(strip, data, size, dest, wanted_num, translated_size, item_num);
+					}, this->buffer(), this->pixel_count, items, chunk);
+		}
+};
+
+static void test_indexed_rgb_strip(PaletteSize palette_size) {
+	RgbStripConfig config {GRB, 300, 900, 600, 600};
+	ItemsStrip<IndexedRgbStrip> strip {GPIO_NUM_12, 20, RMT_CHANNEL_0, palette_size, config};
+	ItemsStrip<RgbStrip> reference {GPIO_NUM_13, 20, RMT_CHANNEL_1, config};
+
+	rgb_pixel colors[3] = {{0, 0, 0}, {255, 10, 0}, {1, 128, 200}};
+	strip.setPaletteColor(1, colors[1]);
+	strip.setPaletteColor(2, colors[2]);
+	for(uint16_t i = 0; i < 20; i++) {
+		strip.setIndex(i, i % 3);
+		reference.setRgbPixel(i, colors[i % 3].red, colors[i % 3].green, colors[i % 3].blue);
+	}
+	TEST_ASSERT_EQUAL_UINT8(1, strip.buffer()[4]);
+	TEST_ASSERT_EQUAL_UINT8(1, strip.pixelSize());
+
+	strip.show();
+	reference.show();
+	assert_same_items(reference.items(), strip.items(), 20 * 24 + 1);
+}
+
+void test_indexed_rgb_strip_16() {
+	test_indexed_rgb_strip(PaletteSize::PALETTE_16);
+}
+
+void test_indexed_rgb_strip_256() {
+	test_indexed_rgb_strip(PaletteSize::PALETTE_256);
+}
+
+void test_indexed_rgbw_strip() {
+	ItemsStrip<IndexedRgbwStrip> strip {GPIO_NUM_12, 10, RMT_CHANNEL_0, PaletteSize::PALETTE_256, SK6812W()};
+	ItemsStrip<RgbwStrip> reference {GPIO_NUM_13, 10, RMT_CHANNEL_1, SK6812W()};
+
+	strip.setPaletteColor(200, rgb_pixel(100, 150, 200));
+	strip.setPaletteColor(201, rgbw_pixel(1, 2, 3, 4));
+	strip.fillIndex(0, 5, 200);
+	strip.fillIndex(5, 5, 201);
+	reference.fillRgb(0, 5, {100, 150, 200});
+	for(uint16_t i = 5; i < 10; i++)
+		reference.setRgbwPixel(i, 1, 2, 3, 4);
+
+	strip.show();
+	reference.show();
+	assert_same_items(reference.items(), strip.items(), 10 * 32 + 1);
+}
+
+void test_indexed_strip_recolor() {
+	RgbStripConfig config {RGB, 300, 900, 600, 600};
+	ItemsStrip<IndexedRgbStrip> strip {GPIO_NUM_12, 8, RMT_CHANNEL_0, PaletteSize::PALETTE_16, config};
+	ItemsStrip<RgbStrip> reference {GPIO_NUM_13, 8, RMT_CHANNEL_1, config};
+	strip.skipUnchangedFrames(true);
+
+	strip.setPaletteColor(3, {10, 20, 30});
+	strip.fillIndex(2, 4, 3);
+	strip.show();
+
+	// Only the palette is modified
+	strip.setPaletteColor(3, {200, 0, 7});
+	TEST_ASSERT_EQUAL_UINT8(3, strip.getIndex(2));
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(0, strip.skippedFrames());
+
+	reference.fillRgb(2, 4, {200, 0, 7});
+	reference.show();
+	assert_same_items(reference.items(), strip.items(), 8 * 24 + 1);
+}
+
+void test_indexed_strip_closest_color() {
+	IndexedRgbStrip strip {GPIO_NUM_12, 4, RMT_CHANNEL_0, PaletteSize::PALETTE_16, WS2812()};
+	strip.setPaletteColor(1, {255, 0, 0});
+	strip.setPaletteColor(2, {0, 255, 0});
+	strip.setPaletteColor(3, {255, 255, 255});
+
+	strip.setRgbPixel(0, 200, 20, 10);
+	strip.setRgbPixel(1, 10, 180, 50);
+	strip.setRgbPixel(2, 220, 230, 200);
+	strip.setRgbPixel(3, 10, 10, 10);
+
+	TEST_ASSERT_EQUAL_UINT8(1, strip.getIndex(0));
+	TEST_ASSERT_EQUAL_UINT8(2, strip.getIndex(1));
+	TEST_ASSERT_EQUAL_UINT8(3, strip.getIndex(2));
+	TEST_ASSERT_EQUAL_UINT8(0, strip.getIndex(3));
+}
+
+void test_indexed_strip_out_of_palette() {
+	IndexedRgbStrip strip {GPIO_NUM_12, 4, RMT_CHANNEL_0, PaletteSize::PALETTE_16, WS2812()};
+	TEST_ASSERT_TRUE(strip.setIndex(0, 15));
+	TEST_ASSERT_TRUE(strip.fillIndex(1, 3, 2));
+
+	// 17 would be displayed as the entry 1 by the 16 colors encoding
+	TEST_ASSERT_FALSE(strip.setIndex(0, 17));
+	TEST_ASSERT_FALSE(strip.fillIndex(1, 3, 16));
+	TEST_ASSERT_EQUAL_UINT8(15, strip.getIndex(0));
+	TEST_ASSERT_EQUAL_UINT8(2, strip.getIndex(3));
+
+	strip.setPaletteColor(1, {1, 2, 3});
+	strip.setPaletteColor(16, {255, 0, 0});
+	TEST_ASSERT_EQUAL_UINT8(1, strip.paletteColor(1).red);
+}
+
+template<typename S, typename Config>
+static void assert_indexed_streaming(Config config, PaletteSize palette_size, uint8_t bits, size_t chunk) {
+	ItemsStrip<S> reference {GPIO_NUM_13, 20, RMT_CHANNEL_1, palette_size, config};
+	config.transmit_mode = TransmitMode::STREAMING;
+	StreamedIndexedStrip<S> strip {GPIO_NUM_12, 20, RMT_CHANNEL_0, palette_size, config};
+	TEST_ASSERT_NULL(strip.items());
+
+	const rgb_pixel colors[3] {{255, 10, 0}, {1, 128, 200}, {7, 7, 7}};
+	for(uint8_t entry = 0; entry < 3; entry++) {
+		strip.setPaletteColor(entry + 1, colors[entry]);
+		reference.setPaletteColor(entry + 1, colors[entry]);
+	}
+	for(uint16_t i = 0; i < 20; i++) {
+		strip.setIndex(i, i % 4);
+		reference.setIndex(i, i % 4);
+	}
+	reference.show();
+
+	assert_streamed_items(strip, reference.items(), 20 * bits, chunk);
+}
+
+void test_indexed_strip_streaming() {
+	RgbStripConfig config {GRB, 300, 900, 600, 600};
+	assert_indexed_streaming<IndexedRgbStrip>(config, PaletteSize::PALETTE_16, 24, 64);
+	assert_indexed_streaming<IndexedRgbStrip>(config, PaletteSize::PALETTE_16, 24, 20);
+	assert_indexed_streaming<IndexedRgbStrip>(config, PaletteSize::PALETTE_256, 24, 32);
+	assert_indexed_streaming<IndexedRgbwStrip>(SK6812W(), PaletteSize::PALETTE_256, 32, 24);
+}
@@ -0,0 +1,7 @@
+void test_indexed_rgb_strip_16();
+void test_indexed_rgb_strip_256();
+void test_indexed_rgbw_strip();
+void test_indexed_strip_recolor();
+void test_indexed_strip_closest_color();
+void test_indexed_strip_out_of_palette();
+void test_indexed_strip_streaming();
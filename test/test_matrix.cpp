@@ -0,0 +1,147 @@
+#include "test_matrix.hpp"
+#include "unity.h"
+
+#include "matrix.hpp"
+#include "strip.hpp"
+#include "constants.hpp"
+
+using namespace pixled;
+
+static MatrixLayout tiled_layout() {
+	// Two rows of two 3x2 panels, rotated by 90 degrees, with serpentine
+	// wiring in each panel and between rows of panels.
+	return {3, 2, 2, 2, MatrixWiring::SERPENTINE, MatrixRotation::ROTATION_90, MatrixWiring::SERPENTINE};
+}
+
+static void fill_coordinates(RgbStrip& strip, const Matrix& matrix) {
+	for(uint16_t y = 0; y < matrix.height(); y++)
+		for(uint16_t x = 0; x < matrix.width(); x++)
+			strip.setRgbPixel(matrix.index(x, y), x, y, 42);
+}
+
+static void assert_pixel(RgbStrip& strip, const Matrix& matrix, uint16_t x, uint16_t y, rgb_pixel color) {
+	uint8_t* pixel = &strip.buffer()[3*matrix.index(x, y)];
+	TEST_ASSERT_EQUAL_UINT8(color.red, pixel[0]);
+	TEST_ASSERT_EQUAL_UINT8(color.green, pixel[1]);
+	TEST_ASSERT_EQUAL_UINT8(color.blue, pixel[2]);
+}
+
+void test_matrix_serpentine_lookup() {
+	RgbStrip strip {GPIO_NUM_12, 12, RMT_CHANNEL_0, {RGB, 10, 10, 10, 10}};
+	Matrix matrix {strip, {4, 3, MatrixWiring::SERPENTINE}};
+
+	uint16_t expected[12] = {
+		0, 1, 2, 3,
+		7, 6, 5, 4,
+		8, 9, 10, 11
+	};
+	TEST_ASSERT_EQUAL_UINT16(4, matrix.width());
+	TEST_ASSERT_EQUAL_UINT16(3, matrix.height());
+	for(uint16_t y = 0; y < 3; y++)
+		for(uint16_t x = 0; x < 4; x++)
+			TEST_ASSERT_EQUAL_UINT16(expected[y*4+x], matrix.index(x, y));
+}
+
+void test_matrix_rotated_tiled_lookup() {
+	RgbStrip strip {GPIO_NUM_12, 30, RMT_CHANNEL_0, {RGB, 10, 10, 10, 10}};
+	Matrix matrix {strip, tiled_layout(), 6};
+
+	// Each native panel is 2 leds wide and 3 leds high, and is rotated to
+	// appear 3 leds wide and 2 leds high. The second row of panels is chained
+	// from right to left.
+	uint16_t expected[24] = {
+		 4,  3,  0, 10,  9,  6,
+		 5,  2,  1, 11,  8,  7,
+		22, 21, 18, 16, 15, 12,
+		23, 20, 19, 17, 14, 13
+	};
+	TEST_ASSERT_EQUAL_UINT16(6, matrix.width());
+	TEST_ASSERT_EQUAL_UINT16(4, matrix.height());
+	for(uint16_t y = 0; y < 4; y++)
+		for(uint16_t x = 0; x < 6; x++)
+			TEST_ASSERT_EQUAL_UINT16(expected[y*6+x] + 6, matrix.index(x, y));
+}
+
+void test_matrix_runs() {
+	RgbStrip strip {GPIO_NUM_12, 64, RMT_CHANNEL_0, {RGB, 10, 10, 10, 10}};
+	Matrix serpentine {strip, {8, 4, 2, 2, MatrixWiring::SERPENTINE, MatrixRotation::ROTATION_0, MatrixWiring::PROGRESSIVE}};
+
+	uint16_t count;
+	const Matrix::run* runs = serpentine.rowRuns(1, count);
+	TEST_ASSERT_EQUAL_UINT16(2, count);
+	TEST_ASSERT_EQUAL_UINT16(0, runs[0].x);
+	TEST_ASSERT_EQUAL_UINT16(8, runs[0].length);
+	TEST_ASSERT_EQUAL_UINT16(15, runs[0].index);
+	TEST_ASSERT_TRUE(runs[0].reversed);
+	TEST_ASSERT_EQUAL_UINT16(8, runs[1].x);
+	TEST_ASSERT_EQUAL_UINT16(8, runs[1].length);
+	TEST_ASSERT_EQUAL_UINT16(47, runs[1].index);
+	TEST_ASSERT_TRUE(runs[1].reversed);
+
+	Matrix rotated {strip, {8, 8, MatrixWiring::PROGRESSIVE, MatrixRotation::ROTATION_90}};
+	runs = rotated.rowRuns(0, count);
+	TEST_ASSERT_EQUAL_UINT16(8, count);
+	for(uint16_t i = 0; i < count; i++) {
+		TEST_ASSERT_EQUAL_UINT16(i, runs[i].x);
+		TEST_ASSERT_EQUAL_UINT16(1, runs[i].length);
+	}
+}
+
+void test_matrix_fill_rect() {
+	RgbStrip strip {GPIO_NUM_12, 24, RMT_CHANNEL_0, {RGB, 10, 10, 10, 10}};
+	Matrix matrix {strip, tiled_layout()};
+
+	matrix.fillRect(1, 1, 4, 10, {200, 100, 50});
+
+	for(uint16_t y = 0; y < matrix.height(); y++) {
+		for(uint16_t x = 0; x < matrix.width(); x++) {
+			if(x >= 1 && x < 5 && y >= 1)
+				assert_pixel(strip, matrix, x, y, {200, 100, 50});
+			else
+				assert_pixel(strip, matrix, x, y, {0, 0, 0});
+		}
+	}
+}
+
+void test_matrix_blit() {
+	RgbStrip strip {GPIO_NUM_12, 64, RMT_CHANNEL_0, {GRB, 10, 10, 10, 10}};
+	Matrix matrix {strip, {4, 4, 2, 2, MatrixWiring::SERPENTINE, MatrixRotation::ROTATION_180, MatrixWiring::PROGRESSIVE}};
+	RgbStrip reference {GPIO_NUM_13, 64, RMT_CHANNEL_1, {GRB, 10, 10, 10, 10}};
+
+	rgb_pixel image[5*3];
+	for(uint16_t j = 0; j < 3; j++)
+		for(uint16_t i = 0; i < 5; i++)
+			image[j*5+i] = {(uint8_t) i, (uint8_t) j, 7};
+
+	// Partially out of the matrix
+	matrix.blit(5, 6, image, 5, 3);
+	for(uint16_t j = 0; j < 3; j++)
+		for(uint16_t i = 0; i < 5; i++)
+			if(5 + i < matrix.width() && 6 + j < matrix.height())
+				reference.setRgbPixel(matrix.index(5+i, 6+j), i, j, 7);
+
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(reference.buffer(), strip.buffer(), 64*3);
+}
+
+void test_matrix_scroll() {
+	RgbStrip strip {GPIO_NUM_12, 24, RMT_CHANNEL_0, {RGB, 10, 10, 10, 10}};
+	Matrix matrix {strip, tiled_layout()};
+
+	for(int16_t dx = -2; dx <= 2; dx++) {
+		for(int16_t dy = -2; dy <= 2; dy++) {
+			fill_coordinates(strip, matrix);
+			matrix.scroll(dx, dy, {1, 2, 3});
+
+			for(int16_t y = 0; y < matrix.height(); y++) {
+				for(int16_t x = 0; x < matrix.width(); x++) {
+					int16_t from_x = x - dx;
+					int16_t from_y = y - dy;
+					if(from_x < 0 || from_x >= matrix.width() || from_y < 0 || from_y >= matrix.height())
+						assert_pixel(strip, matrix, x, y, {1, 2, 3});
+					else
+						assert_pixel(strip, matrix, x, y, {(uint8_t) from_x, (uint8_t) from_y, 42});
+				}
+			}
+		}
+	}
+}
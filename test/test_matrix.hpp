@@ -0,0 +1,6 @@
+void test_matrix_serpentine_lookup();
+void test_matrix_rotated_tiled_lookup();
+void test_matrix_runs();
+void test_matrix_fill_rect();
+void test_matrix_blit();
+void test_matrix_scroll();
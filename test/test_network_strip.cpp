@@ -0,0 +1,182 @@
+#include <cstring>
+
+#include "test_network_strip.hpp"
+#include "unity.h"
+
+#include "lwip/sockets.h"
+#include "esp_netif.h"
+#include "esp_timer.h"
+
+#include "network_strip.hpp"
+#include "strip_config.hpp"
+#include "constants.hpp"
+
+using namespace pixled;
+
+/*
+ * UDP receiver bound to a free port of the loopback interface.
+ */
+class Receiver {
+	public:
+		int sock;
+		uint16_t port;
+
+		Receiver() {
+			esp_netif_init();
+			sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+			TEST_ASSERT_TRUE(sock >= 0);
+			struct sockaddr_in address;
+			std::memset(&address, 0, sizeof(address));
+			address.sin_family = AF_INET;
+			address.sin_port = 0;
+			address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			TEST_ASSERT_EQUAL_INT(0, bind(sock, (struct sockaddr*) &address, sizeof(address)));
+			socklen_t length = sizeof(address);
+			getsockname(sock, (struct sockaddr*) &address, &length);
+			port = ntohs(address.sin_port);
+
+			struct timeval timeout {1, 0};
+			setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+		}
+
+		/*
+		 * Receives a packet, and returns its size.
+		 */
+		int receive(uint8_t* packet, size_t size) {
+			return recv(sock, packet, size, 0);
+		}
+
+		~Receiver() {
+			close(sock);
+		}
+};
+
+static uint16_t read16(const uint8_t* input) {
+	return (input[0] << 8) | input[1];
+}
+
+static void fill(NetworkStrip& strip) {
+	for(uint32_t i = 0; i < strip.length(); i++)
+		strip.setRgbPixel(i, i, i >> 8, 42);
+}
+
+/*
+ * Checks that `data` contains `size` bytes of the buffer of `strip`, from
+ * `offset`.
+ */
+static void assert_data(NetworkStrip& strip, uint32_t offset, const uint8_t* data, uint16_t size) {
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(&strip.buffer()[offset], data, size);
+}
+
+void test_network_strip_e131() {
+	Receiver receiver;
+	E131 config {"127.0.0.1", 7};
+	config.port = receiver.port;
+	config.serializer = GRB;
+	NetworkStrip strip {200, config};
+	TEST_ASSERT_EQUAL_UINT32(2, strip.packetCount());
+	fill(strip);
+	strip.show();
+
+	uint8_t packet[1500];
+	const uint16_t sizes[2] {510, 90};
+	for(uint8_t i = 0; i < 2; i++) {
+		TEST_ASSERT_EQUAL_INT(126 + sizes[i], receiver.receive(packet, sizeof(packet)));
+		TEST_ASSERT_EQUAL_UINT8_ARRAY("ASC-E1.17", &packet[4], 9);
+		TEST_ASSERT_EQUAL_UINT16(0x7000 | (110 + sizes[i]), read16(&packet[16]));
+		TEST_ASSERT_EQUAL_UINT16(0x7000 | (88 + sizes[i]), read16(&packet[38]));
+		TEST_ASSERT_EQUAL_STRING("pixled", (const char*) &packet[44]);
+		TEST_ASSERT_EQUAL_UINT8(100, packet[108]);
+		TEST_ASSERT_EQUAL_UINT8(1, packet[111]);
+		TEST_ASSERT_EQUAL_UINT16(7 + i, read16(&packet[113]));
+		TEST_ASSERT_EQUAL_UINT16(0x7000 | (11 + sizes[i]), read16(&packet[115]));
+		TEST_ASSERT_EQUAL_UINT16(sizes[i] + 1, read16(&packet[123]));
+		TEST_ASSERT_EQUAL_UINT8(0, packet[125]);
+		assert_data(strip, 510 * i, &packet[126], sizes[i]);
+	}
+	// GRB order
+	TEST_ASSERT_EQUAL_UINT8(42, packet[126 + 2]);
+	TEST_ASSERT_EQUAL_UINT8(170, packet[126 + 1]);
+
+	strip.setRgbPixel(0, 1, 2, 3);
+	strip.show();
+	TEST_ASSERT_EQUAL_INT(126 + 510, receiver.receive(packet, sizeof(packet)));
+	TEST_ASSERT_EQUAL_UINT8(2, packet[111]);
+	TEST_ASSERT_EQUAL_UINT32(0, strip.droppedPackets());
+}
+
+void test_network_strip_artnet() {
+	Receiver receiver;
+	ArtNet config {"127.0.0.1", 0x1ff};
+	config.port = receiver.port;
+	NetworkStrip strip {201, config};
+	fill(strip);
+	strip.show();
+
+	uint8_t packet[1500];
+	// 603 bytes : the last packet is padded to an even length
+	const uint16_t sizes[2] {510, 93};
+	for(uint8_t i = 0; i < 2; i++) {
+		const uint16_t padded = sizes[i] + (sizes[i] & 1);
+		TEST_ASSERT_EQUAL_INT(18 + padded, receiver.receive(packet, sizeof(packet)));
+		TEST_ASSERT_EQUAL_UINT8_ARRAY("Art-Net", packet, 8);
+		TEST_ASSERT_EQUAL_UINT8(0x00, packet[8]);
+		TEST_ASSERT_EQUAL_UINT8(0x50, packet[9]);
+		TEST_ASSERT_EQUAL_UINT8(14, packet[11]);
+		TEST_ASSERT_EQUAL_UINT8(1, packet[12]);
+		// SubUni and Net of the universes 0x1ff and 0x200
+		TEST_ASSERT_EQUAL_UINT8(i == 0 ? 0xff : 0x00, packet[14]);
+		TEST_ASSERT_EQUAL_UINT8(i == 0 ? 0x01 : 0x02, packet[15]);
+		TEST_ASSERT_EQUAL_UINT16(padded, read16(&packet[16]));
+		assert_data(strip, 510 * i, &packet[18], sizes[i]);
+	}
+	TEST_ASSERT_EQUAL_UINT8(0, packet[18 + 93]);
+}
+
+void test_network_strip_ddp() {
+	Receiver receiver;
+	DDP config {"127.0.0.1"};
+	config.port = receiver.port;
+	NetworkStrip strip {600, config};
+	TEST_ASSERT_EQUAL_UINT32(2, strip.packetCount());
+	fill(strip);
+
+	uint8_t packet[1500];
+	for(uint8_t frame = 1; frame <= 16; frame++) {
+		strip.setRgbPixel(0, frame, 0, 0);
+		strip.show();
+		const uint16_t sizes[2] {1440, 360};
+		for(uint8_t i = 0; i < 2; i++) {
+			TEST_ASSERT_EQUAL_INT(10 + sizes[i], receiver.receive(packet, sizeof(packet)));
+			TEST_ASSERT_EQUAL_UINT8(i == 1 ? 0x41 : 0x40, packet[0]);
+			// 4 bits sequence, never 0
+			TEST_ASSERT_EQUAL_UINT8(frame == 16 ? 1 : frame, packet[1]);
+			TEST_ASSERT_EQUAL_UINT8(0x0b, packet[2]);
+			TEST_ASSERT_EQUAL_UINT8(0x01, packet[3]);
+			TEST_ASSERT_EQUAL_UINT16(0, read16(&packet[4]));
+			TEST_ASSERT_EQUAL_UINT16(1440 * i, read16(&packet[6]));
+			TEST_ASSERT_EQUAL_UINT16(sizes[i], read16(&packet[8]));
+			assert_data(strip, 1440 * i, &packet[10], sizes[i]);
+		}
+	}
+}
+
+void test_network_strip_pacing() {
+	Receiver receiver;
+	E131 config {"127.0.0.1"};
+	config.port = receiver.port;
+	config.universe_size = 30;
+	config.packet_interval_us = 500;
+	NetworkStrip strip {50, config};
+	TEST_ASSERT_EQUAL_UINT32(5, strip.packetCount());
+
+	const int64_t start = esp_timer_get_time();
+	strip.show();
+	TEST_ASSERT_TRUE(esp_timer_get_time() - start >= 4 * 500);
+
+	uint8_t packet[1500];
+	for(uint16_t universe = 1; universe <= 5; universe++) {
+		TEST_ASSERT_EQUAL_INT(126 + 30, receiver.receive(packet, sizeof(packet)));
+		TEST_ASSERT_EQUAL_UINT16(universe, read16(&packet[113]));
+	}
+}
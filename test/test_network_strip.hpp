@@ -0,0 +1,4 @@
+void test_network_strip_e131();
+void test_network_strip_artnet();
+void test_network_strip_ddp();
+void test_network_strip_pacing();
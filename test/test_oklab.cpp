@@ -0,0 +1,202 @@
+#include "test_oklab.hpp"
+#include "unity.h"
+
+#include <cmath>
+
+#include "converters.hpp"
+
+using namespace pixled;
+
+/*
+ * Double precision reference conversions, from
+ * https://bottosson.github.io/posts/oklab/
+ */
+static double to_linear(uint8_t value) {
+	const double x = value / 255.0;
+	return x <= 0.04045 ? x / 12.92 : std::pow((x + 0.055) / 1.055, 2.4);
+}
+
+static uint8_t to_srgb(double x) {
+	x = x < 0 ? 0 : x > 1 ? 1 : x;
+	x = x <= 0.0031308 ? x * 12.92 : 1.055 * std::pow(x, 1 / 2.4) - 0.055;
+	return (uint8_t) (x * 255 + 0.5);
+}
+
+static void reference_oklab(const rgb_pixel& pixel, double& L, double& a, double& b) {
+	const double r = to_linear(pixel.red), g = to_linear(pixel.green), bl = to_linear(pixel.blue);
+	const double l = std::cbrt(0.4122214708 * r + 0.5363325363 * g + 0.0514459929 * bl);
+	const double m = std::cbrt(0.2119034982 * r + 0.6806995451 * g + 0.1073969566 * bl);
+	const double s = std::cbrt(0.0883024619 * r + 0.2817188376 * g + 0.6299787005 * bl);
+	L = 0.2104542553 * l + 0.7936177850 * m - 0.0040720468 * s;
+	a = 1.9779984951 * l - 2.4285922050 * m + 0.4505937099 * s;
+	b = 0.0259040371 * l + 0.7827717662 * m - 0.8086757660 * s;
+}
+
+/*
+ * Returns false if the color is out of the sRGB gamut, in which case
+ * clipping differs from OklabToRgbConverter.
+ */
+static bool reference_rgb(const oklab_pixel& pixel, rgb_pixel& rgb) {
+	const double L = pixel.lightness / 32768.0, a = pixel.a / 32768.0, b = pixel.b / 32768.0;
+	const double l = std::pow(L + 0.3963377774 * a + 0.2158037573 * b, 3);
+	const double m = std::pow(L - 0.1055613458 * a - 0.0638541728 * b, 3);
+	const double s = std::pow(L - 0.0894841775 * a - 1.2914855480 * b, 3);
+	const double r = 4.0767416621 * l - 3.3077115913 * m + 0.2309699292 * s;
+	const double g = -1.2684380046 * l + 2.6097574011 * m - 0.3413193965 * s;
+	const double bl = -0.0041960863 * l - 0.7034186147 * m + 1.7076147010 * s;
+	rgb = rgb_pixel(to_srgb(r), to_srgb(g), to_srgb(bl));
+	return r >= 0 && r <= 1 && g >= 0 && g <= 1 && bl >= 0 && bl <= 1;
+}
+
+void test_rgb_to_oklab() {
+	oklab_pixel white = RgbToOklabConverter::convert({255, 255, 255});
+	TEST_ASSERT_UINT_WITHIN(2, 32768, white.lightness);
+	TEST_ASSERT_INT_WITHIN(2, 0, white.a);
+	TEST_ASSERT_INT_WITHIN(2, 0, white.b);
+	oklab_pixel black = RgbToOklabConverter::convert({0, 0, 0});
+	TEST_ASSERT_EQUAL_UINT16(0, black.lightness);
+	TEST_ASSERT_EQUAL_INT16(0, black.a);
+	TEST_ASSERT_EQUAL_INT16(0, black.b);
+
+	for(uint16_t red = 0; red < 256; red += 15) {
+		for(uint16_t green = 0; green < 256; green += 15) {
+			for(uint16_t blue = 0; blue < 256; blue += 15) {
+				double L, a, b;
+				reference_oklab({(uint8_t) red, (uint8_t) green, (uint8_t) blue}, L, a, b);
+				oklab_pixel lab = RgbToOklabConverter::convert({(uint8_t) red, (uint8_t) green, (uint8_t) blue});
+				TEST_ASSERT_INT_WITHIN(8, (int32_t) std::lround(L * 32768), lab.lightness);
+				TEST_ASSERT_INT_WITHIN(8, (int32_t) std::lround(a * 32768), lab.a);
+				TEST_ASSERT_INT_WITHIN(8, (int32_t) std::lround(b * 32768), lab.b);
+			}
+		}
+	}
+}
+
+void test_oklab_to_rgb() {
+	rgb_pixel white = OklabToRgbConverter::convert({32768, 0, 0});
+	TEST_ASSERT_EQUAL_UINT8(255, white.red);
+	TEST_ASSERT_EQUAL_UINT8(255, white.green);
+	TEST_ASSERT_EQUAL_UINT8(255, white.blue);
+	// Greys have no chroma
+	for(uint16_t lightness = 0; lightness <= 32768; lightness += 1024) {
+		rgb_pixel grey = OklabToRgbConverter::convert({lightness, 0, 0});
+		TEST_ASSERT_UINT_WITHIN(1, grey.red, grey.green);
+		TEST_ASSERT_UINT_WITHIN(1, grey.red, grey.blue);
+	}
+
+	uint32_t in_gamut = 0;
+	for(uint16_t lightness = 0; lightness <= 32768; lightness += 1024) {
+		for(int32_t a = -8000; a <= 8000; a += 800) {
+			for(int32_t b = -8000; b <= 8000; b += 800) {
+				const oklab_pixel lab {lightness, (int16_t) a, (int16_t) b};
+				rgb_pixel expected;
+				if(!reference_rgb(lab, expected))
+					continue;
+				in_gamut++;
+				rgb_pixel rgb = OklabToRgbConverter::convert(lab);
+				TEST_ASSERT_UINT_WITHIN(2, expected.red, rgb.red);
+				TEST_ASSERT_UINT_WITHIN(2, expected.green, rgb.green);
+				TEST_ASSERT_UINT_WITHIN(2, expected.blue, rgb.blue);
+			}
+		}
+	}
+	TEST_ASSERT_GREATER_THAN(1000, in_gamut);
+}
+
+void test_oklab_round_trip() {
+	uint32_t exact = 0;
+	uint32_t count = 0;
+	for(uint16_t red = 0; red < 256; red += 3) {
+		for(uint16_t green = 0; green < 256; green += 3) {
+			for(uint16_t blue = 0; blue < 256; blue += 3) {
+				const rgb_pixel color {(uint8_t) red, (uint8_t) green, (uint8_t) blue};
+				rgb_pixel rgb = OklabToRgbConverter::convert(RgbToOklabConverter::convert(color));
+				TEST_ASSERT_UINT_WITHIN(2, color.red, rgb.red);
+				TEST_ASSERT_UINT_WITHIN(2, color.green, rgb.green);
+				TEST_ASSERT_UINT_WITHIN(2, color.blue, rgb.blue);
+				exact += rgb.red == color.red && rgb.green == color.green && rgb.blue == color.blue;
+				count++;
+			}
+		}
+	}
+	TEST_ASSERT_GREATER_THAN(count * 95 / 100, exact);
+}
+
+void test_oklch_conversions() {
+	// Red, green and blue primaries, and a grey
+	const rgb_pixel colors[4] {{255, 0, 0}, {0, 255, 0}, {0, 0, 255}, {128, 128, 128}};
+	for(const rgb_pixel& color : colors) {
+		double L, a, b;
+		reference_oklab(color, L, a, b);
+		oklab_pixel lab = RgbToOklabConverter::convert(color);
+		oklch_pixel lch = OklabToOklchConverter::convert(lab);
+		TEST_ASSERT_EQUAL_UINT16(lab.lightness, lch.lightness);
+		TEST_ASSERT_UINT_WITHIN(8, (uint32_t) std::lround(std::hypot(a, b) * 32768), lch.chroma);
+		if(lch.chroma > 100) {
+			const double turns = std::atan2(b, a) / (2 * 3.14159265358979323846);
+			const uint16_t hue = (uint16_t) (int32_t) std::lround(turns * 65536);
+			TEST_ASSERT_INT_WITHIN(16, 0, (int16_t) (lch.hue - hue));
+		}
+
+		oklab_pixel back = OklchToOklabConverter::convert(lch);
+		TEST_ASSERT_EQUAL_UINT16(lab.lightness, back.lightness);
+		TEST_ASSERT_INT_WITHIN(2, lab.a, back.a);
+		TEST_ASSERT_INT_WITHIN(2, lab.b, back.b);
+	}
+	oklch_pixel grey = OklabToOklchConverter::convert({16384, 0, 0});
+	TEST_ASSERT_EQUAL_UINT16(0, grey.chroma);
+	TEST_ASSERT_EQUAL_UINT16(0, grey.hue);
+
+	// Full turn at constant chroma
+	for(uint32_t hue = 0; hue < 65536; hue += 257) {
+		oklab_pixel lab = OklchToOklabConverter::convert({20000, 8000, (uint16_t) hue});
+		const double angle = hue * 2 * 3.14159265358979323846 / 65536;
+		TEST_ASSERT_INT_WITHIN(2, (int32_t) std::lround(8000 * std::cos(angle)), lab.a);
+		TEST_ASSERT_INT_WITHIN(2, (int32_t) std::lround(8000 * std::sin(angle)), lab.b);
+		oklch_pixel lch = OklabToOklchConverter::convert(lab);
+		TEST_ASSERT_UINT_WITHIN(2, 8000, lch.chroma);
+		TEST_ASSERT_INT_WITHIN(8, 0, (int16_t) (lch.hue - hue));
+	}
+}
+
+void test_oklab_batch_conversions() {
+	rgb_pixel rgb[64];
+	for(uint16_t i = 0; i < 64; i++)
+		rgb[i] = {(uint8_t) (i * 4), (uint8_t) (255 - i * 3), (uint8_t) (i * 7)};
+
+	oklab_pixel lab[64];
+	oklch_pixel lch[64];
+	oklab_pixel lab_back[64];
+	rgb_pixel rgb_back[64];
+	rgb_pixel rgb_lch[64];
+	RgbToOklabConverter()(rgb, lab, 64);
+	OklabToOklchConverter()(lab, lch, 64);
+	OklchToOklabConverter()(lch, lab_back, 64);
+	OklabToRgbConverter()(lab, rgb_back, 64);
+	OklchToRgbConverter()(lch, rgb_lch, 64);
+
+	for(uint16_t i = 0; i < 64; i++) {
+		const oklab_pixel expected_lab = RgbToOklabConverter::convert(rgb[i]);
+		TEST_ASSERT_EQUAL_UINT16(expected_lab.lightness, lab[i].lightness);
+		TEST_ASSERT_EQUAL_INT16(expected_lab.a, lab[i].a);
+		TEST_ASSERT_EQUAL_INT16(expected_lab.b, lab[i].b);
+
+		const oklch_pixel expected_lch = OklabToOklchConverter::convert(lab[i]);
+		TEST_ASSERT_EQUAL_UINT16(expected_lch.chroma, lch[i].chroma);
+		TEST_ASSERT_EQUAL_UINT16(expected_lch.hue, lch[i].hue);
+
+		const oklab_pixel expected_back = OklchToOklabConverter::convert(lch[i]);
+		TEST_ASSERT_EQUAL_INT16(expected_back.a, lab_back[i].a);
+		TEST_ASSERT_EQUAL_INT16(expected_back.b, lab_back[i].b);
+
+		const rgb_pixel expected_rgb = OklabToRgbConverter::convert(lab[i]);
+		TEST_ASSERT_EQUAL_UINT8(expected_rgb.red, rgb_back[i].red);
+		TEST_ASSERT_EQUAL_UINT8(expected_rgb.green, rgb_back[i].green);
+		TEST_ASSERT_EQUAL_UINT8(expected_rgb.blue, rgb_back[i].blue);
+
+		const rgb_pixel expected_lch_rgb = OklchToRgbConverter::convert(lch[i]);
+		TEST_ASSERT_EQUAL_UINT8(expected_lch_rgb.red, rgb_lch[i].red);
+		TEST_ASSERT_EQUAL_UINT8(expected_lch_rgb.green, rgb_lch[i].green);
+		TEST_ASSERT_EQUAL_UINT8(expected_lch_rgb.blue, rgb_lch[i].blue);
+	}
+}
@@ -0,0 +1,5 @@
+void test_rgb_to_oklab();
+void test_oklab_to_rgb();
+void test_oklab_round_trip();
+void test_oklch_conversions();
+void test_oklab_batch_conversions();
@@ -0,0 +1,165 @@
+#include "test_parallel_output.hpp"
+#include "unity.h"
+
+#include "transpose.hpp"
+#include "parallel_output.hpp"
+#include "strip_config.hpp"
+#include "constants.hpp"
+
+using namespace pixled;
+
+/*
+ * Reference bit slice : bit `s` of the result is bit `bit` of the byte
+ * `index` of strip `s`.
+ */
+static uint16_t reference_slice(const uint8_t* const* inputs, uint8_t count, uint32_t index, uint8_t bit) {
+	uint16_t slice = 0;
+	for(uint8_t s = 0; s < count; s++)
+		if(inputs[s][index] & (1 << bit))
+			slice |= 1 << s;
+	return slice;
+}
+
+static void fill_random(uint8_t* data, uint32_t size, uint32_t seed) {
+	for(uint32_t i = 0; i < size; i++) {
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		data[i] = seed >> 24;
+	}
+}
+
+void test_transpose8() {
+	uint8_t rows[8];
+	fill_random(rows, 8, 42);
+	uint64_t x = 0;
+	for(int r = 0; r < 8; r++)
+		x |= (uint64_t) rows[r] << (8*r);
+
+	uint64_t t = transpose::transpose8(x);
+	for(int r = 0; r < 8; r++)
+		for(int c = 0; c < 8; c++)
+			TEST_ASSERT_EQUAL((rows[r] >> c) & 1, (t >> (8*c + r)) & 1);
+}
+
+void test_transpose_bits16() {
+	const uint32_t size = 37;
+	static uint8_t data[16][size];
+	const uint8_t* inputs[16];
+	for(int s = 0; s < 16; s++) {
+		fill_random(data[s], size, s + 1);
+		inputs[s] = data[s];
+	}
+
+	const uint8_t counts[4] = {16, 11, 8, 3};
+	static uint16_t output[8 * size];
+	for(uint8_t count : counts) {
+		transpose::bits16(inputs, count, 0, size, output);
+		for(uint32_t i = 0; i < size; i++)
+			for(int bit = 7; bit >= 0; bit--)
+				TEST_ASSERT_EQUAL_HEX16(reference_slice(inputs, count, i, bit), output[8*i + 7 - bit]);
+	}
+}
+
+void test_transpose_bits8() {
+	const uint32_t size = 37;
+	static uint8_t data[8][size];
+	const uint8_t* inputs[8];
+	for(int s = 0; s < 8; s++) {
+		fill_random(data[s], size, s + 1);
+		inputs[s] = data[s];
+	}
+
+	const uint8_t counts[3] = {8, 5, 1};
+	static uint8_t output[8 * size];
+	for(uint8_t count : counts) {
+		transpose::bits8(inputs, count, 0, size, output);
+		for(uint32_t i = 0; i < size; i++)
+			for(int bit = 7; bit >= 0; bit--)
+				TEST_ASSERT_EQUAL_HEX8(reference_slice(inputs, count, i, bit), output[8*i + 7 - bit]);
+	}
+}
+
+void test_transpose_bits16_stride() {
+	const uint32_t size = 5;
+	uint8_t data[2][size];
+	const uint8_t* inputs[2] {data[0], data[1]};
+	fill_random(data[0], size, 7);
+	fill_random(data[1], size, 8);
+
+	uint16_t output[3 * 8 * 3];
+	for(int i = 0; i < 3 * 8 * 3; i++)
+		output[i] = 0xAAAA;
+	// Transposes bytes 2 to 4 in the middle word of each group of 3
+	transpose::bits16(inputs, 2, 2, 3, &output[1], 3);
+
+	for(uint32_t i = 0; i < 3; i++) {
+		for(int bit = 7; bit >= 0; bit--) {
+			uint32_t slot = 3 * (8*i + 7 - bit);
+			TEST_ASSERT_EQUAL_HEX16(0xAAAA, output[slot]);
+			TEST_ASSERT_EQUAL_HEX16(reference_slice(inputs, 2, 2 + i, bit), output[slot + 1]);
+			TEST_ASSERT_EQUAL_HEX16(0xAAAA, output[slot + 2]);
+		}
+	}
+}
+
+void test_parallel_output_buffer() {
+	gpio_num_t gpios[3] {GPIO_NUM_12, GPIO_NUM_13, GPIO_NUM_14};
+	ParallelOutput output {gpios, 3, 2, GPIO_NUM_25, GPIO_NUM_26, WS2812()};
+
+	TEST_ASSERT_TRUE(output.ready());
+	TEST_ASSERT_EQUAL_UINT8(3, output.stripCount());
+	TEST_ASSERT_EQUAL_UINT8(8, output.busWidth());
+	TEST_ASSERT_NULL(output.buffer16());
+	output.strip(0).setRgbPixel(0, 255, 0, 0);
+	output.strip(1).setRgbPixel(1, 0, 0, 1);
+	output.strip(2).fillRgb(0, 2, {0x0F, 0xF0, 0x81});
+	output.strip(2).show();
+
+	const uint8_t* buffer = output.buffer8();
+	const uint8_t* inputs[3] {output.strip(0).buffer(), output.strip(1).buffer(), output.strip(2).buffer()};
+	for(uint32_t i = 0; i < 6; i++) {
+		for(int bit = 7; bit >= 0; bit--) {
+			uint32_t slot = 3 * (8*i + 7 - bit);
+			TEST_ASSERT_EQUAL_HEX8(0x07, buffer[slot]);
+			TEST_ASSERT_EQUAL_HEX8(reference_slice(inputs, 3, i, bit), buffer[slot + 1]);
+			TEST_ASSERT_EQUAL_HEX8(0x00, buffer[slot + 2]);
+		}
+	}
+	// GRB : the first bit of strip 0 is the MSB of its green byte (0), its
+	// 9th bit is the MSB of red (1), strip 2 sends 0xF0, 0x0F, 0x81
+	TEST_ASSERT_EQUAL_HEX8(0x04, buffer[1]);
+	TEST_ASSERT_EQUAL_HEX8(0x01, buffer[3*8 + 1]);
+
+	// Latch
+	TEST_ASSERT_TRUE(output.bufferSize() > 6 * 8 * 3);
+	for(uint32_t i = 6 * 8 * 3; i < output.bufferSize(); i++)
+		TEST_ASSERT_EQUAL_HEX8(0, buffer[i]);
+}
+
+void test_parallel_output_buffer16() {
+	gpio_num_t gpios[10] {
+		GPIO_NUM_2, GPIO_NUM_4, GPIO_NUM_5, GPIO_NUM_12, GPIO_NUM_13,
+		GPIO_NUM_14, GPIO_NUM_15, GPIO_NUM_16, GPIO_NUM_17, GPIO_NUM_18};
+	ParallelOutput output {gpios, 10, 2, GPIO_NUM_25, GPIO_NUM_26, WS2812()};
+
+	TEST_ASSERT_TRUE(output.ready());
+	TEST_ASSERT_EQUAL_UINT8(16, output.busWidth());
+	TEST_ASSERT_NULL(output.buffer8());
+	for(uint8_t s = 0; s < 10; s++)
+		output.strip(s).setRgbPixel(s % 2, 17 * s, 255 - s, s);
+	output.show();
+
+	const uint16_t* buffer = output.buffer16();
+	const uint8_t* inputs[10];
+	for(uint8_t s = 0; s < 10; s++)
+		inputs[s] = output.strip(s).buffer();
+	for(uint32_t i = 0; i < 6; i++) {
+		for(int bit = 7; bit >= 0; bit--) {
+			uint32_t slot = 3 * (8*i + 7 - bit);
+			TEST_ASSERT_EQUAL_HEX16(0x03FF, buffer[slot]);
+			TEST_ASSERT_EQUAL_HEX16(reference_slice(inputs, 10, i, bit), buffer[slot + 1]);
+			TEST_ASSERT_EQUAL_HEX16(0x0000, buffer[slot + 2]);
+		}
+	}
+}
@@ -0,0 +1,6 @@
+void test_transpose8();
+void test_transpose_bits16();
+void test_transpose_bits8();
+void test_transpose_bits16_stride();
+void test_parallel_output_buffer();
+void test_parallel_output_buffer16();
@@ -0,0 +1,119 @@
+#include "test_pixel_map.hpp"
+#include "unity.h"
+
+#include "pixel_map.hpp"
+#include "strip_config.hpp"
+#include "constants.hpp"
+
+using namespace pixled;
+
+/*
+ * Maps the leds on a 10x10x10 cube, with leds 10 units apart, in x, then y,
+ * then z order.
+ */
+static void map_cube(PixelMap& map) {
+	for(uint32_t i = 0; i < 1000; i++)
+		map.setPosition(i, 10 * (i % 10), 10 * ((i / 10) % 10), 10 * (i / 100) - 50);
+	map.buildIndex();
+}
+
+void test_pixel_map_evaluate() {
+	RgbStrip strip {GPIO_NUM_12, 1010, RMT_CHANNEL_0, WS2812()};
+	PixelMap map {strip, 1000, 10};
+	map_cube(map);
+
+	map.evaluate([] (int16_t x, int16_t y, int16_t z) {
+			return rgb_pixel(x, y, z + 50);
+		});
+
+	for(uint32_t i = 0; i < 10; i++)
+		TEST_ASSERT_EQUAL_UINT8(0, strip.getRgbPixel(i).blue);
+	for(uint32_t i = 0; i < 1000; i++) {
+		rgb_pixel pixel = strip.getRgbPixel(10 + i);
+		TEST_ASSERT_EQUAL_UINT8(10 * (i % 10), pixel.red);
+		TEST_ASSERT_EQUAL_UINT8(10 * ((i / 10) % 10), pixel.green);
+		TEST_ASSERT_EQUAL_UINT8(10 * (i / 100), pixel.blue);
+	}
+}
+
+void test_pixel_map_box_query() {
+	RgbStrip strip {GPIO_NUM_12, 1000, RMT_CHANNEL_0, WS2812()};
+	PixelMap map {strip, 1000, 0, 3};
+	map_cube(map);
+
+	TEST_ASSERT_EQUAL_INT16(-50, map.boundsMin().z);
+	TEST_ASSERT_EQUAL_INT16(90, map.boundsMax().x);
+	TEST_ASSERT_EQUAL_UINT32(12 * 12 * 12, map.cellCount());
+
+	bool visited[1000] {};
+	uint32_t count = 0;
+	map.forEachInBox({15, -100, -31}, {40, 25, 0}, [&] (uint32_t index) {
+			TEST_ASSERT_FALSE(visited[index]);
+			visited[index] = true;
+			count++;
+		});
+	// x in {20, 30, 40}, y in {0, 10, 20}, z in {-30, -20, -10, 0}
+	TEST_ASSERT_EQUAL_UINT32(3 * 3 * 4, count);
+	for(uint32_t i = 0; i < 1000; i++) {
+		map_point p = map.position(i);
+		bool inside = p.x >= 15 && p.x <= 40 && p.y <= 25 && p.z >= -31 && p.z <= 0;
+		TEST_ASSERT_EQUAL(inside, visited[i]);
+	}
+
+	count = 0;
+	map.forEachInBox({100, 0, 0}, {200, 100, 100}, [&] (uint32_t) {count++;});
+	TEST_ASSERT_EQUAL_UINT32(0, count);
+}
+
+void test_pixel_map_sphere_query() {
+	RgbStrip strip {GPIO_NUM_12, 1000, RMT_CHANNEL_0, WS2812()};
+	PixelMap map {strip, 1000};
+	map_cube(map);
+
+	const map_point center {42, 37, -8};
+	const uint16_t radius = 25;
+	map.fillSphere(center, radius, {255, 0, 0});
+
+	uint32_t count = 0;
+	for(uint32_t i = 0; i < 1000; i++) {
+		map_point p = map.position(i);
+		int32_t dx = p.x - center.x;
+		int32_t dy = p.y - center.y;
+		int32_t dz = p.z - center.z;
+		bool inside = dx*dx + dy*dy + dz*dz <= radius*radius;
+		if(inside)
+			count++;
+		TEST_ASSERT_EQUAL_UINT8(inside ? 255 : 0, strip.getRgbPixel(i).red);
+	}
+	TEST_ASSERT_TRUE(count > 0);
+
+	map.forEachInSphere(center, radius, [&] (uint32_t index, uint32_t distance2) {
+			map_point p = map.position(index);
+			int32_t dx = p.x - center.x;
+			int32_t dy = p.y - center.y;
+			int32_t dz = p.z - center.z;
+			TEST_ASSERT_EQUAL_UINT32(dx*dx + dy*dy + dz*dz, distance2);
+		});
+}
+
+void test_pixel_map_large_bounds() {
+	RgbStrip strip {GPIO_NUM_12, 4, RMT_CHANNEL_0, WS2812()};
+	PixelMap map {strip, 4, 0, 0};
+	map.setPosition(0, -32768, -32768, -32768);
+	map.setPosition(1, 32767, 32767, 32767);
+	map.setPosition(2, 0, 0, 0);
+	map.setPosition(3, PixelMap::quantize(1.26f, 0.01f), PixelMap::quantize(-0.5f, 0.01f), 0);
+	map.buildIndex();
+
+	TEST_ASSERT_EQUAL_INT16(126, map.position(3).x);
+	TEST_ASSERT_EQUAL_INT16(-50, map.position(3).y);
+	TEST_ASSERT_TRUE(map.cellCount() <= PixelMap::MAX_CELLS);
+	TEST_ASSERT_TRUE(map.cellSize() > 1);
+
+	uint32_t visited = 0;
+	map.forEachInSphere({0, 0, 0}, 200, [&] (uint32_t index, uint32_t) {visited |= 1 << index;});
+	TEST_ASSERT_EQUAL_UINT32(0b1100, visited);
+	visited = 0;
+	map.forEachInBox({-32768, -32768, -32768}, {32767, 32767, 32767}, [&] (uint32_t index) {visited |= 1 << index;});
+	TEST_ASSERT_EQUAL_UINT32(0b1111, visited);
+}
@@ -0,0 +1,4 @@
+void test_pixel_map_evaluate();
+void test_pixel_map_box_query();
+void test_pixel_map_sphere_query();
+void test_pixel_map_large_bounds();
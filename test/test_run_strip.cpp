@@ -0,0 +1,212 @@
+#include "test_run_strip.hpp"
+#include "unity.h"
+#include "test_helpers.hpp"
+
+#include <cstring>
+
+#include "run_strip.hpp"
+#include "strip_config.hpp"
+#include "constants.hpp"
+
+using namespace pixled;
+
+/*
+ * Encodes the runs as the RMT driver does in TransmitMode::STREAMING,
+ * requesting at most `chunk` items at a time.
+ */
+template<typename S>
+class StreamedRunStrip : public ItemsStrip<S> {
+	public:
+		using ItemsStrip<S>::ItemsStrip;
+
+		uint32_t streamItems(rmt_item32_t* items, size_t chunk) {
+			this->startStream();
+			RunStrip::RunContext& context = this->run_context;
+			return stream_items([&context] (const uint8_t*, size_t size, rmt_item32_t* dest,
+						size_t wanted_num, size_t* translated_size, size_t* item_num) {
+					S::encodeRuns(context, size, dest, wanted_num, translated_size, item_num);
+					}, nullptr, this->pixel_count * this->pixel_size, items, chunk);
+		}
+};
+
+/*
+ * Checks that runs are sorted, start at 0, and that consecutive runs have
+ * different colors.
+ */
+static void assert_valid_runs(const RunStrip& strip, uint8_t entry_size) {
+	TEST_ASSERT_GREATER_THAN(0, strip.runCount());
+	TEST_ASSERT_EQUAL_UINT32(0, strip.run(0).start);
+	for(uint32_t i = 1; i < strip.runCount(); i++) {
+		TEST_ASSERT_GREATER_THAN(strip.run(i-1).start, strip.run(i).start);
+		TEST_ASSERT_NOT_EQUAL(0, std::memcmp(strip.run(i-1).color, strip.run(i).color, entry_size));
+	}
+}
+
+static void assert_same_pixels(RunRgbStrip& strip, RgbStrip& reference) {
+	for(uint32_t i = 0; i < reference.length(); i++) {
+		rgb_pixel expected = reference.getRgbPixel(i);
+		rgb_pixel pixel = strip.getRgbPixel(i);
+		TEST_ASSERT_EQUAL_UINT8(expected.red, pixel.red);
+		TEST_ASSERT_EQUAL_UINT8(expected.green, pixel.green);
+		TEST_ASSERT_EQUAL_UINT8(expected.blue, pixel.blue);
+	}
+}
+
+void test_run_strip_fill() {
+	RgbStripConfig config {GRB, 300, 900, 600, 600};
+	ItemsStrip<RunRgbStrip> strip {GPIO_NUM_12, 200, RMT_CHANNEL_0, 200, config};
+	ItemsStrip<RgbStrip> reference {GPIO_NUM_13, 200, RMT_CHANNEL_1, config};
+	TEST_ASSERT_NULL(strip.buffer());
+	TEST_ASSERT_EQUAL_UINT32(1, strip.runCount());
+
+	const rgb_pixel colors[4] {{0, 0, 0}, {255, 0, 0}, {0, 200, 10}, {1, 2, 3}};
+	uint32_t random = 42;
+	for(int i = 0; i < 300; i++) {
+		random = random * 1103515245 + 12345;
+		const uint32_t index = (random >> 8) % 200;
+		const uint32_t count = 1 + (random >> 16) % (i % 3 == 0 ? 100 : 8);
+		const rgb_pixel& color = colors[(random >> 24) % 4];
+		const uint32_t clipped = index + count > 200 ? 200 - index : count;
+		strip.fillRgb(index, clipped, color);
+		reference.fillRgb(index, clipped, color);
+		assert_valid_runs(strip, 3);
+		assert_same_pixels(strip, reference);
+	}
+	TEST_ASSERT_EQUAL_UINT32(0, strip.droppedUpdates());
+
+	strip.show();
+	reference.show();
+	assert_same_items(reference.items(), strip.items(), 200 * 24 + 1);
+	TEST_ASSERT_EQUAL_UINT32(200, strip.transmittedPixels());
+}
+
+void test_run_strip_merge() {
+	RunRgbStrip strip {GPIO_NUM_12, 100, RMT_CHANNEL_0, 10, WS2812()};
+	strip.fillRgb(0, 100, {0, 0, 0});
+	TEST_ASSERT_EQUAL_UINT32(1, strip.runCount());
+
+	strip.fillRgb(40, 20, {255, 0, 0});
+	TEST_ASSERT_EQUAL_UINT32(3, strip.runCount());
+	TEST_ASSERT_EQUAL_UINT32(40, strip.run(1).start);
+	TEST_ASSERT_EQUAL_UINT32(60, strip.run(2).start);
+	TEST_ASSERT_EQUAL_UINT32(1, strip.findRun(59));
+	TEST_ASSERT_EQUAL_UINT32(2, strip.findRun(60));
+
+	// Adjacent runs of the same color are extended
+	strip.fillRgb(60, 10, {255, 0, 0});
+	TEST_ASSERT_EQUAL_UINT32(3, strip.runCount());
+	TEST_ASSERT_EQUAL_UINT32(70, strip.run(2).start);
+	strip.fillRgb(30, 10, {255, 0, 0});
+	TEST_ASSERT_EQUAL_UINT32(3, strip.runCount());
+	TEST_ASSERT_EQUAL_UINT32(30, strip.run(1).start);
+
+	// Filling a run with the color of its neighbours merges them
+	strip.fillRgb(30, 40, {0, 0, 0});
+	TEST_ASSERT_EQUAL_UINT32(1, strip.runCount());
+
+	strip.setRgbPixel(99, 0, 0, 255);
+	strip.setRgbPixel(0, 0, 0, 255);
+	TEST_ASSERT_EQUAL_UINT32(3, strip.runCount());
+	strip.clear();
+	TEST_ASSERT_EQUAL_UINT32(1, strip.runCount());
+	TEST_ASSERT_EQUAL_UINT8(0, strip.getRgbPixel(99).blue);
+}
+
+void test_run_strip_set_pixels() {
+	RgbStripConfig config {GRB, 300, 900, 600, 600};
+	ItemsStrip<RunRgbStrip> strip {GPIO_NUM_12, 64, RMT_CHANNEL_0, 64, config};
+	ItemsStrip<RgbStrip> reference {GPIO_NUM_13, 64, RMT_CHANNEL_1, config};
+
+	// Steps of 4 pixels
+	rgb_pixel pixels[40];
+	for(uint16_t i = 0; i < 40; i++)
+		pixels[i] = {(uint8_t) (i / 4 * 20), 10, 0};
+	strip.setRgbPixels(12, pixels, 40);
+	reference.setRgbPixels(12, pixels, 40);
+	TEST_ASSERT_EQUAL_UINT32(12, strip.runCount());
+	assert_valid_runs(strip, 3);
+	assert_same_pixels(strip, reference);
+
+	strip.setHsbPixel(3, 120, 1, 1);
+	reference.setHsbPixel(3, 120, 1, 1);
+	assert_same_pixels(strip, reference);
+
+	strip.show();
+	reference.show();
+	assert_same_items(reference.items(), strip.items(), 64 * 24 + 1);
+}
+
+void test_run_strip_overflow() {
+	RunRgbStrip strip {GPIO_NUM_12, 100, RMT_CHANNEL_0, 4, WS2812()};
+	strip.fillRgb(10, 10, {255, 0, 0});
+	TEST_ASSERT_EQUAL_UINT32(3, strip.runCount());
+	// Would require 5 runs
+	TEST_ASSERT_FALSE(strip.tryFillRgb(50, 10, {0, 255, 0}));
+	TEST_ASSERT_EQUAL_UINT32(3, strip.runCount());
+	TEST_ASSERT_EQUAL_UINT32(1, strip.droppedUpdates());
+	TEST_ASSERT_EQUAL_UINT8(0, strip.getRgbPixel(55).green);
+	// Replaces a run
+	TEST_ASSERT_TRUE(strip.tryFillRgb(10, 10, {0, 255, 0}));
+	TEST_ASSERT_EQUAL_UINT32(3, strip.runCount());
+	TEST_ASSERT_EQUAL_UINT8(255, strip.getRgbPixel(15).green);
+	TEST_ASSERT_EQUAL_UINT32(1, strip.droppedUpdates());
+
+	// A gradient stops at the first run that does not fit
+	const rgb_pixel gradient[3] {{1, 1, 1}, {2, 2, 2}, {2, 2, 2}};
+	RunRgbStrip gradient_strip {GPIO_NUM_12, 100, RMT_CHANNEL_0, 3, WS2812()};
+	TEST_ASSERT_FALSE(gradient_strip.trySetRgbPixels(30, gradient, 3));
+	TEST_ASSERT_EQUAL_UINT32(3, gradient_strip.runCount());
+	TEST_ASSERT_EQUAL_UINT8(1, gradient_strip.getRgbPixel(30).red);
+	TEST_ASSERT_EQUAL_UINT8(0, gradient_strip.getRgbPixel(31).red);
+	TEST_ASSERT_EQUAL_UINT8(0, gradient_strip.getRgbPixel(32).red);
+	TEST_ASSERT_EQUAL_UINT32(1, gradient_strip.droppedUpdates());
+
+	RunRgbwStrip rgbw_strip {GPIO_NUM_12, 100, RMT_CHANNEL_0, 2, SK6812W()};
+	TEST_ASSERT_TRUE(rgbw_strip.fillRgbw(50, 50, {1, 2, 3, 4}));
+	TEST_ASSERT_FALSE(rgbw_strip.fillRgbw(10, 10, {1, 2, 3, 4}));
+}
+
+template<typename S, typename Reference, typename Config>
+static void assert_run_streaming(Config config, uint8_t bits, size_t chunk) {
+	ItemsStrip<Reference> reference {GPIO_NUM_12, 50, RMT_CHANNEL_0, config};
+	config.transmit_mode = TransmitMode::STREAMING;
+	StreamedRunStrip<S> strip {GPIO_NUM_13, 50, RMT_CHANNEL_1, 16, config};
+	TEST_ASSERT_NULL(strip.items());
+
+	const rgb_pixel colors[3] {{255, 10, 0}, {1, 128, 200}, {7, 7, 7}};
+	for(uint16_t i = 0; i < 9; i++) {
+		const uint32_t index = (i * 17) % 50;
+		const uint32_t count = index + 1 + i > 50 ? 50 - index : 1 + i;
+		strip.fillRgb(index, count, colors[i % 3]);
+		reference.fillRgb(index, count, colors[i % 3]);
+	}
+	strip.show();
+	reference.show();
+
+	assert_streamed_items(strip, reference.items(), 50 * bits, chunk);
+}
+
+void test_run_strip_streaming() {
+	RgbStripConfig config {GRB, 300, 900, 600, 600};
+	assert_run_streaming<RunRgbStrip, RgbStrip>(config, 24, 64);
+	assert_run_streaming<RunRgbStrip, RgbStrip>(config, 24, 20);
+	assert_run_streaming<RunRgbwStrip, RgbwStrip>(SK6812W(), 32, 24);
+}
+
+void test_run_rgbw_strip() {
+	ItemsStrip<RunRgbwStrip> strip {GPIO_NUM_12, 30, RMT_CHANNEL_0, 8, SK6812W()};
+	ItemsStrip<RgbwStrip> reference {GPIO_NUM_13, 30, RMT_CHANNEL_1, SK6812W()};
+	TEST_ASSERT_EQUAL_UINT8(4, strip.pixelSize());
+
+	strip.fillRgb(0, 10, {200, 100, 50});
+	reference.fillRgb(0, 10, {200, 100, 50});
+	strip.fillRgbw(20, 5, {1, 2, 3, 4});
+	for(uint32_t i = 20; i < 25; i++)
+		reference.setRgbwPixel(i, 1, 2, 3, 4);
+	TEST_ASSERT_EQUAL_UINT32(4, strip.runCount());
+	TEST_ASSERT_EQUAL_UINT8(4, strip.getRgbwPixel(22).white);
+
+	strip.show();
+	reference.show();
+	assert_same_items(reference.items(), strip.items(), 30 * 32 + 1);
+}
@@ -0,0 +1,6 @@
+void test_run_strip_fill();
+void test_run_strip_merge();
+void test_run_strip_set_pixels();
+void test_run_strip_overflow();
+void test_run_strip_streaming();
+void test_run_rgbw_strip();
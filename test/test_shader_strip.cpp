@@ -0,0 +1,102 @@
+#include "test_shader_strip.hpp"
+#include "unity.h"
+#include "test_helpers.hpp"
+
+#include "shader_strip.hpp"
+#include "effects.hpp"
+#include "strip_config.hpp"
+#include "constants.hpp"
+
+using namespace pixled;
+
+/*
+ * Renders the strip as the RMT driver does in TransmitMode::STREAMING,
+ * requesting at most `chunk` items at a time.
+ */
+class StreamedShaderStrip : public ShaderStrip {
+	public:
+		using ShaderStrip::ShaderStrip;
+
+		uint32_t streamItems(rmt_item32_t* items, size_t chunk) {
+			startStream();
+			ShaderContext& context = shader_context;
+			return stream_items([&context] (const uint8_t*, size_t size, rmt_item32_t* dest,
+						size_t wanted_num, size_t* translated_size, size_t* item_num) {
+					encodeShader(context, size, dest, wanted_num, translated_size, item_num);
+					}, nullptr, pixel_count * 3, items, chunk);
+		}
+};
+
+void test_shader_strip_buffered() {
+	RgbStripConfig config {GRB, 300, 900, 600, 600};
+	Rainbow rainbow {100, 200, 1000};
+	ItemsStrip<ShaderStrip> strip {GPIO_NUM_12, 100, RMT_CHANNEL_0, rainbow, config};
+	ItemsStrip<RgbStrip> reference {GPIO_NUM_13, 100, RMT_CHANNEL_1, config};
+	TEST_ASSERT_NULL(strip.buffer());
+
+	for(int frame = 0; frame < 3; frame++) {
+		rainbow.draw(reference);
+		reference.show();
+		strip.show();
+		assert_same_items(reference.items(), strip.items(), 100 * 24 + 1);
+		TEST_ASSERT_EQUAL_UINT32(100, strip.transmittedPixels());
+		rainbow.update();
+	}
+
+	// Setters are ignored
+	strip.setRgbPixel(0, 1, 2, 3);
+	strip.clear();
+	strip.show();
+	rainbow.draw(reference);
+	reference.show();
+	assert_same_items(reference.items(), strip.items(), 100 * 24 + 1);
+}
+
+static void assert_shader_streaming(uint32_t length, size_t chunk) {
+	RgbStripConfig config {GRB, 300, 900, 600, 600};
+	Chase chase {(uint16_t) length, {255, 100, 10}, 3, 7};
+	ItemsStrip<RgbStrip> reference {GPIO_NUM_12, length, RMT_CHANNEL_0, config};
+	config.transmit_mode = TransmitMode::STREAMING;
+	StreamedShaderStrip strip {GPIO_NUM_13, length, RMT_CHANNEL_1, chase, config};
+
+	chase.update();
+	chase.draw(reference);
+	reference.show();
+	strip.show();
+
+	assert_streamed_items(strip, reference.items(), length * 24, chunk);
+	// Each frame restarts from the first pixel
+	assert_streamed_items(strip, reference.items(), length * 24, chunk);
+}
+
+void test_shader_strip_streaming() {
+	assert_shader_streaming(37, 64);
+	assert_shader_streaming(37, 20);
+	assert_shader_streaming(16, 24);
+	assert_shader_streaming(5, 512);
+}
+
+void test_pixel_shader() {
+	auto wave = pixelShader(20, [] (uint32_t index, uint32_t frame) {
+			const uint8_t v = (index * 10 + frame) & 0xFF;
+			return rgb_pixel(v, 0, 255 - v);
+			});
+	rgb_pixel output[20];
+	wave.draw(output);
+	TEST_ASSERT_EQUAL_UINT8(0, output[0].red);
+	TEST_ASSERT_EQUAL_UINT8(190, output[19].red);
+	TEST_ASSERT_EQUAL_UINT8(65, output[19].blue);
+	wave.update();
+	wave.update();
+	TEST_ASSERT_EQUAL_UINT32(2, wave.frame());
+	wave.draw(output);
+	TEST_ASSERT_EQUAL_UINT8(2, output[0].red);
+
+	// The strip may be shorter than the effect
+	ItemsStrip<ShaderStrip> strip {GPIO_NUM_12, 10, RMT_CHANNEL_0, wave, WS2812()};
+	ItemsStrip<RgbStrip> reference {GPIO_NUM_13, 10, RMT_CHANNEL_1, WS2812()};
+	strip.show();
+	reference.setRgbPixels(0, output, 10);
+	reference.show();
+	assert_same_items(reference.items(), strip.items(), 10 * 24 + 1);
+}
@@ -0,0 +1,3 @@
+void test_shader_strip_buffered();
+void test_shader_strip_streaming();
+void test_pixel_shader();
@@ -1,7 +1,13 @@
 #include "test_strip.hpp"
 #include "unity.h"
+#include "esp_timer.h"
 
+#include "test_helpers.hpp"
 #include "strip.hpp"
+#include "indexed_strip.hpp"
+#include "run_strip.hpp"
+#include "shader_strip.hpp"
+#include "effects.hpp"
 #include "strip_config.hpp"
 #include "constants.hpp"
 
@@ -15,7 +21,7 @@ void test_rgb_strip_set_rgb() {
 		strip.setRgbPixel(i, 10*i, 10*i+1, 10*i+2);
 	}
 	uint8_t* buffer = strip.buffer();
-	for(int i = 0; i < strip.length(); i++) {
+	for(uint32_t i = 0; i < strip.length(); i++) {
 		TEST_ASSERT_EQUAL_UINT8(10*i, buffer[3*i]);
 		TEST_ASSERT_EQUAL_UINT8(10*i+1, buffer[3*i+1]);
 		TEST_ASSERT_EQUAL_UINT8(10*i+2, buffer[3*i+2]);
@@ -30,7 +36,7 @@ void test_gbr_strip_set_rgb() {
 		strip.setRgbPixel(i, 10*i, 10*i+1, 10*i+2);
 	}
 	uint8_t* buffer = strip.buffer();
-	for(int i = 0; i < strip.length(); i++) {
+	for(uint32_t i = 0; i < strip.length(); i++) {
 		TEST_ASSERT_EQUAL_UINT8(10*i+1, buffer[3*i]);
 		TEST_ASSERT_EQUAL_UINT8(10*i+2, buffer[3*i+1]);
 		TEST_ASSERT_EQUAL_UINT8(10*i, buffer[3*i+2]);
@@ -45,7 +51,7 @@ void test_gbr_strip_set_hsb() {
 		strip.setHsbPixel(i, 10*i, 10*i+1, 10*i+2);
 	}
 	uint8_t* buffer = strip.buffer();
-	for(int i = 0; i < strip.length(); i++) {
+	for(uint32_t i = 0; i < strip.length(); i++) {
 		hsb_pixel hsb (10*i, 10*i+1, 10*i+2);
 		rgb_pixel rgb = HsbToRgbConverter()(hsb);
 
@@ -63,7 +69,7 @@ void test_rgbw_strip_set_rgbw() {
 		strip.setRgbwPixel(i, 10*i, 10*i+1, 10*i+2, 10*i+3);
 	}
 	uint8_t* buffer = strip.buffer();
-	for(int i = 0; i < strip.length(); i++) {
+	for(uint32_t i = 0; i < strip.length(); i++) {
 		rgbw_pixel rgbw (10*i, 10*i+1, 10*i+2, 10*i+3);
 
 		TEST_ASSERT_EQUAL_UINT8(rgbw.red, buffer[4*i]);
@@ -82,7 +88,7 @@ void test_gbrw_strip_set_rgbw() {
 		strip.setRgbwPixel(i, 10*i, 10*i+1, 10*i+2, 10*i+3);
 	}
 	uint8_t* buffer = strip.buffer();
-	for(int i = 0; i < strip.length(); i++) {
+	for(uint32_t i = 0; i < strip.length(); i++) {
 		rgbw_pixel rgbw (10*i, 10*i+1, 10*i+2, 10*i+3);
 
 		TEST_ASSERT_EQUAL_UINT8(rgbw.green, buffer[4*i]);
@@ -101,7 +107,7 @@ void test_gbrw_strip_set_rgb() {
 		strip.setRgbPixel(i, 10*i, 10*i+1, 10*i+2);
 	}
 	uint8_t* buffer = strip.buffer();
-	for(int i = 0; i < strip.length(); i++) {
+	for(uint32_t i = 0; i < strip.length(); i++) {
 		rgb_pixel rgb (10*i, 10*i+1, 10*i+2);
 		rgbw_pixel rgbw = RGB_TO_RGBW_CONVERTER()(rgb);
 
@@ -121,7 +127,7 @@ void test_gbrw_strip_set_hsb() {
 		strip.setHsbPixel(i, 10*i, 10*i+1, 10*i+2);
 	}
 	uint8_t* buffer = strip.buffer();
-	for(int i = 0; i < strip.length(); i++) {
+	for(uint32_t i = 0; i < strip.length(); i++) {
 		hsb_pixel hsb (10*i, 10*i+1, 10*i+2);
 		rgb_pixel rgb = HsbToRgbConverter()(hsb);
 		rgbw_pixel rgbw = RGB_TO_RGBW_CONVERTER()(rgb);
@@ -132,3 +138,375 @@ void test_gbrw_strip_set_hsb() {
 		TEST_ASSERT_EQUAL_UINT8(rgbw.white, buffer[4*i+3]);
 	}
 }
+
+void test_gbr_strip_set_rgb_pixels() {
+	auto serializer = GBR;
+	RgbStrip strip {GPIO_NUM_12, 10, RMT_CHANNEL_0, {serializer, 10, 10, 10, 10}};
+
+	rgb_pixel pixels[6];
+	for(int i = 0; i < 6; i++) {
+		pixels[i] = {(uint8_t) (10*i), (uint8_t) (10*i+1), (uint8_t) (10*i+2)};
+	}
+	strip.setRgbPixels(2, pixels, 6);
+
+	uint8_t* buffer = strip.buffer();
+	for(uint32_t i = 0; i < strip.length(); i++) {
+		if(i >= 2 && i < 8) {
+			TEST_ASSERT_EQUAL_UINT8(pixels[i-2].green, buffer[3*i]);
+			TEST_ASSERT_EQUAL_UINT8(pixels[i-2].blue, buffer[3*i+1]);
+			TEST_ASSERT_EQUAL_UINT8(pixels[i-2].red, buffer[3*i+2]);
+		} else {
+			TEST_ASSERT_EQUAL_UINT8(0, buffer[3*i]);
+			TEST_ASSERT_EQUAL_UINT8(0, buffer[3*i+1]);
+			TEST_ASSERT_EQUAL_UINT8(0, buffer[3*i+2]);
+		}
+	}
+}
+
+void test_gbrw_strip_fill_rgb() {
+	auto serializer = GBRW;
+	RgbwStrip strip {GPIO_NUM_12, 10, RMT_CHANNEL_0, {serializer, 10, 10, 10, 10}};
+
+	strip.fillRgb(3, 5, {120, 60, 30});
+
+	rgbw_pixel rgbw = RGB_TO_RGBW_CONVERTER()({120, 60, 30});
+	uint8_t* buffer = strip.buffer();
+	for(uint32_t i = 0; i < strip.length(); i++) {
+		bool filled = i >= 3 && i < 8;
+		TEST_ASSERT_EQUAL_UINT8(filled ? rgbw.green : 0, buffer[4*i]);
+		TEST_ASSERT_EQUAL_UINT8(filled ? rgbw.blue : 0, buffer[4*i+1]);
+		TEST_ASSERT_EQUAL_UINT8(filled ? rgbw.red : 0, buffer[4*i+2]);
+		TEST_ASSERT_EQUAL_UINT8(filled ? rgbw.white : 0, buffer[4*i+3]);
+	}
+}
+
+void test_rgbw_strip_copy_reverse_pixels() {
+	auto serializer = RGBW;
+	RgbwStrip strip {GPIO_NUM_12, 10, RMT_CHANNEL_0, {serializer, 10, 10, 10, 10}};
+
+	for(int i = 0; i < 10; i++) {
+		strip.setRgbwPixel(i, i, 10*i, 100+i, 200+i);
+	}
+	// Overlapping copy : pixels 0-5 are moved to 2-7
+	strip.copyPixels(2, 0, 6);
+	strip.reversePixels(2, 6);
+
+	uint8_t expected[10] = {0, 1, 5, 4, 3, 2, 1, 0, 8, 9};
+	uint8_t* buffer = strip.buffer();
+	for(uint32_t i = 0; i < strip.length(); i++) {
+		TEST_ASSERT_EQUAL_UINT8(expected[i], buffer[4*i]);
+		TEST_ASSERT_EQUAL_UINT8(10*expected[i], buffer[4*i+1]);
+		TEST_ASSERT_EQUAL_UINT8(100+expected[i], buffer[4*i+2]);
+		TEST_ASSERT_EQUAL_UINT8(200+expected[i], buffer[4*i+3]);
+	}
+}
+
+void test_logical_rgb_strip() {
+	RgbStripConfig config {GBR, 10, 10, 10, 10};
+	ItemsStrip<RgbStrip> chip_strip {GPIO_NUM_12, 10, RMT_CHANNEL_0, config};
+	config.buffer_order = BufferOrder::LOGICAL;
+	ItemsStrip<RgbStrip> strip {GPIO_NUM_13, 10, RMT_CHANNEL_1, config};
+
+	for(int i = 0; i < 10; i++) {
+		strip.setRgbPixel(i, 10*i, 10*i+1, 10*i+2);
+		chip_strip.setRgbPixel(i, 10*i, 10*i+1, 10*i+2);
+	}
+	uint8_t* buffer = strip.buffer();
+	for(uint32_t i = 0; i < strip.length(); i++) {
+		TEST_ASSERT_EQUAL_UINT8(10*i, buffer[3*i]);
+		TEST_ASSERT_EQUAL_UINT8(10*i+1, buffer[3*i+1]);
+		TEST_ASSERT_EQUAL_UINT8(10*i+2, buffer[3*i+2]);
+
+		rgb_pixel pixel = strip.getRgbPixel(i);
+		rgb_pixel chip_pixel = chip_strip.getRgbPixel(i);
+		TEST_ASSERT_EQUAL_UINT8(10*i, pixel.red);
+		TEST_ASSERT_EQUAL_UINT8(10*i+2, pixel.blue);
+		TEST_ASSERT_EQUAL_UINT8(10*i+1, chip_pixel.green);
+	}
+
+	// The color order is applied by the encoder
+	strip.show();
+	chip_strip.show();
+	assert_same_items(chip_strip.items(), strip.items(), 10 * 24 + 1);
+}
+
+void test_logical_rgbw_strip() {
+	RgbwStripConfig config {GBRW, 10, 10, 10, 10};
+	ItemsStrip<RgbwStrip> chip_strip {GPIO_NUM_12, 10, RMT_CHANNEL_0, config};
+	config.buffer_order = BufferOrder::LOGICAL;
+	ItemsStrip<RgbwStrip> strip {GPIO_NUM_13, 10, RMT_CHANNEL_1, config};
+
+	for(int i = 0; i < 10; i++) {
+		strip.setRgbwPixel(i, 10*i, 10*i+1, 10*i+2, 10*i+3);
+		chip_strip.setRgbwPixel(i, 10*i, 10*i+1, 10*i+2, 10*i+3);
+	}
+	strip.fillRgb(8, 2, {200, 100, 50});
+	chip_strip.fillRgb(8, 2, {200, 100, 50});
+
+	uint8_t* buffer = strip.buffer();
+	for(int i = 0; i < 8; i++) {
+		TEST_ASSERT_EQUAL_UINT8(10*i, buffer[4*i]);
+		TEST_ASSERT_EQUAL_UINT8(10*i+3, buffer[4*i+3]);
+
+		rgbw_pixel pixel = strip.getRgbwPixel(i);
+		TEST_ASSERT_EQUAL_UINT8(10*i+1, pixel.green);
+		TEST_ASSERT_EQUAL_UINT8(10*i+3, pixel.white);
+	}
+	rgbw_pixel filled = chip_strip.getRgbwPixel(9);
+	TEST_ASSERT_EQUAL_UINT8(filled.red, strip.getRgbwPixel(9).red);
+	TEST_ASSERT_EQUAL_UINT8(filled.white, strip.getRgbwPixel(9).white);
+
+	strip.show();
+	chip_strip.show();
+	assert_same_items(chip_strip.items(), strip.items(), 10 * 32 + 1);
+}
+
+void test_skip_unchanged_frames() {
+	RgbStrip strip {GPIO_NUM_12, 10, RMT_CHANNEL_0, WS2812()};
+
+	// Disabled by default
+	strip.show();
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(0, strip.skippedFrames());
+
+	strip.skipUnchangedFrames(true);
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(0, strip.skippedFrames());
+	strip.show();
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(2, strip.skippedFrames());
+
+	strip.setRgbPixel(3, 1, 2, 3);
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(2, strip.skippedFrames());
+
+	// Direct writes are detected
+	strip.buffer()[29] = 42;
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(2, strip.skippedFrames());
+
+	strip.markChanged();
+	strip.show();
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(3, strip.skippedFrames());
+
+	strip.skipUnchangedFrames(false);
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(3, strip.skippedFrames());
+}
+
+void test_skip_unchanged_frames_setters() {
+	ItemsStrip<RgbStrip> strip {GPIO_NUM_12, 10, RMT_CHANNEL_0, WS2812()};
+	strip.skipUnchangedFrames(true);
+	strip.fillRgb(0, 10, {1, 2, 3});
+	strip.show();
+
+	// Rewriting the same colors does not change the frame
+	strip.fillRgb(0, 10, {1, 2, 3});
+	strip.setRgbPixel(4, 1, 2, 3);
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(1, strip.skippedFrames());
+
+	// A single changed byte is transmitted
+	strip.setRgbPixel(9, 1, 2, 4);
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(1, strip.skippedFrames());
+	ItemsStrip<RgbStrip> reference {GPIO_NUM_13, 10, RMT_CHANNEL_1, WS2812()};
+	reference.fillRgb(0, 10, {1, 2, 3});
+	reference.setRgbPixel(9, 1, 2, 4);
+	reference.show();
+	assert_same_items(reference.items(), strip.items(), 10 * 24 + 1);
+
+	strip.copyPixels(0, 9, 1);
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(1, strip.skippedFrames());
+	strip.reversePixels(0, 5);
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(1, strip.skippedFrames());
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(2, strip.skippedFrames());
+}
+
+void test_skip_unchanged_frames_keep_alive() {
+	RgbStrip strip {GPIO_NUM_12, 10, RMT_CHANNEL_0, WS2812()};
+	strip.skipUnchangedFrames(true, 5);
+
+	strip.show();
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(1, strip.skippedFrames());
+
+	int64_t start = esp_timer_get_time();
+	while(esp_timer_get_time() - start < 6000);
+	strip.show();
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(2, strip.skippedFrames());
+}
+
+/*
+ * Streams the strip buffer in chunks of `chunk` items, and checks the result
+ * against the buffered encoding of the same pixels.
+ */
+template<typename S, typename Config>
+static void assert_streaming(Config config, uint8_t bits, size_t chunk) {
+	ItemsStrip<S> strip {GPIO_NUM_12, 10, RMT_CHANNEL_0, config};
+	config.transmit_mode = TransmitMode::STREAMING;
+	ItemsStrip<S> streaming {GPIO_NUM_13, 10, RMT_CHANNEL_1, config};
+	TEST_ASSERT_NULL(streaming.items());
+
+	for(int i = 0; i < 10; i++) {
+		strip.setRgbPixel(i, 10*i, 255-i, 3*i);
+		streaming.setRgbPixel(i, 10*i, 255-i, 3*i);
+	}
+	strip.show();
+	streaming.show();
+
+	assert_streamed_items(streaming, strip.items(), 10 * bits, chunk);
+}
+
+void test_streaming_rgb_strip() {
+	RgbStripConfig config {GRB, 300, 900, 600, 600};
+	assert_streaming<RgbStrip>(config, 24, 32);
+	assert_streaming<RgbStrip>(config, 24, 20);
+	config.buffer_order = BufferOrder::LOGICAL;
+	assert_streaming<RgbStrip>(config, 24, 32);
+}
+
+void test_streaming_rgbw_strip() {
+	RgbwStripConfig config {GBRW, 300, 900, 600, 600};
+	assert_streaming<RgbwStrip>(config, 32, 64);
+	config.buffer_order = BufferOrder::LOGICAL;
+	assert_streaming<RgbwStrip>(config, 32, 24);
+}
+
+/*
+ * Transmits frames of a single RMT memory block with the translators of the
+ * streaming strips, through rmt_write_sample() and the lookup of their
+ * context by the RMT driver.
+ */
+void test_stream_translators() {
+	const uint32_t length = (SOC_RMT_MEM_WORDS_PER_CHANNEL - 1) / 24;
+	RgbStripConfig config {GRB, 300, 900, 600, 600};
+	ItemsStrip<RgbStrip> reference {GPIO_NUM_13, length, RMT_CHANNEL_1, config};
+	reference.setRgbPixel(0, 255, 10, 0);
+	reference.setRgbPixel(length - 1, 1, 128, 200);
+	reference.show();
+	config.transmit_mode = TransmitMode::STREAMING;
+	{
+		RgbStrip strip {GPIO_NUM_12, length, RMT_CHANNEL_0, config};
+		strip.setRgbPixel(0, 255, 10, 0);
+		strip.setRgbPixel(length - 1, 1, 128, 200);
+		strip.show();
+		assert_translated_items(RMT_CHANNEL_0, reference.items(), length * 24);
+	}
+	{
+		IndexedRgbStrip strip {GPIO_NUM_12, length, RMT_CHANNEL_0, PaletteSize::PALETTE_16, config};
+		strip.setPaletteColor(1, {255, 10, 0});
+		strip.setPaletteColor(2, {1, 128, 200});
+		strip.setIndex(0, 1);
+		strip.setIndex(length - 1, 2);
+		strip.show();
+		assert_translated_items(RMT_CHANNEL_0, reference.items(), length * 24);
+	}
+	{
+		RunRgbStrip strip {GPIO_NUM_12, length, RMT_CHANNEL_0, 4, config};
+		strip.setRgbPixel(0, 255, 10, 0);
+		strip.setRgbPixel(length - 1, 1, 128, 200);
+		strip.show();
+		assert_translated_items(RMT_CHANNEL_0, reference.items(), length * 24);
+	}
+	{
+		Chase chase {length, {255, 100, 10}, 1, 2};
+		ShaderStrip strip {GPIO_NUM_12, length, RMT_CHANNEL_0, chase, config};
+		chase.draw(reference);
+		reference.show();
+		strip.show();
+		assert_translated_items(RMT_CHANNEL_0, reference.items(), length * 24);
+	}
+}
+
+void test_mirrored_strip() {
+	RgbStripConfig config {GRB, 300, 900, 600, 600};
+	ItemsStrip<RgbStrip> strip {GPIO_NUM_12, 10, RMT_CHANNEL_0, config};
+	ItemsStrip<RgbStrip> mirrored {GPIO_NUM_13, 10, RMT_CHANNEL_1, config};
+	mirrored.addMirror(GPIO_NUM_14, RMT_CHANNEL_2);
+	mirrored.addMirror(GPIO_NUM_15, RMT_CHANNEL_3);
+	TEST_ASSERT_EQUAL_UINT8(0, strip.mirrorCount());
+	TEST_ASSERT_EQUAL_UINT8(2, mirrored.mirrorCount());
+
+	for(int i = 0; i < 10; i++) {
+		strip.setRgbPixel(i, 10*i, 255-i, 3*i);
+		mirrored.setRgbPixel(i, 10*i, 255-i, 3*i);
+	}
+	strip.show();
+	mirrored.show();
+
+	// A single items buffer is encoded for all the channels
+	assert_same_items(strip.items(), mirrored.items(), 10 * 24 + 1);
+}
+
+void test_changed_prefix_transmission() {
+	ItemsStrip<RgbStrip> strip {GPIO_NUM_12, 10, RMT_CHANNEL_0, WS2812()};
+	ItemsStrip<RgbStrip> reference {GPIO_NUM_13, 10, RMT_CHANNEL_1, WS2812()};
+	for(int i = 0; i < 10; i++)
+		strip.setRgbPixel(i, i, 2*i, 3*i);
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(10, strip.transmittedPixels());
+
+	strip.transmitChangedPrefix(true);
+	// The first frame is transmitted in full
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(10, strip.transmittedPixels());
+
+	strip.setRgbPixel(1, 42, 42, 42);
+	strip.setRgbPixel(3, 43, 43, 43);
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(4, strip.transmittedPixels());
+	TEST_ASSERT_EQUAL_UINT64(6, strip.truncatedPixels());
+
+	// The encoded prefix is the prefix of the full frame
+	for(int i = 0; i < 10; i++)
+		reference.setRgbPixel(i, i, 2*i, 3*i);
+	reference.setRgbPixel(1, 42, 42, 42);
+	reference.setRgbPixel(3, 43, 43, 43);
+	reference.show();
+	assert_same_items(reference.items(), strip.items(), 4 * 24);
+
+	// Unchanged frame : nothing is transmitted
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(0, strip.transmittedPixels());
+	TEST_ASSERT_EQUAL_UINT64(16, strip.truncatedPixels());
+
+	// Direct writes are detected, up to the last byte
+	strip.buffer()[29] = 1;
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(10, strip.transmittedPixels());
+	strip.buffer()[15] = 1;
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(6, strip.transmittedPixels());
+
+	strip.markChanged();
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(10, strip.transmittedPixels());
+	TEST_ASSERT_EQUAL_UINT64(20, strip.truncatedPixels());
+	TEST_ASSERT_EQUAL_UINT64(20 * 24 * WS2812().bitPeriodNs() / 1000, strip.savedWireTimeUs());
+
+	strip.transmitChangedPrefix(false);
+	strip.show();
+	TEST_ASSERT_EQUAL_UINT32(10, strip.transmittedPixels());
+}
+
+void test_changed_prefix_reset() {
+	WS2812 config;
+	config.reset_us = 2000;
+	RgbStrip strip {GPIO_NUM_12, 10, RMT_CHANNEL_0, config};
+	strip.transmitChangedPrefix(true);
+	strip.show();
+
+	// Each frame starts at least reset_us after the end of the last one
+	const int64_t start = esp_timer_get_time();
+	for(int i = 0; i < 3; i++) {
+		strip.setRgbPixel(0, i + 1, i + 1, i + 1);
+		strip.show();
+	}
+	TEST_ASSERT_GREATER_THAN(2 * 2000, esp_timer_get_time() - start);
+}
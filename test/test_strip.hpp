@@ -7,3 +7,18 @@ void test_rgbw_strip_set_rgbw();
 void test_gbrw_strip_set_rgbw();
 void test_gbrw_strip_set_rgb();
 void test_gbrw_strip_set_hsb();
+
+void test_gbr_strip_set_rgb_pixels();
+void test_gbrw_strip_fill_rgb();
+void test_rgbw_strip_copy_reverse_pixels();
+void test_logical_rgb_strip();
+void test_logical_rgbw_strip();
+void test_skip_unchanged_frames();
+void test_skip_unchanged_frames_setters();
+void test_skip_unchanged_frames_keep_alive();
+void test_streaming_rgb_strip();
+void test_streaming_rgbw_strip();
+void test_stream_translators();
+void test_mirrored_strip();
+void test_changed_prefix_transmission();
+void test_changed_prefix_reset();
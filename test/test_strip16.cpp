@@ -0,0 +1,149 @@
+#include "test_strip16.hpp"
+#include "unity.h"
+#include "test_helpers.hpp"
+
+#include "strip16.hpp"
+#include "strip_config.hpp"
+#include "constants.hpp"
+
+using namespace pixled;
+
+/*
+ * Checks that `items` encode `bytes`, MSB first, with the timings of
+ * `config`.
+ */
+static void assert_encoded(const StripConfig& config, const uint8_t* bytes, uint32_t size, const rmt_item32_t* items) {
+	for(uint32_t i = 0; i < size; i++) {
+		for(int bit = 7; bit >= 0; bit--) {
+			const rmt_item32_t& item = items[8*i + 7 - bit];
+			bool one = bytes[i] & (1 << bit);
+			TEST_ASSERT_EQUAL_UINT32(1, item.level0);
+			TEST_ASSERT_EQUAL_UINT32(0, item.level1);
+			TEST_ASSERT_EQUAL_UINT32(one ? config.t1h : config.t0h, item.duration0);
+			TEST_ASSERT_EQUAL_UINT32(one ? config.t1l : config.t0l, item.duration1);
+		}
+	}
+	TEST_ASSERT_EQUAL_UINT32(0, items[8*size].val);
+}
+
+void test_serializer_grb16_output() {
+	rgb16_pixel pixel {0x1234, 0xABCD, 0x00FF};
+	Rgb16Serializer grb = GRB;
+	uint8_t output[6];
+
+	grb.serialize(pixel, output);
+
+	uint8_t expected[6] = {0xAB, 0xCD, 0x12, 0x34, 0x00, 0xFF};
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, output, 6);
+}
+
+void test_serializer_grbw16_output() {
+	rgbw16_pixel pixel {0x1234, 0xABCD, 0x00FF, 0xFF00};
+	Rgbw16Serializer grbw = GRBW;
+	uint8_t output[8];
+
+	grbw.serialize(pixel, output);
+
+	uint8_t expected[8] = {0xAB, 0xCD, 0x12, 0x34, 0x00, 0xFF, 0xFF, 0x00};
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, output, 8);
+}
+
+void test_rgb16_strip_set_rgb16() {
+	Rgb16Strip strip {GPIO_NUM_12, 10, RMT_CHANNEL_0, {GRB, 10, 10, 10, 10}};
+
+	for(int i = 0; i < 10; i++) {
+		strip.setRgb16Pixel(i, 1000*i, 1000*i+1, 1000*i+2);
+	}
+	uint8_t* buffer = strip.buffer();
+	TEST_ASSERT_EQUAL_UINT8(6, strip.pixelSize());
+	for(uint32_t i = 0; i < strip.length(); i++) {
+		TEST_ASSERT_EQUAL_UINT8((1000*i+1) >> 8, buffer[6*i]);
+		TEST_ASSERT_EQUAL_UINT8((1000*i+1) & 0xFF, buffer[6*i+1]);
+		TEST_ASSERT_EQUAL_UINT8((1000*i) >> 8, buffer[6*i+2]);
+		TEST_ASSERT_EQUAL_UINT8((1000*i) & 0xFF, buffer[6*i+3]);
+		TEST_ASSERT_EQUAL_UINT8((1000*i+2) >> 8, buffer[6*i+4]);
+		TEST_ASSERT_EQUAL_UINT8((1000*i+2) & 0xFF, buffer[6*i+5]);
+	}
+}
+
+void test_rgb16_strip_set_rgb() {
+	Rgb16Strip strip {GPIO_NUM_12, 2, RMT_CHANNEL_0, {RGB, 10, 10, 10, 10}};
+
+	strip.setRgbPixel(0, 255, 0, 0x12);
+	strip.fillRgb(1, 1, {1, 2, 3});
+
+	uint8_t expected[12] = {
+		0xFF, 0xFF, 0x00, 0x00, 0x12, 0x12,
+		0x01, 0x01, 0x02, 0x02, 0x03, 0x03
+	};
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, strip.buffer(), 12);
+}
+
+void test_rgb16_strip_show() {
+	ItemsStrip<Rgb16Strip> strip {GPIO_NUM_12, 3, RMT_CHANNEL_0, WS2816()};
+
+	strip.setRgb16Pixel(0, 0xFFFF, 0x0001, 0x8000);
+	strip.setRgb16Pixel(1, 0x1234, 0x5678, 0x9ABC);
+	strip.show();
+
+	assert_encoded(strip.stripConfig(), strip.buffer(), 3 * 6, strip.items());
+}
+
+void test_rgbw16_strip_set_rgb16() {
+	Rgbw16Strip strip {GPIO_NUM_12, 2, RMT_CHANNEL_0, {RGBW, 10, 10, 10, 10}};
+
+	strip.setRgb16Pixel(0, 0x3000, 0x1000, 0x2000);
+
+	uint8_t expected[8] = {0x20, 0x00, 0x00, 0x00, 0x10, 0x00, 0x10, 0x00};
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, strip.buffer(), 8);
+
+	// Same white extraction as the 8 bits RGBW strips
+	strip.setRgb16Pixel(1, 200 * 257, 40 * 257, 90 * 257);
+	const rgbw_pixel rgbw = RGB_TO_RGBW_CONVERTER::convert({200, 40, 90});
+	const uint8_t* pixel = &strip.buffer()[8];
+	TEST_ASSERT_UINT32_WITHIN(257, rgbw.red * 257, (pixel[0] << 8) | pixel[1]);
+	TEST_ASSERT_UINT32_WITHIN(257, rgbw.green * 257, (pixel[2] << 8) | pixel[3]);
+	TEST_ASSERT_UINT32_WITHIN(257, rgbw.blue * 257, (pixel[4] << 8) | pixel[5]);
+	TEST_ASSERT_UINT32_WITHIN(257, rgbw.white * 257, (pixel[6] << 8) | pixel[7]);
+}
+
+void test_rgbw16_strip_show() {
+	ItemsStrip<Rgbw16Strip> strip {GPIO_NUM_12, 2, RMT_CHANNEL_0, UCS8904()};
+
+	strip.setRgbw16Pixel(0, 0xFFFF, 0x0001, 0x8000, 0x00F0);
+	strip.setRgbPixel(1, 10, 200, 30);
+	strip.show();
+
+	assert_encoded(strip.stripConfig(), strip.buffer(), 2 * 8, strip.items());
+}
+
+void test_rgb_strip_set_rgb16_pixels() {
+	RgbStrip strip {GPIO_NUM_12, 40, RMT_CHANNEL_0, {GRB, 10, 10, 10, 10}};
+
+	rgb16_pixel pixels[40];
+	for(uint16_t i = 0; i < 40; i++)
+		pixels[i] = {(uint16_t) (i * 257), 0xFFFF, (uint16_t) (i * 257 + 128)};
+	strip.setRgb16Pixels(0, pixels, 40);
+
+	uint8_t* buffer = strip.buffer();
+	for(uint16_t i = 0; i < 40; i++) {
+		TEST_ASSERT_EQUAL_UINT8(255, buffer[3*i]);
+		TEST_ASSERT_EQUAL_UINT8(i, buffer[3*i+1]);
+		TEST_ASSERT_UINT_WITHIN(1, i, buffer[3*i+2]);
+	}
+}
+
+void test_rgbw16_strip_streaming() {
+	Rgbw16StripConfig config = UCS8904();
+	config.transmit_mode = TransmitMode::STREAMING;
+	ItemsStrip<Rgbw16Strip> strip {GPIO_NUM_12, 2, RMT_CHANNEL_0, config};
+
+	strip.setRgbw16Pixel(0, 0xFFFF, 0x0001, 0x8000, 0x00F0);
+	strip.setRgbPixel(1, 10, 200, 30);
+	strip.show();
+
+	rmt_item32_t items[2 * 64 + 1];
+	TEST_ASSERT_EQUAL_UINT32(2 * 64, strip.streamItems(items, 32));
+	items[2 * 64].val = 0;
+	assert_encoded(strip.stripConfig(), strip.buffer(), 2 * 8, items);
+}
@@ -0,0 +1,9 @@
+void test_serializer_grb16_output();
+void test_serializer_grbw16_output();
+void test_rgb16_strip_set_rgb16();
+void test_rgb16_strip_set_rgb();
+void test_rgb16_strip_show();
+void test_rgbw16_strip_set_rgb16();
+void test_rgbw16_strip_show();
+void test_rgb_strip_set_rgb16_pixels();
+void test_rgbw16_strip_streaming();
@@ -0,0 +1,77 @@
+#include <cmath>
+#include <cstring>
+
+#include "test_tables.hpp"
+#include "unity.h"
+
+#include "tables.hpp"
+
+using namespace pixled;
+
+static constexpr std::array<uint8_t, 256> gamma_table = make_table<uint8_t, 256>(GammaCurve(2.2));
+static constexpr std::array<rgb_pixel, 64> hue_wheel = make_table<rgb_pixel, 64>(HueWheel(64, 200, 180));
+
+static_assert(GammaCurve(2.2)(0) == 0, "Bad gamma");
+static_assert(GammaCurve(2.2)(255) == 255, "Bad gamma");
+static_assert(GammaCurve(1.0)(100) == 100, "Bad gamma");
+static_assert(FastHsbToRgbConverter::convert(0, 255, 255).red == 255, "Bad hue");
+static_assert(SimpleRgbToRgbwConverter::convert(rgb_pixel(10, 20, 30)).white == 10, "Bad white");
+
+void test_pixel_types_trivial() {
+	rgbw_pixel pixels[4];
+	std::memset(pixels, 0xFF, sizeof(pixels));
+	const rgbw_pixel black {};
+	pixels[2] = black;
+	TEST_ASSERT_EQUAL_UINT8(0xFF, pixels[1].white);
+	TEST_ASSERT_EQUAL_UINT8(0, pixels[2].red);
+	TEST_ASSERT_EQUAL_UINT8(0, pixels[2].white);
+	TEST_ASSERT_EQUAL(16, sizeof(pixels));
+}
+
+void test_gamma_table() {
+	for(uint16_t i = 0; i < 256; i++) {
+		uint8_t expected = 255.0 * std::pow(i / 255.0, 2.2) + 0.5;
+		TEST_ASSERT_EQUAL_UINT8(expected, gamma_table[i]);
+	}
+}
+
+void test_hue_wheel_table() {
+	FastHsbToRgbConverter hsb_to_rgb;
+	for(uint16_t i = 0; i < 64; i++) {
+		rgb_pixel expected = hsb_to_rgb(i * 1024, 200, 180);
+		TEST_ASSERT_EQUAL_UINT8(expected.red, hue_wheel[i].red);
+		TEST_ASSERT_EQUAL_UINT8(expected.green, hue_wheel[i].green);
+		TEST_ASSERT_EQUAL_UINT8(expected.blue, hue_wheel[i].blue);
+	}
+}
+
+void test_constexpr_converters() {
+	// Tables built at compile time from the converters
+	constexpr rgb_pixel hsb[4] {
+		HsbToRgbConverter::convert({0, 1, 1}),
+		HsbToRgbConverter::convert({120, 0.5, 0.8}),
+		HsbToRgbConverter::convert({300, 1, 0.5}),
+		HsbToRgbConverter::convert({42, 0, 0.4})
+	};
+	constexpr rgbw_pixel rgbw[2] {
+		ComplexRgbToRgbwConverter::convert({255, 128, 64}),
+		ComplexRgbToRgbwConverter::convert({0, 0, 0})
+	};
+
+	TEST_ASSERT_EQUAL_UINT8(255, hsb[0].red);
+	TEST_ASSERT_EQUAL_UINT8(0, hsb[0].green);
+	TEST_ASSERT_EQUAL_UINT8(102, hsb[1].red);
+	TEST_ASSERT_EQUAL_UINT8(204, hsb[1].green);
+	TEST_ASSERT_EQUAL_UINT8(127, hsb[2].red);
+	TEST_ASSERT_EQUAL_UINT8(0, hsb[2].green);
+	TEST_ASSERT_EQUAL_UINT8(127, hsb[2].blue);
+	TEST_ASSERT_EQUAL_UINT8(102, hsb[3].green);
+
+	ComplexRgbToRgbwConverter rgb_to_rgbw;
+	rgbw_pixel expected = rgb_to_rgbw({255, 128, 64});
+	TEST_ASSERT_EQUAL_UINT8(expected.red, rgbw[0].red);
+	TEST_ASSERT_EQUAL_UINT8(expected.green, rgbw[0].green);
+	TEST_ASSERT_EQUAL_UINT8(expected.blue, rgbw[0].blue);
+	TEST_ASSERT_EQUAL_UINT8(expected.white, rgbw[0].white);
+	TEST_ASSERT_EQUAL_UINT8(0, rgbw[1].white);
+}
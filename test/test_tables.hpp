@@ -0,0 +1,4 @@
+void test_pixel_types_trivial();
+void test_gamma_table();
+void test_hue_wheel_table();
+void test_constexpr_converters();
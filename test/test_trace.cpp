@@ -0,0 +1,99 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "test_trace.hpp"
+#include "test_helpers.hpp"
+#include "unity.h"
+
+#include "trace.hpp"
+#include "strip.hpp"
+#include "strip_config.hpp"
+
+using namespace pixled;
+
+static std::string dump() {
+	FILE* file = tmpfile();
+	TEST_ASSERT_NOT_NULL(file);
+	Trace::dump(file);
+	std::string json;
+	char chunk[128];
+	std::rewind(file);
+	size_t size;
+	while((size = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+		json.append(chunk, size);
+	std::fclose(file);
+	return json;
+}
+
+void test_trace_ring_buffer() {
+	Trace::start(4);
+	TEST_ASSERT_TRUE(Trace::enabled());
+	TEST_ASSERT_EQUAL_UINT32(0, Trace::eventCount());
+
+	const char* names[6] = {"a", "b", "c", "d", "e", "f"};
+	for(int i = 0; i < 6; i++)
+		Trace::record(names[i], 100 * i, 100 * i + i);
+	TEST_ASSERT_EQUAL_UINT32(4, Trace::eventCount());
+	TEST_ASSERT_EQUAL_UINT32(2, Trace::overwrittenCount());
+
+	// The two oldest spans are overwritten
+	trace_event event;
+	for(uint32_t i = 0; i < 4; i++) {
+		TEST_ASSERT_TRUE(Trace::event(i, event));
+		TEST_ASSERT_EQUAL_STRING(names[i + 2], event.name);
+		TEST_ASSERT_EQUAL_INT64(100 * (i + 2), event.start);
+		TEST_ASSERT_EQUAL_UINT32(i + 2, event.duration);
+	}
+	TEST_ASSERT_FALSE(Trace::event(4, event));
+
+	// Nothing is recorded once stopped
+	Trace::stop();
+	Trace::record("g", 0, 1);
+	TEST_ASSERT_EQUAL_UINT32(4, Trace::eventCount());
+	Trace::clear();
+	TEST_ASSERT_EQUAL_UINT32(0, Trace::eventCount());
+}
+
+void test_trace_dump() {
+	Trace::start(16);
+	{
+		TraceSpan outer {"outer"};
+		TraceSpan inner {"inner"};
+	}
+	Trace::stop();
+	TEST_ASSERT_EQUAL_UINT32(2, Trace::eventCount());
+
+	const std::string json = dump();
+	TEST_ASSERT_EQUAL_STRING("{\"traceEvents\":[", json.substr(0, 16).c_str());
+	TEST_ASSERT_NOT_EQUAL(std::string::npos, json.find("\"name\":\"process_name\""));
+	// Spans are recorded when they end
+	const size_t inner = json.find("{\"name\":\"inner\",\"cat\":\"pixled\",\"ph\":\"X\"");
+	const size_t outer = json.find("{\"name\":\"outer\",\"cat\":\"pixled\",\"ph\":\"X\"");
+	TEST_ASSERT_NOT_EQUAL(std::string::npos, inner);
+	TEST_ASSERT_NOT_EQUAL(std::string::npos, outer);
+	TEST_ASSERT_LESS_THAN(outer, inner);
+	const char end[] = "\n],\"displayTimeUnit\":\"ms\"}\n";
+	TEST_ASSERT_EQUAL_STRING(end, json.substr(json.size() - std::strlen(end)).c_str());
+	Trace::clear();
+}
+
+void test_trace_strip_spans() {
+	ItemsStrip<RgbStrip> strip {GPIO_NUM_12, 10, RMT_CHANNEL_1, WS2812()};
+	Trace::start(16);
+	strip.fillRgb(0, 10, {1, 2, 3});
+	strip.show();
+	Trace::stop();
+	const std::string json = dump();
+	Trace::clear();
+#ifdef PIXLED_TRACE
+	TEST_ASSERT_NOT_EQUAL(std::string::npos, json.find("\"name\":\"fillRgb\""));
+	TEST_ASSERT_NOT_EQUAL(std::string::npos, json.find("\"name\":\"encode\""));
+	TEST_ASSERT_NOT_EQUAL(std::string::npos, json.find("\"name\":\"rmt submit\""));
+	TEST_ASSERT_NOT_EQUAL(std::string::npos, json.find("\"name\":\"rmt transmit\""));
+#else
+	// Spans are compiled out
+	TEST_ASSERT_EQUAL_UINT32(0, Trace::eventCount());
+	TEST_ASSERT_EQUAL(std::string::npos, json.find("\"ph\":\"X\""));
+#endif
+}
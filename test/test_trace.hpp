@@ -0,0 +1,3 @@
+void test_trace_ring_buffer();
+void test_trace_dump();
+void test_trace_strip_spans();
@@ -0,0 +1,94 @@
+#include "test_transition.hpp"
+#include "unity.h"
+
+#include "transition.hpp"
+#include "strip_config.hpp"
+#include "constants.hpp"
+
+using namespace pixled;
+
+/*
+ * Reference float interpolation.
+ */
+static uint8_t lerp(uint8_t from, uint8_t to, float progress) {
+	return from + (to - from) * progress + 0.5f;
+}
+
+void test_transition_linear() {
+	RgbStrip strip {GPIO_NUM_12, 10, RMT_CHANNEL_0, WS2812()};
+	Transition transition {strip};
+
+	for(uint16_t i = 0; i < 10; i++)
+		strip.setRgbPixel(i, 25*i, 255 - 25*i, 7);
+	transition.captureSource();
+	for(uint16_t i = 0; i < 10; i++)
+		strip.setRgbPixel(i, 255 - 20*i, 20*i, 200);
+	transition.captureTarget();
+
+	const uint16_t steps = 300;
+	transition.start(steps);
+	for(uint16_t i = 0; i < 30; i++)
+		TEST_ASSERT_EQUAL_UINT8(transition.sourceFrame()[i], strip.buffer()[i]);
+
+	uint16_t step = 0;
+	while(transition.step()) {
+		step++;
+		for(uint16_t i = 0; i < 30; i++) {
+			uint8_t expected = lerp(transition.sourceFrame()[i], transition.targetFrame()[i], (float) step / steps);
+			TEST_ASSERT_UINT8_WITHIN(1, expected, strip.buffer()[i]);
+		}
+	}
+	TEST_ASSERT_EQUAL(steps, step);
+	TEST_ASSERT_TRUE(transition.done());
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(transition.targetFrame(), strip.buffer(), 30);
+}
+
+void test_transition_skip_equal() {
+	RgbwStrip strip {GPIO_NUM_12, 20, RMT_CHANNEL_0, SK6812W()};
+	Transition transition {strip};
+
+	strip.fillRgb(0, 20, {100, 50, 20});
+	transition.captureSource();
+	strip.fillRgb(5, 2, {10, 200, 30});
+	transition.captureTarget();
+
+	transition.start(10, Easing::EASE_IN_OUT);
+	TEST_ASSERT_TRUE(transition.activeCount() <= 2 * 4);
+	TEST_ASSERT_TRUE(transition.activeCount() > 0);
+
+	// Bytes that do not change are never written
+	strip.buffer()[0] = 0xAB;
+	while(transition.step());
+	TEST_ASSERT_EQUAL_UINT8(0xAB, strip.buffer()[0]);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(&transition.targetFrame()[4], &strip.buffer()[4], 76);
+	TEST_ASSERT_FALSE(transition.step());
+}
+
+void test_transition_easing() {
+	RgbStrip strip {GPIO_NUM_12, 1, RMT_CHANNEL_0, WS2812()};
+	Transition transition {strip};
+
+	strip.setRgbPixel(0, 0, 0, 0);
+	transition.captureSource();
+	strip.setRgbPixel(0, 255, 255, 255);
+	transition.captureTarget();
+
+	Easing easings[3] {Easing::EASE_IN, Easing::EASE_OUT, Easing::EASE_IN_OUT};
+	for(Easing easing : easings) {
+		transition.start(100, easing);
+		uint8_t previous = 0;
+		for(uint16_t step = 1; step <= 100; step++) {
+			transition.step();
+			float t = step / 100.f;
+			float eased =
+				easing == Easing::EASE_IN ? t * t :
+				easing == Easing::EASE_OUT ? 1 - (1-t) * (1-t) :
+				t * t * (3 - 2*t);
+			// Eased progression is rounded to the closest step
+			TEST_ASSERT_UINT8_WITHIN(3, lerp(0, 255, eased), strip.buffer()[0]);
+			TEST_ASSERT_TRUE(strip.buffer()[0] >= previous);
+			previous = strip.buffer()[0];
+		}
+		TEST_ASSERT_EQUAL_UINT8(255, strip.buffer()[0]);
+	}
+}
@@ -0,0 +1,3 @@
+void test_transition_linear();
+void test_transition_skip_equal();
+void test_transition_easing();
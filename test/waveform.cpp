@@ -0,0 +1,63 @@
+#include "waveform.hpp"
+
+using namespace pixled;
+
+static uint32_t distance(uint32_t a, uint32_t b) {
+	return a > b ? a - b : b - a;
+}
+
+/*
+ * Checks that `ticks` is within the tolerance of `nominal_ns`.
+ */
+static bool in_tolerance(const StripConfig& config, uint32_t ticks, uint32_t nominal_ns) {
+	return distance(ticks * config.tickPs(), nominal_ns * 1000) <= config.tolerance * 1000u;
+}
+
+DecodedWaveform decode_waveform(
+		const StripConfig& config, const rmt_item32_t* items, uint32_t max_items,
+		uint8_t* output, uint32_t output_size) {
+	DecodedWaveform result {0, 0, -1, false};
+	uint8_t byte = 0;
+
+	for(uint32_t i = 0; i < max_items; i++) {
+		const rmt_item32_t& item = items[i];
+		if(item.duration0 == 0) {
+			result.terminated = true;
+			break;
+		}
+
+		bool one = distance(item.duration0, config.t1h) < distance(item.duration0, config.t0h);
+		bool valid = item.level0 == 1 && item.level1 == 0
+			&& in_tolerance(config, item.duration0, one ? config.nominal_t1h : config.nominal_t0h)
+			&& in_tolerance(config, item.duration1, one ? config.nominal_t1l : config.nominal_t0l);
+		if(!valid) {
+			if(result.violations == 0)
+				result.first_violation = i;
+			result.violations++;
+		}
+
+		byte = (byte << 1) | one;
+		result.bits++;
+		if(result.bits % 8 == 0) {
+			if(result.bits / 8 <= output_size)
+				output[result.bits / 8 - 1] = byte;
+			byte = 0;
+		}
+	}
+	return result;
+}
+
+void reference_encode(const StripConfig& config, const uint8_t* data, uint32_t size, rmt_item32_t* items) {
+	for(uint32_t i = 0; i < size; i++) {
+		for(int bit = 7; bit >= 0; bit--) {
+			bool one = data[i] & (1 << bit);
+			items->val = 0;
+			items->level0 = 1;
+			items->duration0 = one ? config.t1h : config.t0h;
+			items->level1 = 0;
+			items->duration1 = one ? config.t1l : config.t0l;
+			items++;
+		}
+	}
+	items->val = 0;
+}
@@ -0,0 +1,57 @@
+#ifndef PIXLED_DRIVER_TEST_WAVEFORM_H
+#define PIXLED_DRIVER_TEST_WAVEFORM_H
+
+#include <driver/rmt.h>
+
+#include "strip_config.hpp"
+
+/*
+ * Result of the decoding of an RMT item stream.
+ */
+struct DecodedWaveform {
+	/*
+	 * Count of decoded bits, terminator excluded.
+	 */
+	uint32_t bits;
+	/*
+	 * Count of items with invalid levels, or with phases out of the
+	 * tolerance of the strip config.
+	 */
+	uint32_t violations;
+	/*
+	 * Index of the first violation, -1 if none.
+	 */
+	int32_t first_violation;
+	/*
+	 * True if the stream ends with a terminator (null duration).
+	 */
+	bool terminated;
+};
+
+/*
+ * Decodes RMT items, as written by Strip::show(), back to bytes (MSB first).
+ *
+ * Each item is decoded as a 1 if its high phase is closer to t1h than to
+ * t0h. Phases are checked against the nominal durations and tolerance of
+ * `config`, in nS, so that an encoder writing wrong tick counts is detected
+ * even if the bits can still be decoded.
+ *
+ * Decoding stops at the first terminator, or after `max_items` items.
+ *
+ * @param config strip config the items were encoded with
+ * @param items RMT items to decode
+ * @param max_items maximum number of items to read, terminator included
+ * @param output decoded bytes
+ * @param output_size size of output, extra bytes are not written
+ */
+DecodedWaveform decode_waveform(
+		const pixled::StripConfig& config, const rmt_item32_t* items, uint32_t max_items,
+		uint8_t* output, uint32_t output_size);
+
+/*
+ * Reference encoder : encodes `size` bytes bit by bit, MSB first, then
+ * writes a terminator. `size * 8 + 1` items are written.
+ */
+void reference_encode(const pixled::StripConfig& config, const uint8_t* data, uint32_t size, rmt_item32_t* items);
+
+#endif